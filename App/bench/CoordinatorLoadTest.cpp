@@ -0,0 +1,414 @@
+// Coordinator 全链路压测 (CoordinatorLoadTest)
+// 用录制回放或合成场景代替触控芯片，驱动完整的线程化 Coordinator：
+// 采集线程 -> SPSC 队列 -> 处理管线 -> 三缓冲发布 / DVR 环形缓冲 / (可选) 连续录制，
+// 可在没有设备的 Linux 机器上压测与剖析。结束后输出读帧 / 丢帧计数、吞吐与端到端
+// 延迟分解 (p50/p90/p99/max)，以及各处理器的延迟分布。
+//
+//   CoordinatorLoadTest [--replay path | --scene name] [--emulator instant|spb|spidev]
+//                       [--timing original|scaled|fast]
+//                       [--speed N] [--loop] [--frames N] [--seconds S]
+//                       [--mode throughput|latency|both] [--core N]
+//                       [--record dir] [--snapshots dir] [--log dir]
+//
+// 说明：
+// - 默认合成 finger5 场景、flat-out (fast)，运行 10 秒。
+// - --replay 接受单个 .egdvr 文件或录制目录；非循环回放播完后自动结束。
+// - --timing original 按录制 / 场景帧率送帧，scaled 为 --speed 倍速，fast 不等待，
+//   只受下游背压 (帧槽 / 队列) 限制；离线来源在队列满时等待而不丢帧。
+// - --mode 选择执行模型 (见 App::ExecutionMode)；both 依次以相同来源运行两种模型并输出
+//   端到端分解对照表。--core 为 latency 模式绑定的逻辑核 (缺省最后一个)。
+// - --snapshots 开启异常触发快照 (默认阈值)，结束后输出各类检测命中与快照计数。
+// - --emulator 经 DeviceFrameSource + Chip 从 HimaxEmulator 取帧 (帧内容为 --scene 场景，
+//   帧率为场景帧率)，压测真实的设备读路径；启动前执行 Chip::Init，结束后输出总线事务计数。
+//   需要 Device 库 (EGOTOUCH_WITH_DEVICE)。
+
+#include "Coordinator.h"
+#include "FrameSource.h"
+#include "Logger.h"
+#if EGOTOUCH_WITH_DEVICE
+#include "DeviceFrameSource.h"
+#include "HimaxEmulator.h"
+#endif
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+bool ParseTiming(const std::string& name, App::ReplayTiming& timing) {
+    if (name == "original") timing = App::ReplayTiming::Original;
+    else if (name == "scaled") timing = App::ReplayTiming::Scaled;
+    else if (name == "fast") timing = App::ReplayTiming::AsFastAsPossible;
+    else return false;
+    return true;
+}
+
+bool FindScene(const std::string& name, Engine::SceneConfig& scene) {
+    for (Engine::SceneConfig& preset : Engine::SceneGenerator::Presets()) {
+        if (preset.name == name) {
+            scene = std::move(preset);
+            return true;
+        }
+    }
+    return false;
+}
+
+void PrintSpan(const char* name, const Engine::LatencySummary& s) {
+    std::printf("  %-28s samples=%-8llu p50=%8.1fus p90=%8.1fus p99=%8.1fus max=%8.1fus\n", name,
+                static_cast<unsigned long long>(s.count), s.p50 / 1000.0, s.p90 / 1000.0, s.p99 / 1000.0,
+                s.max / 1000.0);
+}
+
+unsigned long long Load(const std::atomic<uint64_t>& counter) {
+    return counter.load(std::memory_order_relaxed);
+}
+
+struct Options {
+    std::string replayPath;
+    std::string sceneName = "finger5";
+    App::ReplayTiming timing = App::ReplayTiming::AsFastAsPossible;
+    double speed = 1.0;
+    bool loop = false;
+    uint64_t maxFrames = 0;
+    double seconds = 10.0;
+    int core = -1;
+    std::string recordDir;
+    std::string snapshotDir;
+    std::string emulatorTiming;     // 非空时使用仿真设备
+};
+
+#if EGOTOUCH_WITH_DEVICE
+// 仿真设备的帧内容：每个帧号由场景生成一次，Master / Slave 两侧各取自己的字节段
+class SceneFiller {
+public:
+    explicit SceneFiller(Engine::SceneConfig scene) : m_generator(std::move(scene)) {}
+
+    void Fill(Himax::DeviceType side, uint64_t frameIndex, uint8_t* data, uint32_t len) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (frameIndex != m_frameIndex) {
+            m_generator.Next(m_frame);
+            m_frameIndex = frameIndex;
+        }
+        const size_t offset = side == Himax::DeviceType::Slave ? Engine::SceneGenerator::kMasterFrameBytes : 0;
+        std::memcpy(data, m_frame.rawData.data() + offset, std::min<size_t>(len, m_frame.rawData.size() - offset));
+    }
+
+private:
+    std::mutex m_mutex;
+    Engine::SceneGenerator m_generator;
+    Engine::HeatmapFrame m_frame;
+    uint64_t m_frameIndex = UINT64_MAX;
+};
+
+// 仿真器须比其上的 Chip (由 Coordinator 持有) 晚析构，因此由调用方保存
+std::unique_ptr<App::IFrameSource> MakeEmulatorSource(const Options& options,
+                                                      std::unique_ptr<Himax::HimaxEmulator>& emulator) {
+    Engine::SceneConfig scene;
+    if (!FindScene(options.sceneName, scene)) {
+        std::fprintf(stderr, "unknown scene '%s'\n", options.sceneName.c_str());
+        return nullptr;
+    }
+    Himax::EmulatorTiming timing = options.emulatorTiming == "instant" ? Himax::EmulatorTiming::Instant()
+                                 : options.emulatorTiming == "spidev" ? Himax::EmulatorTiming::Spidev()
+                                                                      : Himax::EmulatorTiming::SpbTestTool();
+    if (timing.frameIntervalUs != 0) timing.frameIntervalUs = static_cast<uint32_t>(1e6 / scene.frameRateHz);
+    std::printf("source: emulated device (%s timing), scene %s @ %.0f Hz\n", options.emulatorTiming.c_str(),
+                scene.name.c_str(), timing.frameIntervalUs ? scene.frameRateHz : 0.0);
+
+    emulator = std::make_unique<Himax::HimaxEmulator>(timing);
+    auto filler = std::make_shared<SceneFiller>(std::move(scene));
+    emulator->SetFrameFiller([filler](Himax::DeviceType side, uint64_t index, uint8_t* data, uint32_t len) {
+        filler->Fill(side, index, data, len);
+    });
+    auto chip = std::make_unique<Himax::Chip>(emulator->OpenTransport(Himax::DeviceType::Master),
+                                              emulator->OpenTransport(Himax::DeviceType::Slave),
+                                              emulator->OpenTransport(Himax::DeviceType::Interrupt));
+    const Clock::time_point start = Clock::now();
+    if (!chip->Init()) {
+        std::fprintf(stderr, "Chip::Init failed on the emulator\n");
+        return nullptr;
+    }
+    std::printf("Chip::Init: %.1f ms, %llu bus transactions\n",
+                std::chrono::duration<double, std::milli>(Clock::now() - start).count(),
+                static_cast<unsigned long long>(emulator->Counters().transactions.load()));
+    return std::make_unique<App::DeviceFrameSource>(std::move(chip));
+}
+#endif
+
+// 每种执行模型各建一个新来源，回放 / 合成都从第一帧开始
+std::unique_ptr<App::IFrameSource> MakeSource(const Options& options) {
+    if (!options.replayPath.empty()) {
+        App::ReplaySourceConfig config;
+        config.path = options.replayPath;
+        config.timing = options.timing;
+        config.speed = options.speed;
+        config.loop = options.loop;
+        auto replay = std::make_unique<App::ReplayFrameSource>(std::move(config));
+        if (!replay->Open()) {
+            std::fprintf(stderr, "no readable recording at %s\n", options.replayPath.c_str());
+            return nullptr;
+        }
+        std::printf("source: replay %s (%zu frames)\n", options.replayPath.c_str(), replay->FrameCount());
+        return replay;
+    }
+
+    App::SyntheticSourceConfig config;
+    if (!FindScene(options.sceneName, config.scene)) {
+        std::fprintf(stderr, "unknown scene '%s'; presets:", options.sceneName.c_str());
+        for (const Engine::SceneConfig& preset : Engine::SceneGenerator::Presets()) {
+            std::fprintf(stderr, " %s", preset.name.c_str());
+        }
+        std::fprintf(stderr, "\n");
+        return nullptr;
+    }
+    config.timing = options.timing;
+    config.speed = options.speed;
+    config.maxFrames = options.maxFrames;
+    std::printf("source: synthetic %s @ %.0f Hz\n", config.scene.name.c_str(), config.scene.frameRateHz);
+    return std::make_unique<App::SyntheticFrameSource>(std::move(config));
+}
+
+struct RunSummary {
+    App::ExecutionMode mode;
+    double throughput = 0.0;
+    Engine::LatencySummary queueing;
+    Engine::LatencySummary processing;
+    Engine::LatencySummary publication;
+    Engine::LatencySummary endToEnd;
+};
+
+// 以一种执行模型跑完整个压测；来源或录制无法打开时返回 false
+bool RunMode(const Options& options, App::ExecutionMode mode, RunSummary& summary) {
+#if EGOTOUCH_WITH_DEVICE
+    std::unique_ptr<Himax::HimaxEmulator> emulator;
+    std::unique_ptr<App::IFrameSource> source =
+        options.emulatorTiming.empty() ? MakeSource(options) : MakeEmulatorSource(options, emulator);
+#else
+    std::unique_ptr<App::IFrameSource> source = MakeSource(options);
+#endif
+    if (!source) return false;
+
+    App::Coordinator coordinator(std::move(source));
+    App::ExecutionConfig execution;
+    execution.mode = mode;
+    execution.pinnedCore = options.core;
+    coordinator.SetExecutionConfig(execution);
+    std::printf("mode: %s\n", App::ExecutionModeName(mode));
+
+    if (!options.recordDir.empty()) {
+        App::RecorderConfig recorder;
+        recorder.directory = options.recordDir;
+        if (!coordinator.StartRecording(recorder)) {
+            std::fprintf(stderr, "failed to start recording into %s\n", options.recordDir.c_str());
+            return false;
+        }
+    }
+    if (!options.snapshotDir.empty()) {
+        App::SnapshotConfig snapshots;
+        snapshots.enabled = true;
+        snapshots.directory = options.snapshotDir;
+        coordinator.ConfigureSnapshots(snapshots);
+    }
+
+    const App::AcquisitionStats& stats = coordinator.GetAcquisitionStats();
+    coordinator.Start();
+    coordinator.SetAcquisitionActive(true);
+
+    // 运行到时限；有限来源读完 (读帧计数 500 ms 不再增长) 后提前结束
+    const Clock::time_point start = Clock::now();
+    const Clock::time_point deadline =
+        start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.seconds));
+    Clock::time_point lastProgress = start;
+    Clock::time_point nextReport = start + std::chrono::seconds(1);
+    uint64_t lastRead = 0;
+    uint64_t reportedProcessed = 0;
+    Clock::time_point end = deadline;
+    while (Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        const Clock::time_point now = Clock::now();
+        const uint64_t read = Load(stats.framesRead);
+        if (read != lastRead) {
+            lastRead = read;
+            lastProgress = now;
+        } else if (read > 0 && now - lastProgress > std::chrono::milliseconds(500)) {
+            end = lastProgress;
+            break;
+        }
+        if (now >= nextReport) {
+            const uint64_t processed = Load(stats.framesProcessed);
+            std::printf("  t=%5.1fs read=%llu processed=%llu (%.0f fps)\n",
+                        std::chrono::duration<double>(now - start).count(), static_cast<unsigned long long>(read),
+                        static_cast<unsigned long long>(processed), static_cast<double>(processed - reportedProcessed));
+            reportedProcessed = processed;
+            nextReport += std::chrono::seconds(1);
+        }
+    }
+
+    coordinator.SetAcquisitionActive(false);
+    const double elapsed = std::chrono::duration<double>(std::min(end, Clock::now()) - start).count();
+    coordinator.Stop();
+
+    std::printf("\nframes: read=%llu processed=%llu read_errors=%llu pool_exhausted=%llu queue_full=%llu\n",
+                Load(stats.framesRead), Load(stats.framesProcessed), Load(stats.readErrors),
+                Load(stats.poolExhausted), Load(stats.queueFull));
+    summary.mode = mode;
+    summary.throughput = Load(stats.framesProcessed) / elapsed;
+    std::printf("throughput: %.1f frames/s over %.2f s\n", summary.throughput, elapsed);
+
+    std::printf("\nend-to-end latency:\n");
+    const App::FrameLatencyBreakdown& breakdown = coordinator.GetLatencyBreakdown();
+    summary.queueing = breakdown.queueing.Summarize();
+    summary.processing = breakdown.processing.Summarize();
+    summary.publication = breakdown.publication.Summarize();
+    summary.endToEnd = breakdown.endToEnd.Summarize();
+    PrintSpan("source read", breakdown.deviceIo.Summarize());
+    PrintSpan("queueing", summary.queueing);
+    PrintSpan("processing", summary.processing);
+    PrintSpan("publication", summary.publication);
+    PrintSpan("end-to-end", summary.endToEnd);
+
+    std::printf("\npipeline:\n");
+    Engine::FramePipeline& pipeline = coordinator.GetPipeline();
+    const auto& processors = pipeline.GetProcessors();
+    for (size_t i = 0; i < processors.size(); ++i) {
+        PrintSpan(processors[i]->GetName().c_str(), pipeline.GetProcessorStats(i).latency.Summarize());
+    }
+    PrintSpan("Front-end (fused)", pipeline.GetFrontEndStats().latency.Summarize());
+    PrintSpan("Pipeline total", pipeline.GetPipelineStats().latency.Summarize());
+
+    if (!options.recordDir.empty()) {
+        const App::RecorderStats& rec = coordinator.GetRecorder().Stats();
+        std::printf("\nrecorder: submitted=%llu written=%llu dropped_queue=%llu dropped_io=%llu bytes=%llu files=%llu\n",
+                    Load(rec.submitted), Load(rec.written), Load(rec.droppedQueueFull), Load(rec.droppedWriteError),
+                    Load(rec.bytesWritten), Load(rec.filesOpened));
+    }
+
+    if (!options.snapshotDir.empty()) {
+        const App::SnapshotStats& snap = coordinator.GetSnapshotter().Stats();
+        std::printf("\nanomalies: inspected=%llu", Load(snap.framesInspected));
+        for (int i = 0; i < Engine::kAnomalyKindCount; ++i) {
+            std::printf(" %s=%llu", Engine::AnomalyKindName(1u << i), Load(snap.hits[i]));
+        }
+        std::printf("\nsnapshots: captures=%llu written=%llu suppressed=%llu errors=%llu\n", Load(snap.captures),
+                    Load(snap.written), Load(snap.suppressed), Load(snap.writeErrors));
+    }
+
+#if EGOTOUCH_WITH_DEVICE
+    if (emulator) {
+        const Himax::EmulatorCounters& bus = emulator->Counters();
+        std::printf("\nemulator: transactions=%llu bytes=%llu frames_served=%llu overrun=%llu timeouts=%llu "
+                    "protocol_errors=%llu\n",
+                    Load(bus.transactions), Load(bus.bytes), Load(bus.framesServed), Load(bus.framesOverrun),
+                    Load(bus.frameTimeouts), Load(bus.protocolErrors));
+    }
+#endif
+    return true;
+}
+
+void PrintComparison(const std::vector<RunSummary>& runs) {
+    std::printf("\n%-12s %10s %-12s %10s %10s %10s %10s\n", "mode", "fps", "span", "p50 (us)", "p90 (us)",
+                "p99 (us)", "max (us)");
+    for (const RunSummary& run : runs) {
+        const std::pair<const char*, const Engine::LatencySummary*> spans[] = {
+            {"queueing", &run.queueing},
+            {"processing", &run.processing},
+            {"publication", &run.publication},
+            {"end-to-end", &run.endToEnd},
+        };
+        bool first = true;
+        for (const auto& [name, s] : spans) {
+            std::printf("%-12s %10s %-12s %10.1f %10.1f %10.1f %10.1f\n", first ? App::ExecutionModeName(run.mode) : "",
+                        first ? std::to_string(static_cast<int>(run.throughput)).c_str() : "", name, s->p50 / 1000.0,
+                        s->p90 / 1000.0, s->p99 / 1000.0, s->max / 1000.0);
+            first = false;
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    std::vector<App::ExecutionMode> modes = {App::ExecutionMode::Throughput};
+    std::string logDir;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--replay" && i + 1 < argc) {
+            options.replayPath = argv[++i];
+        } else if (arg == "--scene" && i + 1 < argc) {
+            options.sceneName = argv[++i];
+        } else if (arg == "--timing" && i + 1 < argc && ParseTiming(argv[i + 1], options.timing)) {
+            ++i;
+        } else if (arg == "--speed" && i + 1 < argc) {
+            options.speed = std::max(0.01, std::atof(argv[++i]));
+        } else if (arg == "--loop") {
+            options.loop = true;
+        } else if (arg == "--frames" && i + 1 < argc) {
+            options.maxFrames = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--seconds" && i + 1 < argc) {
+            options.seconds = std::max(0.1, std::atof(argv[++i]));
+        } else if (arg == "--mode" && i + 1 < argc) {
+            const std::string mode = argv[++i];
+            if (mode == "throughput") modes = {App::ExecutionMode::Throughput};
+            else if (mode == "latency") modes = {App::ExecutionMode::Latency};
+            else if (mode == "both") modes = {App::ExecutionMode::Throughput, App::ExecutionMode::Latency};
+            else modes.clear();
+        } else if (arg == "--core" && i + 1 < argc) {
+            options.core = std::atoi(argv[++i]);
+        } else if (arg == "--record" && i + 1 < argc) {
+            options.recordDir = argv[++i];
+        } else if (arg == "--snapshots" && i + 1 < argc) {
+            options.snapshotDir = argv[++i];
+        } else if (arg == "--log" && i + 1 < argc) {
+            logDir = argv[++i];
+#if EGOTOUCH_WITH_DEVICE
+        } else if (arg == "--emulator" && i + 1 < argc) {
+            options.emulatorTiming = argv[++i];
+            if (options.emulatorTiming != "instant" && options.emulatorTiming != "spb" &&
+                options.emulatorTiming != "spidev") {
+                modes.clear();
+            }
+#endif
+        } else {
+            modes.clear();
+            break;
+        }
+    }
+    if (modes.empty()) {
+        std::fprintf(stderr,
+                     "usage: %s [--replay path | --scene name] [--emulator instant|spb|spidev]\n"
+                     "          [--timing original|scaled|fast] [--speed N]\n"
+                     "          [--loop] [--frames N] [--seconds S] [--mode throughput|latency|both] [--core N]\n"
+                     "          [--record dir] [--snapshots dir] [--log dir]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    if (!logDir.empty()) Common::Logger::Init("CoordinatorLoadTest", logDir);
+
+    std::vector<RunSummary> runs;
+    for (App::ExecutionMode mode : modes) {
+        if (!runs.empty()) std::printf("\n----------------------------------------\n");
+        RunSummary summary;
+        if (!RunMode(options, mode, summary)) {
+            Common::Logger::Shutdown();
+            return 1;
+        }
+        runs.push_back(summary);
+    }
+    if (runs.size() > 1) PrintComparison(runs);
+
+    Common::Logger::Shutdown();
+    return 0;
+}
@@ -0,0 +1,120 @@
+// 采集 -> 处理帧队列争用基准
+// 对比 mutex + condvar 的 RingBuffer 与无锁 SpscRingBuffer / OverwriteRingBuffer：
+//   - 生产者按 120 / 240 / 480 Hz 节拍推帧，消费者 WaitForData 取帧，统计交接延迟
+//   - 消费者每帧再写入 DVR 环形缓冲区，同时 UI 线程以 60 Hz 拉取快照，统计 DVR 写入耗时
+//
+//   RingBufferBench [seconds-per-case]
+
+#include "RingBuffer.h"
+#include "SpscRingBuffer.h"
+#include "EngineTypes.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Engine::HeatmapFrame;
+
+uint64_t NowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now().time_since_epoch()).count());
+}
+
+double Percentile(std::vector<uint64_t>& samples, double p) {
+    if (samples.empty()) return 0.0;
+    size_t idx = static_cast<size_t>(p * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+    return samples[idx] / 1000.0;
+}
+
+struct CaseResult {
+    std::vector<uint64_t> handoffNs;
+    std::vector<uint64_t> dvrPushNs;
+    uint64_t dvrDropped = 0;
+    uint64_t queueFull = 0;
+};
+
+template <typename Queue, typename Dvr>
+CaseResult RunCase(int rateHz, double seconds) {
+    auto* queue = new Queue();
+    auto* dvr = new Dvr();
+    CaseResult result;
+    const int frames = static_cast<int>(rateHz * seconds);
+    result.handoffNs.reserve(frames);
+    result.dvrPushNs.reserve(frames);
+
+    std::atomic<bool> producing{true};
+
+    std::thread ui([&] {
+        // 模拟 UI 以 60 Hz 拉取 DVR 快照
+        while (producing.load()) {
+            auto snapshot = dvr->GetSnapshot();
+            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        }
+    });
+
+    std::thread consumer([&] {
+        HeatmapFrame frame;
+        int received = 0;
+        while (received < frames) {
+            if (!queue->WaitForData(frame, std::chrono::milliseconds(100))) {
+                if (!producing.load()) break;
+                continue;
+            }
+            result.handoffNs.push_back(NowNs() - frame.timestamp);
+            const uint64_t t0 = NowNs();
+            dvr->PushOverwriting(frame);
+            result.dvrPushNs.push_back(NowNs() - t0);
+            ++received;
+        }
+    });
+
+    HeatmapFrame frame;
+    frame.rawData.resize(5063 + 339);
+    const auto period = std::chrono::nanoseconds(1000000000LL / rateHz);
+    auto next = Clock::now();
+    for (int i = 0; i < frames; ++i) {
+        next += period;
+        std::this_thread::sleep_until(next);
+        frame.timestamp = NowNs();
+        if (!queue->Push(frame)) ++result.queueFull;
+    }
+    producing.store(false);
+    consumer.join();
+    ui.join();
+
+    if constexpr (requires { dvr->DroppedCount(); }) {
+        result.dvrDropped = dvr->DroppedCount();
+    }
+    delete queue;
+    delete dvr;
+    return result;
+}
+
+void Report(const char* name, int rateHz, CaseResult r) {
+    std::printf("%-10s %5d %9zu %10.1f %10.1f %10.1f %12.1f %12.1f %8llu %6llu\n",
+                name, rateHz, r.handoffNs.size(),
+                Percentile(r.handoffNs, 0.50), Percentile(r.handoffNs, 0.99), Percentile(r.handoffNs, 1.0),
+                Percentile(r.dvrPushNs, 0.99), Percentile(r.dvrPushNs, 1.0),
+                static_cast<unsigned long long>(r.dvrDropped), static_cast<unsigned long long>(r.queueFull));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::max(0.1, std::atof(argv[1])) : 3.0;
+
+    std::printf("%-10s %5s %9s %10s %10s %10s %12s %12s %8s %6s\n",
+                "queue", "Hz", "frames", "p50 us", "p99 us", "max us", "dvr p99 us", "dvr max us", "dropped", "full");
+    for (int rate : {120, 240, 480}) {
+        Report("mutex", rate, RunCase<App::RingBuffer<HeatmapFrame, 16>, App::RingBuffer<HeatmapFrame, 120>>(rate, seconds));
+        Report("spsc", rate, RunCase<App::SpscRingBuffer<HeatmapFrame, 16>, App::OverwriteRingBuffer<HeatmapFrame, 120>>(rate, seconds));
+    }
+    return 0;
+}
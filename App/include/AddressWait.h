@@ -0,0 +1,33 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#elif defined(_M_ARM64) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace App {
+
+// 自旋等待中的 CPU 提示 (x86 PAUSE / ARM YIELD)，降低超线程争用与功耗
+inline void CpuRelax() {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(_M_ARM64) && defined(_MSC_VER)
+    __yield();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// 在 32-bit 原子量上挂起，直到其值不再等于 expected、被 WakeOne 唤醒或超时。
+// Windows 走 WaitOnAddress，Linux 走 futex；允许虚假唤醒，调用方需自行复查条件。
+void WaitOnValue(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::nanoseconds timeout);
+
+// 唤醒一个挂起在 word 上的线程
+void WakeOne(std::atomic<uint32_t>& word);
+
+} // namespace App
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "AnomalyDetector.h"
+#include "FramePool.h"
+#include "SpscRingBuffer.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace App {
+
+// DVR 时间回溯缓冲的容量 (Coordinator::m_dvrBuffer)，也是快照可回溯的最大帧数
+inline constexpr size_t kDvrHistoryFrames = 120;
+using DvrHistory = OverwriteRingBuffer<FrameRef, kDvrHistoryFrames>;
+
+struct SnapshotConfig {
+    bool enabled = false;
+    std::string directory = "snapshots";
+    int preFrames = 120;              // 触发帧之前的帧数 (<= kDvrHistoryFrames)
+    int postFrames = 60;              // 触发帧之后的帧数 (<= AnomalySnapshotter::kMaxPostFrames)
+    int cooldownFrames = 240;         // 两次截取的起点至少间隔的帧数
+    uint32_t maxSnapshots = 100;      // 本次运行最多写出的快照数，持续异常时不会刷满磁盘
+    bool compress = true;
+    uint32_t keyframeInterval = 60;
+    Engine::AnomalyConfig detector;
+};
+
+// 各计数只增不减，任意线程可读
+struct SnapshotStats {
+    std::atomic<uint64_t> framesInspected{0};
+    std::array<std::atomic<uint64_t>, Engine::kAnomalyKindCount> hits{};   // 按 AnomalyKind 位序，不论是否截取
+    std::atomic<uint64_t> captures{0};       // 开始截取
+    std::atomic<uint64_t> suppressed{0};     // 命中但处于冷却 / 上一个快照未写完 / 达到上限
+    std::atomic<uint64_t> written{0};        // 已写出的快照文件
+    std::atomic<uint64_t> writeErrors{0};
+    std::atomic<uint64_t> lastMask{0};       // 最近一次截取的类别
+};
+
+// 异常触发快照 (Anomaly Snapshotter)
+// 处理线程每帧调用 OnFrame：Engine::AnomalyDetector 做常数级检查，命中时把 DVR 缓冲中的
+// 前 preFrames 帧、触发帧与随后 postFrames 帧的引用收集为一份快照，交给后台写线程写成
+// .egdvr (snapshots/anomaly_<时间>_<序号>_<类别>_at<触发帧>.egdvr)，处理线程不做任何 I/O。
+// 同一时刻至多一份快照在途 (收集或写入)，帧槽占用上限为 kMaxFramesHeld，计入 Coordinator 的 FramePool。
+class AnomalySnapshotter {
+public:
+    static constexpr int kMaxPostFrames = 120;
+    static constexpr size_t kMaxFramesHeld = kDvrHistoryFrames + 1 + kMaxPostFrames;
+
+    AnomalySnapshotter() = default;
+    ~AnomalySnapshotter();
+    AnomalySnapshotter(const AnomalySnapshotter&) = delete;
+    AnomalySnapshotter& operator=(const AnomalySnapshotter&) = delete;
+
+    // 启动 / 停止写线程 (随 Coordinator::Start / Stop)。Stop 须在处理线程退出后调用：
+    // 收集到一半的快照按已有帧写出
+    void Start();
+    void Stop();
+
+    // 任意线程调用；处理线程在下一帧取用。configHash 写入快照文件头 (见 DvrFile.h)
+    void Configure(const SnapshotConfig& config, uint64_t configHash);
+
+    // 任意线程调用：帧序列出现断点 (采集恢复、线程重启) 时清空检测历史，处理线程在下一帧执行。
+    // 计数与冷却保留
+    void ResetDetector() { m_resetPending.store(true, std::memory_order_release); }
+
+    // 仅限处理线程：frame 为刚发布的帧，须在其推入 history 之前调用
+    void OnFrame(const FrameRef& frame, const DvrHistory& history);
+
+    const SnapshotStats& Stats() const { return m_stats; }
+
+private:
+    struct Capture {
+        std::vector<FrameRef> frames;
+        uint32_t mask = 0;
+        size_t triggerIndex = 0;      // 触发帧在 frames 中的下标
+        uint64_t configHash = 0;
+        std::string directory;
+        bool compress = true;
+        uint32_t keyframeInterval = 60;
+    };
+
+    void ApplyPendingConfig();
+    void BeginCapture(const FrameRef& frame, const DvrHistory& history, uint32_t mask);
+    void FinishCapture();
+    void WriterThreadFunc();
+    void WriteCapture(Capture& capture, uint32_t sequence);
+
+    // --- 处理线程独占 ---
+    SnapshotConfig m_config;
+    uint64_t m_configHash = 0;
+    Engine::AnomalyDetector m_detector;
+    Capture m_capture;
+    int m_postRemaining = 0;          // > 0 表示正在收集触发后的帧
+    int64_t m_cooldown = 0;           // 剩余冷却帧数
+    uint32_t m_started = 0;           // 已开始的截取数 (对照 maxSnapshots)
+
+    // --- 配置移交 (GUI -> 处理线程) ---
+    std::mutex m_configMutex;
+    SnapshotConfig m_pendingConfig;
+    uint64_t m_pendingHash = 0;
+    std::atomic<bool> m_configPending{false};
+    std::atomic<bool> m_resetPending{false};
+
+    // --- 写线程 ---
+    std::atomic<bool> m_inFlight{false};   // 处理线程开始截取时置位，写线程写完并释放帧槽后清除
+    std::atomic<bool> m_stopRequested{false};
+    std::thread m_writerThread;
+    SpscRingBuffer<Capture, 2> m_queue;
+
+    SnapshotStats m_stats;
+};
+
+} // namespace App
@@ -1,7 +1,11 @@
 #pragma once
 
-#include "HimaxChip.h"
-#include "RingBuffer.h"
+#include "FrameSource.h"
+#include "SpscRingBuffer.h"
+#include "FramePool.h"
+#include "TripleBuffer.h"
+#include "StreamRecorder.h"
+#include "AnomalySnapshotter.h"
 #include <thread>
 #include <atomic>
 #include <memory>
@@ -15,25 +19,81 @@
 
 namespace App {
 
+// 端到端延迟分解 (与 Engine::FrameTrace 的各区段对应)，由处理线程写入
+struct FrameLatencyBreakdown {
+    Engine::LatencyHistogram deviceIo;     // readStart -> readDone
+    Engine::LatencyHistogram queueing;     // readDone -> dequeue
+    Engine::LatencyHistogram processing;   // dequeue -> processed
+    Engine::LatencyHistogram publication;  // processed -> GUI 发布完成 (FrameTrace::publishedNs)
+    Engine::LatencyHistogram endToEnd;     // readStart -> 发布完成
+
+    void Clear() {
+        deviceIo.Clear();
+        queueing.Clear();
+        processing.Clear();
+        publication.Clear();
+        endToEnd.Clear();
+    }
+};
+
+// 采集线程计数 (采集线程写入，任意线程读取)
+struct AcquisitionStats {
+    std::atomic<uint64_t> framesRead{0};
+    std::atomic<uint64_t> readErrors{0};
+    std::atomic<uint64_t> poolExhausted{0};   // 帧槽耗尽，本帧未读
+    std::atomic<uint64_t> queueFull{0};       // 处理队列满，读到的帧被丢弃 (仅实时来源)
+    std::atomic<uint64_t> framesProcessed{0}; // 处理线程：管线成功并已发布
+};
+
+// 线程执行模型
+enum class ExecutionMode {
+    Throughput,   // 采集线程 -> SPSC 队列 -> 处理线程：读设备与处理在两个核上重叠 (默认)
+    Latency,      // 单线程 run-to-completion：读帧 -> 解析 -> 管线 -> 发布在同一线程完成，无队列交接与唤醒
+};
+
+const char* ExecutionModeName(ExecutionMode mode);
+
+struct ExecutionConfig {
+    ExecutionMode mode = ExecutionMode::Throughput;
+    int pinnedCore = -1;   // Latency 模式工作线程绑定的逻辑核；< 0 为最后一个逻辑核 (单核机器不绑定)
+};
+
 class Coordinator {
 public:
-    Coordinator();
+    // source 为采集线程的帧来源 (真实设备 / 录制回放 / 合成场景，见 FrameSource.h)
+    explicit Coordinator(std::unique_ptr<IFrameSource> source);
     ~Coordinator();
 
     bool Start();
     void Stop();
+
+    // 选择执行模型。运行中调用会停止采集 / 处理线程、清零延迟统计并以新模型重启，
+    // 使两种模型的端到端分解可以在同一设备上直接对比；进行中的录制与异常快照不受影响
+    bool SetExecutionConfig(const ExecutionConfig& config);
+    const ExecutionConfig& GetExecutionConfig() const { return m_executionConfig; }
     
-    // GUI 交互接口，用于手动控制芯片
-    Himax::Chip* GetDevice() { return m_device.get(); }
+    // GUI 交互接口：真实设备来源可向下转型为 DeviceFrameSource 以手动控制芯片
+    IFrameSource* GetSource() { return m_source.get(); }
+    const AcquisitionStats& GetAcquisitionStats() const { return m_acquisitionStats; }
     
     // 注入供 GUI 使用的最新热力图引用
-    bool GetLatestFrame(Engine::HeatmapFrame& outFrame);
+    // 仅当存在比 ioVersion 更新的帧时写出 outFrame (只增加槽位引用计数) 并更新 ioVersion。
+    // 无等待，处理线程不会因 GUI 而阻塞；只允许单一线程 (GUI 线程) 调用。
+    bool GetLatestFrame(FrameRef& outFrame, uint64_t& ioVersion);
 
     // 获取数据处理管线，用于 GUI 动态配置
     Engine::FramePipeline& GetPipeline() { return m_pipeline; }
 
-    // 数据采集循环控制
-    void SetAcquisitionActive(bool active) { m_isAcquiring.store(active); }
+    // 把管线各处理器的延迟分布 (p50/p90/p99/max) 与调用 / 丢帧计数写入日志
+    void LogPipelineLatency();
+
+    // 端到端延迟分解 (实时)
+    const FrameLatencyBreakdown& GetLatencyBreakdown() const { return m_latencyBreakdown; }
+    // 清零管线统计与延迟分解 (由处理线程在下一帧执行)
+    void ResetLatencyStats();
+
+    // 数据采集循环控制；暂停后恢复时清空异常检测的历史 (前后两帧不连续)
+    void SetAcquisitionActive(bool active);
     bool IsAcquisitionActive() const { return m_isAcquiring.load(); }
 
     /**
@@ -41,14 +101,34 @@ public:
      * 
      * 该功能实现“时间溯源”式的回放：
      * 系统在后台自动维护一个环形缓冲区（Rolling Buffer），循环记录最新的 120 帧（约 2 秒历史）。
-     * 当用户发现特定异常场景时（如：断线、跳动），点击导出按钮可将缓存中的原始热力图及
-     * 算法处理后的坐标点完整序列快照导出为 CSV 文件，用于离线算法回放与精度复现。
+     * 当用户发现特定异常场景时（如：断线、跳动），点击导出按钮可将缓存中的原始数据、
+     * 处理后的热力图、坐标点与打点完整序列快照导出为 .egdvr 二进制文件 (见 Engine/DvrFile.h)，
+     * 用于离线算法回放与精度复现；需要文本时用 DvrToCsv 转换。
      */
     void TriggerDVRExport();
 
+    // 连续录制 (Streaming Recorder)：每个处理后的帧异步写入磁盘，不阻塞处理线程
+    bool StartRecording(const RecorderConfig& config);
+    void StopRecording() { m_recorder.Stop(); }
+    const StreamRecorder& GetRecorder() const { return m_recorder; }
+
+    // 异常触发快照：检测命中时自动导出触发前后的帧 (配置在处理线程的下一帧生效)
+    void ConfigureSnapshots(const SnapshotConfig& config);
+    const AnomalySnapshotter& GetSnapshotter() const { return m_snapshotter; }
+
 private:
+    // 按 m_executionConfig.mode 启动 / 等待退出采集、处理与状态线程 (不涉及录制与快照)
+    void StartThreads();
+    void StopThreads();
+
     void AcquisitionThreadFunc();
     void ProcessingThreadFunc();
+    void RunToCompletionThreadFunc();
+    // 两种执行模型共用的单帧步骤
+    bool AcquireFrame(FrameRef& frame);
+    void ProcessFrame(FrameRef frame);
+    void WaitPollInterval();
+    void RecordLatencyBreakdown(const Engine::FrameTrace& trace);
     void SystemStateThreadFunc();
 
 private:
@@ -56,9 +136,11 @@ private:
     std::atomic<bool> m_isAcquiring{false};
     
     // Modules
-    std::unique_ptr<Himax::Chip> m_device;
+    std::unique_ptr<IFrameSource> m_source;
+    AcquisitionStats m_acquisitionStats;
     
-    // Threads
+    // Threads (Latency 模式只使用 m_acquisitionThread 运行 RunToCompletionThreadFunc)
+    ExecutionConfig m_executionConfig;
     std::thread m_acquisitionThread;
     std::thread m_processingThread;
     std::thread m_systemStateThread;
@@ -66,15 +148,27 @@ private:
     // Engine Pipeline
     Engine::FramePipeline m_pipeline;
 
-    // Data flow
-    RingBuffer<Engine::HeatmapFrame, 16> m_frameBuffer;
+    // 帧槽池：须先于下列持有 FrameRef 的成员构造、后于它们析构
+    // 容量覆盖 队列 16 + DVR 120 + 导出快照 120 + 录制队列 64 + 异常快照 241 + GUI / 处理中的少量引用
+    FramePool m_framePool{336 + AnomalySnapshotter::kMaxFramesHeld};
+
+    // Data flow (采集线程 -> 处理线程，单生产者单消费者；仅 Throughput 模式)
+    SpscRingBuffer<FrameRef, 16> m_frameBuffer;
     
-    // GUI needs the latest frame synchronously
-    std::mutex m_latestFrameMutex;
-    Engine::HeatmapFrame m_latestFrame;
+    // GUI needs the latest frame (处理线程发布，GUI 线程读取)
+    TripleBuffer<FrameRef> m_latestFrame;
 
     // Time Backtrack (DVR) rolling buffer
-    RingBuffer<Engine::HeatmapFrame, 120> m_dvrBuffer;
+    DvrHistory m_dvrBuffer;
+
+    // 连续录制 (队列中持有帧槽引用)
+    StreamRecorder m_recorder;
+
+    // 异常触发快照 (在途快照持有帧槽引用)
+    AnomalySnapshotter m_snapshotter;
+
+    FrameLatencyBreakdown m_latencyBreakdown;
+    std::atomic<bool> m_resetBreakdown{false};
 };
 
 } // namespace App
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "FrameSource.h"
+#include "HimaxChip.h"
+#include <memory>
+
+namespace App {
+
+// 真实设备：Himax 双芯片 (Master + Slave) 经 SPB 测试驱动读帧。
+// 只分配 Chip 对象，不拉起通信；连接 / AFE 控制由 GUI 通过 Device() 手动操作
+class DeviceFrameSource : public IFrameSource {
+public:
+#ifdef _WIN32
+    DeviceFrameSource();
+#endif
+    // 使用外部构造的 Chip (spidev / HimaxEmulator 等 transport)
+    explicit DeviceFrameSource(std::unique_ptr<Himax::Chip> device);
+
+    const char* Name() const override { return "Device"; }
+    bool IsReady() const override;
+    bool ReadFrame(Engine::HeatmapFrame& frame) override;
+    bool IsLive() const override { return true; }
+    std::chrono::microseconds PollInterval() const override { return std::chrono::milliseconds(2); }
+
+    Himax::Chip* Device() { return m_device.get(); }
+
+private:
+    std::unique_ptr<Himax::Chip> m_device;
+};
+
+} // namespace App
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Coordinator.h"
+#include "DvrMappedReader.h"
+#include <chrono>
 
 namespace App {
 
@@ -19,20 +21,46 @@ private:
     void DrawCoordinateTable();
     void DrawMasterSuffixTable();
     void DrawSlaveSuffixTable();
+    void DrawPipelineLatency();
+    void DrawRecorderControls();
+    void DrawSnapshotControls();
+    void DrawReplayPanel();
 
-    void ExportCurrentFrameToCSV();
+    // 导出当前帧为单帧 .egdvr 文件
+    void ExportCurrentFrame();
+
+    // 当前显示的帧 (回放打开时为回放帧)；尚未收到任何帧时返回一个空帧
+    const Engine::HeatmapFrame& CurrentFrame() const;
 
 private:
     Coordinator* m_coordinator;
     
-    // 缓存的最新的热力图数据
-    Engine::HeatmapFrame m_currentFrame;
+    // 缓存的最新的热力图数据 (持有帧槽引用，不拷贝帧内容)
+    FrameRef m_currentFrame;
+    uint64_t m_currentVersion = 0;   // 0 = 尚未收到任何帧
     
     // GUI 内部状态
     bool m_autoRefresh = true;
     bool m_fullscreen = false;
     int m_heatmapScale = 10;
     float m_colorRange = 1000.0f;
+
+    // 连续录制参数 (下次 Start Recording 时生效)
+    RecorderConfig m_recorderConfig;
+
+    // 异常触发快照参数 (修改后立即下发给处理线程)
+    SnapshotConfig m_snapshotConfig;
+
+    // 录制回放：打开后各面板显示回放帧，实时帧仍在后台更新
+    Engine::DvrSession m_replay;
+    Engine::HeatmapFrame m_replayFrame;
+    char m_replayPath[260] = "recordings";
+    size_t m_replayIndex = 0;
+    size_t m_replayLoaded = SIZE_MAX;    // m_replayFrame 对应的帧
+    bool m_replayPlaying = false;
+    float m_replaySpeed = 1.0f;
+    uint64_t m_replayStartTimestamp = 0; // 开始播放时的帧时间戳
+    std::chrono::steady_clock::time_point m_replayStartTime;
 };
 
 } // namespace App
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "EngineTypes.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace App {
+
+class FramePool;
+
+namespace detail {
+struct FrameSlot {
+    Engine::HeatmapFrame frame;
+    std::atomic<uint32_t> refs{0};
+    std::atomic<uint32_t> nextFree{0};
+    uint32_t index = 0;
+    FramePool* pool = nullptr;
+};
+} // namespace detail
+
+// 帧槽引用 (Ref-counted Frame Handle)
+// 拷贝只增减引用计数，最后一个引用释放时槽位归还 FramePool。
+// 约定：帧只在采集 -> 处理阶段由当前持有者通过 Mutable() 写入，
+// 发布给 GUI / DVR 之后所有持有者都只读。
+class FrameRef {
+public:
+    FrameRef() = default;
+    FrameRef(const FrameRef& other) noexcept : m_slot(other.m_slot) { AddRef(); }
+    FrameRef(FrameRef&& other) noexcept : m_slot(other.m_slot) { other.m_slot = nullptr; }
+    FrameRef& operator=(const FrameRef& other) noexcept {
+        if (m_slot != other.m_slot) {
+            other.AddRef();
+            Reset();
+            m_slot = other.m_slot;
+        }
+        return *this;
+    }
+    FrameRef& operator=(FrameRef&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            m_slot = other.m_slot;
+            other.m_slot = nullptr;
+        }
+        return *this;
+    }
+    ~FrameRef() { Reset(); }
+
+    explicit operator bool() const { return m_slot != nullptr; }
+    const Engine::HeatmapFrame& operator*() const { return m_slot->frame; }
+    const Engine::HeatmapFrame* operator->() const { return &m_slot->frame; }
+
+    // 仅限当前写阶段 (采集 / 处理线程) 使用
+    Engine::HeatmapFrame& Mutable() const { return m_slot->frame; }
+
+    uint32_t SlotIndex() const { return m_slot ? m_slot->index : UINT32_MAX; }
+
+    void Reset();
+
+private:
+    friend class FramePool;
+    explicit FrameRef(detail::FrameSlot* slot) : m_slot(slot) {}
+
+    void AddRef() const {
+        if (m_slot) m_slot->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    detail::FrameSlot* m_slot = nullptr;
+};
+
+// 预分配帧槽池 (Frame Slot Pool)
+// 每个槽的 rawData 在构造时一次性分配为 Master + Slave 原始帧长度，
+// 设备读取直接写入槽内缓冲区；之后队列 / DVR / GUI 之间只流转 FrameRef，
+// 5.4 KB 原始数据与 4.8 KB 热力图每帧只写一次、从不整帧拷贝。
+// 空闲链表为带 ABA 标签的无锁栈，Acquire / 释放可在任意线程并发调用。
+class FramePool {
+public:
+    static constexpr size_t kMasterFrameBytes = 5063;
+    static constexpr size_t kSlaveFrameBytes = 339;
+    static constexpr size_t kRawFrameBytes = kMasterFrameBytes + kSlaveFrameBytes;
+
+    explicit FramePool(size_t slotCount);
+    ~FramePool();
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // 取一个空闲槽 (引用计数为 1)；池耗尽时返回空引用，调用方应丢弃该帧
+    FrameRef Acquire();
+
+    size_t Capacity() const { return m_slotCount; }
+    size_t FreeCount() const { return m_freeCount.load(std::memory_order_relaxed); }
+
+    // 因池耗尽而失败的 Acquire 次数
+    uint64_t ExhaustedCount() const { return m_exhausted.load(std::memory_order_relaxed); }
+
+private:
+    friend class FrameRef;
+    void Release(detail::FrameSlot* slot);
+
+    static constexpr uint32_t kNil = UINT32_MAX;
+    static uint64_t Pack(uint32_t tag, uint32_t index) { return (static_cast<uint64_t>(tag) << 32) | index; }
+
+    std::unique_ptr<detail::FrameSlot[]> m_slots;
+    size_t m_slotCount;
+
+    // 高 32 位为 ABA 标签，低 32 位为栈顶槽位
+    std::atomic<uint64_t> m_freeHead;
+    std::atomic<size_t> m_freeCount;
+    std::atomic<uint64_t> m_exhausted{0};
+};
+
+inline void FrameRef::Reset() {
+    if (m_slot) {
+        if (m_slot->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            m_slot->pool->Release(m_slot);
+        }
+        m_slot = nullptr;
+    }
+}
+
+} // namespace App
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "EngineTypes.h"
+#include "DvrMappedReader.h"
+#include "SceneGenerator.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace App {
+
+// ---------------------------------------------------------
+// 帧来源 (Frame Source)
+// Coordinator 的采集线程只通过此接口取原始帧，不关心帧来自真实设备、录制回放还是
+// 合成场景；因此整条线程化链路 (队列 / 管线 / 发布 / 录制) 可以在没有触控芯片的
+// 机器上压测与剖析。
+// 除 Name() 外只由采集线程调用 (构造与配置在 Coordinator::Start 之前完成)。
+class IFrameSource {
+public:
+    virtual ~IFrameSource() = default;
+
+    virtual const char* Name() const = 0;
+
+    // 当前能否读帧 (设备已连接 / 回放已打开且未播完)；false 时采集线程空闲等待
+    virtual bool IsReady() const = 0;
+
+    // 读入下一帧：写入 rawData、timestamp，以及 trace.readStartNs / readDoneNs。
+    // frame 为 FramePool 的槽位，rawData 已按整帧长度 (FramePool::kRawFrameBytes) 分配，原地写入且不改变长度。
+    // 可以阻塞 (设备 I/O 或回放节拍)，但节拍等待不计入 readStart -> readDone。
+    // 返回 false 表示本次没有帧 (读失败 / 播完)
+    virtual bool ReadFrame(Engine::HeatmapFrame& frame) = 0;
+
+    // 有限来源读完 (回放到末尾且不循环) 后返回 true
+    virtual bool IsFinished() const { return false; }
+
+    // 实时来源 (设备) 无法暂停，下游满时丢帧；离线来源 (回放 / 合成) 等待下游，不丢帧
+    virtual bool IsLive() const { return false; }
+
+    // 两次 ReadFrame 之间的固定间隔 (设备轮询)；自带节拍的来源为 0
+    virtual std::chrono::microseconds PollInterval() const { return std::chrono::microseconds(0); }
+};
+
+// 回放节拍
+enum class ReplayTiming {
+    Original,          // 按录制时的帧间隔
+    Scaled,            // 帧间隔除以 speed (N 倍速)
+    AsFastAsPossible,  // 不等待，只受下游背压限制
+};
+
+// 按帧时间戳 (ns) 换算墙钟节拍。第一帧建立锚点；落后超过 kMaxLagNs 时重新锚定，
+// 避免下游卡顿后一次性补发大量积压帧
+class FramePacer {
+public:
+    static constexpr uint64_t kMaxLagNs = 100'000'000;
+
+    void Configure(ReplayTiming timing, double speed);
+    void Reset() { m_anchored = false; }
+
+    // 等待到 timestamp 对应的墙钟时刻
+    void WaitFor(uint64_t timestamp);
+
+    ReplayTiming Timing() const { return m_timing; }
+    double Speed() const { return m_speed; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    ReplayTiming m_timing = ReplayTiming::Original;
+    double m_speed = 1.0;
+    bool m_anchored = false;
+    uint64_t m_anchorTimestamp = 0;
+    Clock::time_point m_anchorTime;
+};
+
+struct ReplaySourceConfig {
+    std::string path;                          // 单个 .egdvr 文件或录制目录 (见 Engine::DvrSession)
+    ReplayTiming timing = ReplayTiming::Original;
+    double speed = 1.0;                        // 仅 Scaled 使用
+    bool loop = false;                         // 播完后从头继续；时间戳保持递增
+};
+
+// 录制回放：把 .egdvr 中的原始数据按录制时间戳重新送入管线。
+// 处理结果 (heatmap / contacts) 不从文件读取，由当前管线重新计算
+class ReplayFrameSource : public IFrameSource {
+public:
+    explicit ReplayFrameSource(ReplaySourceConfig config);
+
+    bool Open();
+    bool IsOpen() const { return m_session.IsOpen(); }
+
+    const char* Name() const override { return "Replay"; }
+    bool IsReady() const override { return m_session.IsOpen() && !IsFinished(); }
+    bool ReadFrame(Engine::HeatmapFrame& frame) override;
+    bool IsFinished() const override;
+
+    size_t FrameCount() const { return m_session.FrameCount(); }
+    size_t Position() const { return m_position; }
+    uint64_t Loops() const { return m_loops; }
+
+private:
+    ReplaySourceConfig m_config;
+    Engine::DvrSession m_session;
+    FramePacer m_pacer;
+    size_t m_position = 0;
+    uint64_t m_loops = 0;
+    uint64_t m_timestampOffset = 0;   // 循环回放时叠加，保证下游看到的时间戳单调递增
+};
+
+struct SyntheticSourceConfig {
+    Engine::SceneConfig scene = Engine::SceneGenerator::OneFinger();
+    ReplayTiming timing = ReplayTiming::Original;   // Original = scene.frameRateHz
+    double speed = 1.0;
+    uint64_t maxFrames = 0;                         // 0 = 无限
+};
+
+// 合成场景：Engine::SceneGenerator 逐帧生成，时间戳为场景的合成时钟
+class SyntheticFrameSource : public IFrameSource {
+public:
+    explicit SyntheticFrameSource(SyntheticSourceConfig config);
+
+    const char* Name() const override { return "Synthetic"; }
+    bool IsReady() const override { return !IsFinished(); }
+    bool ReadFrame(Engine::HeatmapFrame& frame) override;
+    bool IsFinished() const override;
+
+    uint64_t FramesGenerated() const { return m_generator.FrameIndex(); }
+
+private:
+    SyntheticSourceConfig m_config;
+    Engine::SceneGenerator m_generator;
+    FramePacer m_pacer;
+};
+
+} // namespace App
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "IFrameProcessor.h"
+
+namespace App {
+
+// 处理器参数面板 (ImGui 适配层)
+// 根据 IFrameProcessor::DescribeParams 的描述符生成控件，Engine 本身不链接 ImGui。
+void DrawProcessorConfig(Engine::IFrameProcessor& processor);
+
+} // namespace App
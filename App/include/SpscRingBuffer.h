@@ -0,0 +1,189 @@
+#pragma once
+
+#include "AddressWait.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace App {
+
+inline constexpr size_t kCacheLineSize = 64;
+
+// 单生产者 / 单消费者无锁环形队列 (采集线程 -> 处理线程)
+// - head / tail 各占独立缓存行，并各自缓存对端索引，常态下 Push / Pop 不产生跨核缓存行争用
+// - WaitForData 先自旋一小段，再在唤醒序号上 park (futex / WaitOnAddress)；
+//   生产者只在消费者确实挂起时才发起系统调用
+// Push 只能由同一个线程调用，Pop / WaitForData / Clear 只能由另一个线程调用。
+template<typename T, size_t Capacity>
+class SpscRingBuffer {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // 缓冲区满时返回 false (丢弃新帧，与 RingBuffer::Push 一致)
+    bool Push(const T& item) { return PushImpl(item); }
+    bool Push(T&& item) { return PushImpl(std::move(item)); }
+
+    // 取出时移动而非拷贝：队列中不残留句柄 (如 FrameRef) 的引用
+    bool Pop(T& outItem) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) return false;
+        }
+        outItem = std::move(m_buffer[head & kMask]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 阻塞直到有新数据或超时 (用于处理线程)
+    bool WaitForData(T& outItem, std::chrono::milliseconds timeout) {
+        if (Pop(outItem)) return true;
+
+        // 1. 自旋：240/480Hz 下帧往往在数微秒内到达，避免一次内核往返
+        for (int i = 0; i < kSpinIterations; ++i) {
+            CpuRelax();
+            if (Pop(outItem)) return true;
+        }
+
+        // 2. park：先读唤醒序号再复查，生产者在此之后的唤醒会让 WaitOnValue 立即返回
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (;;) {
+            const uint32_t seq = m_wakeSeq.load(std::memory_order_acquire);
+            m_consumerParked.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (Pop(outItem)) {
+                m_consumerParked.store(false, std::memory_order_relaxed);
+                return true;
+            }
+            const auto remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining <= std::chrono::steady_clock::duration::zero()) {
+                m_consumerParked.store(false, std::memory_order_relaxed);
+                return false;
+            }
+            WaitOnValue(m_wakeSeq, seq, remaining);
+            m_consumerParked.store(false, std::memory_order_relaxed);
+            if (Pop(outItem)) return true;
+        }
+    }
+
+    size_t Size() const {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    // 消费者侧丢弃所有未读帧
+    void Clear() {
+        T discarded;
+        while (Pop(discarded)) {}
+    }
+
+private:
+    template<typename U>
+    bool PushImpl(U&& item) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead >= Capacity) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead >= Capacity) return false;
+        }
+        m_buffer[tail & kMask] = std::forward<U>(item);
+        m_tail.store(tail + 1, std::memory_order_release);
+
+        // 与消费者的 "置 parked -> 复查 tail" 构成 Dekker 对：两侧至少一方能看到对方的写入
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_consumerParked.load(std::memory_order_relaxed)) {
+            m_wakeSeq.fetch_add(1, std::memory_order_release);
+            WakeOne(m_wakeSeq);
+        }
+        return true;
+    }
+
+    static constexpr size_t kMask = Capacity - 1;
+    static constexpr int kSpinIterations = 512;
+
+    // 消费者独占
+    alignas(kCacheLineSize) std::atomic<size_t> m_head{0};
+    size_t m_cachedTail = 0;
+
+    // 生产者独占
+    alignas(kCacheLineSize) std::atomic<size_t> m_tail{0};
+    size_t m_cachedHead = 0;
+
+    // 唤醒通道
+    alignas(kCacheLineSize) std::atomic<uint32_t> m_wakeSeq{0};
+    std::atomic<bool> m_consumerParked{false};
+
+    alignas(kCacheLineSize) std::array<T, Capacity> m_buffer{};
+};
+
+// 单写者覆盖式环形缓冲区 (DVR 时间回溯)
+// PushOverwriting 永不阻塞：缓冲区满时覆盖最旧帧。GetSnapshot 可在任意线程调用，
+// 按从旧到新的顺序复制当前内容。
+// 写者与快照之间用一对标志做 Dekker 互斥，而不是给每帧加锁：快照期间到达的
+// PushOverwriting 直接丢弃 (计入 DroppedCount)，保证写者 (处理线程) 永远不会等待 UI。
+template<typename T, size_t Capacity>
+class OverwriteRingBuffer {
+public:
+    // 仅限单一写线程调用；被覆盖的最旧元素随赋值析构 (FrameRef 即归还槽位)
+    void PushOverwriting(const T& item) { PushImpl(item); }
+    void PushOverwriting(T&& item) { PushImpl(std::move(item)); }
+
+    std::vector<T> GetSnapshot() const {
+        std::vector<T> snapshot;
+        // 多个快照线程之间仍需串行
+        while (m_snapshotActive.exchange(true, std::memory_order_acquire)) {
+            CpuRelax();
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // 等待进行中的那一次写入结束 (至多一帧拷贝的时间)
+        while (m_writing.load(std::memory_order_acquire)) {
+            CpuRelax();
+        }
+
+        const uint64_t written = m_written.load(std::memory_order_acquire);
+        const size_t count = static_cast<size_t>(written < Capacity ? written : Capacity);
+        snapshot.reserve(count);
+        for (uint64_t i = written - count; i < written; ++i) {
+            snapshot.push_back(m_buffer[i % Capacity]);
+        }
+
+        m_snapshotActive.store(false, std::memory_order_release);
+        return snapshot;
+    }
+
+    size_t Size() const {
+        const uint64_t written = m_written.load(std::memory_order_acquire);
+        return static_cast<size_t>(written < Capacity ? written : Capacity);
+    }
+
+    // 快照期间被丢弃的写入数
+    uint64_t DroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    template<typename U>
+    void PushImpl(U&& item) {
+        m_writing.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_snapshotActive.load(std::memory_order_relaxed)) {
+            m_writing.store(false, std::memory_order_release);
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        const uint64_t written = m_written.load(std::memory_order_relaxed);
+        m_buffer[written % Capacity] = std::forward<U>(item);
+        m_written.store(written + 1, std::memory_order_release);
+        m_writing.store(false, std::memory_order_release);
+    }
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> m_written{0};
+    std::atomic<bool> m_writing{false};
+    std::atomic<uint64_t> m_dropped{0};
+
+    alignas(kCacheLineSize) mutable std::atomic<bool> m_snapshotActive{false};
+
+    std::array<T, Capacity> m_buffer{};
+};
+
+} // namespace App
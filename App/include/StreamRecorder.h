@@ -0,0 +1,75 @@
+#pragma once
+
+#include "FramePool.h"
+#include "SpscRingBuffer.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace App {
+
+struct RecorderConfig {
+    std::string directory = "recordings";
+    std::string prefix = "session";
+    uint64_t maxFileBytes = 256ull << 20;    // 单文件大小上限，达到后轮转
+    uint32_t maxFileSeconds = 300;           // 单文件时长上限，0 为不限
+    uint64_t maxTotalBytes = 4ull << 30;     // 目录内本前缀文件的总占用上限，超出删除最旧文件
+    bool compress = true;                    // 以 FrameEncoder 压缩块写入 (见 DvrFile.h)
+    uint32_t keyframeInterval = 60;          // 压缩时的关键帧间隔 (帧)
+};
+
+// 各计数只增不减 (Start 时清零)，任意线程可读
+struct RecorderStats {
+    std::atomic<uint64_t> submitted{0};      // 处理线程提交的帧
+    std::atomic<uint64_t> written{0};        // 已写入磁盘的帧
+    std::atomic<uint64_t> droppedQueueFull{0};  // 写线程落后、队列满而丢弃
+    std::atomic<uint64_t> droppedWriteError{0}; // 打开 / 写入失败而丢弃
+    std::atomic<uint64_t> bytesWritten{0};
+    std::atomic<uint64_t> filesOpened{0};
+    std::atomic<uint64_t> filesDeleted{0};   // 因磁盘预算删除的旧文件
+    std::atomic<uint64_t> maxQueueDepth{0};  // 观测到的最大积压 (写线程侧)
+};
+
+// 连续录制器 (Streaming Recorder)
+// 处理线程通过 Submit 把已发布帧的引用推入无锁 SPSC 队列，后台写线程逐帧追加到
+// .egdvr 文件 (Engine::DvrWriter，可选压缩，编码在写线程上完成)，按大小 / 时长轮转，并把目录总占用限制在预算内。
+// Submit 从不阻塞、不分配：队列满即丢弃并计数。帧在队列中只占用帧槽引用，
+// 队列容量计入 Coordinator 的 FramePool 容量。
+class StreamRecorder {
+public:
+    static constexpr size_t kQueueCapacity = 64;   // 240Hz 下约 266ms 的磁盘抖动余量
+
+    StreamRecorder() = default;
+    ~StreamRecorder();
+    StreamRecorder(const StreamRecorder&) = delete;
+    StreamRecorder& operator=(const StreamRecorder&) = delete;
+
+    // 启动写线程 (GUI 线程调用)；已在录制时返回 false
+    bool Start(const RecorderConfig& config, uint64_t configHash);
+    // 写完队列中剩余的帧、补全当前文件的索引后返回
+    void Stop();
+
+    bool IsRecording() const { return m_active.load(std::memory_order_relaxed); }
+
+    // 仅限处理线程调用；未在录制时为空操作
+    void Submit(const FrameRef& frame);
+
+    const RecorderStats& Stats() const { return m_stats; }
+
+private:
+    void WriterThreadFunc();
+    void EnforceDiskBudget(const std::string& currentFile);
+
+    RecorderConfig m_config;
+    uint64_t m_configHash = 0;
+
+    std::atomic<bool> m_active{false};
+    std::atomic<bool> m_stopRequested{false};
+    std::thread m_writerThread;
+
+    SpscRingBuffer<FrameRef, kQueueCapacity> m_queue;
+    RecorderStats m_stats;
+};
+
+} // namespace App
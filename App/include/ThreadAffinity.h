@@ -0,0 +1,12 @@
+#pragma once
+
+namespace App {
+
+// 把调用线程固定到逻辑核 core 上 (Windows SetThreadAffinityMask / Linux pthread_setaffinity_np)。
+// 核号越界或平台不支持时返回 false，线程保持原有亲和性
+bool PinCurrentThread(int core);
+
+// 逻辑核数量 (至少为 1)
+int LogicalCoreCount();
+
+} // namespace App
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "SpscRingBuffer.h"
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+namespace App {
+
+// 单写者 / 单读者无等待三缓冲 (处理线程 -> GUI 最新帧发布)
+// 三个槽位分别归写者 (back)、读者 (front) 所有，第三个 (middle) 为交换位。
+// Publish 写 back 后与 middle 原子交换；Update 仅在 middle 带有新数据标记时与 front 交换。
+// 两侧都只做一次原子交换，任何一方都不会等待另一方：GUI 卡顿只会让中间帧被覆盖，
+// 而不会拖慢写者。每次发布附带单调递增的版本号 (从 1 开始，0 表示尚未发布)。
+template<typename T>
+class TripleBuffer {
+public:
+    // 仅限写线程调用
+    void Publish(const T& value) { PublishImpl(value); }
+    void Publish(T&& value) { PublishImpl(std::move(value)); }
+
+    // 仅限读线程调用：有新发布时换入并返回 true，之后 Front() / FrontVersion() 指向最新值
+    bool Update() {
+        if ((m_middle.load(std::memory_order_relaxed) & kDirty) == 0) return false;
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & kIndexMask;
+        return true;
+    }
+
+    const T& Front() const { return m_slots[m_front].value; }
+    uint64_t FrontVersion() const { return m_slots[m_front].version; }
+
+    // 任意线程：已发布的次数
+    uint64_t PublishedVersion() const { return m_version.load(std::memory_order_relaxed); }
+
+private:
+    template<typename U>
+    void PublishImpl(U&& value) {
+        Slot& slot = m_slots[m_back];
+        slot.value = std::forward<U>(value);
+        slot.version = m_version.load(std::memory_order_relaxed) + 1;
+        m_version.store(slot.version, std::memory_order_relaxed);
+        m_back = m_middle.exchange(m_back | kDirty, std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    static constexpr uint32_t kIndexMask = 0x3;
+    static constexpr uint32_t kDirty = 0x4;
+
+    struct alignas(kCacheLineSize) Slot {
+        T value{};
+        uint64_t version = 0;
+    };
+
+    Slot m_slots[3];
+
+    // middle 槽位索引 | 新数据标记
+    alignas(kCacheLineSize) std::atomic<uint32_t> m_middle{1};
+    std::atomic<uint64_t> m_version{0};
+
+    alignas(kCacheLineSize) uint32_t m_back = 0;   // 写者独占
+    alignas(kCacheLineSize) uint32_t m_front = 2;  // 读者独占
+};
+
+} // namespace App
@@ -0,0 +1,46 @@
+#include "AddressWait.h"
+#include <algorithm>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace App {
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex / WaitOnAddress need a plain 32-bit word");
+
+void WaitOnValue(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::nanoseconds timeout) {
+    if (timeout <= std::chrono::nanoseconds::zero()) return;
+#if defined(_WIN32)
+    // WaitOnAddress 以毫秒计，向上取整避免 0ms 退化为忙等
+    auto ms = std::chrono::ceil<std::chrono::milliseconds>(timeout).count();
+    WaitOnAddress(reinterpret_cast<volatile VOID*>(&word), &expected, sizeof(expected), static_cast<DWORD>(ms));
+#elif defined(__linux__)
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+    ts.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, &ts, nullptr, 0);
+#else
+    (void)word;
+    (void)expected;
+    std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(timeout, std::chrono::milliseconds(1)));
+#endif
+}
+
+void WakeOne(std::atomic<uint32_t>& word) {
+#if defined(_WIN32)
+    WakeByAddressSingle(reinterpret_cast<PVOID>(&word));
+#elif defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+} // namespace App
@@ -0,0 +1,201 @@
+#include "AnomalySnapshotter.h"
+#include "DvrFile.h"
+#include "Logger.h"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <format>
+#include <iterator>
+
+namespace App {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void Bump(std::atomic<uint64_t>& counter, uint64_t delta = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+} // namespace
+
+AnomalySnapshotter::~AnomalySnapshotter() {
+    Stop();
+}
+
+void AnomalySnapshotter::Start() {
+    if (m_writerThread.joinable()) return;
+
+    // 上次 Stop 时未写出的快照已随队列丢弃，处理线程尚未启动；
+    // 上一次运行的末帧与本次首帧不连续，检测历史一并清空
+    m_queue.Clear();
+    m_detector.Reset();
+    m_resetPending.store(false, std::memory_order_relaxed);
+    m_inFlight.store(false, std::memory_order_relaxed);
+    m_stopRequested.store(false, std::memory_order_relaxed);
+    m_writerThread = std::thread(&AnomalySnapshotter::WriterThreadFunc, this);
+}
+
+void AnomalySnapshotter::Stop() {
+    if (!m_writerThread.joinable()) return;
+
+    // 处理线程已退出，本线程暂为收集状态的唯一访问者
+    if (m_postRemaining > 0) {
+        m_postRemaining = 0;
+        FinishCapture();
+    }
+    m_stopRequested.store(true, std::memory_order_release);
+    m_writerThread.join();
+    m_queue.Clear();
+}
+
+void AnomalySnapshotter::Configure(const SnapshotConfig& config, uint64_t configHash) {
+    std::lock_guard<std::mutex> lock(m_configMutex);
+    m_pendingConfig = config;
+    m_pendingHash = configHash;
+    m_configPending.store(true, std::memory_order_release);
+}
+
+void AnomalySnapshotter::ApplyPendingConfig() {
+    if (!m_configPending.load(std::memory_order_acquire)) return;
+
+    std::lock_guard<std::mutex> lock(m_configMutex);
+    m_config = m_pendingConfig;
+    m_configHash = m_pendingHash;
+    m_configPending.store(false, std::memory_order_relaxed);
+
+    m_config.preFrames = std::clamp(m_config.preFrames, 0, static_cast<int>(kDvrHistoryFrames));
+    m_config.postFrames = std::clamp(m_config.postFrames, 0, kMaxPostFrames);
+    m_config.cooldownFrames = std::max(0, m_config.cooldownFrames);
+    // 阈值变化不清空检测历史，ghost / flip-flop 判断跨配置连续
+    m_detector.SetConfig(m_config.detector);
+}
+
+void AnomalySnapshotter::OnFrame(const FrameRef& frame, const DvrHistory& history) {
+    ApplyPendingConfig();
+    if (m_resetPending.exchange(false, std::memory_order_acquire)) m_detector.Reset();
+
+    // 收集中的快照先于检测取帧：即使随后关闭检测，已开始的快照也会收满
+    if (m_postRemaining > 0) {
+        m_capture.frames.push_back(frame);
+        if (--m_postRemaining == 0) FinishCapture();
+    }
+    if (!m_config.enabled) return;
+
+    const uint32_t mask = m_detector.Inspect(*frame);
+    Bump(m_stats.framesInspected);
+    if (m_cooldown > 0) --m_cooldown;
+    if (!mask) return;
+
+    for (uint32_t bits = mask; bits; bits &= bits - 1) {
+        Bump(m_stats.hits[std::countr_zero(bits)]);
+    }
+    if (m_postRemaining > 0 || m_cooldown > 0 || m_started >= m_config.maxSnapshots ||
+        m_inFlight.load(std::memory_order_acquire)) {
+        Bump(m_stats.suppressed);
+        return;
+    }
+    BeginCapture(frame, history, mask);
+}
+
+void AnomalySnapshotter::BeginCapture(const FrameRef& frame, const DvrHistory& history, uint32_t mask) {
+    m_inFlight.store(true, std::memory_order_relaxed);
+    ++m_started;
+    m_cooldown = m_config.cooldownFrames;
+
+    // 只在触发时复制一次 DVR 缓冲 (帧槽引用)；frame 尚未推入 history
+    std::vector<FrameRef> past = history.GetSnapshot();
+    const size_t pre = std::min(past.size(), static_cast<size_t>(m_config.preFrames));
+    m_capture.frames.reserve(pre + 1 + m_config.postFrames);
+    m_capture.frames.assign(std::make_move_iterator(past.end() - pre), std::make_move_iterator(past.end()));
+    m_capture.frames.push_back(frame);
+    m_capture.mask = mask;
+    m_capture.triggerIndex = pre;
+    m_capture.configHash = m_configHash;
+    m_capture.directory = m_config.directory;
+    m_capture.compress = m_config.compress;
+    m_capture.keyframeInterval = m_config.keyframeInterval;
+
+    Bump(m_stats.captures);
+    m_stats.lastMask.store(mask, std::memory_order_relaxed);
+
+    m_postRemaining = m_config.postFrames;
+    if (m_postRemaining == 0) FinishCapture();
+}
+
+void AnomalySnapshotter::FinishCapture() {
+    // m_inFlight 保证队列为空，Push 失败只可能是写线程未启动
+    if (!m_queue.Push(std::move(m_capture))) {
+        Bump(m_stats.writeErrors);
+        m_inFlight.store(false, std::memory_order_release);
+    }
+    m_capture = Capture{};
+}
+
+void AnomalySnapshotter::WriterThreadFunc() {
+    uint32_t sequence = 0;
+    for (;;) {
+        Capture capture;
+        if (!m_queue.WaitForData(capture, std::chrono::milliseconds(100))) {
+            if (m_stopRequested.load(std::memory_order_acquire)) break;
+            continue;
+        }
+        WriteCapture(capture, sequence++);
+        // 先归还帧槽，再允许下一次截取
+        capture.frames.clear();
+        m_inFlight.store(false, std::memory_order_release);
+    }
+}
+
+void AnomalySnapshotter::WriteCapture(Capture& capture, uint32_t sequence) {
+    const auto start = std::chrono::steady_clock::now();
+
+    std::error_code ec;
+    fs::create_directories(capture.directory, ec);
+    if (ec) {
+        LOG_ERROR("App", "AnomalySnapshotter::WriteCapture", "Snapshot", "Cannot create snapshot directory {}: {}",
+                  capture.directory, ec.message());
+        Bump(m_stats.writeErrors);
+        return;
+    }
+
+    const std::time_t wallNow = std::time(nullptr);
+    struct tm timeInfo;
+#if defined(_WIN32)
+    localtime_s(&timeInfo, &wallNow);
+#else
+    localtime_r(&wallNow, &timeInfo);
+#endif
+    const std::string kinds = Engine::FormatAnomalyMask(capture.mask);
+    const std::string path =
+        (fs::path(capture.directory) /
+         std::format("anomaly_{:04d}{:02d}{:02d}_{:02d}{:02d}{:02d}_{:04d}_{}_at{}.egdvr", timeInfo.tm_year + 1900,
+                     timeInfo.tm_mon + 1, timeInfo.tm_mday, timeInfo.tm_hour, timeInfo.tm_min, timeInfo.tm_sec,
+                     sequence, kinds, capture.triggerIndex)).string();
+
+    Engine::DvrWriter writer;
+    if (!writer.Open(path, capture.configHash, capture.compress, capture.keyframeInterval)) {
+        LOG_ERROR("App", "AnomalySnapshotter::WriteCapture", "Snapshot", "Failed to create {}", path);
+        Bump(m_stats.writeErrors);
+        return;
+    }
+    for (const FrameRef& frame : capture.frames) {
+        if (!writer.Append(*frame)) break;
+    }
+    const uint64_t written = writer.RecordCount();
+    if (!writer.Close() || written != capture.frames.size()) {
+        LOG_ERROR("App", "AnomalySnapshotter::WriteCapture", "Snapshot", "Snapshot incomplete: {} of {} frames written to {}",
+                  written, capture.frames.size(), path);
+        Bump(m_stats.writeErrors);
+        return;
+    }
+
+    Bump(m_stats.written);
+    const double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("App", "AnomalySnapshotter::WriteCapture", "Snapshot", "Anomaly [{}] captured: {} ({} frames, trigger at {}, {:.2f} ms)",
+             kinds, path, written, capture.triggerIndex, elapsedMs);
+}
+
+} // namespace App
@@ -1,33 +1,26 @@
 #include "Coordinator.h"
 #include "Logger.h"
-#include "DynamicDeadzoneFilter.h"
-#include "SignalConditioningFilter.h"
-#include "GaussianFilter.h"
-#include "SpatialSharpenFilter.h"
-#include "CentroidExtractor.h"
+#include "DvrFile.h"
+#include "ThreadAffinity.h"
 #include <chrono>
+#include <ctime>
+#include <format>
 
 namespace App {
 
-// --- 设备路径 ---
-const std::wstring DEVICE_PATH_INTERRUPT = L"\\\\.\\Global\\SPBTESTTOOL_MASTER";
-const std::wstring DEVICE_PATH_MASTER = L"\\\\.\\Global\\SPBTESTTOOL_MASTER";
-const std::wstring DEVICE_PATH_SLAVE = L"\\\\.\\Global\\SPBTESTTOOL_SLAVE";
+const char* ExecutionModeName(ExecutionMode mode) {
+    switch (mode) {
+        case ExecutionMode::Throughput: return "Throughput";
+        case ExecutionMode::Latency: return "Latency";
+    }
+    return "Unknown";
+}
 
-Coordinator::Coordinator() {
-    LOG_INFO("App", "Coordinator::Coordinator", "Unconnected", "Initializing Himax Device Instance (Unconnected)...");
-    // 初始化 Hardware 层对象，此时只分配资源，不拉起 I2C 通信
-    m_device = std::make_unique<Himax::Chip>(DEVICE_PATH_MASTER, DEVICE_PATH_SLAVE, DEVICE_PATH_INTERRUPT);
+Coordinator::Coordinator(std::unique_ptr<IFrameSource> source) : m_source(std::move(source)) {
+    LOG_INFO("App", "Coordinator::Coordinator", "Unknown", "Frame source: {}", m_source->Name());
 
     // Initialise Engine Pipeline
-    m_pipeline.AddProcessor(std::make_unique<Engine::MasterFrameParser>());
-    m_pipeline.AddProcessor(std::make_unique<Engine::BaselineSubtraction>());
-    m_pipeline.AddProcessor(std::make_unique<Engine::DynamicDeadzoneFilter>());
-    m_pipeline.AddProcessor(std::make_unique<Engine::SignalConditioningFilter>());
-    m_pipeline.AddProcessor(std::make_unique<Engine::GaussianFilter>());
-    // Unsharp masking filter to separate highly merged fingers *before* extraction
-    m_pipeline.AddProcessor(std::make_unique<Engine::SpatialSharpenFilter>());
-    m_pipeline.AddProcessor(std::make_unique<Engine::CentroidExtractor>());
+    Engine::AddDefaultProcessors(m_pipeline);
 }
 
 Coordinator::~Coordinator() {
@@ -37,14 +30,14 @@ Coordinator::~Coordinator() {
 bool Coordinator::Start() {
     if (m_running.exchange(true)) return false; // Already running
 
-    LOG_INFO("App", "Coordinator::Start", "Unknown", "Starting background threads...");
+    LOG_INFO("App", "Coordinator::Start", "Unknown", "Starting background threads ({} mode)...",
+             ExecutionModeName(m_executionConfig.mode));
     
     // 启动 Himax AFE (假设它已经在构造里或外面调了，或者在这里调)
     // 也可以留给 GUI 去手动点击 "Start AFE"
     
-    m_acquisitionThread = std::thread(&Coordinator::AcquisitionThreadFunc, this);
-    m_processingThread = std::thread(&Coordinator::ProcessingThreadFunc, this);
-    m_systemStateThread = std::thread(&Coordinator::SystemStateThreadFunc, this);
+    m_snapshotter.Start();
+    StartThreads();
 
     return true;
 }
@@ -54,42 +47,184 @@ void Coordinator::Stop() {
 
     LOG_INFO("App", "Coordinator::Stop", "Unknown", "Stopping background threads...");
 
+    StopThreads();
+
+    // 处理线程已退出，不会再有新帧提交；写完剩余帧
+    m_recorder.Stop();
+    m_snapshotter.Stop();
+
+    LogPipelineLatency();
+}
+
+void Coordinator::StartThreads() {
+    if (m_executionConfig.mode == ExecutionMode::Latency) {
+        m_acquisitionThread = std::thread(&Coordinator::RunToCompletionThreadFunc, this);
+    } else {
+        m_acquisitionThread = std::thread(&Coordinator::AcquisitionThreadFunc, this);
+        m_processingThread = std::thread(&Coordinator::ProcessingThreadFunc, this);
+    }
+    m_systemStateThread = std::thread(&Coordinator::SystemStateThreadFunc, this);
+}
+
+void Coordinator::StopThreads() {
     if (m_acquisitionThread.joinable()) m_acquisitionThread.join();
     if (m_processingThread.joinable()) m_processingThread.join();
     if (m_systemStateThread.joinable()) m_systemStateThread.join();
+
+    // 上一种模式遗留在队列中的帧
+    m_frameBuffer.Clear();
+}
+
+bool Coordinator::SetExecutionConfig(const ExecutionConfig& config) {
+    // 只重启线程：录制器与快照器在切换期间只是收不到新帧，录制文件不会被结束
+    const bool wasRunning = m_running.exchange(false);
+    if (wasRunning) {
+        LOG_INFO("App", "Coordinator::SetExecutionConfig", "Unknown", "Restarting background threads...");
+        StopThreads();
+        LogPipelineLatency();
+    }
+
+    m_executionConfig = config;
+    // 线程均已停止，可直接清零 (不经处理线程的延迟清零标志)
+    m_pipeline.ResetStats();
+    m_latencyBreakdown.Clear();
+    m_resetBreakdown.store(false, std::memory_order_relaxed);
+    // 切换期间丢弃了队列中的帧，重启后的首帧与之前不连续
+    m_snapshotter.ResetDetector();
+    LOG_INFO("App", "Coordinator::SetExecutionConfig", "Unknown", "Execution mode: {}", ExecutionModeName(config.mode));
+
+    if (wasRunning) {
+        m_running.store(true);
+        StartThreads();
+    }
+    return true;
+}
+
+void Coordinator::SetAcquisitionActive(bool active) {
+    if (!m_isAcquiring.exchange(active) && active) m_snapshotter.ResetDetector();
+}
+
+bool Coordinator::StartRecording(const RecorderConfig& config) {
+    return m_recorder.Start(config, m_pipeline.ConfigHash());
+}
+
+void Coordinator::ConfigureSnapshots(const SnapshotConfig& config) {
+    m_snapshotter.Configure(config, m_pipeline.ConfigHash());
+}
+
+void Coordinator::ResetLatencyStats() {
+    m_pipeline.ResetStats();
+    m_resetBreakdown.store(true, std::memory_order_relaxed);
+}
+
+void Coordinator::RecordLatencyBreakdown(const Engine::FrameTrace& trace) {
+    if (m_resetBreakdown.exchange(false, std::memory_order_relaxed)) {
+        m_latencyBreakdown.Clear();
+    }
+    m_latencyBreakdown.deviceIo.Record(trace.DeviceIoNs());
+    m_latencyBreakdown.queueing.Record(trace.QueueNs());
+    m_latencyBreakdown.processing.Record(trace.ProcessingNs());
+    m_latencyBreakdown.publication.Record(trace.PublicationNs());
+    m_latencyBreakdown.endToEnd.Record(trace.EndToEndNs());
 }
 
-bool Coordinator::GetLatestFrame(Engine::HeatmapFrame& outFrame) {
-    std::lock_guard<std::mutex> lock(m_latestFrameMutex);
-    outFrame = m_latestFrame;
+void Coordinator::LogPipelineLatency() {
+    LOG_INFO("App", "Coordinator::LogPipelineLatency", "Profiling", "Execution mode: {}",
+             ExecutionModeName(m_executionConfig.mode));
+    auto logStats = [](const std::string& name, const Engine::ProcessorStats& stats) {
+        const Engine::LatencySummary s = stats.latency.Summarize();
+        LOG_INFO("App", "Coordinator::LogPipelineLatency", "Profiling",
+                 "{:<32} calls={} drops={} samples={} p50={:.1f}us p90={:.1f}us p99={:.1f}us max={:.1f}us",
+                 name, stats.calls.load(std::memory_order_relaxed), stats.drops.load(std::memory_order_relaxed),
+                 s.count, s.p50 / 1000.0, s.p90 / 1000.0, s.p99 / 1000.0, s.max / 1000.0);
+    };
+
+    const auto& processors = m_pipeline.GetProcessors();
+    for (size_t i = 0; i < processors.size(); ++i) {
+        logStats(processors[i]->GetName(), m_pipeline.GetProcessorStats(i));
+    }
+    logStats("Front-end (fused)", m_pipeline.GetFrontEndStats());
+    logStats("Pipeline total", m_pipeline.GetPipelineStats());
+
+    auto logSpan = [](const char* name, const Engine::LatencyHistogram& histogram) {
+        const Engine::LatencySummary s = histogram.Summarize();
+        LOG_INFO("App", "Coordinator::LogPipelineLatency", "Profiling",
+                 "{:<32} samples={} p50={:.1f}us p90={:.1f}us p99={:.1f}us max={:.1f}us",
+                 name, s.count, s.p50 / 1000.0, s.p90 / 1000.0, s.p99 / 1000.0, s.max / 1000.0);
+    };
+    logSpan("[E2E] Device I/O", m_latencyBreakdown.deviceIo);
+    logSpan("[E2E] Queueing", m_latencyBreakdown.queueing);
+    logSpan("[E2E] Processing", m_latencyBreakdown.processing);
+    logSpan("[E2E] Publication", m_latencyBreakdown.publication);
+    logSpan("[E2E] End-to-end", m_latencyBreakdown.endToEnd);
+}
+
+bool Coordinator::GetLatestFrame(FrameRef& outFrame, uint64_t& ioVersion) {
+    m_latestFrame.Update();
+    const uint64_t version = m_latestFrame.FrontVersion();
+    if (version == 0 || version == ioVersion) return false;
+    outFrame = m_latestFrame.Front();
+    ioVersion = version;
     return true;
 }
 
+// 采集一帧到池中槽位 (来源直接写入，不经中转缓冲)；本轮没有帧时按需等待并返回 false
+bool Coordinator::AcquireFrame(FrameRef& frame) {
+    if (!m_source->IsReady() || !m_isAcquiring.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return false;
+    }
+
+    frame = m_framePool.Acquire();
+    if (!frame) {
+        // 下游持有了全部槽位 (处理严重滞后)，丢弃本帧，与队列满时的策略一致
+        m_acquisitionStats.poolExhausted.fetch_add(1, std::memory_order_relaxed);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        return false;
+    }
+
+    Engine::HeatmapFrame& data = frame.Mutable();
+    if (!m_source->ReadFrame(data)) {
+        // 读失败由来源记录日志；播完的回放在下一轮 IsReady 变为 false。
+        // 总线挂死时读会连续立即失败，稍作退避，避免空转刷日志
+        frame = FrameRef();
+        if (!m_source->IsFinished()) {
+            m_acquisitionStats.readErrors.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        return false;
+    }
+    m_acquisitionStats.framesRead.fetch_add(1, std::memory_order_relaxed);
+    data.trace.enqueueNs = Engine::TraceNowNs();
+    return true;
+}
+
+void Coordinator::WaitPollInterval() {
+    if (const auto interval = m_source->PollInterval(); interval.count() > 0) {
+        std::this_thread::sleep_for(interval); // Polling Interval
+    }
+}
+
 void Coordinator::AcquisitionThreadFunc() {
     LOG_INFO("App", "Coordinator::AcquisitionThreadFunc", "Unknown", "Acquisition Thread started.");
     
     while (m_running) {
-        if (m_device->GetConnectionState() != Himax::ConnectionState::Connected || !m_isAcquiring.load()) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            continue;
-        }
+        FrameRef frame;
+        if (!AcquireFrame(frame)) continue;
 
-        if (auto res = m_device->GetFrame(); !res) {
-            // Handle error, maybe logging is enough for now as Device does it
-            continue;
+        // Push Raw data into Processing Thread (只移交槽位引用)
+        if (m_source->IsLive()) {
+            if (!m_frameBuffer.Push(std::move(frame))) {
+                m_acquisitionStats.queueFull.fetch_add(1, std::memory_order_relaxed);
+            }
+        } else {
+            // 离线来源以处理线程的速度为上限 (Push 失败时不移走 frame)
+            while (!m_frameBuffer.Push(std::move(frame)) && m_running) {
+                std::this_thread::yield();
+            }
         }
-        
-        // 提取采集的数据到帧对象
-        Engine::HeatmapFrame frame;
-        
-        // m_device->back_data is std::array<uint8_t, ...> inside the HAL. 
-        // We copy it out for processing. We take the 5063 master bytes (+339 slave)
-        frame.rawData.assign(m_device->back_data.begin(), m_device->back_data.end());
 
-        // Push Raw data into Processing Thread
-        m_frameBuffer.Push(frame);
-
-        std::this_thread::sleep_for(std::chrono::milliseconds(2)); // Polling Interval
+        WaitPollInterval();
     }
     LOG_INFO("App", "Coordinator::AcquisitionThreadFunc", "Unknown", "Acquisition Thread stopped.");
 }
@@ -97,32 +232,68 @@ void Coordinator::AcquisitionThreadFunc() {
 void Coordinator::ProcessingThreadFunc() {
     LOG_INFO("App", "Coordinator::ProcessingThreadFunc", "Unknown", "Processing Thread started.");
     while (m_running) {
-        Engine::HeatmapFrame frame;
+        FrameRef frame;
         // 阻塞等待采集线程 push 原始帧
         if (m_frameBuffer.WaitForData(frame, std::chrono::milliseconds(100))) {
-            
-            // Execute the pipeline (MasterFrameParser -> BaselineSubtraction -> ...)
-            if (m_pipeline.Execute(frame)) {
-
-                // 如果处理成功, 写回给 GUI 
-                {
-                    std::lock_guard<std::mutex> lock(m_latestFrameMutex);
-                    m_latestFrame = frame;
-                }
-
-                // Push to DVR buffer (automatically overwrites old frames)
-                m_dvrBuffer.PushOverwriting(frame);
-
-                // TODO: (Stage 3) 交给 Host::VhfInjector 发送 HID Report
-            }
+            ProcessFrame(std::move(frame));
         }
     }
     LOG_INFO("App", "Coordinator::ProcessingThreadFunc", "Unknown", "Processing Thread stopped.");
 }
 
+// Latency 模式：读完即在同一线程处理并发布，帧不跨线程交接；读设备期间不处理，
+// 因此吞吐上限为 1 / (读取 + 处理)，换取最短的 readDone -> 发布 路径
+void Coordinator::RunToCompletionThreadFunc() {
+    const int core = m_executionConfig.pinnedCore >= 0 ? m_executionConfig.pinnedCore : LogicalCoreCount() - 1;
+    const bool pinned = LogicalCoreCount() > 1 && PinCurrentThread(core);
+    LOG_INFO("App", "Coordinator::RunToCompletionThreadFunc", "Unknown", "Run-to-completion Thread started ({}).",
+             pinned ? std::format("pinned to core {}", core) : std::string("not pinned"));
+
+    while (m_running) {
+        FrameRef frame;
+        if (!AcquireFrame(frame)) continue;
+        ProcessFrame(std::move(frame));
+        WaitPollInterval();
+    }
+    LOG_INFO("App", "Coordinator::RunToCompletionThreadFunc", "Unknown", "Run-to-completion Thread stopped.");
+}
+
+void Coordinator::ProcessFrame(FrameRef frame) {
+    Engine::HeatmapFrame& data = frame.Mutable();
+    data.trace.dequeueNs = Engine::TraceNowNs();
+
+    // Execute the pipeline (MasterFrameParser -> BaselineSubtraction -> ...)
+    // 管线原地写入槽位；发布给 GUI / DVR 之后该帧只读
+    if (!m_pipeline.Execute(data)) return;
+
+    data.trace.processedNs = Engine::TraceNowNs();
+
+    // 如果处理成功, 写回给 GUI (三缓冲发布，无锁、不等待 GUI)
+    m_latestFrame.Publish(frame);
+
+    // GUI 此后可能正在读取该帧，唯一允许的写入是原子的发布时间戳；
+    // 录制与 DVR 在其后入队，因此文件中的 trace 与实时统计是同一个时间点
+    data.trace.StampPublished(Engine::TraceNowNs());
+    const Engine::FrameTrace trace = data.trace;
+
+    // 连续录制 (未开启时为空操作；写线程落后时丢弃并计数，不等待)
+    m_recorder.Submit(frame);
+
+    // 异常检测 (常数级)；命中时从 DVR 缓冲取触发前的帧，因此须在本帧推入之前
+    m_snapshotter.OnFrame(frame, m_dvrBuffer);
+
+    // Push to DVR buffer (automatically overwrites old frames)
+    m_dvrBuffer.PushOverwriting(std::move(frame));
+
+    RecordLatencyBreakdown(trace);
+    m_acquisitionStats.framesProcessed.fetch_add(1, std::memory_order_relaxed);
+
+    // TODO: (Stage 3) 交给 Host::VhfInjector 发送 HID Report
+}
+
 void Coordinator::SystemStateThreadFunc() {
     LOG_INFO("App", "Coordinator::SystemStateThreadFunc", "Unknown", "SystemState Thread started.");
-    // TODO: (Stage 3) 使用 Host/SystemMonitor 监听亮屏/息屏，并调用 m_device->thp_afe_enter_idle()
+    // TODO: (Stage 3) 使用 Host/SystemMonitor 监听亮屏/息屏，并调用设备来源芯片的 thp_afe_enter_idle()
     while (m_running) {
         std::this_thread::sleep_for(std::chrono::milliseconds(1000));
     }
@@ -139,45 +310,36 @@ void Coordinator::TriggerDVRExport() {
     auto now = std::chrono::system_clock::now();
     auto time_t_now = std::chrono::system_clock::to_time_t(now);
     struct tm time_info;
+#if defined(_WIN32)
     localtime_s(&time_info, &time_t_now);
+#else
+    localtime_r(&time_t_now, &time_info);
+#endif
 
-    char filename[128];
-    sprintf_s(filename, "dvr_backtrack_%04d%02d%02d_%02d%02d%02d.csv",
-              time_info.tm_year + 1900, time_info.tm_mon + 1, time_info.tm_mday,
-              time_info.tm_hour, time_info.tm_min, time_info.tm_sec);
+    const std::string filename = std::format("dvr_backtrack_{:04d}{:02d}{:02d}_{:02d}{:02d}{:02d}.egdvr",
+                                             time_info.tm_year + 1900, time_info.tm_mon + 1, time_info.tm_mday,
+                                             time_info.tm_hour, time_info.tm_min, time_info.tm_sec);
 
-    FILE* fp = nullptr;
-    fopen_s(&fp, filename, "w");
-    if (!fp) {
-        LOG_ERROR("App", "Coordinator::TriggerDVRExport", "Unknown", "Failed to create DVR export file: %s", filename);
+    // 定长二进制记录，每帧一次写入；文本格式用 DvrToCsv 离线转换
+    const auto start = std::chrono::steady_clock::now();
+    Engine::DvrWriter writer;
+    if (!writer.Open(filename, m_pipeline.ConfigHash())) {
+        LOG_ERROR("App", "Coordinator::TriggerDVRExport", "Unknown", "Failed to create DVR export file: {}", filename);
         return;
     }
-
-    LOG_INFO("App", "Coordinator::TriggerDVRExport", "Unknown", "Exporting %zu frames to %s...", snapshot.size(), filename);
-
-    for (size_t i = 0; i < snapshot.size(); ++i) {
-        const auto& f = snapshot[i];
-        fprintf(fp, "--- Frame [%zu] --- TS: %llu\n", i, f.timestamp);
-        
-        // Heatmap
-        for (int y = 0; y < 40; ++y) {
-            for (int x = 0; x < 60; ++x) {
-                fprintf(fp, "%d%s", f.heatmapMatrix[y][x], (x == 59 ? "" : ","));
-            }
-            fprintf(fp, "\n");
-        }
-
-        // Contacts
-        fprintf(fp, "Contacts: %zu\n", f.contacts.size());
-        for (const auto& c : f.contacts) {
-            fprintf(fp, "ID:%d, X:%.3f, Y:%.3f, State:%d, Area:%d\n", 
-                    c.id, c.x, c.y, c.state, c.area);
-        }
-        fprintf(fp, "\n");
+    for (const FrameRef& frame : snapshot) {
+        if (!writer.Append(*frame)) break;
+    }
+    const uint64_t written = writer.RecordCount();
+    if (!writer.Close() || written != snapshot.size()) {
+        LOG_ERROR("App", "Coordinator::TriggerDVRExport", "Unknown", "DVR export incomplete: {} of {} frames written to {}",
+                  written, snapshot.size(), filename);
+        return;
     }
 
-    fclose(fp);
-    LOG_INFO("App", "Coordinator::TriggerDVRExport", "Unknown", "DVR Export Complete: %s", filename);
+    const double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("App", "Coordinator::TriggerDVRExport", "Unknown", "DVR Export Complete: {} ({} frames, {:.2f} ms)",
+             filename, written, elapsedMs);
 }
 
 } // namespace App
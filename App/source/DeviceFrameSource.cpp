@@ -0,0 +1,38 @@
+#include "DeviceFrameSource.h"
+#include "Logger.h"
+#include <format>
+
+namespace App {
+
+#ifdef _WIN32
+// --- 设备路径 ---
+const std::wstring DEVICE_PATH_INTERRUPT = L"\\\\.\\Global\\SPBTESTTOOL_MASTER";
+const std::wstring DEVICE_PATH_MASTER = L"\\\\.\\Global\\SPBTESTTOOL_MASTER";
+const std::wstring DEVICE_PATH_SLAVE = L"\\\\.\\Global\\SPBTESTTOOL_SLAVE";
+
+DeviceFrameSource::DeviceFrameSource() {
+    LOG_INFO("App", "DeviceFrameSource::DeviceFrameSource", "Unconnected", "Initializing Himax Device Instance (Unconnected)...");
+    // 初始化 Hardware 层对象，此时只分配资源，不拉起 I2C 通信
+    m_device = std::make_unique<Himax::Chip>(DEVICE_PATH_MASTER, DEVICE_PATH_SLAVE, DEVICE_PATH_INTERRUPT);
+}
+#endif
+
+DeviceFrameSource::DeviceFrameSource(std::unique_ptr<Himax::Chip> device) : m_device(std::move(device)) {}
+
+bool DeviceFrameSource::IsReady() const {
+    return m_device->GetConnectionState() == Himax::ConnectionState::Connected;
+}
+
+bool DeviceFrameSource::ReadFrame(Engine::HeatmapFrame& frame) {
+    // 设备直接读入池中槽位的 rawData (5063 master bytes + 339 slave)，不再经 back_data 中转
+    frame.trace.readStartNs = Engine::TraceNowNs();
+    if (auto res = m_device->GetFrame(frame.rawData.data(), frame.rawData.size()); !res) {
+        // Device 层已记录错误日志
+        return false;
+    }
+    frame.trace.readDoneNs = Engine::TraceNowNs();
+    frame.timestamp = frame.trace.readDoneNs;
+    return true;
+}
+
+} // namespace App
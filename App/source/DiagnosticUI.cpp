@@ -1,39 +1,66 @@
 #include "DiagnosticUI.h"
-#include "HimaxChip.h"
+#include "DeviceFrameSource.h"
+#include "ProcessorConfigPanel.h"
 #include "imgui.h"
 #include "Logger.h"
-#include <fstream>
-#include <iomanip>
-#include <sstream>
+#include "DvrFile.h"
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <iterator>
 
 namespace App {
 
 DiagnosticUI::DiagnosticUI(Coordinator* coordinator) : m_coordinator(coordinator) {
+    // 诊断工具默认开启异常快照，不再依赖人工在异常发生时按下导出
+    m_snapshotConfig.enabled = true;
+    if (m_coordinator) m_coordinator->ConfigureSnapshots(m_snapshotConfig);
 }
 
 DiagnosticUI::~DiagnosticUI() {
 }
 
+const Engine::HeatmapFrame& DiagnosticUI::CurrentFrame() const {
+    static const Engine::HeatmapFrame kEmptyFrame;
+    if (m_replay.IsOpen()) return m_replayFrame;
+    return m_currentFrame ? *m_currentFrame : kEmptyFrame;
+}
+
 void DiagnosticUI::Render() {
     // 拉取最新的数据
     if (m_autoRefresh && m_coordinator) {
-        m_coordinator->GetLatestFrame(m_currentFrame);
+        // 仅在有新版本时替换引用，否则继续显示当前帧
+        m_coordinator->GetLatestFrame(m_currentFrame, m_currentVersion);
     }
 
+    // 回放面板先于各显示面板绘制，保证本帧显示的是刚定位到的回放帧
+    DrawReplayPanel();
+
     // 绘制控制面板和热力图窗口
     DrawControlPanel();
     DrawHeatmap();
     DrawCoordinateTable();
     DrawMasterSuffixTable();
     DrawSlaveSuffixTable();
+    DrawPipelineLatency();
 }
 
 void DiagnosticUI::DrawControlPanel() {
     ImGui::Begin("Device Control Panel");
     
     if (m_coordinator) {
-        Himax::Chip* chip = m_coordinator->GetDevice();
+        // 只有真实设备来源提供芯片控制；回放 / 合成来源只控制采集循环
+        IFrameSource* source = m_coordinator->GetSource();
+        auto* deviceSource = dynamic_cast<DeviceFrameSource*>(source);
+        Himax::Chip* chip = deviceSource ? deviceSource->Device() : nullptr;
+        if (!chip) {
+            ImGui::Text("Frame Source: %s", source->Name());
+            bool loopActive = m_coordinator->IsAcquisitionActive();
+            if (ImGui::Button(loopActive ? "Stop Reading Loop" : "Start Reading Loop")) {
+                m_coordinator->SetAcquisitionActive(!loopActive);
+            }
+        }
         if (chip) {
             auto connState = chip->GetConnectionState();
             bool connected = (connState == Himax::ConnectionState::Connected);
@@ -94,8 +121,8 @@ void DiagnosticUI::DrawControlPanel() {
     }
     
     ImGui::Separator();
-    if (ImGui::Button("Export Frame to CSV")) {
-        ExportCurrentFrameToCSV();
+    if (ImGui::Button("Export Frame")) {
+        ExportCurrentFrame();
     }
     ImGui::SameLine();
     if (ImGui::Button("Export DVR (Last 120 Frames)")) {
@@ -103,6 +130,11 @@ void DiagnosticUI::DrawControlPanel() {
             m_coordinator->TriggerDVRExport();
         }
     }
+
+    if (m_coordinator) {
+        DrawRecorderControls();
+        DrawSnapshotControls();
+    }
     
     if (m_coordinator) {
         ImGui::Separator();
@@ -132,7 +164,7 @@ void DiagnosticUI::DrawControlPanel() {
             
             if (enabled) {
                 ImGui::Indent();
-                processor->DrawConfigUI();
+                DrawProcessorConfig(*processor);
                 ImGui::Unindent();
             }
             ImGui::PopID();
@@ -148,6 +180,7 @@ void DiagnosticUI::DrawControlPanel() {
 }
 
 void DiagnosticUI::DrawHeatmap() {
+    const Engine::HeatmapFrame& frame = CurrentFrame();
     ImGuiWindowFlags window_flags = ImGuiWindowFlags_NoScrollWithMouse | ImGuiWindowFlags_NoScrollbar;
     ImGuiViewport* viewport = ImGui::GetMainViewport();
 
@@ -179,7 +212,7 @@ void DiagnosticUI::DrawHeatmap() {
     }
 
     if (!m_fullscreen) {
-        ImGui::Text("Timestamp: %llu | Cell Size: %.1fx%.1f", (unsigned long long)m_currentFrame.timestamp, cell_w, cell_h);
+        ImGui::Text("Frame #%llu | Timestamp: %llu | Cell Size: %.1fx%.1f", (unsigned long long)m_currentVersion, (unsigned long long)frame.timestamp, cell_w, cell_h);
     }
     
     ImDrawList* draw_list = ImGui::GetWindowDrawList();
@@ -187,7 +220,7 @@ void DiagnosticUI::DrawHeatmap() {
     for (int y = 0; y < rows; ++y) {
         for (int x = 0; x < cols; ++x) {
             // Mirror Matrix: Left becomes Right, Top becomes Bottom
-            int16_t val = m_currentFrame.heatmapMatrix[rows - 1 - y][cols - 1 - x];
+            int16_t val = frame.heatmapMatrix[rows - 1 - y][cols - 1 - x];
             
             // 值映射 (使用用户界面可调的最大量程)
             float normalized = std::clamp(val / m_colorRange, 0.0f, 1.0f);
@@ -230,9 +263,10 @@ void DiagnosticUI::DrawHeatmap() {
 }
 
 void DiagnosticUI::DrawCoordinateTable() {
+    const Engine::HeatmapFrame& frame = CurrentFrame();
     ImGui::Begin("Parsed Coordinates");
 
-    if (m_currentFrame.contacts.empty()) {
+    if (frame.contacts.empty()) {
         ImGui::Text("No touches detected.");
     } else {
         if (ImGui::BeginTable("ContactsTable", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable)) {
@@ -242,7 +276,7 @@ void DiagnosticUI::DrawCoordinateTable() {
             ImGui::TableSetupColumn("Peak Intensity", ImGuiTableColumnFlags_WidthFixed, 100.0f);
             ImGui::TableHeadersRow();
 
-            for (const auto& contact : m_currentFrame.contacts) {
+            for (const auto& contact : frame.contacts) {
                 ImGui::TableNextRow();
                 
                 ImGui::TableSetColumnIndex(0);
@@ -265,10 +299,11 @@ void DiagnosticUI::DrawCoordinateTable() {
 }
 
 void DiagnosticUI::DrawMasterSuffixTable() {
+    const Engine::HeatmapFrame& frame = CurrentFrame();
     ImGui::Begin("Master Frame Suffix (128 words)");
-    if (m_currentFrame.rawData.size() >= 5063) {
+    if (frame.rawData.size() >= 5063) {
         if (ImGui::BeginTable("MasterSuffixTable", 8, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
-            const uint8_t* ptr = m_currentFrame.rawData.data() + 4807;
+            const uint8_t* ptr = frame.rawData.data() + 4807;
             for (int i = 0; i < 128; ++i) {
                 if (i % 8 == 0) ImGui::TableNextRow();
                 ImGui::TableSetColumnIndex(i % 8);
@@ -284,10 +319,11 @@ void DiagnosticUI::DrawMasterSuffixTable() {
 }
 
 void DiagnosticUI::DrawSlaveSuffixTable() {
+    const Engine::HeatmapFrame& frame = CurrentFrame();
     ImGui::Begin("Slave Frame Suffix (166 words)");
-    if (m_currentFrame.rawData.size() >= 5402) { // 5063 + 339 = 5402
+    if (frame.rawData.size() >= 5402) { // 5063 + 339 = 5402
         if (ImGui::BeginTable("SlaveSuffixTable", 8, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
-            const uint8_t* ptr = m_currentFrame.rawData.data() + 5070; // 5063 + 7
+            const uint8_t* ptr = frame.rawData.data() + 5070; // 5063 + 7
             for (int i = 0; i < 166; ++i) {
                 if (i % 8 == 0) ImGui::TableNextRow();
                 ImGui::TableSetColumnIndex(i % 8);
@@ -302,67 +338,343 @@ void DiagnosticUI::DrawSlaveSuffixTable() {
     ImGui::End();
 }
 
-void DiagnosticUI::ExportCurrentFrameToCSV() {
-    auto now = std::chrono::system_clock::now();
-    std::time_t time_now = std::chrono::system_clock::to_time_t(now);
-    std::tm* tm_now = std::localtime(&time_now);
-    
-    std::ostringstream filename;
-    filename << "heatmap_" 
-             << std::put_time(tm_now, "%Y%m%d_%H%M%S") << "_" 
-             << (m_currentFrame.timestamp % 1000) 
-             << ".csv";
-
-    std::ofstream out(filename.str());
-    if (!out.is_open()) {
-        LOG_INFO("App", "DiagnosticUI::ExportCurrentFrameToCSV", "Error", "Failed to open file for writing.");
-        return;
+void DiagnosticUI::DrawPipelineLatency() {
+    if (!m_coordinator) return;
+    Engine::FramePipeline& pipeline = m_coordinator->GetPipeline();
+
+    ImGui::Begin("Pipeline Latency");
+
+    bool profiling = pipeline.IsProfilingEnabled();
+    if (ImGui::Checkbox("Enable Profiling", &profiling)) {
+        pipeline.SetProfilingEnabled(profiling);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Reset")) {
+        m_coordinator->ResetLatencyStats();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Dump to Log")) {
+        m_coordinator->LogPipelineLatency();
     }
 
-    out << "--- EGoTouch Frame Export ---\n";
-    out << "Timestamp: " << m_currentFrame.timestamp << "\n\n";
+    // 执行模型切换会重启采集 / 处理线程并清零统计，切换后的分解即为新模型的数据
+    ExecutionConfig execution = m_coordinator->GetExecutionConfig();
+    int mode = static_cast<int>(execution.mode);
+    const char* modes[] = {"Throughput (acquire -> queue -> process)", "Latency (run-to-completion, pinned)"};
+    if (ImGui::Combo("Execution Mode", &mode, modes, static_cast<int>(std::size(modes)))) {
+        execution.mode = static_cast<ExecutionMode>(mode);
+        LOG_INFO("App", "DiagnosticUI::DrawPipelineLatency", "UI", "Execution Mode User Action: {}",
+                 ExecutionModeName(execution.mode));
+        m_coordinator->SetExecutionConfig(execution);
+    }
 
-    out << "--- Heatmap (40 rows x 60 cols) ---\n";
-    for (int y = 0; y < 40; ++y) {
-        for (int x = 0; x < 60; ++x) {
-            out << m_currentFrame.heatmapMatrix[y][x];
-            if (x < 59) out << ",";
+    if (ImGui::BeginTable("LatencyTable", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+        ImGui::TableSetupColumn("Stage", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Calls");
+        ImGui::TableSetupColumn("Drops");
+        ImGui::TableSetupColumn("p50 (us)");
+        ImGui::TableSetupColumn("p90 (us)");
+        ImGui::TableSetupColumn("p99 (us)");
+        ImGui::TableSetupColumn("Max (us)");
+        ImGui::TableHeadersRow();
+
+        auto drawRow = [](const char* name, const Engine::ProcessorStats& stats) {
+            const Engine::LatencySummary s = stats.latency.Summarize();
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0); ImGui::TextUnformatted(name);
+            ImGui::TableSetColumnIndex(1); ImGui::Text("%llu", (unsigned long long)stats.calls.load(std::memory_order_relaxed));
+            ImGui::TableSetColumnIndex(2); ImGui::Text("%llu", (unsigned long long)stats.drops.load(std::memory_order_relaxed));
+            ImGui::TableSetColumnIndex(3); ImGui::Text("%.1f", s.p50 / 1000.0);
+            ImGui::TableSetColumnIndex(4); ImGui::Text("%.1f", s.p90 / 1000.0);
+            ImGui::TableSetColumnIndex(5); ImGui::Text("%.1f", s.p99 / 1000.0);
+            ImGui::TableSetColumnIndex(6); ImGui::Text("%.1f", s.max / 1000.0);
+        };
+
+        const auto& processors = pipeline.GetProcessors();
+        for (size_t i = 0; i < processors.size(); ++i) {
+            drawRow(processors[i]->GetName().c_str(), pipeline.GetProcessorStats(i));
         }
-        out << "\n";
+        drawRow("Front-end (fused)", pipeline.GetFrontEndStats());
+        drawRow("Pipeline total", pipeline.GetPipelineStats());
+        ImGui::EndTable();
     }
 
-    out << "\n--- Master Frame Suffix (128 words) ---\n";
-    if (m_currentFrame.rawData.size() >= 5063) {
-        const uint8_t* ptr = m_currentFrame.rawData.data() + 4807;
-        for (int i = 0; i < 128; ++i) {
-            uint16_t val = static_cast<uint16_t>(ptr[i * 2] | (ptr[i * 2 + 1] << 8));
-            out << val;
-            if (i < 127) {
-                out << (((i + 1) % 16 == 0) ? "\n" : ",");
-            }
+    // 端到端分解：设备读取 -> 队列 -> 管线 -> 发布
+    ImGui::Separator();
+    ImGui::Text("End-to-end Breakdown");
+    if (ImGui::BeginTable("BreakdownTable", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+        ImGui::TableSetupColumn("Span", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Samples");
+        ImGui::TableSetupColumn("p50 (us)");
+        ImGui::TableSetupColumn("p90 (us)");
+        ImGui::TableSetupColumn("p99 (us)");
+        ImGui::TableSetupColumn("Max (us)");
+        ImGui::TableHeadersRow();
+
+        auto drawSpan = [](const char* name, const Engine::LatencyHistogram& histogram) {
+            const Engine::LatencySummary s = histogram.Summarize();
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0); ImGui::TextUnformatted(name);
+            ImGui::TableSetColumnIndex(1); ImGui::Text("%llu", (unsigned long long)s.count);
+            ImGui::TableSetColumnIndex(2); ImGui::Text("%.1f", s.p50 / 1000.0);
+            ImGui::TableSetColumnIndex(3); ImGui::Text("%.1f", s.p90 / 1000.0);
+            ImGui::TableSetColumnIndex(4); ImGui::Text("%.1f", s.p99 / 1000.0);
+            ImGui::TableSetColumnIndex(5); ImGui::Text("%.1f", s.max / 1000.0);
+        };
+
+        const FrameLatencyBreakdown& breakdown = m_coordinator->GetLatencyBreakdown();
+        drawSpan("Device I/O", breakdown.deviceIo);
+        drawSpan("Queueing", breakdown.queueing);
+        drawSpan("Processing", breakdown.processing);
+        drawSpan("Publication", breakdown.publication);
+        drawSpan("End-to-end", breakdown.endToEnd);
+        ImGui::EndTable();
+    }
+
+    // 当前显示帧自身的打点
+    const Engine::FrameTrace& trace = CurrentFrame().trace;
+    ImGui::Text("Current frame (us): io %.1f | queue %.1f | proc %.1f | pub %.1f | e2e %.1f",
+                trace.DeviceIoNs() / 1000.0, trace.QueueNs() / 1000.0, trace.ProcessingNs() / 1000.0,
+                trace.PublicationNs() / 1000.0, trace.EndToEndNs() / 1000.0);
+
+    ImGui::End();
+}
+
+void DiagnosticUI::DrawRecorderControls() {
+    ImGui::Separator();
+    ImGui::Text("Continuous Recorder");
+
+    const StreamRecorder& recorder = m_coordinator->GetRecorder();
+    const bool recording = recorder.IsRecording();
+
+    // 录制中不允许修改轮转参数 (Start 时生效)
+    if (recording) ImGui::BeginDisabled();
+    int fileMb = static_cast<int>(m_recorderConfig.maxFileBytes >> 20);
+    if (ImGui::InputInt("File Size Limit (MB)", &fileMb)) {
+        m_recorderConfig.maxFileBytes = static_cast<uint64_t>(std::clamp(fileMb, 1, 4096)) << 20;
+    }
+    int fileSeconds = static_cast<int>(m_recorderConfig.maxFileSeconds);
+    if (ImGui::InputInt("File Duration Limit (s, 0 = none)", &fileSeconds)) {
+        m_recorderConfig.maxFileSeconds = static_cast<uint32_t>(std::clamp(fileSeconds, 0, 24 * 3600));
+    }
+    int budgetMb = static_cast<int>(m_recorderConfig.maxTotalBytes >> 20);
+    if (ImGui::InputInt("Disk Budget (MB)", &budgetMb)) {
+        m_recorderConfig.maxTotalBytes = static_cast<uint64_t>(std::clamp(budgetMb, 16, 1 << 20)) << 20;
+    }
+    ImGui::Checkbox("Compress (delta codec)", &m_recorderConfig.compress);
+    if (m_recorderConfig.compress) {
+        int keyframeInterval = static_cast<int>(m_recorderConfig.keyframeInterval);
+        if (ImGui::InputInt("Keyframe Interval (frames)", &keyframeInterval)) {
+            m_recorderConfig.keyframeInterval = static_cast<uint32_t>(std::clamp(keyframeInterval, 1, 10000));
         }
-        out << "\n";
-    } else {
-        out << "Data unavailable\n";
+    }
+    if (recording) ImGui::EndDisabled();
+
+    if (ImGui::Button(recording ? "Stop Recording" : "Start Recording")) {
+        LOG_INFO("App", "DiagnosticUI::DrawRecorderControls", "UI", "{} Recording User Action", recording ? "Stop" : "Start");
+        if (recording) m_coordinator->StopRecording();
+        else m_coordinator->StartRecording(m_recorderConfig);
+    }
+
+    const RecorderStats& stats = recorder.Stats();
+    const uint64_t droppedQueue = stats.droppedQueueFull.load(std::memory_order_relaxed);
+    const uint64_t droppedIo = stats.droppedWriteError.load(std::memory_order_relaxed);
+    ImGui::Text("Written: %llu frames, %.1f MB in %llu files (%llu rotated out)",
+                static_cast<unsigned long long>(stats.written.load(std::memory_order_relaxed)),
+                stats.bytesWritten.load(std::memory_order_relaxed) / (1024.0 * 1024.0),
+                static_cast<unsigned long long>(stats.filesOpened.load(std::memory_order_relaxed)),
+                static_cast<unsigned long long>(stats.filesDeleted.load(std::memory_order_relaxed)));
+    // 有丢帧时高亮：磁盘 I/O 跟不上或写入失败
+    const ImVec4 dropColor = (droppedQueue || droppedIo) ? ImVec4(1.0f, 0.4f, 0.3f, 1.0f) : ImVec4(0.6f, 0.9f, 0.6f, 1.0f);
+    ImGui::TextColored(dropColor, "Dropped: %llu (queue full) | %llu (I/O error) | max backlog %llu / %zu",
+                       static_cast<unsigned long long>(droppedQueue), static_cast<unsigned long long>(droppedIo),
+                       static_cast<unsigned long long>(stats.maxQueueDepth.load(std::memory_order_relaxed)),
+                       StreamRecorder::kQueueCapacity);
+}
+
+void DiagnosticUI::DrawSnapshotControls() {
+    ImGui::Separator();
+    ImGui::Text("Anomaly Snapshots");
+
+    bool changed = ImGui::Checkbox("Auto Capture on Anomaly", &m_snapshotConfig.enabled);
+    changed |= ImGui::SliderInt("Frames Before", &m_snapshotConfig.preFrames, 0, static_cast<int>(kDvrHistoryFrames));
+    changed |= ImGui::SliderInt("Frames After", &m_snapshotConfig.postFrames, 0, AnomalySnapshotter::kMaxPostFrames);
+    changed |= ImGui::InputInt("Cooldown (frames)", &m_snapshotConfig.cooldownFrames);
+
+    Engine::AnomalyConfig& detector = m_snapshotConfig.detector;
+    for (int i = 0; i < Engine::kAnomalyKindCount; ++i) {
+        const uint32_t bit = 1u << i;
+        bool on = (detector.enabledMask & bit) != 0;
+        if (i > 0) ImGui::SameLine();
+        if (ImGui::Checkbox(Engine::AnomalyKindName(bit), &on)) {
+            detector.enabledMask = on ? (detector.enabledMask | bit) : (detector.enabledMask & ~bit);
+            changed = true;
+        }
+    }
+    changed |= ImGui::SliderInt("Count Jump", &detector.countJump, 1, 10);
+    changed |= ImGui::SliderFloat("Ghost Radius (cells)", &detector.ghostRadius, 0.5f, 10.0f, "%.1f");
+    changed |= ImGui::SliderInt("Flip-Flop Reversals", &detector.flipFlopReversals, 1, 16);
+    changed |= ImGui::SliderInt("Flip-Flop Window (frames)", &detector.flipFlopWindow, 2, 64);
+    changed |= ImGui::SliderFloat("Frame Gap Factor", &detector.gapFactor, 1.2f, 10.0f, "%.1fx");
+    int saturated = static_cast<int>(detector.saturatedCells);
+    if (ImGui::SliderInt("Saturated Cells", &saturated, 1, 2400)) {
+        detector.saturatedCells = static_cast<uint32_t>(saturated);
+        changed = true;
+    }
+    if (changed) {
+        m_snapshotConfig.cooldownFrames = std::max(0, m_snapshotConfig.cooldownFrames);
+        m_coordinator->ConfigureSnapshots(m_snapshotConfig);
     }
 
-    out << "\n--- Slave Frame Suffix (166 words) ---\n";
-    if (m_currentFrame.rawData.size() >= 5402) {
-        const uint8_t* ptr = m_currentFrame.rawData.data() + 5070;
-        for (int i = 0; i < 166; ++i) {
-            uint16_t val = static_cast<uint16_t>(ptr[i * 2] | (ptr[i * 2 + 1] << 8));
-            out << val;
-            if (i < 165) {
-                out << (((i + 1) % 16 == 0) ? "\n" : ",");
+    const SnapshotStats& stats = m_coordinator->GetSnapshotter().Stats();
+    ImGui::Text("Hits:");
+    for (int i = 0; i < Engine::kAnomalyKindCount; ++i) {
+        ImGui::SameLine();
+        ImGui::Text("%s %llu", Engine::AnomalyKindName(1u << i),
+                    static_cast<unsigned long long>(stats.hits[i].load(std::memory_order_relaxed)));
+    }
+    const uint64_t errors = stats.writeErrors.load(std::memory_order_relaxed);
+    const ImVec4 color = errors ? ImVec4(1.0f, 0.4f, 0.3f, 1.0f) : ImVec4(0.6f, 0.9f, 0.6f, 1.0f);
+    ImGui::TextColored(color, "Snapshots: %llu written, %llu suppressed, %llu errors | last [%s]",
+                       static_cast<unsigned long long>(stats.written.load(std::memory_order_relaxed)),
+                       static_cast<unsigned long long>(stats.suppressed.load(std::memory_order_relaxed)),
+                       static_cast<unsigned long long>(errors),
+                       Engine::FormatAnomalyMask(static_cast<uint32_t>(stats.lastMask.load(std::memory_order_relaxed))).c_str());
+}
+
+void DiagnosticUI::DrawReplayPanel() {
+    ImGui::Begin("Replay");
+
+    ImGui::InputText("File / Directory", m_replayPath, sizeof(m_replayPath));
+    if (!m_replay.IsOpen()) {
+        if (ImGui::Button("Open Recording")) {
+            LOG_INFO("App", "DiagnosticUI::DrawReplayPanel", "UI", "Open Recording User Action: {}", m_replayPath);
+            if (m_replay.Open(m_replayPath)) {
+                m_replayIndex = 0;
+                m_replayLoaded = SIZE_MAX;
+                LOG_INFO("App", "DiagnosticUI::DrawReplayPanel", "Replay", "Opened {} files, {} frames ({} skipped)",
+                         m_replay.FileCount(), m_replay.FrameCount(), m_replay.SkippedFiles());
+            } else {
+                LOG_WARN("App", "DiagnosticUI::DrawReplayPanel", "Replay", "No readable .egdvr recording at {}",
+                         m_replayPath);
             }
         }
-        out << "\n";
-    } else {
-        out << "Data unavailable\n";
+        ImGui::End();
+        return;
+    }
+
+    if (ImGui::Button("Close Recording (Back to Live)")) {
+        LOG_INFO("App", "DiagnosticUI::DrawReplayPanel", "UI", "Close Recording User Action");
+        m_replay.Close();
+        m_replayPlaying = false;
+        ImGui::End();
+        return;
+    }
+
+    const size_t frameCount = m_replay.FrameCount();
+    const uint64_t firstTs = m_replay.FirstTimestamp();
+    const float duration = static_cast<float>((m_replay.LastTimestamp() - firstTs) / 1e9);
+    ImGui::Text("%zu files, %zu frames, %.1f s", m_replay.FileCount(), frameCount, duration);
+
+    // 拖动 / 单步会停止播放；时间轴按时间戳二分定位
+    int index = static_cast<int>(m_replayIndex);
+    if (ImGui::SliderInt("Frame", &index, 0, static_cast<int>(frameCount) - 1)) {
+        m_replayIndex = static_cast<size_t>(std::max(index, 0));
+        m_replayPlaying = false;
+    }
+    float seconds = static_cast<float>((m_replay.Timestamp(m_replayIndex) - firstTs) / 1e9);
+    if (ImGui::SliderFloat("Time (s)", &seconds, 0.0f, duration, "%.3f")) {
+        m_replayIndex = m_replay.FindByTimestamp(firstTs + static_cast<uint64_t>(std::max(seconds, 0.0f) * 1e9));
+        m_replayPlaying = false;
+    }
+
+    const bool focused = ImGui::IsWindowFocused();
+    if (ImGui::Button("|<")) {
+        m_replayIndex = 0;
+        m_replayPlaying = false;
+    }
+    ImGui::SameLine();
+    if ((ImGui::Button("<") || (focused && ImGui::IsKeyPressed(ImGuiKey_LeftArrow))) && m_replayIndex > 0) {
+        --m_replayIndex;
+        m_replayPlaying = false;
+    }
+    ImGui::SameLine();
+    if ((ImGui::Button(">") || (focused && ImGui::IsKeyPressed(ImGuiKey_RightArrow))) && m_replayIndex + 1 < frameCount) {
+        ++m_replayIndex;
+        m_replayPlaying = false;
+    }
+    ImGui::SameLine();
+    if (ImGui::Button(">|")) {
+        m_replayIndex = frameCount - 1;
+        m_replayPlaying = false;
+    }
+    ImGui::SameLine();
+    if (ImGui::Button(m_replayPlaying ? "Pause" : "Play") || (focused && ImGui::IsKeyPressed(ImGuiKey_Space, false))) {
+        m_replayPlaying = !m_replayPlaying;
+        if (m_replayPlaying && m_replayIndex + 1 >= frameCount) m_replayIndex = 0;
+        m_replayStartTimestamp = m_replay.Timestamp(m_replayIndex);
+        m_replayStartTime = std::chrono::steady_clock::now();
+    }
+    if (ImGui::SliderFloat("Speed", &m_replaySpeed, 0.1f, 8.0f, "%.1fx")) {
+        m_replayStartTimestamp = m_replay.Timestamp(m_replayIndex);
+        m_replayStartTime = std::chrono::steady_clock::now();
+    }
+
+    // 按录制时的时间戳播放：墙钟经过的时间 x 倍速 -> 目标时间戳 -> 帧号
+    if (m_replayPlaying) {
+        const double elapsedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - m_replayStartTime).count();
+        m_replayIndex = m_replay.FindByTimestamp(m_replayStartTimestamp + static_cast<uint64_t>(elapsedNs * m_replaySpeed));
+        if (m_replayIndex + 1 >= frameCount) m_replayPlaying = false;
+    }
+
+    // 只在帧号变化时解码 / 拷贝
+    if (m_replayIndex != m_replayLoaded) {
+        if (m_replay.ReadFrame(m_replayIndex, m_replayFrame)) {
+            m_replayLoaded = m_replayIndex;
+        } else {
+            LOG_WARN("App", "DiagnosticUI::DrawReplayPanel", "Replay", "Failed to read frame {}", m_replayIndex);
+            m_replayPlaying = false;
+            m_replayLoaded = m_replayIndex;   // 不在每帧重复报错
+        }
     }
 
-    out.close();
-    LOG_INFO("App", "DiagnosticUI::ExportCurrentFrameToCSV", "UI", "Frame exported to {}", filename.str());
+    const auto [file, local] = m_replay.Locate(m_replayIndex);
+    ImGui::Text("TS: %llu | file %zu/%zu, frame %zu%s", static_cast<unsigned long long>(m_replayFrame.timestamp),
+                file + 1, m_replay.FileCount(), local, m_replay.File(file).IsCompressed() ? " (compressed)" : "");
+
+    ImGui::End();
+}
+
+void DiagnosticUI::ExportCurrentFrame() {
+    // 导出屏幕上显示的帧：打开回放时为回放帧，否则为最新的实时帧
+    const bool replaying = m_replay.IsOpen();
+    if (replaying ? m_replayLoaded == SIZE_MAX : !m_currentFrame) {
+        LOG_WARN("App", "DiagnosticUI::ExportCurrentFrame", "UI", "No frame to export.");
+        return;
+    }
+    const Engine::HeatmapFrame& frame = CurrentFrame();
+
+    auto now = std::chrono::system_clock::now();
+    std::time_t time_now = std::chrono::system_clock::to_time_t(now);
+    struct tm time_info;
+    localtime_s(&time_info, &time_now);
+
+    char filename[128];
+    sprintf_s(filename, "heatmap_%04d%02d%02d_%02d%02d%02d_%03llu.egdvr",
+              time_info.tm_year + 1900, time_info.tm_mon + 1, time_info.tm_mday,
+              time_info.tm_hour, time_info.tm_min, time_info.tm_sec,
+              static_cast<unsigned long long>(frame.timestamp % 1000));
+
+    // 单帧 DVR 文件 (原始数据 + 热力图 + 触点 + 打点)，DvrToCsv --raw 可转回含尾部数据的文本
+    Engine::DvrWriter writer;
+    // 回放帧沿用其录制文件的管线配置
+    uint64_t configHash = m_coordinator ? m_coordinator->GetPipeline().ConfigHash() : 0;
+    if (replaying) configHash = m_replay.File(m_replay.Locate(m_replayLoaded).first).Header().configHash;
+    if (!writer.Open(filename, configHash) || !writer.Append(frame) || !writer.Close()) {
+        LOG_ERROR("App", "DiagnosticUI::ExportCurrentFrame", "UI", "Failed to write {}", filename);
+        return;
+    }
+    LOG_INFO("App", "DiagnosticUI::ExportCurrentFrame", "UI", "Frame exported to {}", filename);
 }
 
 } // namespace App
@@ -0,0 +1,59 @@
+#include "FramePool.h"
+
+namespace App {
+
+FramePool::FramePool(size_t slotCount)
+    : m_slots(std::make_unique<detail::FrameSlot[]>(slotCount)),
+      m_slotCount(slotCount),
+      m_freeHead(Pack(0, slotCount ? 0 : kNil)),
+      m_freeCount(slotCount) {
+    for (size_t i = 0; i < slotCount; ++i) {
+        detail::FrameSlot& slot = m_slots[i];
+        slot.index = static_cast<uint32_t>(i);
+        slot.pool = this;
+        slot.nextFree.store((i + 1 < slotCount) ? static_cast<uint32_t>(i + 1) : kNil, std::memory_order_relaxed);
+        // 一次性分配，之后设备直接写入 rawData.data()
+        slot.frame.rawData.resize(kRawFrameBytes);
+        slot.frame.contacts.reserve(32);
+    }
+}
+
+FramePool::~FramePool() = default;
+
+FrameRef FramePool::Acquire() {
+    uint64_t head = m_freeHead.load(std::memory_order_acquire);
+    for (;;) {
+        const uint32_t index = static_cast<uint32_t>(head);
+        if (index == kNil) {
+            m_exhausted.fetch_add(1, std::memory_order_relaxed);
+            return FrameRef();
+        }
+        // 槽位可能已被其它线程弹出并改写 nextFree，此时 CAS 会因标签变化而失败
+        const uint32_t next = m_slots[index].nextFree.load(std::memory_order_relaxed);
+        const uint64_t desired = Pack(static_cast<uint32_t>(head >> 32) + 1, next);
+        if (m_freeHead.compare_exchange_weak(head, desired, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            m_freeCount.fetch_sub(1, std::memory_order_relaxed);
+            detail::FrameSlot& slot = m_slots[index];
+            slot.refs.store(1, std::memory_order_relaxed);
+            slot.frame.contacts.clear();
+            slot.frame.timestamp = 0;
+            slot.frame.saturatedCells = 0;
+            slot.frame.trace = {};
+            return FrameRef(&slot);
+        }
+    }
+}
+
+void FramePool::Release(detail::FrameSlot* slot) {
+    uint64_t head = m_freeHead.load(std::memory_order_relaxed);
+    for (;;) {
+        slot->nextFree.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        const uint64_t desired = Pack(static_cast<uint32_t>(head >> 32) + 1, slot->index);
+        if (m_freeHead.compare_exchange_weak(head, desired, std::memory_order_release, std::memory_order_relaxed)) {
+            m_freeCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+} // namespace App
@@ -0,0 +1,118 @@
+#include "FrameSource.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <thread>
+
+namespace App {
+
+// ---------------------------------------------------------
+// FramePacer
+
+void FramePacer::Configure(ReplayTiming timing, double speed) {
+    m_timing = timing;
+    m_speed = speed > 0.0 ? speed : 1.0;
+    m_anchored = false;
+}
+
+void FramePacer::WaitFor(uint64_t timestamp) {
+    if (m_timing == ReplayTiming::AsFastAsPossible) return;
+
+    const Clock::time_point now = Clock::now();
+    // 时间戳回退 (新文件 / 未排序的录制) 同样重新锚定
+    if (!m_anchored || timestamp < m_anchorTimestamp) {
+        m_anchored = true;
+        m_anchorTimestamp = timestamp;
+        m_anchorTime = now;
+        return;
+    }
+
+    const double speed = m_timing == ReplayTiming::Scaled ? m_speed : 1.0;
+    const auto offset = std::chrono::nanoseconds(static_cast<int64_t>((timestamp - m_anchorTimestamp) / speed));
+    const Clock::time_point due = m_anchorTime + std::chrono::duration_cast<Clock::duration>(offset);
+    if (due > now) {
+        std::this_thread::sleep_until(due);
+    } else if (now - due > std::chrono::nanoseconds(kMaxLagNs)) {
+        m_anchorTimestamp = timestamp;
+        m_anchorTime = now;
+    }
+}
+
+// ---------------------------------------------------------
+// ReplayFrameSource
+
+ReplayFrameSource::ReplayFrameSource(ReplaySourceConfig config) : m_config(std::move(config)) {
+    m_pacer.Configure(m_config.timing, m_config.speed);
+}
+
+bool ReplayFrameSource::Open() {
+    m_position = 0;
+    m_loops = 0;
+    m_timestampOffset = 0;
+    m_pacer.Reset();
+    if (!m_session.Open(m_config.path)) {
+        LOG_ERROR("App", "ReplayFrameSource::Open", "Replay", "No readable recording at {}", m_config.path);
+        return false;
+    }
+    LOG_INFO("App", "ReplayFrameSource::Open", "Replay", "Replaying {} ({} files, {} frames, {} skipped)",
+             m_config.path, m_session.FileCount(), m_session.FrameCount(), m_session.SkippedFiles());
+    return true;
+}
+
+bool ReplayFrameSource::IsFinished() const {
+    return !m_config.loop && m_position >= m_session.FrameCount();
+}
+
+bool ReplayFrameSource::ReadFrame(Engine::HeatmapFrame& frame) {
+    const size_t count = m_session.FrameCount();
+    if (count == 0) return false;
+    if (m_position >= count) {
+        if (!m_config.loop) return false;
+        // 下一轮的时间戳接在本轮末尾之后 (间隔取平均帧间隔)
+        const uint64_t span = m_session.LastTimestamp() - m_session.FirstTimestamp();
+        m_timestampOffset += span + (count > 1 ? span / (count - 1) : 0);
+        m_position = 0;
+        ++m_loops;
+    }
+
+    const size_t index = m_position++;
+    m_pacer.WaitFor(m_session.Timestamp(index) + m_timestampOffset);
+
+    frame.trace.readStartNs = Engine::TraceNowNs();
+    const Engine::DvrRecord* record = m_session.Record(index);
+    if (!record) return false;
+    // frame 为 FramePool 的槽位，rawData 已按整帧长度分配：原地定长拷贝，不足部分补零，
+    // 不改变长度 (其它来源按 rawData.size() 直接读入)
+    const size_t rawSize = std::min({static_cast<size_t>(record->rawSize), sizeof(record->raw), frame.rawData.size()});
+    std::memcpy(frame.rawData.data(), record->raw, rawSize);
+    std::memset(frame.rawData.data() + rawSize, 0, frame.rawData.size() - rawSize);
+    frame.timestamp = record->timestamp + m_timestampOffset;
+    frame.trace.readDoneNs = Engine::TraceNowNs();
+    return true;
+}
+
+// ---------------------------------------------------------
+// SyntheticFrameSource
+
+SyntheticFrameSource::SyntheticFrameSource(SyntheticSourceConfig config)
+    : m_config(std::move(config)), m_generator(m_config.scene) {
+    m_pacer.Configure(m_config.timing, m_config.speed);
+}
+
+bool SyntheticFrameSource::IsFinished() const {
+    return m_config.maxFrames != 0 && m_generator.FrameIndex() >= m_config.maxFrames;
+}
+
+bool SyntheticFrameSource::ReadFrame(Engine::HeatmapFrame& frame) {
+    if (IsFinished()) return false;
+    // 合成时钟按帧号线性推进，下一帧的时间戳可以在生成前算出
+    m_pacer.WaitFor(static_cast<uint64_t>(m_generator.CurrentTime() * 1e9));
+
+    frame.trace.readStartNs = Engine::TraceNowNs();
+    m_generator.Next(frame);
+    frame.trace.readDoneNs = Engine::TraceNowNs();
+    return true;
+}
+
+} // namespace App
@@ -0,0 +1,36 @@
+#include "ProcessorConfigPanel.h"
+#include "imgui.h"
+#include <vector>
+
+namespace App {
+
+void DrawProcessorConfig(Engine::IFrameProcessor& processor) {
+    const char* description = processor.GetDescription();
+    if (description && description[0] != '\0') {
+        ImGui::TextWrapped("%s", description);
+    }
+
+    std::vector<Engine::ParamDesc> params;
+    processor.DescribeParams(params);
+
+    for (const Engine::ParamDesc& param : params) {
+        switch (param.type) {
+        case Engine::ParamType::Int:
+            ImGui::SliderInt(param.name, param.intValue, static_cast<int>(param.min), static_cast<int>(param.max),
+                             param.format ? param.format : "%d");
+            break;
+        case Engine::ParamType::Float:
+            ImGui::SliderFloat(param.name, param.floatValue, param.min, param.max,
+                               param.format ? param.format : "%.3f");
+            break;
+        case Engine::ParamType::Choice:
+            // 单选按钮组，每个选项一行
+            for (size_t i = 0; i < param.choices.size(); ++i) {
+                ImGui::RadioButton(param.choices[i], param.intValue, static_cast<int>(i));
+            }
+            break;
+        }
+    }
+}
+
+} // namespace App
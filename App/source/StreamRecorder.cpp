@@ -0,0 +1,201 @@
+#include "StreamRecorder.h"
+#include "DvrFile.h"
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <format>
+#include <vector>
+
+namespace App {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void RaiseMax(std::atomic<uint64_t>& target, uint64_t value) {
+    if (value > target.load(std::memory_order_relaxed)) target.store(value, std::memory_order_relaxed);
+}
+
+void Bump(std::atomic<uint64_t>& counter, uint64_t delta = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+} // namespace
+
+StreamRecorder::~StreamRecorder() {
+    Stop();
+}
+
+bool StreamRecorder::Start(const RecorderConfig& config, uint64_t configHash) {
+    if (m_writerThread.joinable()) return false;
+
+    std::error_code ec;
+    fs::create_directories(config.directory, ec);
+    if (ec) {
+        LOG_ERROR("App", "StreamRecorder::Start", "Recorder", "Cannot create recording directory {}: {}",
+                  config.directory, ec.message());
+        return false;
+    }
+
+    m_config = config;
+    m_config.maxFileBytes = std::max<uint64_t>(m_config.maxFileBytes, sizeof(Engine::DvrFileHeader) + sizeof(Engine::DvrRecord));
+    m_configHash = configHash;
+
+    // 计数器均为单写者 (写线程或处理线程)，此时两者都未在录制，可直接清零
+    for (auto* counter : {&m_stats.submitted, &m_stats.written, &m_stats.droppedQueueFull, &m_stats.droppedWriteError,
+                          &m_stats.bytesWritten, &m_stats.filesOpened, &m_stats.filesDeleted, &m_stats.maxQueueDepth}) {
+        counter->store(0, std::memory_order_relaxed);
+    }
+
+    // 上次 Stop 与处理线程 Submit 竞争时可能遗留的引用
+    m_queue.Clear();
+    m_stopRequested.store(false, std::memory_order_relaxed);
+    m_writerThread = std::thread(&StreamRecorder::WriterThreadFunc, this);
+    m_active.store(true, std::memory_order_release);
+
+    LOG_INFO("App", "StreamRecorder::Start", "Recorder",
+             "Recording to {}/{}_*.egdvr (file {} MB / {} s, budget {} MB, {})", m_config.directory, m_config.prefix,
+             m_config.maxFileBytes >> 20, m_config.maxFileSeconds, m_config.maxTotalBytes >> 20,
+             m_config.compress ? std::format("compressed, keyframe every {}", m_config.keyframeInterval) : "uncompressed");
+    return true;
+}
+
+void StreamRecorder::Stop() {
+    if (!m_writerThread.joinable()) return;
+
+    m_active.store(false, std::memory_order_relaxed);
+    m_stopRequested.store(true, std::memory_order_release);
+    m_writerThread.join();
+    // 写线程已退出，本线程暂为唯一消费者；之后才到达的 Submit 由下次 Start 清理
+    m_queue.Clear();
+
+    LOG_INFO("App", "StreamRecorder::Stop", "Recorder",
+             "Recording stopped: {} written, {} dropped (queue full), {} dropped (I/O), {} files, {} MB",
+             m_stats.written.load(), m_stats.droppedQueueFull.load(), m_stats.droppedWriteError.load(),
+             m_stats.filesOpened.load(), m_stats.bytesWritten.load() >> 20);
+}
+
+void StreamRecorder::Submit(const FrameRef& frame) {
+    if (!m_active.load(std::memory_order_acquire)) return;
+    Bump(m_stats.submitted);
+    if (!m_queue.Push(frame)) {
+        Bump(m_stats.droppedQueueFull);
+    }
+}
+
+void StreamRecorder::WriterThreadFunc() {
+    using Clock = std::chrono::steady_clock;
+
+    Engine::DvrWriter writer;
+    std::string currentFile;
+    uint32_t fileSequence = 0;
+    Clock::time_point fileOpenedAt{};
+    Clock::time_point nextOpenAttempt{};
+
+    auto closeFile = [&] {
+        if (!writer.IsOpen()) return;
+        if (!writer.Close()) {
+            LOG_WARN("App", "StreamRecorder::WriterThreadFunc", "Recorder",
+                     "Failed to finalize {}; readers will recover it without the index", currentFile);
+        }
+    };
+
+    for (;;) {
+        FrameRef frame;
+        if (!m_queue.WaitForData(frame, std::chrono::milliseconds(100))) {
+            // 只在队列已排空时响应停止，保证 Stop 前提交的帧全部落盘
+            if (m_stopRequested.load(std::memory_order_acquire)) break;
+            continue;
+        }
+        RaiseMax(m_stats.maxQueueDepth, m_queue.Size() + 1);
+
+        // 下一帧的大小按一条未压缩记录估算
+        const Clock::time_point now = Clock::now();
+        if (writer.IsOpen() &&
+            (writer.BytesWritten() + sizeof(Engine::DvrRecord) > m_config.maxFileBytes ||
+             (m_config.maxFileSeconds && now - fileOpenedAt >= std::chrono::seconds(m_config.maxFileSeconds)))) {
+            closeFile();
+        }
+
+        if (!writer.IsOpen()) {
+            // 打开失败后 1 秒内不再重试，期间的帧直接计入 I/O 丢弃
+            if (now < nextOpenAttempt) {
+                Bump(m_stats.droppedWriteError);
+                continue;
+            }
+            const std::time_t wallNow = std::time(nullptr);
+            struct tm timeInfo;
+#if defined(_WIN32)
+            localtime_s(&timeInfo, &wallNow);
+#else
+            localtime_r(&wallNow, &timeInfo);
+#endif
+            currentFile = (fs::path(m_config.directory) /
+                           std::format("{}_{:04d}{:02d}{:02d}_{:02d}{:02d}{:02d}_{:04d}.egdvr", m_config.prefix,
+                                       timeInfo.tm_year + 1900, timeInfo.tm_mon + 1, timeInfo.tm_mday,
+                                       timeInfo.tm_hour, timeInfo.tm_min, timeInfo.tm_sec, fileSequence++)).string();
+            if (!writer.Open(currentFile, m_configHash, m_config.compress, m_config.keyframeInterval)) {
+                LOG_ERROR("App", "StreamRecorder::WriterThreadFunc", "Recorder", "Failed to create {}", currentFile);
+                nextOpenAttempt = now + std::chrono::seconds(1);
+                Bump(m_stats.droppedWriteError);
+                continue;
+            }
+            Bump(m_stats.filesOpened);
+            Bump(m_stats.bytesWritten, writer.BytesWritten());
+            fileOpenedAt = now;
+            EnforceDiskBudget(currentFile);
+        }
+
+        const uint64_t bytesBefore = writer.BytesWritten();
+        if (writer.Append(*frame)) {
+            Bump(m_stats.written);
+            Bump(m_stats.bytesWritten, writer.BytesWritten() - bytesBefore);
+        } else {
+            LOG_ERROR("App", "StreamRecorder::WriterThreadFunc", "Recorder", "Write failed on {}, rotating", currentFile);
+            Bump(m_stats.droppedWriteError);
+            closeFile();
+            nextOpenAttempt = now + std::chrono::seconds(1);
+        }
+    }
+
+    closeFile();
+}
+
+// 按修改时间删除最旧的本前缀录制文件，直到 (其余文件 + 当前文件的最大长度) 不超过预算
+void StreamRecorder::EnforceDiskBudget(const std::string& currentFile) {
+    struct Entry {
+        fs::path path;
+        uint64_t size;
+        fs::file_time_type time;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = m_config.maxFileBytes;   // 为正在写入的文件预留其上限
+
+    std::error_code ec;
+    const fs::path current = fs::path(currentFile).lexically_normal();
+    for (const auto& item : fs::directory_iterator(m_config.directory, ec)) {
+        if (!item.is_regular_file(ec)) continue;
+        const fs::path& path = item.path();
+        if (path.extension() != ".egdvr" || !path.filename().string().starts_with(m_config.prefix + "_")) continue;
+        if (path.lexically_normal() == current) continue;
+        const uint64_t size = item.file_size(ec);
+        entries.push_back({path, size, item.last_write_time(ec)});
+        total += size;
+    }
+    if (total <= m_config.maxTotalBytes) return;
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.time < b.time; });
+    for (const Entry& entry : entries) {
+        if (total <= m_config.maxTotalBytes) break;
+        if (fs::remove(entry.path, ec)) {
+            total -= entry.size;
+            Bump(m_stats.filesDeleted);
+            LOG_INFO("App", "StreamRecorder::EnforceDiskBudget", "Recorder", "Deleted {} to stay within budget",
+                     entry.path.string());
+        }
+    }
+}
+
+} // namespace App
@@ -7,6 +7,7 @@
 #include "imgui_impl_dx11.h"
 
 #include "Coordinator.h"
+#include "DeviceFrameSource.h"
 #include "DiagnosticUI.h"
 #include "Logger.h"
 
@@ -37,7 +38,7 @@ int main(int, char**)
     LOG_INFO("App", "wWinMain", "System", "--- EGoTouchApp (DX11) Starts ---");
 
     // 1. 初始化驱动服务协调器
-    App::Coordinator coordinator;
+    App::Coordinator coordinator(std::make_unique<App::DeviceFrameSource>());
     if (!coordinator.Start()) {
         LOG_ERROR("App", "wWinMain", "System", "Failed to start coordinator threads.");
         Common::Logger::Shutdown();
@@ -0,0 +1,419 @@
+// Himax 芯片端到端基准 / 回归 (ChipEmulatorBench)
+// 用 HimaxEmulator 代替 SPBTESTTOOL / spidev，驱动真实的 Chip::Init、AFE 命令、Chip::GetFrame
+// 与 Chip::Deinit，输出各阶段耗时与总线事务数，并检查协议约束：
+//   - 无故障时 Init / Deinit 成功，无协议错误 (未设方向即读、未开中断即取帧) 与命令校验错误
+//   - AFE 命令被 FW 按槽位顺序接受，idle 切换生效
+//   - 帧号连续，Master / Slave 帧号只在主机漏帧时错位
+//   - Slave 不等中断 (立即读出当前帧，如 spidev) 时在 Master 读完后才取，两侧属于同一次扫描
+//   - 注入总线错误 / 帧超时 / 掉线后 Chip 返回错误而不是挂起，故障消失后恢复取帧
+// 任一检查失败时退出码为 1，可直接接入 CI。
+//
+//   ChipEmulatorBench [--frames N] [--timing instant|spb|spidev] [--log dir]
+//
+// 说明：
+// - instant 为零延迟 (只测协议逻辑与主机侧开销)；spb 按 SPBTESTTOOL 实测量级计入每次
+//   IOCTL 往返与 10 MHz 总线传输，帧率 120 Hz，每个总线命令各一次 IOCTL；spidev 把
+//   BusTransaction 的多相合并为一次往返，且 Slave 不接中断脚。
+// - 结束时按协议操作 (register_read / send_command 等) 输出调用次数、往返次数、总线命令数
+//   与省去的 burst_enable 写。
+// - 取帧延迟为 GetFrame 调用到返回 (含等待下一帧)，"xfer" 行为帧就绪后的读出时间。
+
+#include "HimaxChip.h"
+#include "HimaxEmulator.h"
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Himax::DeviceType;
+
+constexpr uint32_t kMasterBytes = 5063;
+constexpr uint32_t kSlaveBytes = 339;
+
+int g_failures = 0;
+
+void Check(bool ok, const char* what) {
+    if (!ok) {
+        std::printf("  FAIL: %s\n", what);
+        ++g_failures;
+    }
+}
+
+double Ms(Clock::duration d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+unsigned long long Load(const std::atomic<uint64_t>& counter) {
+    return counter.load(std::memory_order_relaxed);
+}
+
+// 两次快照之间的事务数
+struct Traffic {
+    uint64_t transactions = 0;
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+    uint64_t controls = 0;
+    uint64_t bytes = 0;
+
+    static Traffic Take(const Himax::EmulatorCounters& c) {
+        return {Load(c.transactions), Load(c.busReads), Load(c.busWrites), Load(c.controls), Load(c.bytes)};
+    }
+    Traffic operator-(const Traffic& o) const {
+        return {transactions - o.transactions, reads - o.reads, writes - o.writes, controls - o.controls, bytes - o.bytes};
+    }
+};
+
+void PrintStep(const char* name, Clock::duration elapsed, const Traffic& t, uint64_t ops = 1) {
+    std::printf("  %-22s %9.3f ms  txn=%-6llu read=%-5llu write=%-5llu ctrl=%-4llu bytes=%-7llu",
+                name, Ms(elapsed), static_cast<unsigned long long>(t.transactions),
+                static_cast<unsigned long long>(t.reads), static_cast<unsigned long long>(t.writes),
+                static_cast<unsigned long long>(t.controls), static_cast<unsigned long long>(t.bytes));
+    if (ops > 1) std::printf("  (%.1f txn/op)", static_cast<double>(t.transactions) / ops);
+    std::printf("\n");
+}
+
+void PrintPercentiles(const char* name, std::vector<double>& us) {
+    if (us.empty()) return;
+    std::sort(us.begin(), us.end());
+    auto at = [&](double q) { return us[std::min(us.size() - 1, static_cast<size_t>(q * us.size()))]; };
+    std::printf("  %-22s samples=%-6zu p50=%8.1fus p90=%8.1fus p99=%8.1fus max=%8.1fus\n", name, us.size(),
+                at(0.50), at(0.90), at(0.99), us.back());
+}
+
+uint32_t FrameIndex(const uint8_t* data) {
+    uint32_t index = 0;
+    std::memcpy(&index, data, sizeof(index));
+    return index;
+}
+
+struct Rig {
+    Himax::HimaxEmulator emulator;
+    std::unique_ptr<Himax::Chip> chip;
+
+    explicit Rig(const Himax::EmulatorTiming& timing, const Himax::EmulatorFaults& faults = {})
+        : emulator(timing, faults),
+          chip(std::make_unique<Himax::Chip>(emulator.OpenTransport(DeviceType::Master),
+                                             emulator.OpenTransport(DeviceType::Slave),
+                                             emulator.OpenTransport(DeviceType::Interrupt))) {}
+};
+
+void PrintBusReport(const Himax::Chip& chip, const Himax::EmulatorTiming& timing) {
+    std::printf("\nbus operations:\n");
+    std::printf("  %-8s %-22s %8s %10s %8s %10s %10s\n", "side", "operation", "calls", "round_trips", "phases",
+                "burst_skip", "trips/call");
+    uint64_t commandCalls = 0;
+    uint64_t commandTrips = 0;
+    for (DeviceType side : {DeviceType::Master, DeviceType::Slave}) {
+        const Himax::BusStats* stats = chip.GetBusStats(side);
+        if (!stats) continue;
+        for (size_t i = 0; i < stats->size(); ++i) {
+            const Himax::BusOperationStats& op = (*stats)[i];
+            const uint64_t calls = Load(op.calls);
+            if (calls == 0) continue;
+            const uint64_t trips = Load(op.roundTrips);
+            std::printf("  %-8s %-22s %8llu %10llu %8llu %10llu %10.2f\n",
+                        side == DeviceType::Master ? "master" : "slave",
+                        Himax::BusOperationName(static_cast<Himax::BusOperation>(i)),
+                        static_cast<unsigned long long>(calls), static_cast<unsigned long long>(trips),
+                        Load(op.phases), Load(op.burstSkipped), static_cast<double>(trips) / calls);
+            if (static_cast<Himax::BusOperation>(i) == Himax::BusOperation::SendCommand) {
+                commandCalls += calls;
+                commandTrips += trips;
+            }
+        }
+    }
+    // 合并传输时一条 AFE 命令 (写包、触发、回读) 只应有一次往返
+    if (timing.batchedTransfers) Check(commandTrips <= commandCalls, "send_command in one round trip");
+}
+
+void RunLifecycle(const Himax::EmulatorTiming& timing, uint64_t frames) {
+    std::printf("\nlifecycle:\n");
+    Rig rig(timing);
+    const Himax::EmulatorCounters& counters = rig.emulator.Counters();
+
+    Traffic before = Traffic::Take(counters);
+    Clock::time_point start = Clock::now();
+    const bool initOk = rig.chip->Init().has_value();
+    PrintStep("Chip::Init", Clock::now() - start, Traffic::Take(counters) - before);
+    Check(initOk, "Chip::Init with a healthy device");
+    Check(rig.chip->GetConnectionState() == Himax::ConnectionState::Connected, "connected after Init");
+    Check(rig.emulator.Streaming(DeviceType::Master) && rig.emulator.Streaming(DeviceType::Slave),
+          "both chips streaming after Init");
+    if (!initOk) return;
+
+    before = Traffic::Take(counters);
+    start = Clock::now();
+    const bool idleOk = rig.chip->thp_afe_enter_idle().has_value();
+    const bool idleState = rig.emulator.Idle();
+    const bool exitOk = rig.chip->thp_afe_force_exit_idle().has_value();
+    PrintStep("AFE enter/exit idle", Clock::now() - start, Traffic::Take(counters) - before, 2);
+    Check(idleOk && exitOk, "AFE commands accepted");
+    Check(idleState && !rig.emulator.Idle(), "idle state follows AFE commands");
+    const std::vector<Himax::EmulatorCommand> commands = rig.emulator.Commands();
+    Check(commands.size() == 2 && commands[0].id == 0x0A && commands[1].id == 0x0B &&
+              commands[0].slot == 0 && commands[1].slot == 1,
+          "command ring slots consumed in order");
+
+    std::vector<uint8_t> buffer(kMasterBytes + kSlaveBytes);
+    std::vector<double> latency;
+    latency.reserve(frames);
+    uint64_t errors = 0;
+    uint64_t mismatched = 0;
+    uint64_t gaps = 0;
+    uint64_t slips = 0;             // 两侧帧号之差发生变化的次数
+    uint64_t stale = 0;             // Slave 帧号早于 Master (读到了上一次扫描)
+    int64_t last = -1;
+    int64_t skew = 0;
+    const uint64_t overrunBefore = Load(counters.framesOverrun);
+    before = Traffic::Take(counters);
+    start = Clock::now();
+    for (uint64_t i = 0; i < frames; ++i) {
+        const Clock::time_point t0 = Clock::now();
+        if (!rig.chip->GetFrame(buffer.data(), buffer.size())) {
+            ++errors;
+            continue;
+        }
+        latency.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+        const uint32_t master = FrameIndex(buffer.data());
+        const uint32_t slave = FrameIndex(buffer.data() + kMasterBytes);
+        if (master != slave) ++mismatched;
+        if (slave < master) ++stale;
+        if (static_cast<int64_t>(slave) - master != skew) {
+            skew = static_cast<int64_t>(slave) - master;
+            ++slips;
+        }
+        if (last >= 0 && master != static_cast<uint32_t>(last + 1)) ++gaps;
+        last = master;
+    }
+    const Clock::duration loop = Clock::now() - start;
+    const uint64_t overrun = Load(counters.framesOverrun) - overrunBefore;
+    PrintStep("Chip::GetFrame loop", loop, Traffic::Take(counters) - before, frames);
+    std::printf("  %-22s %.1f frames/s, errors=%llu mismatched=%llu stale=%llu slips=%llu gaps=%llu overrun=%llu\n", "",
+                frames / (Ms(loop) / 1000.0), static_cast<unsigned long long>(errors),
+                static_cast<unsigned long long>(mismatched), static_cast<unsigned long long>(stale),
+                static_cast<unsigned long long>(slips),
+                static_cast<unsigned long long>(gaps),
+                static_cast<unsigned long long>(overrun));
+    PrintPercentiles("GetFrame latency", latency);
+    Check(errors == 0, "no GetFrame errors without faults");
+    if (timing.slaveInterrupt) {
+        // 主机被调度延误而漏帧时两侧会错开一帧，且顺序取帧无法自行对齐，直到下一次漏帧；
+        // 因此只要求每次错位 / 跳号都对应一次仿真器记录的覆盖
+        Check(slips <= overrun, "master / slave skew changes only on overrun");
+    } else {
+        // 不等中断的 Slave 在 Master 读完后读出最新扫描：主机延误时可能比 Master 新，但不会更旧
+        Check(stale == 0, "read-now slave never returns an older scan");
+    }
+    Check(gaps <= overrun, "consecutive frame indices");
+
+    before = Traffic::Take(counters);
+    start = Clock::now();
+    const bool deinitOk = rig.chip->Deinit().has_value();
+    PrintStep("Chip::Deinit", Clock::now() - start, Traffic::Take(counters) - before);
+    Check(deinitOk, "Chip::Deinit");
+    Check(!rig.emulator.Streaming(DeviceType::Master), "master stopped after Deinit");
+
+    std::printf("  protocol_errors=%llu command_errors=%llu resets=%llu\n", Load(counters.protocolErrors),
+                Load(counters.commandErrors), Load(counters.resets));
+    Check(Load(counters.protocolErrors) == 0, "no protocol errors");
+    Check(Load(counters.commandErrors) == 0, "no command checksum / slot errors");
+    PrintBusReport(*rig.chip, timing);
+}
+
+// 取帧传输本身的耗时 (帧随取随有，不含等帧)：Slave 等待中断时两侧同时在途，应接近 Master 一侧的
+// 传输时间而不是两侧之和；Slave 不等中断时两侧依次读出，不少于两侧之和
+void RunFetchOverlap(Himax::EmulatorTiming timing) {
+    if (timing.byteNs == 0 && timing.transactionUs == 0) return;
+    timing.frameIntervalUs = 0;
+    std::printf("\nframe fetch (no frame wait):\n");
+
+    Rig rig(timing);
+    Check(rig.chip->Init().has_value(), "Init before fetch-overlap test");
+    std::vector<uint8_t> buffer(kMasterBytes + kSlaveBytes);
+    std::vector<double> latency;
+    for (int i = 0; i < 200; ++i) {
+        const Clock::time_point t0 = Clock::now();
+        if (rig.chip->GetFrame(buffer.data(), buffer.size())) {
+            latency.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+        }
+    }
+    PrintPercentiles("GetFrame latency", latency);   // 排序
+    const double p50 = latency.empty() ? 0.0 : latency[latency.size() / 2];
+    const double masterUs = timing.transactionUs + kMasterBytes * timing.byteNs / 1000.0;
+    const double slaveUs = timing.transactionUs + kSlaveBytes * timing.byteNs / 1000.0;
+    std::printf("  %-22s master=%.0fus slave=%.0fus sequential=%.0fus\n", "transfer cost", masterUs, slaveUs,
+                masterUs + slaveUs);
+    Check(latency.size() == 200, "no GetFrame errors without faults");
+    if (timing.slaveInterrupt) {
+        Check(p50 < masterUs + slaveUs, "master / slave transfers overlap");
+    } else {
+        Check(p50 >= masterUs + slaveUs, "read-now slave fetched after the master");
+    }
+}
+
+// Slave 不等中断 (立即读出最近一次完成的扫描)：若与 Master 同时提交，Slave 会在 Master 等帧期间
+// 读到上一次扫描。按实际帧周期取帧 (instant 时改用 2 ms)，要求 Slave 帧号从不早于 Master；
+// 主机延误超过一帧时 Slave 可能已是下一次扫描，不计为错误
+void RunReadNowSlave(Himax::EmulatorTiming timing) {
+    timing.slaveInterrupt = false;
+    if (timing.frameIntervalUs == 0) timing.frameIntervalUs = 2000;
+    std::printf("\nread-now slave (no slave interrupt):\n");
+
+    Rig rig(timing);
+    Check(rig.chip->Init().has_value(), "Init before read-now slave test");
+    const Himax::EmulatorCounters& counters = rig.emulator.Counters();
+    const uint64_t overrunBefore = Load(counters.framesOverrun);
+    std::vector<uint8_t> buffer(kMasterBytes + kSlaveBytes);
+    uint64_t errors = 0;
+    uint64_t mismatched = 0;
+    uint64_t stale = 0;
+    for (int i = 0; i < 100; ++i) {
+        if (!rig.chip->GetFrame(buffer.data(), buffer.size())) {
+            ++errors;
+            continue;
+        }
+        const uint32_t master = FrameIndex(buffer.data());
+        const uint32_t slave = FrameIndex(buffer.data() + kMasterBytes);
+        if (master != slave) ++mismatched;
+        if (slave < master) ++stale;
+    }
+    const uint64_t overrun = Load(counters.framesOverrun) - overrunBefore;
+    std::printf("  %-22s errors=%llu mismatched=%llu stale=%llu overrun=%llu\n", "100 frames",
+                static_cast<unsigned long long>(errors), static_cast<unsigned long long>(mismatched),
+                static_cast<unsigned long long>(stale), static_cast<unsigned long long>(overrun));
+    Check(errors == 0, "no GetFrame errors with a read-now slave");
+    Check(stale == 0, "read-now slave never returns an older scan");
+}
+
+void RunFaults(const Himax::EmulatorTiming& timing) {
+    std::printf("\nfault injection:\n");
+    std::vector<uint8_t> buffer(kMasterBytes + kSlaveBytes);
+
+    // 总线错误：Init 可能失败，但必须返回；统计多次 Init 的成功率
+    {
+        int succeeded = 0;
+        constexpr int kAttempts = 20;
+        const Clock::time_point start = Clock::now();
+        for (int i = 0; i < kAttempts; ++i) {
+            Himax::EmulatorFaults faults;
+            faults.busErrorRate = 0.01;
+            faults.seed = 1000 + i;
+            Rig rig(Himax::EmulatorTiming::Instant(), faults);
+            if (rig.chip->Init()) ++succeeded;
+        }
+        std::printf("  %-22s %d/%d Init succeeded at 1%% bus errors (%.1f ms)\n", "bus errors", succeeded, kAttempts,
+                    Ms(Clock::now() - start));
+    }
+
+    // 帧超时：GetFrame 按超时返回，关闭注入后恢复
+    {
+        Rig rig(timing);
+        Check(rig.chip->Init().has_value(), "Init before frame-timeout test");
+        Himax::EmulatorFaults faults;
+        faults.frameTimeoutRate = 0.2;
+        rig.emulator.SetFaults(faults);
+        int timeouts = 0;
+        const Clock::time_point start = Clock::now();
+        for (int i = 0; i < 50; ++i) {
+            auto res = rig.chip->GetFrame(buffer.data(), buffer.size());
+            if (!res && res.error() == Himax::ChipError::Timeout) ++timeouts;
+        }
+        const Clock::duration elapsed = Clock::now() - start;
+        rig.emulator.SetFaults({});
+        const bool recovered = rig.chip->GetFrame(buffer.data(), buffer.size()).has_value();
+        std::printf("  %-22s %d/50 timed out (%.1f ms), recovered=%d\n", "frame timeouts", timeouts, Ms(elapsed),
+                    recovered);
+        Check(timeouts > 0, "injected frame timeouts reported as ChipError::Timeout");
+        Check(recovered, "GetFrame recovers after timeouts stop");
+    }
+
+    // 总线挂起：请求迟迟不完成时 GetFrame 按截止时间 (驱动超时 + 余量) 返回，而不是陪着挂起；
+    // 挂起的请求结束、槽位回收后恢复
+    {
+        Rig rig(timing);
+        Check(rig.chip->Init().has_value(), "Init before bus-hang test");
+        Himax::EmulatorFaults faults;
+        faults.frameHangRate = 1.0;
+        faults.frameHangMs = 1000;
+        rig.emulator.SetFaults(faults);
+        Clock::time_point start = Clock::now();
+        const auto res = rig.chip->GetFrame(buffer.data(), buffer.size());
+        const double hungMs = Ms(Clock::now() - start);
+        rig.emulator.SetFaults({});
+
+        start = Clock::now();
+        bool recovered = false;
+        while (!recovered && Clock::now() - start < std::chrono::seconds(3)) {
+            recovered = rig.chip->GetFrame(buffer.data(), buffer.size()).has_value();
+        }
+        std::printf("  %-22s GetFrame -> %s in %.1f ms (hang %u ms), recovered=%d after %.1f ms\n", "bus hang",
+                    res ? "ok" : "error", hungMs, faults.frameHangMs, recovered, Ms(Clock::now() - start));
+        Check(!res && res.error() == Himax::ChipError::Timeout, "hung request reported as ChipError::Timeout");
+        Check(hungMs < faults.frameHangMs / 2.0, "hung request abandoned at its deadline");
+        Check(recovered, "GetFrame recovers after the hung request completes");
+    }
+
+    // 掉线：所有事务失败，GetFrame 立即返回错误
+    {
+        Rig rig(timing);
+        Check(rig.chip->Init().has_value(), "Init before disconnect test");
+        Himax::EmulatorFaults faults;
+        faults.disconnectAfter = Load(rig.emulator.Counters().transactions);
+        rig.emulator.SetFaults(faults);
+        const Clock::time_point start = Clock::now();
+        const auto res = rig.chip->GetFrame(buffer.data(), buffer.size());
+        const double ms = Ms(Clock::now() - start);
+        std::printf("  %-22s GetFrame -> %s in %.3f ms\n", "disconnect", res ? "ok" : "error", ms);
+        Check(!res && res.error() == Himax::ChipError::CommunicationError, "disconnect reported as CommunicationError");
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint64_t frames = 600;
+    Himax::EmulatorTiming timing = Himax::EmulatorTiming::SpbTestTool();
+    std::string logDir;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--frames" && i + 1 < argc) {
+            frames = std::max<uint64_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--timing" && i + 1 < argc) {
+            const std::string name = argv[++i];
+            if (name == "instant") timing = Himax::EmulatorTiming::Instant();
+            else if (name == "spb") timing = Himax::EmulatorTiming::SpbTestTool();
+            else if (name == "spidev") timing = Himax::EmulatorTiming::Spidev();
+            else frames = 0;
+        } else if (arg == "--log" && i + 1 < argc) {
+            logDir = argv[++i];
+        } else {
+            frames = 0;
+        }
+        if (frames == 0) {
+            std::fprintf(stderr, "usage: %s [--frames N] [--timing instant|spb|spidev] [--log dir]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (!logDir.empty()) Common::Logger::Init("ChipEmulatorBench", logDir);
+
+    std::printf("timing: transaction=%uus byte=%uns frame=%uus reload=%ums batched=%d slave_interrupt=%d\n",
+                timing.transactionUs, timing.byteNs, timing.frameIntervalUs, timing.reloadMs, timing.batchedTransfers,
+                timing.slaveInterrupt);
+    RunLifecycle(timing, frames);
+    RunFetchOverlap(timing);
+    RunReadNowSlave(timing);
+    RunFaults(timing);
+
+    std::printf("\n%s (%d failed checks)\n", g_failures == 0 ? "PASS" : "FAIL", g_failures);
+    Common::Logger::Shutdown();
+    return g_failures == 0 ? 0 : 1;
+}
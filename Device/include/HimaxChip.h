@@ -14,7 +14,6 @@
 #include <memory>
 #include <array>
 #include <string>
-#include <winnt.h>
 
 // Note: The legacy HIMAX_LOG is removed. We use LOG_INFO, LOG_ERROR, etc. from Logger.h
 
@@ -64,6 +63,11 @@ namespace Himax {
             sram_operation      psram_op{};
             driver_operation    pdriver_op{};
             zf_operation        pzf_op{};
+
+            // 总线挂死时每帧都提交失败，这类日志每秒最多一条，其间被压下的条数记在下一条里
+            IoClock::time_point m_submitLogAt{};
+            uint32_t m_submitLogSuppressed = 0;
+            bool TakeSubmitLogSlot(uint32_t& suppressed);
         
             
             ChipResult<HalDevice*> SelectDevice(DeviceType type);
@@ -116,15 +120,27 @@ namespace Himax {
             ChipResult<> thp_afe_force_to_freq_point(uint8_t freq_idx);
             ChipResult<> thp_afe_force_to_scan_rate(uint8_t rate_idx);
 
+            // master / slave 不可为空；interrupt 可为空 (Linux 后端的中断脚挂在 master 上)
+            Chip(std::unique_ptr<ITransport> master, std::unique_ptr<ITransport> slave, std::unique_ptr<ITransport> interrupt = nullptr);
+#if defined(_WIN32)
+            // SPBTESTTOOL 设备路径
             Chip(const std::wstring& master_path, const std::wstring& slave_path, const std::wstring& interrupt_path);
+#endif
             ~Chip(); // Add destructor for explicit cleanup
             
             bool IsReady(DeviceType type) const;
+            // 各协议操作的总线往返 / 命令数统计；type 无对应设备时为 nullptr
+            const BusStats* GetBusStats(DeviceType type) const;
+            void ResetBusStats();
             ConnectionState GetConnectionState() const { return m_connState.load(); }
             
             ChipResult<> Init(void);
             ChipResult<> Deinit(void); // Replaces Stop
             
             ChipResult<> GetFrame(void);
+            // 直接读入调用方提供的缓冲区 (Master 5063 + Slave 339 字节)，省去 back_data 中转拷贝。
+            // Slave 后端等待中断时两侧同时在途，否则 Master 读完后再读 Slave；
+            // 任一侧失败都会记录日志，两侧都失败时返回 Master 的错误
+            ChipResult<> GetFrame(uint8_t* buffer, size_t size);
     };
 }
\ No newline at end of file
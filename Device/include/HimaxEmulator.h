@@ -0,0 +1,191 @@
+#pragma once
+#include "HimaxTransport.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Himax {
+
+    // ---------------------------------------------------------
+    // Himax 双芯片仿真器 (Emulator)
+    // 在 ITransport 层面模拟 Master / Slave 两颗控制器，使 Chip::Init、Chip::GetFrame 与采集
+    // 线程可以在没有硬件的机器上端到端运行、计时与回归：
+    //   - 总线寄存器 0x00 (AHB 地址 / 写数据)、0x08 (AHB 读数据)、0x0C (访问方向)、
+    //     0x0D (incr4)、0x13 (conti)、0x31/0x32 (safe mode 口令)；burst 需 conti=0x31 且
+    //     incr4 bit0=1，否则每次 AHB 访问只覆盖同一个字 (暴露漏掉 burst_enable 的调用)；
+    //     未写 0x0C 读方向时读 0x08 只唤醒总线并返回 0
+    //   - HimaxRegisters 中 Chip 用到的 AHB 寄存器按普通内存读写，以下带副作用：
+    //     0x900000A8 FW 状态 (运行 0x05 / safe mode 0x0C / 停止 0x00)、0x9000005C 写 0xA5 停 FW、
+    //     0x90000018 写 0x55 软复位、0x10000000 写 0x5AA5 开始出帧 (握手)、
+    //     0x100072C0 复位释放 reloadMs 后由 FW 写回 0x72C0 (重载完成握手)、
+    //     0x10007550 起 5 个 16 字节命令槽 (send_command)，0x1000753C 为 FW 侧槽位指针
+    //   - 复位脚 (SetReset) 同时作用于两颗芯片；帧按固定周期产生，GetFrame 阻塞到下一帧
+    //     (无中断线的 Slave 除外，见 EmulatorTiming::slaveInterrupt)
+    // 每次事务按 EmulatorTiming 计入延迟 (在芯片锁之外等待，两颗芯片可并发)，并可按
+    // EmulatorFaults 注入故障。仿真器须比它开出的 transport 晚析构。
+    struct EmulatorTiming {
+        uint32_t transactionUs = 0;         // 每次事务的固定开销 (驱动 / IOCTL 往返)
+        uint32_t byteNs = 0;                // 每字节传输时间 (10 MHz SPI 约 800 ns)
+        uint32_t frameIntervalUs = 8333;    // 帧周期；0 = 帧随取随有
+        uint32_t idleIntervalUs = 33333;    // 进入 idle (命令 0x0A) 后的帧周期
+        uint32_t reloadMs = 20;             // 复位释放到 FW 写回 0x72C0
+        bool batchedTransfers = true;       // ITransport::Transfer 的多相合并为一次事务 (spidev)；
+                                            // false 时逐相各算一次 (SPBTESTTOOL 每个命令一次 IOCTL)
+        bool slaveInterrupt = true;         // Slave 取帧等待下一帧 (驱动侧有中断)；false 时 (spidev 的 Slave
+                                            // 不接中断脚) 不等待，立即读出最近一次完成扫描的帧
+
+        // 零延迟 (逻辑回归)
+        static EmulatorTiming Instant() { return {0, 0, 0, 0, 0, true, true}; }
+        // 接近 SPBTESTTOOL 实测：每次 IOCTL 约 60 us，总线 10 MHz
+        static EmulatorTiming SpbTestTool() { return {60, 800, 8333, 33333, 20, false, true}; }
+        // spidev：每条 SPI_IOC_MESSAGE 约 15 us 系统调用开销，总线 10 MHz，Slave 无中断脚
+        static EmulatorTiming Spidev() { return {15, 800, 8333, 33333, 20, true, false}; }
+    };
+
+    struct EmulatorFaults {
+        double busErrorRate = 0.0;          // 任意事务返回 CommunicationError
+        double frameTimeoutRate = 0.0;      // GetFrame / WaitInterrupt 超时
+        double frameHangRate = 0.0;         // GetFrame 挂起 (总线无应答)：frameHangMs 后才返回超时
+        uint32_t frameHangMs = 1000;
+        double corruptReadRate = 0.0;       // ReadBus 返回的数据翻转一位
+        double dropCommandRate = 0.0;       // FW 忽略命令槽中的命令 (不清除包头)
+        uint64_t disconnectAfter = 0;       // 累计事务数达到后全部失败 (模拟掉线)；0 = 不断开
+        uint32_t seed = 1;
+    };
+
+    // 各计数只增不减，任意线程可读
+    struct EmulatorCounters {
+        std::atomic<uint64_t> transactions{0};
+        std::atomic<uint64_t> busReads{0};
+        std::atomic<uint64_t> busWrites{0};
+        std::atomic<uint64_t> controls{0};          // 复位 / 中断 / 超时等控制操作
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> framesServed{0};
+        std::atomic<uint64_t> framesOverrun{0};     // 主机取帧过慢而被覆盖的帧
+        std::atomic<uint64_t> frameTimeouts{0};
+        std::atomic<uint64_t> framesHung{0};
+        std::atomic<uint64_t> resets{0};
+        std::atomic<uint64_t> commands{0};          // FW 接受的命令
+        std::atomic<uint64_t> commandErrors{0};     // 校验和错误 / 槽位不符
+        std::atomic<uint64_t> protocolErrors{0};    // 未开中断即取帧 / 等中断
+        std::atomic<uint64_t> injectedFaults{0};
+    };
+
+    struct EmulatorCommand {
+        DeviceType side;
+        uint8_t slot;
+        uint8_t id;
+        uint8_t value;
+    };
+
+    class HimaxEmulator {
+    public:
+        // 填充一帧 (side 为 Master 时 len 通常为 5063，Slave 为 339)；同一 frameIndex 的两侧
+        // 属于同一次扫描。可能在两个线程上并发调用
+        using FrameFiller = std::function<void(DeviceType side, uint64_t frameIndex, uint8_t* data, uint32_t len)>;
+
+        explicit HimaxEmulator(const EmulatorTiming& timing = {}, const EmulatorFaults& faults = {});
+        ~HimaxEmulator();
+        HimaxEmulator(const HimaxEmulator&) = delete;
+        HimaxEmulator& operator=(const HimaxEmulator&) = delete;
+
+        // Interrupt 端点与 Master 共用一颗芯片
+        std::unique_ptr<ITransport> OpenTransport(DeviceType type);
+
+        // 以下配置在任意线程调用，从下一次事务起生效
+        void SetTiming(const EmulatorTiming& timing);
+        void SetFaults(const EmulatorFaults& faults);
+        // 缺省填充：前 4 字节为小端 frameIndex，其余为 0
+        void SetFrameFiller(FrameFiller filler);
+
+        // 直接访问 AHB 空间 (不计事务、不触发副作用)，供断言与预置状态
+        uint32_t PeekRegister(DeviceType side, uint32_t addr) const;
+        void PokeRegister(DeviceType side, uint32_t addr, uint32_t value);
+
+        bool Streaming(DeviceType side) const;
+        bool Idle() const { return m_idle.load(std::memory_order_relaxed); }
+        std::vector<EmulatorCommand> Commands() const;
+        const EmulatorCounters& Counters() const { return m_counters; }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+        class Endpoint;
+
+        struct Ic {
+            DeviceType side;
+            mutable std::mutex mutex;
+            std::unordered_map<uint32_t, uint32_t> memory;   // 按字对齐的 AHB 空间
+            std::array<uint8_t, 256> busRegs{};
+            uint32_t ahbAddr = 0;
+            bool readArmed = false;        // 0x0C 已写读方向
+            bool fwRunning = true;
+            bool handshake = false;        // 0x10000000 == 0x5AA5
+            bool reloadPending = false;
+            Clock::time_point reloadDoneAt{};
+            uint8_t commandSlot = 0;       // FW 下一个处理的命令槽
+            bool interruptOpen = false;
+            bool block = true;
+            uint32_t timeoutMs = 100;
+            int64_t lastFrame = -1;
+            uint32_t rng = 1;
+        };
+
+        // --- 事务入口 (Endpoint 调用) ---
+        ChipResult<> ReadBus(Ic& ic, uint8_t cmd, uint8_t* data, uint32_t len, uint32_t& error);
+        ChipResult<> WriteBus(Ic& ic, uint8_t cmd, const uint8_t* addr, const uint8_t* data, uint32_t len, uint32_t& error);
+        ChipResult<> Transfer(Ic& ic, const BusPhase* phases, size_t count, uint32_t& error);
+        ChipResult<> GetFrame(Ic& ic, uint8_t* buffer, uint32_t len, uint32_t& error);
+        ChipResult<> WaitInterrupt(Ic& ic, uint32_t& error);
+        ChipResult<> SetReset(bool state, uint32_t& error);
+        ChipResult<> Control(Ic& ic, const std::function<void(Ic&)>& apply, uint32_t& error);
+        bool FrameWaitsForInterrupt(const Ic& ic) const;
+
+        // 事务开始：推进 FW 状态、决定是否注入故障；调用方持有 ic.mutex
+        ChipResult<> Begin(Ic& ic, uint32_t& error);
+        bool Roll(Ic& ic, double rate);
+        void Advance(Ic& ic, Clock::time_point now);
+        void ResetIc(Ic& ic, Clock::time_point reloadDoneAt);
+
+        uint32_t ApplyRead(Ic& ic, uint8_t cmd, uint8_t* data, uint32_t len);
+        uint32_t ApplyWrite(Ic& ic, uint8_t cmd, const uint8_t* addr, const uint8_t* data, uint32_t len);
+        uint8_t ReadByte(const Ic& ic, uint32_t addr) const;
+        void WriteByte(Ic& ic, uint32_t addr, uint8_t value);
+        uint32_t ReadWord(const Ic& ic, uint32_t addr) const;
+        void OnAhbWrite(Ic& ic, uint32_t addr, uint32_t len);
+        void ProcessCommand(Ic& ic, uint8_t slot);
+        bool StreamingLocked(const Ic& ic) const;
+        // 该芯片是否有中断线 (见 EmulatorTiming::slaveInterrupt)；调用方持有 m_configMutex
+        bool HasInterruptLocked(const Ic& ic) const;
+
+        // 帧节拍
+        int64_t CurrentTick(Clock::time_point now) const;
+        Clock::time_point TickTime(int64_t tick) const;
+        void SetFrameInterval(uint32_t intervalUs);
+
+        static void Wait(Clock::duration duration);
+        Clock::duration Cost(uint32_t bytes) const;
+        bool Batched() const;
+
+        Ic m_master;
+        Ic m_slave;
+
+        mutable std::mutex m_configMutex;   // m_timing / m_faults / m_filler / 节拍基准 / 命令记录
+        EmulatorTiming m_timing;
+        EmulatorFaults m_faults;
+        std::shared_ptr<const FrameFiller> m_filler;
+        int64_t m_tickBase = 0;
+        Clock::time_point m_tickEpoch;
+        uint32_t m_frameIntervalUs = 0;
+        std::vector<EmulatorCommand> m_commands;
+
+        bool m_resetLow = false;            // 复位脚电平 (两颗芯片共用)，在两把芯片锁下读写
+        std::atomic<bool> m_idle{false};
+        EmulatorCounters m_counters;
+    };
+}
@@ -8,67 +8,140 @@
  */
 // HimaxHal.h
 #pragma once
-#include <vector>
-#include <expected>
-#include <windows.h>
-#include <winnt.h>
+#include "HimaxTransport.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 
 namespace Himax {
-    // 芯片错误码定义
-    enum class ChipError {
-        Success = 0,
-        CommunicationError,  // 底层驱动/总线通讯故障 (Handle, IOCTL, Read/Write)
-        Timeout,             // 操作超时 (Interrupt, Reloading, Status polling)
-        VerificationFailed,  // 逻辑校验失败 (Verify failed, FW Status error)
-        InvalidOperation,    // 调用时机或参数非法 (Invalid param, State error, Not ready)
-        InternalError        // 内部逻辑异常
+    // 按协议操作分类的总线统计 (见 HimaxProtocol::BusTransaction)
+    enum class BusOperation : uint8_t {
+        RegisterRead,
+        RegisterWrite,
+        WriteAndVerify,
+        SendCommand,
+        ReadFwStatus,
+        BurstEnable,
+        Raw,            // 上层直接调用 ReadBus / WriteBus
+        Count
     };
 
-    // 错误处理别名
-    template <typename T = void>
-    using ChipResult = std::expected<T, ChipError>;
+    const char* BusOperationName(BusOperation op);
 
-    enum class DeviceType { Master, Slave, Interrupt };
-    
+    struct BusOperationStats {
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> roundTrips{0};      // 后端往返次数 (合并传输计一次)
+        std::atomic<uint64_t> phases{0};          // 总线命令数 (CS 周期)
+        std::atomic<uint64_t> burstSkipped{0};    // 因 burst 状态已知而省去的写
+    };
+
+    using BusStats = std::array<BusOperationStats, static_cast<size_t>(BusOperation::Count)>;
+
+    // 单颗芯片 (Master / Slave) 的总线端点：操作全部转交给 ITransport 后端
     class HalDevice {
     public:
+        // transport 不可为空；打开失败的后端使 IsValid 为 false
+        HalDevice(std::unique_ptr<ITransport> transport, DeviceType type);
+#if defined(_WIN32)
+        // SPBTESTTOOL 设备路径
         HalDevice(const wchar_t* path, DeviceType type);
+#endif
         ~HalDevice();
 
         bool IsValid() const;
-        ChipResult<> Ioctl(DWORD code, const void* in, uint32_t inLen, void* out,
-                   uint32_t outLen, uint32_t* retLen);
-        ChipResult<> Read(void* buffer, uint32_t len);
         ChipResult<> WaitInterrupt();
         ChipResult<> ReadBus(uint8_t cmd, uint8_t* data, uint32_t len);
         ChipResult<> WriteBus(const uint8_t cmd, const uint8_t* addr, const uint8_t* data, uint32_t len);
         ChipResult<> ReadAcpi(uint8_t* data, uint32_t len);
         ChipResult<> GetFrame(void* buffer, uint32_t outLen, uint32_t* retLen);
+        // 异步取帧 (见 ITransport::SubmitFrame)；两侧都等待中断时 Master / Slave 可同时在途
+        ChipResult<IoTicket> SubmitFrame(uint32_t len, IoClock::time_point deadline);
+        ChipResult<> CompleteFrame(IoTicket ticket, void* buffer, uint32_t len, uint32_t* retLen);
+        bool FrameWaitsForInterrupt() const { return m_transport->FrameWaitsForInterrupt(); }
+        // 本设备取帧的截止时间：SetTimeOut 设定的超时 + kFrameDeadlineMarginMs
+        IoClock::time_point FrameDeadline(IoClock::time_point from) const {
+            return from + std::chrono::milliseconds(m_frameTimeoutMs + kFrameDeadlineMarginMs);
+        }
         ChipResult<> SetTimeOut(uint8_t millisecond);
         ChipResult<> SetBlock(bool status);
         ChipResult<> SetReset(bool state);
         ChipResult<> IntOpen(void);
         ChipResult<> IntClose(void);
-        DWORD GetError(void);
+        uint32_t GetError(void);
+
+        DeviceType Type() const { return m_type; }
+        ITransport* Transport() { return m_transport.get(); }
+
+        // 以一次 Transfer 执行多相 (HimaxProtocol::BusTransaction 使用)，计入 op 的统计
+        ChipResult<> Transfer(BusOperation op, const BusPhase* phases, size_t count);
+
+        // 总线寄存器 0x13 (conti) / 0x0D (incr4) 的已知取值；-1 为未知。
+        // 写这两个寄存器时更新，传输失败、复位、写系统复位寄存器后作废。
+        // 两颗芯片共用复位脚，Chip 在复位后需同时作废另一颗的状态
+        int KnownConti() const { return m_conti; }
+        int KnownIncr4() const { return m_incr4; }
+        void InvalidateBusState() { m_conti = m_incr4 = -1; }
+
+        const BusStats& Stats() const { return m_stats; }
+        void ResetStats();
+        // 一次协议操作结束 (BusTransaction::Commit)：计调用次数与省去的 burst 写
+        void CountOperation(BusOperation op, uint64_t burstSkipped);
 
     private:
-        HANDLE m_handle;
-        DWORD m_lastError;
+        void Track(const BusPhase& phase);
+        void CountTransfer(BusOperation op, uint64_t roundTrips, uint64_t phases);
+
+        std::unique_ptr<ITransport> m_transport;
         DeviceType m_type;
-        
-        uint8_t m_readOp;
-        uint8_t m_writeOp;
-        
-        const size_t dummy_size = 1;
-        const size_t header_size = 2;
-        const size_t data_offset = header_size + dummy_size;
-        
-        OVERLAPPED m_ov = {};
-        std::vector<uint8_t> m_xfer_buffer;
+        int m_conti = -1;
+        int m_incr4 = -1;
+        uint32_t m_frameTimeoutMs = 100;   // 驱动侧默认超时
+        BusStats m_stats;
     };
 
     namespace HimaxProtocol {
 
+        // ---------------------------------------------------------
+        // 寄存器事务构造器
+        // 把若干次 AHB 读写排成总线命令序列，Commit 时以一次 HalDevice::Transfer 发出：
+        //   - 按长度自动选择 burst (len > 4)，与设备上已知的 conti / incr4 相同时不再写
+        //   - 寄存器读 = 地址 + 读方向 + 读数据三相，写 = 地址与数据合为一相
+        // 读取的数据在 Commit 成功后才有效；相数超过容量时自动先提交已排入的部分。
+        class BusTransaction {
+        public:
+            static constexpr size_t kMaxPhases = 16;
+
+            BusTransaction(HalDevice* dev, BusOperation op);
+            BusTransaction(const BusTransaction&) = delete;
+            BusTransaction& operator=(const BusTransaction&) = delete;
+
+            BusTransaction& Burst(bool enable);
+            BusTransaction& Write(uint32_t addr, const uint8_t* data, uint32_t len);
+            BusTransaction& Read(uint32_t addr, uint8_t* out, uint32_t len);
+            // 总线寄存器直接读写 (safe mode 口令等)
+            BusTransaction& WriteBus(uint8_t cmd, const uint8_t* data, uint32_t len);
+            BusTransaction& ReadBus(uint8_t cmd, uint8_t* out, uint32_t len);
+
+            // 提交排入的全部相；排入阶段的错误 (参数非法、中途提交失败) 也在此返回
+            ChipResult<> Commit();
+
+        private:
+            // 追加一相；scratch 为该相专用的 4 字节存储 (地址 / 单字节寄存器值)
+            BusPhase& Push(uint8_t*& scratch);
+            ChipResult<> Flush();
+
+            HalDevice* m_dev;
+            BusOperation m_op;
+            std::array<BusPhase, kMaxPhases> m_phases{};
+            std::array<std::array<uint8_t, 4>, kMaxPhases> m_scratch{};
+            size_t m_count = 0;
+            int m_conti;                 // 排入序列后的 conti / incr4 (-1 未知)
+            int m_incr4;
+            uint64_t m_skipped = 0;
+            ChipResult<> m_status{};
+        };
+
         ChipResult<> burst_enable(HalDevice *dev, bool isEnable);
         ChipResult<> register_read(HalDevice *dev, const uint32_t addr, uint8_t* buffer, uint32_t len);
         ChipResult<> register_write(HalDevice *dev, const uint32_t addr, const uint8_t* buffer, uint32_t len);
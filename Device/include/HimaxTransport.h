@@ -0,0 +1,135 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <string>
+
+namespace Himax {
+    // 芯片错误码定义
+    enum class ChipError {
+        Success = 0,
+        CommunicationError,  // 底层驱动/总线通讯故障 (Handle, IOCTL, Read/Write)
+        Timeout,             // 操作超时 (Interrupt, Reloading, Status polling)
+        VerificationFailed,  // 逻辑校验失败 (Verify failed, FW Status error)
+        InvalidOperation,    // 调用时机或参数非法 (Invalid param, State error, Not ready)
+        InternalError        // 内部逻辑异常
+    };
+
+    // 错误处理别名
+    template <typename T = void>
+    using ChipResult = std::expected<T, ChipError>;
+
+    enum class DeviceType { Master, Slave, Interrupt };
+
+    // SPI 帧格式 (各后端共用)：
+    //   写: [writeOp, cmd, addr[4]?, data...]
+    //   读: [readOp, cmd, dummy, 0...] 全双工，数据从第 kReadDataOffset 字节起
+    // Master / Slave 两颗芯片挂在同一总线上，以操作码区分
+    struct BusOpcodes {
+        uint8_t read;
+        uint8_t write;
+    };
+
+    constexpr BusOpcodes OpcodesFor(DeviceType type) {
+        return type == DeviceType::Slave ? BusOpcodes{0xF5, 0xF4} : BusOpcodes{0xF3, 0xF2};
+    }
+
+    inline constexpr uint32_t kReadDataOffset = 3;   // 操作码 + 命令 + dummy
+
+    // 一次总线命令 (一个 CS 周期)：读时 out 接收 len 字节；写时 addr (4 字节) 与 data 均可为空
+    struct BusPhase {
+        bool read = false;
+        uint8_t cmd = 0;
+        const uint8_t* addr = nullptr;
+        const uint8_t* data = nullptr;
+        uint8_t* out = nullptr;
+        uint32_t len = 0;
+    };
+
+    using IoClock = std::chrono::steady_clock;
+
+    // 在途异步请求的句柄；generation 防止槽位复用后把新请求误认为旧请求
+    struct IoTicket {
+        uint32_t slot = 0;
+        uint32_t generation = 0;
+    };
+
+    // 同步 GetFrame 的截止时间 = SetTimeOut 设定的驱动超时 + 此余量 (整帧传输与调度)
+    inline constexpr uint32_t kFrameDeadlineMarginMs = 50;
+
+    // ---------------------------------------------------------
+    // 总线传输层 (Transport)
+    // HalDevice 的全部总线 / 中断 / 复位操作都经由此接口，HimaxProtocol 与 Chip 不接触
+    // 平台 API。后端：
+    //   - SPBTESTTOOL IOCTL (Windows，OpenSpbTestToolTransport)
+    //   - spidev + GPIO 字符设备 (Linux，OpenSpidevTransport)
+    //   - 进程内双芯片仿真器 (HimaxEmulator.h，所有平台；无硬件时的端到端运行与回归)
+    // 同一实例的调用由上层串行化，实现不做加锁。
+    class ITransport {
+    public:
+        virtual ~ITransport() = default;
+
+        // 打开失败的后端仍返回对象，IsValid 为 false，GetError 给出原因
+        virtual bool IsValid() const = 0;
+
+        virtual ChipResult<> ReadBus(uint8_t cmd, uint8_t* data, uint32_t len) = 0;
+        virtual ChipResult<> WriteBus(uint8_t cmd, const uint8_t* addr, const uint8_t* data, uint32_t len) = 0;
+        // 一帧触摸数据；阻塞模式下先等待中断
+        virtual ChipResult<> GetFrame(void* buffer, uint32_t outLen, uint32_t* retLen) = 0;
+        virtual ChipResult<> SetReset(bool state) = 0;
+        virtual ChipResult<> WaitInterrupt() = 0;
+
+        virtual ChipResult<> IntOpen() = 0;
+        virtual ChipResult<> IntClose() = 0;
+        virtual ChipResult<> SetTimeOut(uint8_t millisecond) = 0;
+        virtual ChipResult<> SetBlock(bool state) = 0;
+        virtual ChipResult<> ReadAcpi(uint8_t* data, uint32_t len) = 0;
+
+        // 依次执行一组总线命令，遇到失败即停止。能把多相合并为一次往返的后端覆盖此函数
+        // (spidev：一条 SPI_IOC_MESSAGE)；缺省逐相调用 ReadBus / WriteBus
+        virtual ChipResult<> Transfer(const BusPhase* phases, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                const BusPhase& p = phases[i];
+                auto res = p.read ? ReadBus(p.cmd, p.out, p.len) : WriteBus(p.cmd, p.addr, p.data, p.len);
+                if (!res) return res;
+            }
+            return {};
+        }
+        // Transfer 的一次调用是否只产生一次往返 (供统计)
+        virtual bool BatchesTransfers() const { return false; }
+
+        // 异步取帧：提交后立即返回，可与另一颗芯片的请求同时在途。数据读入后端自有的缓冲，
+        // CompleteFrame 成功时才拷入 buffer；deadline 到期仍未完成则返回 Timeout 并放弃该请求
+        // (后端负责取消或事后回收)，调用线程不会被挂起的总线卡住
+        virtual ChipResult<IoTicket> SubmitFrame(uint32_t len, IoClock::time_point deadline) = 0;
+        virtual ChipResult<> CompleteFrame(IoTicket ticket, void* buffer, uint32_t len, uint32_t* retLen) = 0;
+        // 取帧时后端是否自己等待下一帧就绪 (阻塞模式且接了中断)。为 false 时 SubmitFrame 立即读出
+        // 芯片当前的帧，与另一颗芯片同时提交会读到上一次扫描，调用方须等那一侧的帧就绪后再提交
+        virtual bool FrameWaitsForInterrupt() const = 0;
+
+        // 最近一次失败的平台错误码 (Win32 GetLastError / errno)，成功后为 0
+        virtual uint32_t GetError() const = 0;
+    };
+
+#if defined(_WIN32)
+    // SPBTESTTOOL 测试驱动 (\\.\Global\SPBTESTTOOL_MASTER 等)，全部操作走 overlapped IOCTL
+    std::unique_ptr<ITransport> OpenSpbTestToolTransport(const wchar_t* path, DeviceType type);
+#endif
+
+#if defined(__linux__)
+    // Linux spidev + GPIO 字符设备 (uAPI v2)。
+    // GetFrame 对应驱动侧 SPI_IOCTL_GET_FRAME：阻塞模式下等待中断线下降沿，再以命令 0x08 读出整帧
+    struct SpidevConfig {
+        std::string spiDevice = "/dev/spidev0.0";
+        uint32_t speedHz = 10'000'000;
+        uint8_t mode = 3;                          // SPI_MODE_3
+        std::string gpioChip = "/dev/gpiochip0";
+        int resetLine = -1;                        // 复位脚的 line offset；-1 = 不接 (SetReset 报错)
+        int interruptLine = -1;                    // 中断脚的 line offset；-1 = 不接 (GetFrame 不等待)
+    };
+
+    std::unique_ptr<ITransport> OpenSpidevTransport(const SpidevConfig& config, DeviceType type);
+#endif
+}
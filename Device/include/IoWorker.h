@@ -0,0 +1,79 @@
+#pragma once
+#include "HimaxTransport.h"
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Himax {
+
+    // ---------------------------------------------------------
+    // I/O 工作线程 (提交 / 完成)
+    // 把只能阻塞调用的后端操作 (spidev ioctl、仿真器) 变为带截止时间的异步请求：
+    //   - 请求槽与数据缓冲在构造时一次分配，提交 / 完成路径不分配、不创建句柄
+    //   - Submit 立即返回；Complete 最多等到提交时给出的 deadline，超时即放弃该请求
+    //   - 被放弃的请求若尚未开始则不再执行，已在执行的由工作线程做完后回收槽位，
+    //     数据只写入槽内缓冲，因此调用方可以放心返回
+    // 同一 IoWorker 的请求按提交顺序串行执行；并发来自多个 IoWorker (每个设备一个)。
+    // 析构时等待正在执行的请求结束。
+    class IoWorker {
+    public:
+        struct Request {
+            uint32_t op = 0;              // 含义由 Executor 决定
+            uint32_t arg = 0;
+            uint32_t len = 0;             // 输入 / 期望输出长度
+            uint8_t* data = nullptr;      // 槽内缓冲 (容量 bufferBytes)
+        };
+        // 在工作线程上执行请求，返回实际输出字节数；error 为平台错误码
+        using Executor = std::function<ChipResult<uint32_t>(Request& request, uint32_t& error)>;
+
+        IoWorker(Executor executor, size_t slots, size_t bufferBytes);
+        ~IoWorker();
+        IoWorker(const IoWorker&) = delete;
+        IoWorker& operator=(const IoWorker&) = delete;
+
+        // in 非空时先拷入槽内缓冲 (len 字节)。槽位全部在途 / 被已放弃的请求占住时等待空槽，
+        // 到 deadline 仍没有则返回 ChipError::Timeout (总线挂起时调用方按截止时间节流，而不是空转)
+        ChipResult<IoTicket> Submit(uint32_t op, uint32_t arg, const uint8_t* in, uint32_t len, IoClock::time_point deadline);
+        // 等待请求完成，成功时把至多 outLen 字节拷入 out (可为空)。超时返回 ChipError::Timeout
+        ChipResult<uint32_t> Complete(IoTicket ticket, uint8_t* out, uint32_t outLen, uint32_t& error);
+
+        // 被放弃后仍在执行或排队的请求数 (挂起的总线会使其持续不为 0)
+        size_t Abandoned() const;
+
+        // 等到队列为空且没有请求在执行 (含已被放弃、仍在执行的请求)。
+        // 用于释放执行器用到的资源之前；执行器本身须有界返回
+        void WaitIdle();
+
+    private:
+        enum class State : uint8_t { Free, Queued, Running, Done, Abandoned };
+
+        struct Slot {
+            State state = State::Free;
+            uint32_t generation = 0;
+            IoClock::time_point deadline{};
+            Request request;
+            ChipResult<uint32_t> result{};
+            uint32_t error = 0;
+            std::vector<uint8_t> buffer;
+        };
+
+        void Run();
+
+        Executor m_executor;
+        std::vector<Slot> m_slots;
+        std::vector<uint32_t> m_queue;       // 环形 FIFO，容量 = 槽数
+        size_t m_queueHead = 0;
+        size_t m_queueSize = 0;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_submitted;
+        std::condition_variable m_completed;
+        std::condition_variable m_idle;
+        std::condition_variable m_freed;     // 有槽位回到 Free
+        bool m_executing = false;            // 执行器正在运行 (锁外)
+        bool m_stop = false;
+        std::thread m_thread;
+    };
+}
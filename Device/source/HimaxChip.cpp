@@ -11,12 +11,12 @@
 #include "Logger.h"
 #include <cstddef>
 #include <cstdint>
+#include <chrono>
 #include <cstring>
 #include <format>
 #include <string>
-#include <synchapi.h>
+#include <thread>
 #include <vector>
-#include <windows.h>
 
 namespace {
 
@@ -46,11 +46,15 @@ void himax_parse_assign_cmd(uint32_t addr, uint8_t *cmd, int len) {
     }
 }
 
+void SleepMs(int ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
 } // end anonymous namespace
 
 namespace Himax {
 
-Chip::Chip(const std::wstring& master_path, const std::wstring& slave_path, const std::wstring& interrupt_path)
+Chip::Chip(std::unique_ptr<ITransport> master, std::unique_ptr<ITransport> slave, std::unique_ptr<ITransport> interrupt)
     : pic_op(InitIcOperation()),
       pfw_op(InitFwOperation()),
       pflash_op(InitFlashOperation()),
@@ -58,9 +62,11 @@ Chip::Chip(const std::wstring& master_path, const std::wstring& slave_path, cons
       pdriver_op(InitDriverOperation()),
       pzf_op(InitZfOperation())
 {
-    m_master = std::make_unique<HalDevice>(master_path.c_str(), DeviceType::Master);
-    m_slave = std::make_unique<HalDevice>(slave_path.c_str(), DeviceType::Slave);
-    m_interrupt = std::make_unique<HalDevice>(interrupt_path.c_str(), DeviceType::Interrupt);
+    m_master = std::make_unique<HalDevice>(std::move(master), DeviceType::Master);
+    m_slave = std::make_unique<HalDevice>(std::move(slave), DeviceType::Slave);
+    if (interrupt) {
+        m_interrupt = std::make_unique<HalDevice>(std::move(interrupt), DeviceType::Interrupt);
+    }
     
     m_inspection_mode = THP_INSPECTION_ENUM::HX_RAWDATA;
     afe_mode = THP_AFE_MODE::Normal;
@@ -68,6 +74,15 @@ Chip::Chip(const std::wstring& master_path, const std::wstring& slave_path, cons
     current_slot = 0;
 }
 
+#if defined(_WIN32)
+Chip::Chip(const std::wstring& master_path, const std::wstring& slave_path, const std::wstring& interrupt_path)
+    : Chip(OpenSpbTestToolTransport(master_path.c_str(), DeviceType::Master),
+           OpenSpbTestToolTransport(slave_path.c_str(), DeviceType::Slave),
+           OpenSpbTestToolTransport(interrupt_path.c_str(), DeviceType::Interrupt))
+{
+}
+#endif
+
 /**
  * @brief 根据设备类型选择对应的 HalDevice 指针
  * @param type 设备类型 (Master/Slave/Interrupt)
@@ -103,6 +118,19 @@ bool Chip::IsReady(DeviceType type) const {
     return const_cast<Chip*>(this)->SelectDevice(type).has_value();
 }
 
+const BusStats* Chip::GetBusStats(DeviceType type) const {
+    const HalDevice* dev = type == DeviceType::Master ? m_master.get()
+                         : type == DeviceType::Slave  ? m_slave.get()
+                                                      : m_interrupt.get();
+    return dev ? &dev->Stats() : nullptr;
+}
+
+void Chip::ResetBusStats() {
+    for (HalDevice* dev : {m_master.get(), m_slave.get(), m_interrupt.get()}) {
+        if (dev) dev->ResetStats();
+    }
+}
+
 /**
  * @brief 检查主从设备的总线连接状态
  * @return bool 主从设备总线均正常返回 true
@@ -243,14 +271,16 @@ ChipResult<> Chip::hx_hw_reset_ahb_intf(DeviceType type) {
     // 物理复位操作：经测试，Slave 句柄 (WinError 1168) 不支持复位控制，
     // 物理复位引脚仅绑定在 Master 句柄上，故统一由 m_master 执行。
     if (auto res = m_master->SetReset(0); !res) {
-        LOG_ERROR("Device", "Chip::hx_hw_reset_ahb_intf", GetStateStr(), "Physical SetReset(0) via Master failed, WinError: {}", (int)m_master->GetError());
+        LOG_ERROR("Device", "Chip::hx_hw_reset_ahb_intf", GetStateStr(), "Physical SetReset(0) via Master failed, OS error: {}", (int)m_master->GetError());
         return res;
     }
 
     if (auto res = m_master->SetReset(1); !res) {
-        LOG_ERROR("Device", "Chip::hx_hw_reset_ahb_intf", GetStateStr(), "Physical SetReset(1) via Master failed, WinError: {}", (int)m_master->GetError());
+        LOG_ERROR("Device", "Chip::hx_hw_reset_ahb_intf", GetStateStr(), "Physical SetReset(1) via Master failed, OS error: {}", (int)m_master->GetError());
         return res;
     }
+    // 复位脚两颗芯片共用，Slave 的总线寄存器同样回到默认值
+    m_slave->InvalidateBusState();
 
     if (auto res = HimaxProtocol::burst_enable(dev, 1); !res) {
         LOG_ERROR("Device", "Chip::hx_hw_reset_ahb_intf", GetStateStr(), "burst_enable set to 1 failed");
@@ -279,20 +309,20 @@ ChipResult<> Chip::hx_sw_reset_ahb_intf(DeviceType type) {
             safe_mode_ok = true;
             break;
         }
-        Sleep(10);
+        SleepMs(10);
     }
 
     if (!safe_mode_ok) {
         LOG_WARN("Device", "Chip::hx_sw_reset_ahb_intf", GetStateStr(), "Failed to enter Safe Mode before reset, proceeding anyway...");
     }
 
-    Sleep(10);
+    SleepMs(10);
     himax_parse_assign_cmd(pdriver_op.data_fw_define_flash_reload_en, tmp_data, 4);
     if (auto res = HimaxProtocol::register_write(dev, pdriver_op.addr_fw_define_2nd_flash_reload, tmp_data, 4); !res) {
         LOG_ERROR("Device", "Chip::hx_sw_reset_ahb_intf", GetStateStr(), "clean reload done failed!");
         return res;
     }
-    Sleep(10);
+    SleepMs(10);
     
     himax_parse_assign_cmd(pfw_op.data_system_reset, tmp_data, 4);
     if (auto res = HimaxProtocol::register_write(dev, pfw_op.addr_system_reset, tmp_data, 4); !res) {
@@ -300,7 +330,7 @@ ChipResult<> Chip::hx_sw_reset_ahb_intf(DeviceType type) {
         return res;
     }
 
-    Sleep(100);
+    SleepMs(100);
     if (auto res = HimaxProtocol::burst_enable(dev, 1); !res) return res;
 
     return {};
@@ -434,13 +464,19 @@ ChipResult<> Chip::hx_is_reload_done_ahb(void) {
 }
 
 ChipResult<> Chip::himax_mcu_read_FW_status(void) {
-    std::array<uint8_t, 4> tmp_data{};
     uint32_t dbg_reg_ary[4] = {pfw_op.addr_fw_dbg_msg_addr, pfw_op.addr_chk_fw_status,
 	pfw_op.addr_chk_dd_status, pfw_op.addr_flag_reset_event};
 
-    for (uint32_t addr : dbg_reg_ary) {
-        if (auto res = HimaxProtocol::register_read(m_master.get(), addr, tmp_data.data(), 4); !res) return res;
-        LOG_INFO("Device", "Chip::himax_mcu_read_FW_status", GetStateStr(), "{:x} = {::#x}",addr, tmp_data);
+    std::array<std::array<uint8_t, 4>, 4> values{};
+
+    // 四个调试寄存器在同一事务中读出
+    HimaxProtocol::BusTransaction txn(m_master.get(), BusOperation::ReadFwStatus);
+    for (size_t i = 0; i < values.size(); ++i) {
+        txn.Read(dbg_reg_ary[i], values[i].data(), 4);
+    }
+    if (auto res = txn.Commit(); !res) return res;
+    for (size_t i = 0; i < values.size(); ++i) {
+        LOG_INFO("Device", "Chip::himax_mcu_read_FW_status", GetStateStr(), "{:x} = {::#x}", dbg_reg_ary[i], values[i]);
     }
     return {};
 }
@@ -478,7 +514,7 @@ ChipResult<> Chip::himax_mcu_interface_on(void) {
             break;
         }
 
-        Sleep(1);
+        SleepMs(1);
     } while (++cnt < 10);
 
     if (cnt > 0) {
@@ -500,11 +536,12 @@ ChipResult<> Chip::hx_sense_on(bool FlashMode) {
     himax_parse_assign_cmd(pfw_op.data_clear, tmp_data.data(), 4);
     if (auto res = HimaxProtocol::register_write(m_master.get(), pfw_op.addr_ctrl_fw_isr, tmp_data.data(), 4); !res) return res;
     
-    Sleep(11);
+    SleepMs(11);
 
     if (!FlashMode) {
         if (auto res = m_master->SetReset(false); !res) return res;
         if (auto res = m_master->SetReset(true); !res) return res;
+        m_slave->InvalidateBusState();
     } else {
         tmp_data.fill(0);
         if (auto res = m_master->WriteBus(pic_op.adr_i2c_psw_lb, NULL, tmp_data.data(), 2); !res) return res;
@@ -529,7 +566,7 @@ ChipResult<> Chip::hx_sense_off(bool check_en) {
             step_ok = HimaxProtocol::register_write(m_master.get(), pfw_op.addr_ctrl_fw_isr, send_data.data(), 4);
             if (!step_ok) return step_ok;
         }
-        Sleep(20);
+        SleepMs(20);
 
         step_ok = HimaxProtocol::register_read(m_master.get(), pfw_op.addr_chk_fw_status, back_data.data(), 4);
         if (!step_ok) return step_ok;
@@ -564,9 +601,10 @@ ChipResult<> Chip::hx_sense_off(bool check_en) {
             return {};
         }
         if (auto res = m_master->SetReset(0); !res) return res;
-        Sleep(20);
+        SleepMs(20);
         if (auto res = m_master->SetReset(1); !res) return res; // Fix: SetReset should be 1, original had 50? SetReset(bool)
-        Sleep(50);
+        m_slave->InvalidateBusState();
+        SleepMs(50);
     }while (cnt++ < 15);
 
     LOG_INFO("Device", "Chip::hx_sense_off", GetStateStr(), "Out!");
@@ -597,7 +635,7 @@ ChipResult<> Chip::himax_mcu_power_on_init(void) {
         }
         LOG_INFO("Device", "Chip::himax_mcu_power_on_init", GetStateStr(), "waiting for FW reload data %d", retry); 
         auto res = himax_mcu_read_FW_status(); // 打印 log
-        Sleep(11);
+        SleepMs(11);
     }
     LOG_ERROR("Device", "Chip::himax_mcu_power_on_init", GetStateStr(), "FW reload timeout!");
     return std::unexpected(ChipError::Timeout);
@@ -710,7 +748,7 @@ ChipResult<> Chip::switch_afe_mode(AFE_Command cmd, uint8_t param) {
 
 ChipResult<> Chip::Init(void) {
     if (auto res = hx_hw_reset_ahb_intf(DeviceType::Master); !res) return res;
-    Sleep(10);
+    SleepMs(10);
     LOG_INFO("Device", "Chip::Init", GetStateStr(), "Starting initialization sequence...");
 
     std::array<uint8_t, 4> tmp_data = {0xA5, 0x5A, 0x00, 0x00};
@@ -770,22 +808,68 @@ Chip::~Chip() {
 }
 
 ChipResult<> Chip::GetFrame(void) {
+    return GetFrame(back_data.data(), back_data.size());
+}
+
+bool Chip::TakeSubmitLogSlot(uint32_t& suppressed) {
+    const auto now = IoClock::now();
+    if (m_submitLogAt != IoClock::time_point{} && now - m_submitLogAt < std::chrono::seconds(1)) {
+        ++m_submitLogSuppressed;
+        return false;
+    }
+    m_submitLogAt = now;
+    suppressed = m_submitLogSuppressed;
+    m_submitLogSuppressed = 0;
+    return true;
+}
+
+ChipResult<> Chip::GetFrame(uint8_t* buffer, size_t size) {
     if (m_connState.load() != ConnectionState::Connected) {
         return std::unexpected(ChipError::InvalidOperation);
     }
+    if (buffer == nullptr || size < 5063 + 339) {
+        return std::unexpected(ChipError::InvalidOperation);
+    }
 
-    // 从 Master 读取主帧数据 (5063 bytes)
-    if (auto res = m_master->GetFrame(back_data.data(), 5063, nullptr); !res) {
-        LOG_ERROR("Device", "Chip::GetFrame", GetStateStr(), "Master GetFrame failed!");
-        return res;
+    // Master 主帧 (5063 bytes) 与 Slave 副帧 (339 bytes，拼接在 Master 之后)。
+    // Slave 的后端自己等待帧就绪时两侧同时提交，两次传输重叠；否则 (如 spidev 的 Slave 不接中断脚)
+    // Slave 立即读出芯片当前的帧，须等 Master 的帧读完再提交，才与 Master 属于同一次扫描。
+    // 各侧按自己的超时截止，失败分别记录
+    const bool overlapped = m_slave->FrameWaitsForInterrupt();
+    auto masterTicket = m_master->SubmitFrame(5063, m_master->FrameDeadline(IoClock::now()));
+    if (!masterTicket) {
+        if (uint32_t suppressed = 0; TakeSubmitLogSlot(suppressed)) {
+            LOG_ERROR("Device", "Chip::GetFrame", GetStateStr(), "Master GetFrame submit failed ({}), OS error: {}, {} similar suppressed",
+                      masterTicket.error() == ChipError::Timeout ? "no free slot" : "bus error", (int)m_master->GetError(), suppressed);
+        }
+        return std::unexpected(masterTicket.error());
     }
+    ChipResult<IoTicket> slaveTicket = std::unexpected(ChipError::InternalError);
+    if (overlapped) slaveTicket = m_slave->SubmitFrame(339, m_slave->FrameDeadline(IoClock::now()));
 
-    // 从 Slave 读取副帧数据 (339 bytes)，拼接到 Master 之后
-    if (auto res = m_slave->GetFrame(back_data.data() + 5063, 339, nullptr); !res) {
-        LOG_ERROR("Device", "Chip::GetFrame", GetStateStr(), "Slave GetFrame failed!");
-        return res;
+    // 已提交的请求都要完成 (或超时放弃)，以归还后端的请求槽
+    ChipResult<> master = m_master->CompleteFrame(*masterTicket, buffer, 5063, nullptr);
+    if (!master) {
+        LOG_ERROR("Device", "Chip::GetFrame", GetStateStr(), "Master GetFrame failed ({}), OS error: {}",
+                  master.error() == ChipError::Timeout ? "timeout" : "bus error", (int)m_master->GetError());
+    }
+    if (!overlapped) {
+        if (!master) return master;
+        slaveTicket = m_slave->SubmitFrame(339, m_slave->FrameDeadline(IoClock::now()));
+    }
+    if (!slaveTicket) {
+        if (uint32_t suppressed = 0; TakeSubmitLogSlot(suppressed)) {
+            LOG_ERROR("Device", "Chip::GetFrame", GetStateStr(), "Slave GetFrame submit failed ({}), OS error: {}, {} similar suppressed",
+                      slaveTicket.error() == ChipError::Timeout ? "no free slot" : "bus error", (int)m_slave->GetError(), suppressed);
+        }
+        return master ? std::unexpected(slaveTicket.error()) : master;
+    }
+    ChipResult<> slave = m_slave->CompleteFrame(*slaveTicket, buffer + 5063, 339, nullptr);
+    if (!slave) {
+        LOG_ERROR("Device", "Chip::GetFrame", GetStateStr(), "Slave GetFrame failed ({}), OS error: {}",
+                  slave.error() == ChipError::Timeout ? "timeout" : "bus error", (int)m_slave->GetError());
     }
 
-    return {};
+    return master ? slave : master;
 }
 } // namespace Himax
\ No newline at end of file
@@ -0,0 +1,625 @@
+#include "HimaxEmulator.h"
+#include "IoWorker.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+namespace Himax {
+
+namespace {
+
+// 芯片侧地址 (与 HimaxRegisters 中的取值一致)
+constexpr uint32_t kAddrRawdata       = 0x10000000;   // sram_op.addr_rawdata_addr
+constexpr uint32_t kAddrReloadDone    = 0x100072C0;   // driver_op.addr_fw_define_2nd_flash_reload
+constexpr uint32_t kAddrCommandRing   = 0x10007550;   // send_command BASE_ADDR
+constexpr uint32_t kAddrCommandSlot   = 0x1000753C;   // init_buffers_and_register
+constexpr uint32_t kAddrSystemReset   = 0x90000018;   // fw_op.addr_system_reset
+constexpr uint32_t kAddrCtrlFwIsr     = 0x9000005C;   // fw_op.addr_ctrl_fw_isr
+constexpr uint32_t kAddrFwStatus      = 0x900000A8;   // fw_op.addr_chk_fw_status
+
+constexpr uint32_t kReloadDoneValue   = 0x000072C0;
+constexpr uint32_t kHandshakeValue    = 0x00005AA5;   // 字节 A5 5A
+constexpr int kCommandSlots = 5;
+constexpr int kCommandBytes = 16;
+
+// 端点的异步取帧 (与 spidev 后端相同的 IoWorker 结构)
+constexpr size_t kFrameSlots = 4;
+constexpr size_t kFrameBufferBytes = 0x4000;
+
+// 总线寄存器
+constexpr uint8_t kBusAhbAddr   = 0x00;
+constexpr uint8_t kBusAhbData   = 0x08;
+constexpr uint8_t kBusDirection = 0x0C;
+constexpr uint8_t kBusIncr4     = 0x0D;
+constexpr uint8_t kBusConti     = 0x13;
+constexpr uint8_t kBusPswLb     = 0x31;
+
+// 本次 AHB 写覆盖的字节范围是否包含 target
+bool Covers(uint32_t addr, uint32_t len, uint32_t target) {
+    return target >= addr && target < addr + std::max<uint32_t>(len, 1);
+}
+
+} // namespace
+
+// 绑定到一颗芯片的 ITransport；全部状态在 HimaxEmulator 中，本身只保存错误码。
+// 取帧与硬件后端一样经由工作线程执行，挂起 (frameHangRate) 时调用方按截止时间返回
+class HimaxEmulator::Endpoint final : public ITransport {
+public:
+    Endpoint(HimaxEmulator& emulator, Ic& ic)
+        : m_emulator(emulator), m_ic(ic),
+          m_frames([this](IoWorker::Request& request, uint32_t& error) -> ChipResult<uint32_t> {
+              auto res = m_emulator.GetFrame(m_ic, request.data, request.len, error);
+              if (!res) return std::unexpected(res.error());
+              return request.len;
+          }, kFrameSlots, kFrameBufferBytes) {}
+
+    bool IsValid() const override { return true; }
+    ChipResult<> ReadBus(uint8_t cmd, uint8_t* data, uint32_t len) override {
+        return m_emulator.ReadBus(m_ic, cmd, data, len, m_lastError);
+    }
+    ChipResult<> WriteBus(uint8_t cmd, const uint8_t* addr, const uint8_t* data, uint32_t len) override {
+        return m_emulator.WriteBus(m_ic, cmd, addr, data, len, m_lastError);
+    }
+    // 合并传输 (对应 spidev 的单条 SPI_IOC_MESSAGE)；timing 不合并时逐相执行
+    ChipResult<> Transfer(const BusPhase* phases, size_t count) override {
+        if (!m_emulator.Batched()) return ITransport::Transfer(phases, count);
+        return m_emulator.Transfer(m_ic, phases, count, m_lastError);
+    }
+    bool BatchesTransfers() const override { return m_emulator.Batched(); }
+    ChipResult<> GetFrame(void* buffer, uint32_t outLen, uint32_t* retLen) override {
+        const auto deadline = IoClock::now() + std::chrono::milliseconds(m_frameTimeoutMs + kFrameDeadlineMarginMs);
+        auto ticket = SubmitFrame(outLen, deadline);
+        if (!ticket) return std::unexpected(ticket.error());
+        return CompleteFrame(*ticket, buffer, outLen, retLen);
+    }
+    ChipResult<IoTicket> SubmitFrame(uint32_t len, IoClock::time_point deadline) override {
+        auto ticket = m_frames.Submit(0, 0, nullptr, len, deadline);
+        if (!ticket) m_lastError = ticket.error() == ChipError::Timeout ? ETIMEDOUT : EINVAL;
+        return ticket;
+    }
+    ChipResult<> CompleteFrame(IoTicket ticket, void* buffer, uint32_t len, uint32_t* retLen) override {
+        auto res = m_frames.Complete(ticket, static_cast<uint8_t*>(buffer), len, m_lastError);
+        if (!res) return std::unexpected(res.error());
+        if (retLen) *retLen = *res;
+        return {};
+    }
+    bool FrameWaitsForInterrupt() const override { return m_emulator.FrameWaitsForInterrupt(m_ic); }
+    ChipResult<> SetReset(bool state) override { return m_emulator.SetReset(state, m_lastError); }
+    ChipResult<> WaitInterrupt() override { return m_emulator.WaitInterrupt(m_ic, m_lastError); }
+    ChipResult<> IntOpen() override {
+        return m_emulator.Control(m_ic, [](Ic& ic) { ic.interruptOpen = true; }, m_lastError);
+    }
+    ChipResult<> IntClose() override {
+        return m_emulator.Control(m_ic, [](Ic& ic) { ic.interruptOpen = false; }, m_lastError);
+    }
+    ChipResult<> SetTimeOut(uint8_t millisecond) override {
+        auto res = m_emulator.Control(m_ic, [millisecond](Ic& ic) { ic.timeoutMs = millisecond; }, m_lastError);
+        if (res) m_frameTimeoutMs = millisecond;
+        return res;
+    }
+    ChipResult<> SetBlock(bool state) override {
+        return m_emulator.Control(m_ic, [state](Ic& ic) { ic.block = state; }, m_lastError);
+    }
+    ChipResult<> ReadAcpi(uint8_t* data, uint32_t len) override {
+        std::memset(data, 0, len);
+        return m_emulator.Control(m_ic, [](Ic&) {}, m_lastError);
+    }
+    uint32_t GetError() const override { return m_lastError; }
+
+private:
+    HimaxEmulator& m_emulator;
+    Ic& m_ic;
+    uint32_t m_lastError = 0;
+    uint32_t m_frameTimeoutMs = 100;    // 与 Ic::timeoutMs 的初值一致
+    IoWorker m_frames;                  // 最后声明：先于其余成员析构，等待在途请求结束
+};
+
+HimaxEmulator::HimaxEmulator(const EmulatorTiming& timing, const EmulatorFaults& faults)
+    : m_timing(timing), m_faults(faults) {
+    m_master.side = DeviceType::Master;
+    m_slave.side = DeviceType::Slave;
+    m_master.rng = faults.seed | 1;
+    m_slave.rng = (faults.seed * 2654435761u) | 1;
+    // 上电即处于 FW 运行、重载已完成的状态
+    m_master.memory[kAddrReloadDone] = kReloadDoneValue;
+    m_slave.memory[kAddrReloadDone] = kReloadDoneValue;
+    m_tickEpoch = Clock::now();
+    m_frameIntervalUs = timing.frameIntervalUs;
+}
+
+HimaxEmulator::~HimaxEmulator() = default;
+
+std::unique_ptr<ITransport> HimaxEmulator::OpenTransport(DeviceType type) {
+    return std::make_unique<Endpoint>(*this, type == DeviceType::Slave ? m_slave : m_master);
+}
+
+void HimaxEmulator::SetTiming(const EmulatorTiming& timing) {
+    std::lock_guard<std::mutex> lock(m_configMutex);
+    m_timing = timing;
+    SetFrameInterval(m_idle.load(std::memory_order_relaxed) ? timing.idleIntervalUs : timing.frameIntervalUs);
+}
+
+void HimaxEmulator::SetFaults(const EmulatorFaults& faults) {
+    std::lock_guard<std::mutex> lock(m_configMutex);
+    m_faults = faults;
+}
+
+void HimaxEmulator::SetFrameFiller(FrameFiller filler) {
+    auto shared = filler ? std::make_shared<const FrameFiller>(std::move(filler)) : nullptr;
+    std::lock_guard<std::mutex> lock(m_configMutex);
+    m_filler = std::move(shared);
+}
+
+uint32_t HimaxEmulator::PeekRegister(DeviceType side, uint32_t addr) const {
+    const Ic& ic = side == DeviceType::Slave ? m_slave : m_master;
+    std::lock_guard<std::mutex> lock(ic.mutex);
+    return ReadWord(ic, addr);
+}
+
+void HimaxEmulator::PokeRegister(DeviceType side, uint32_t addr, uint32_t value) {
+    Ic& ic = side == DeviceType::Slave ? m_slave : m_master;
+    std::lock_guard<std::mutex> lock(ic.mutex);
+    for (int i = 0; i < 4; ++i) WriteByte(ic, addr + i, static_cast<uint8_t>(value >> (8 * i)));
+}
+
+bool HimaxEmulator::Streaming(DeviceType side) const {
+    const Ic& ic = side == DeviceType::Slave ? m_slave : m_master;
+    std::lock_guard<std::mutex> lock(ic.mutex);
+    return StreamingLocked(ic);
+}
+
+std::vector<EmulatorCommand> HimaxEmulator::Commands() const {
+    std::lock_guard<std::mutex> lock(m_configMutex);
+    return m_commands;
+}
+
+// ---------------------------------------------------------
+// AHB 空间
+
+uint8_t HimaxEmulator::ReadByte(const Ic& ic, uint32_t addr) const {
+    auto it = ic.memory.find(addr & ~3u);
+    return it == ic.memory.end() ? 0 : static_cast<uint8_t>(it->second >> (8 * (addr & 3u)));
+}
+
+void HimaxEmulator::WriteByte(Ic& ic, uint32_t addr, uint8_t value) {
+    uint32_t& word = ic.memory[addr & ~3u];
+    const uint32_t shift = 8 * (addr & 3u);
+    word = (word & ~(0xFFu << shift)) | (static_cast<uint32_t>(value) << shift);
+}
+
+uint32_t HimaxEmulator::ReadWord(const Ic& ic, uint32_t addr) const {
+    auto it = ic.memory.find(addr & ~3u);
+    return it == ic.memory.end() ? 0 : it->second;
+}
+
+bool HimaxEmulator::StreamingLocked(const Ic& ic) const {
+    const bool safeMode = ic.busRegs[kBusPswLb] == 0x27 && ic.busRegs[kBusPswLb + 1] == 0x95;
+    return ic.fwRunning && ic.handshake && !safeMode && !m_resetLow;
+}
+
+bool HimaxEmulator::HasInterruptLocked(const Ic& ic) const {
+    return ic.side != DeviceType::Slave || m_timing.slaveInterrupt;
+}
+
+bool HimaxEmulator::FrameWaitsForInterrupt(const Ic& ic) const {
+    std::lock_guard<std::mutex> lock(ic.mutex);
+    std::lock_guard<std::mutex> config(m_configMutex);
+    return ic.block && ic.interruptOpen && HasInterruptLocked(ic);
+}
+
+void HimaxEmulator::ResetIc(Ic& ic, Clock::time_point reloadDoneAt) {
+    ic.busRegs.fill(0);
+    ic.readArmed = false;
+    ic.fwRunning = false;
+    ic.handshake = false;
+    ic.commandSlot = 0;
+    ic.lastFrame = -1;
+    ic.memory[kAddrReloadDone] = 0;
+    ic.memory[kAddrRawdata] = 0;
+    ic.reloadPending = true;
+    ic.reloadDoneAt = reloadDoneAt;
+}
+
+// 复位释放后到时即完成 FW 重载
+void HimaxEmulator::Advance(Ic& ic, Clock::time_point now) {
+    if (ic.reloadPending && !m_resetLow && now >= ic.reloadDoneAt) {
+        ic.reloadPending = false;
+        ic.fwRunning = true;
+        ic.memory[kAddrReloadDone] = kReloadDoneValue;
+    }
+}
+
+// 写入后由 FW 响应的寄存器；addr/len 为本次写覆盖的范围
+void HimaxEmulator::OnAhbWrite(Ic& ic, uint32_t addr, uint32_t len) {
+    if (Covers(addr, len, kAddrCtrlFwIsr) && ReadByte(ic, kAddrCtrlFwIsr) == 0xA5) {
+        ic.fwRunning = false;
+    }
+    if (Covers(addr, len, kAddrSystemReset) && ReadByte(ic, kAddrSystemReset) == 0x55) {
+        // 软复位：FW 随即开始重载
+        std::lock_guard<std::mutex> lock(m_configMutex);
+        ResetIc(ic, Clock::now() + std::chrono::milliseconds(m_timing.reloadMs));
+    }
+    if (Covers(addr, len, kAddrRawdata)) {
+        ic.handshake = (ReadWord(ic, kAddrRawdata) & 0xFFFF) == kHandshakeValue;
+    }
+    if (Covers(addr, len, kAddrCommandSlot)) {
+        ic.commandSlot = static_cast<uint8_t>(ReadByte(ic, kAddrCommandSlot) % kCommandSlots);
+    }
+    // 命令槽：写入触发标记 (A8 8A id 00) 时处理；写整包 (包头已清零) 时不处理
+    if (addr >= kAddrCommandRing && addr < kAddrCommandRing + kCommandSlots * kCommandBytes &&
+        (addr - kAddrCommandRing) % kCommandBytes == 0 && len <= 4 &&
+        ReadByte(ic, addr) == 0xA8 && ReadByte(ic, addr + 1) == 0x8A) {
+        ProcessCommand(ic, static_cast<uint8_t>((addr - kAddrCommandRing) / kCommandBytes));
+    }
+}
+
+void HimaxEmulator::ProcessCommand(Ic& ic, uint8_t slot) {
+    double dropRate;
+    {
+        std::lock_guard<std::mutex> lock(m_configMutex);
+        dropRate = m_faults.dropCommandRate;
+    }
+    if (Roll(ic, dropRate)) {
+        m_counters.injectedFaults.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const uint32_t base = kAddrCommandRing + slot * kCommandBytes;
+    uint32_t sum = 0;
+    for (int i = 0; i < kCommandBytes; i += 2) {
+        sum += ReadByte(ic, base + i) | (ReadByte(ic, base + i + 1) << 8);
+    }
+    if ((sum & 0xFFFF) != 0 || slot != ic.commandSlot || !ic.fwRunning) {
+        m_counters.commandErrors.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const EmulatorCommand command{ic.side, slot, ReadByte(ic, base + 2), ReadByte(ic, base + 4)};
+    if (command.id == 0x0A) {
+        m_idle.store(true, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(m_configMutex);
+        SetFrameInterval(m_timing.idleIntervalUs);
+    } else if (command.id == 0x0B) {
+        m_idle.store(false, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(m_configMutex);
+        SetFrameInterval(m_timing.frameIntervalUs);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_configMutex);
+        m_commands.push_back(command);
+    }
+    m_counters.commands.fetch_add(1, std::memory_order_relaxed);
+
+    // 处理完毕：清除包头，推进槽位
+    WriteByte(ic, base, 0);
+    WriteByte(ic, base + 1, 0);
+    ic.commandSlot = static_cast<uint8_t>((slot + 1) % kCommandSlots);
+}
+
+// ---------------------------------------------------------
+// 帧节拍 (调用方持有 m_configMutex)
+
+int64_t HimaxEmulator::CurrentTick(Clock::time_point now) const {
+    if (m_frameIntervalUs == 0) return INT64_MAX;
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - m_tickEpoch).count();
+    return m_tickBase + elapsed / m_frameIntervalUs;
+}
+
+HimaxEmulator::Clock::time_point HimaxEmulator::TickTime(int64_t tick) const {
+    return m_tickEpoch + std::chrono::microseconds((tick - m_tickBase) * static_cast<int64_t>(m_frameIntervalUs));
+}
+
+// 周期变化时保持帧号连续
+void HimaxEmulator::SetFrameInterval(uint32_t intervalUs) {
+    if (intervalUs == m_frameIntervalUs) return;
+    const Clock::time_point now = Clock::now();
+    if (m_frameIntervalUs != 0) m_tickBase = CurrentTick(now);
+    m_tickEpoch = now;
+    m_frameIntervalUs = intervalUs;
+}
+
+// ---------------------------------------------------------
+// 事务
+
+HimaxEmulator::Clock::duration HimaxEmulator::Cost(uint32_t bytes) const {
+    std::lock_guard<std::mutex> lock(m_configMutex);
+    return std::chrono::microseconds(m_timing.transactionUs) +
+           std::chrono::nanoseconds(static_cast<uint64_t>(bytes) * m_timing.byteNs);
+}
+
+bool HimaxEmulator::Batched() const {
+    std::lock_guard<std::mutex> lock(m_configMutex);
+    return m_timing.batchedTransfers;
+}
+
+// 长于 1 ms 的部分交给 sleep，余下自旋，使微秒级事务延迟不受调度粒度影响
+void HimaxEmulator::Wait(Clock::duration duration) {
+    if (duration <= Clock::duration::zero()) return;
+    const Clock::time_point until = Clock::now() + duration;
+    if (duration > std::chrono::milliseconds(1)) {
+        std::this_thread::sleep_for(duration - std::chrono::microseconds(500));
+    }
+    // 让出 CPU：两颗芯片的等待在单核上也能重叠
+    while (Clock::now() < until) {
+        std::this_thread::yield();
+    }
+}
+
+bool HimaxEmulator::Roll(Ic& ic, double rate) {
+    if (rate <= 0.0) return false;
+    ic.rng ^= ic.rng << 13;
+    ic.rng ^= ic.rng >> 17;
+    ic.rng ^= ic.rng << 5;
+    return (ic.rng & 0xFFFFFF) < rate * 0x1000000;
+}
+
+ChipResult<> HimaxEmulator::Begin(Ic& ic, uint32_t& error) {
+    const uint64_t count = m_counters.transactions.fetch_add(1, std::memory_order_relaxed) + 1;
+    Advance(ic, Clock::now());
+
+    double busErrorRate;
+    uint64_t disconnectAfter;
+    {
+        std::lock_guard<std::mutex> lock(m_configMutex);
+        busErrorRate = m_faults.busErrorRate;
+        disconnectAfter = m_faults.disconnectAfter;
+    }
+    if (disconnectAfter != 0 && count > disconnectAfter) {
+        error = ENODEV;
+        return std::unexpected(ChipError::CommunicationError);
+    }
+    if (Roll(ic, busErrorRate)) {
+        m_counters.injectedFaults.fetch_add(1, std::memory_order_relaxed);
+        error = EIO;
+        return std::unexpected(ChipError::CommunicationError);
+    }
+    error = 0;
+    return {};
+}
+
+// 单相读写的效果 (调用方持有 ic.mutex，已通过 Begin)；返回本相在总线上的字节数
+uint32_t HimaxEmulator::ApplyRead(Ic& ic, uint8_t cmd, uint8_t* data, uint32_t len) {
+    m_counters.busReads.fetch_add(1, std::memory_order_relaxed);
+
+    if (cmd == kBusAhbData && !ic.readArmed) {
+        // 未设读方向：只唤醒总线 (interface_on 的 dummy read)，不访问 AHB
+        std::memset(data, 0, len);
+    } else if (cmd == kBusAhbData) {
+        ic.readArmed = false;
+        const bool burst = ic.busRegs[kBusConti] == 0x31 && (ic.busRegs[kBusIncr4] & 1);
+        const uint32_t addr = ic.ahbAddr;
+        for (uint32_t i = 0; i < len; ++i) {
+            if (addr + i == kAddrFwStatus) {
+                // FW 状态由仿真状态派生
+                const bool safeMode = ic.busRegs[kBusPswLb] == 0x27 && ic.busRegs[kBusPswLb + 1] == 0x95;
+                data[i] = safeMode ? 0x0C : (ic.fwRunning ? 0x05 : 0x00);
+                continue;
+            }
+            data[i] = ReadByte(ic, burst ? addr + i : addr + (i & 3u));
+        }
+    } else {
+        for (uint32_t i = 0; i < len; ++i) data[i] = ic.busRegs[(cmd + i) & 0xFF];
+    }
+
+    double corruptRate;
+    {
+        std::lock_guard<std::mutex> lock(m_configMutex);
+        corruptRate = m_faults.corruptReadRate;
+    }
+    if (len > 0 && Roll(ic, corruptRate)) {
+        m_counters.injectedFaults.fetch_add(1, std::memory_order_relaxed);
+        data[ic.rng % len] ^= static_cast<uint8_t>(1u << (ic.rng >> 8 & 7u));
+    }
+    return kReadDataOffset + len;
+}
+
+uint32_t HimaxEmulator::ApplyWrite(Ic& ic, uint8_t cmd, const uint8_t* addr, const uint8_t* data, uint32_t len) {
+    const uint32_t payload = (data ? len : 0);
+    m_counters.busWrites.fetch_add(1, std::memory_order_relaxed);
+
+    if (cmd == kBusAhbAddr) {
+        if (addr) {
+            ic.ahbAddr = addr[0] | (addr[1] << 8) | (addr[2] << 16) | (static_cast<uint32_t>(addr[3]) << 24);
+            ic.readArmed = false;
+        }
+        if (payload > 0) {
+            // 非 burst 时地址不递增，每个字覆盖同一位置
+            const bool burst = ic.busRegs[kBusConti] == 0x31 && (ic.busRegs[kBusIncr4] & 1);
+            for (uint32_t i = 0; i < payload; ++i) {
+                WriteByte(ic, burst ? ic.ahbAddr + i : ic.ahbAddr + (i & 3u), data[i]);
+            }
+            OnAhbWrite(ic, ic.ahbAddr, burst ? payload : std::min<uint32_t>(payload, 4));
+        }
+    } else if (cmd == kBusDirection) {
+        ic.readArmed = payload > 0 && data[0] == 0x00;
+    } else {
+        for (uint32_t i = 0; i < payload; ++i) ic.busRegs[(cmd + i) & 0xFF] = data[i];
+    }
+    return 2 + (addr ? 4 : 0) + payload;
+}
+
+ChipResult<> HimaxEmulator::ReadBus(Ic& ic, uint8_t cmd, uint8_t* data, uint32_t len, uint32_t& error) {
+    const BusPhase phase{true, cmd, nullptr, nullptr, data, len};
+    return Transfer(ic, &phase, 1, error);
+}
+
+ChipResult<> HimaxEmulator::WriteBus(Ic& ic, uint8_t cmd, const uint8_t* addr, const uint8_t* data, uint32_t len,
+                                     uint32_t& error) {
+    const BusPhase phase{false, cmd, addr, data, nullptr, len};
+    return Transfer(ic, &phase, 1, error);
+}
+
+// 一次往返：固定开销只计一次，字节按各相之和
+ChipResult<> HimaxEmulator::Transfer(Ic& ic, const BusPhase* phases, size_t count, uint32_t& error) {
+    uint32_t bytes = 0;
+    {
+        std::lock_guard<std::mutex> lock(ic.mutex);
+        if (auto res = Begin(ic, error); !res) return res;
+        for (size_t i = 0; i < count; ++i) {
+            const BusPhase& p = phases[i];
+            bytes += p.read ? ApplyRead(ic, p.cmd, p.out, p.len) : ApplyWrite(ic, p.cmd, p.addr, p.data, p.len);
+        }
+        m_counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    Wait(Cost(bytes));
+    return {};
+}
+
+ChipResult<> HimaxEmulator::Control(Ic& ic, const std::function<void(Ic&)>& apply, uint32_t& error) {
+    {
+        std::lock_guard<std::mutex> lock(ic.mutex);
+        if (auto res = Begin(ic, error); !res) return res;
+        m_counters.controls.fetch_add(1, std::memory_order_relaxed);
+        apply(ic);
+    }
+    Wait(Cost(0));
+    return {};
+}
+
+ChipResult<> HimaxEmulator::SetReset(bool state, uint32_t& error) {
+    {
+        std::scoped_lock lock(m_master.mutex, m_slave.mutex);
+        if (auto res = Begin(m_master, error); !res) return res;
+        m_counters.controls.fetch_add(1, std::memory_order_relaxed);
+
+        const Clock::time_point now = Clock::now();
+        if (!state && !m_resetLow) {
+            m_counters.resets.fetch_add(1, std::memory_order_relaxed);
+            // 复位脚释放 (SetReset(true)) 时才开始重载计时
+            ResetIc(m_master, Clock::time_point::max());
+            ResetIc(m_slave, Clock::time_point::max());
+        } else if (state && m_resetLow) {
+            uint32_t reloadMs;
+            {
+                std::lock_guard<std::mutex> config(m_configMutex);
+                reloadMs = m_timing.reloadMs;
+            }
+            m_master.reloadDoneAt = m_slave.reloadDoneAt = now + std::chrono::milliseconds(reloadMs);
+        }
+        m_resetLow = !state;
+    }
+    Wait(Cost(0));
+    return {};
+}
+
+ChipResult<> HimaxEmulator::WaitInterrupt(Ic& ic, uint32_t& error) {
+    Clock::time_point readyAt;
+    {
+        std::lock_guard<std::mutex> lock(ic.mutex);
+        if (auto res = Begin(ic, error); !res) return res;
+        m_counters.controls.fetch_add(1, std::memory_order_relaxed);
+        if (!ic.interruptOpen) {
+            m_counters.protocolErrors.fetch_add(1, std::memory_order_relaxed);
+            error = ENODEV;
+            return std::unexpected(ChipError::CommunicationError);
+        }
+        // 只等待下一帧就绪，不领取帧号
+        std::lock_guard<std::mutex> config(m_configMutex);
+        const Clock::time_point now = Clock::now();
+        if (!StreamingLocked(ic)) {
+            readyAt = Clock::time_point::max();
+        } else if (Roll(ic, m_faults.frameTimeoutRate)) {
+            m_counters.injectedFaults.fetch_add(1, std::memory_order_relaxed);
+            readyAt = Clock::time_point::max();
+        } else if (m_frameIntervalUs == 0) {
+            readyAt = now;
+        } else {
+            readyAt = TickTime(std::max(ic.lastFrame + 1, CurrentTick(now)));
+        }
+    }
+    const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(200);
+    if (readyAt > deadline) {
+        Wait(deadline - Clock::now());
+        m_counters.frameTimeouts.fetch_add(1, std::memory_order_relaxed);
+        error = ETIMEDOUT;
+        return std::unexpected(ChipError::Timeout);
+    }
+    Wait(readyAt - Clock::now());
+    return {};
+}
+
+ChipResult<> HimaxEmulator::GetFrame(Ic& ic, uint8_t* buffer, uint32_t len, uint32_t& error) {
+    int64_t frame = 0;
+    Clock::time_point readyAt;
+    Clock::time_point deadline;
+    bool block;
+    bool hang = false;
+    uint32_t hangMs = 0;
+    {
+        std::lock_guard<std::mutex> lock(ic.mutex);
+        if (auto res = Begin(ic, error); !res) return res;
+        if (!ic.interruptOpen) {
+            m_counters.protocolErrors.fetch_add(1, std::memory_order_relaxed);
+            error = ENODEV;
+            return std::unexpected(ChipError::CommunicationError);
+        }
+        block = ic.block;
+        const Clock::time_point now = Clock::now();
+        deadline = now + std::chrono::milliseconds(ic.timeoutMs);
+
+        std::lock_guard<std::mutex> config(m_configMutex);
+        bool timeout = !StreamingLocked(ic);
+        if (!timeout && Roll(ic, m_faults.frameTimeoutRate)) {
+            m_counters.injectedFaults.fetch_add(1, std::memory_order_relaxed);
+            timeout = true;
+        }
+        if (!timeout && Roll(ic, m_faults.frameHangRate)) {
+            m_counters.injectedFaults.fetch_add(1, std::memory_order_relaxed);
+            hang = true;
+            hangMs = m_faults.frameHangMs;
+        }
+        if (hang) {
+            readyAt = Clock::time_point::max();
+        } else if (timeout) {
+            readyAt = Clock::time_point::max();
+        } else if (m_frameIntervalUs == 0) {
+            frame = ic.lastFrame + 1;
+            readyAt = now;
+        } else {
+            const int64_t current = CurrentTick(now);
+            // 无中断线时不等待：读出最近一次完成的扫描，两次读之间没有新扫描则重复上一帧
+            frame = HasInterruptLocked(ic) ? std::max(ic.lastFrame + 1, current) : current;
+            if (ic.lastFrame >= 0 && current > ic.lastFrame + 1) {
+                m_counters.framesOverrun.fetch_add(current - ic.lastFrame - 1, std::memory_order_relaxed);
+            }
+            readyAt = TickTime(frame);
+        }
+        // 先占住帧号：即使本次等待超时，下一次也不会重复领取同一帧之前的帧
+        if (readyAt <= deadline && (block || readyAt <= now)) ic.lastFrame = frame;
+    }
+
+    // 挂起不受驱动超时约束：调用方只能靠自己的截止时间脱身
+    if (hang) {
+        Wait(std::chrono::milliseconds(hangMs));
+        m_counters.framesHung.fetch_add(1, std::memory_order_relaxed);
+        error = ETIMEDOUT;
+        return std::unexpected(ChipError::Timeout);
+    }
+
+    if (readyAt > deadline || (!block && readyAt > Clock::now())) {
+        if (block) Wait(deadline - Clock::now());
+        m_counters.frameTimeouts.fetch_add(1, std::memory_order_relaxed);
+        error = ETIMEDOUT;
+        return std::unexpected(ChipError::Timeout);
+    }
+    Wait(readyAt - Clock::now());
+
+    std::shared_ptr<const FrameFiller> filler;
+    {
+        std::lock_guard<std::mutex> lock(m_configMutex);
+        filler = m_filler;
+    }
+    if (filler) {
+        (*filler)(ic.side, static_cast<uint64_t>(frame), buffer, len);
+    } else {
+        std::memset(buffer, 0, len);
+        for (uint32_t i = 0; i < std::min<uint32_t>(len, 4); ++i) buffer[i] = static_cast<uint8_t>(frame >> (8 * i));
+    }
+    m_counters.framesServed.fetch_add(1, std::memory_order_relaxed);
+    m_counters.bytes.fetch_add(len, std::memory_order_relaxed);
+    Wait(Cost(len));
+    return {};
+}
+
+} // namespace Himax
@@ -7,404 +7,208 @@
  * @Description: 这是默认设置,请设置`customMade`, 打开koroFileHeader查看配置 进行设置: https://github.com/OBKoro1/koro1FileHeader/wiki/%E9%85%8D%E7%BD%AE
  */
 #include "HimaxProtocol.h"
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <array>
-#include <errhandlingapi.h>
-#include <handleapi.h>
-#include <ioapiset.h>
-#include <minwindef.h>
-#include <synchapi.h>
-#include <windows.h>
-#include <winscard.h>
-
-using Himax::ChipError;
-using Himax::ChipResult;
-
-constexpr uint8_t OP_WRITE_MASTER = 0xF2;
-constexpr uint8_t OP_READ_MASTER  = 0xF3;
-constexpr uint8_t OP_WRITE_SLAVE  = 0xF4;
-constexpr uint8_t OP_READ_SLAVE   = 0xF5;
-
-const DWORD SPI_IOCTL_INT_OPEN    = 0x4001c00; // 打开中断/初始化
-const DWORD SPI_IOCTL_INT_CLOSE   = 0x4001c04; // 关闭中断
-const DWORD SPI_IOCTL_WRITEREAD   = 0x4001c10; // [不常用] 偶见于特定初始化流
-const DWORD SPI_IOCTL_WAIT_INT    = 0x4001c20; // 等待中断触发
-const DWORD SPI_IOCTL_FULL_DUPLEX = 0x4001c24; // [核心] BusRead / 全双工读
-const DWORD SPI_IOCTL_GET_FRAME   = 0x4001c28; // 获取帧数据
-const DWORD SPI_IOCTL_SET_TIMEOUT = 0x4001c2c; // 设置超时
-const DWORD SPI_IOCTL_SET_BLOCK   = 0x4001c30; // 设置阻塞模式
-const DWORD SPI_IOCTL_SET_RESET   = 0x4001c34; // 复位设备
-const DWORD SPI_IOCTL_READ_ACPI   = 0x4001c38; // 读取 ACPI 配置
-
-namespace {
-
-    /**
-     * @brief 执行同步 I/O 操作（封装 Overlapped 异步操作为同步）
-     * @param handle 文件句柄
-     * @param mutex 互斥锁
-     * @param lastError 错误码输出
-     * @param ioFunc I/O 函数 lambda
-     * @param expectedLen 预期长度
-     * @param checkLen 是否检查长度
-     * @param outBytes 实际传输字节数输出
-     * @return bool 是否成功
-     */
-    template<typename Func>
-    Himax::ChipResult<> PerformSyncIo(HANDLE handle, DWORD& lastError, Func ioFunc, Himax::ChipError errType, DWORD expectedLen = 0, bool checkLen = false, DWORD* outBytes = NULL) {
-        if (handle == INVALID_HANDLE_VALUE) {
-            lastError = ERROR_INVALID_HANDLE;
-            return std::unexpected(Himax::ChipError::CommunicationError);
-        }
-        OVERLAPPED ov = {0};
-        ov.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
-        if (!ov.hEvent) {
-            lastError = GetLastError();
-            return std::unexpected(Himax::ChipError::InternalError);
-        }
-
-        DWORD bytesTransferred = 0;
-        BOOL res = ioFunc(&ov, &bytesTransferred);
-
-        if (!res) {
-            DWORD err = GetLastError();
-            if (err == ERROR_IO_PENDING) {
-                if (WaitForSingleObject(ov.hEvent, INFINITE) == WAIT_OBJECT_0) {
-                    res = GetOverlappedResult(handle, &ov, &bytesTransferred, TRUE);
-                    if (!res) lastError = GetLastError();
-                } else {
-                    lastError = GetLastError();
-                }
-            } else {
-                lastError = err;
-            }
-        }
-        CloseHandle(ov.hEvent);
-
-        if (!res) return std::unexpected(errType);
-        if (checkLen && bytesTransferred != expectedLen) {
-            lastError = ERROR_WRITE_FAULT;
-            return std::unexpected(ChipError::CommunicationError);
-        }
-        
-        if (outBytes) *outBytes = bytesTransferred;
-        lastError = 0;
-        return {};
-    }
-}
+#include <vector>
 
 namespace Himax {
 
-    /**
-     * @brief 构造函数，打开设备句柄并初始化
-     * @param path 设备路径
-     * @param type 设备类型 (Master/Slave/Interrupt)
-     */
-    HalDevice::HalDevice(const wchar_t* path, DeviceType type) : m_handle(INVALID_HANDLE_VALUE), m_lastError(0), m_type(type) {
-        m_xfer_buffer.reserve(0x4000 + 32);
-
-        m_handle = CreateFileW(
-            path, 
-            GENERIC_ALL, 
-            FILE_SHARE_READ | FILE_SHARE_WRITE, 
-            NULL, 
-            OPEN_EXISTING, 
-            FILE_FLAG_OVERLAPPED, 
-            NULL
-        );
-        if (m_handle == INVALID_HANDLE_VALUE) {
-            m_lastError = GetLastError();
-        }
-
-        m_ov.hEvent = CreateEvent(nullptr, true, false, nullptr);
-        if (m_ov.hEvent == nullptr) {
-            m_lastError = GetLastError();
-            if (m_handle != INVALID_HANDLE_VALUE) {
-                CloseHandle(m_handle);
-                m_handle = INVALID_HANDLE_VALUE;
-            }
-            return;
-        }
-        if (type == DeviceType::Slave) {
-            m_readOp = OP_READ_SLAVE;
-            m_writeOp = OP_WRITE_SLAVE;
-        } else {
-            m_readOp = OP_READ_MASTER;
-            m_writeOp = OP_WRITE_MASTER;
-        }
+    namespace {
+        // 总线寄存器
+        constexpr uint8_t kBusAhbAddr = 0x00;
+        constexpr uint8_t kBusAhbData = 0x08;
+        constexpr uint8_t kBusDirection = 0x0C;
+        constexpr uint8_t kBusIncr4 = 0x0D;
+        constexpr uint8_t kBusConti = 0x13;
+        constexpr uint8_t kContiValue = 0x31;
+        constexpr uint8_t kIncr4Base = 0x12;       // | 1 = burst
+        constexpr uint32_t kAddrSystemReset = 0x90000018;
     }
 
-    /**
-     * @brief 析构函数，关闭句柄
-     */
-    HalDevice::~HalDevice() {
-        if (m_ov.hEvent) {
-            CloseHandle(m_ov.hEvent);
-            m_ov.hEvent = nullptr;
-        }
-        
-        if (IsValid()) {
-            CloseHandle(m_handle);
-            m_handle = INVALID_HANDLE_VALUE;
+    const char* BusOperationName(BusOperation op) {
+        switch (op) {
+            case BusOperation::RegisterRead: return "register_read";
+            case BusOperation::RegisterWrite: return "register_write";
+            case BusOperation::WriteAndVerify: return "write_and_verify";
+            case BusOperation::SendCommand: return "send_command";
+            case BusOperation::ReadFwStatus: return "read_FW_status";
+            case BusOperation::BurstEnable: return "burst_enable";
+            case BusOperation::Raw: return "raw ReadBus/WriteBus";
+            default: return "unknown";
         }
     }
 
     /**
-     * @brief 检查设备句柄是否有效
-     * @return bool 是否有效
+     * @brief 构造函数，接管总线后端
+     * @param transport 总线后端 (不可为空)
+     * @param type 设备类型 (Master/Slave/Interrupt)
      */
-    bool HalDevice::IsValid() const {return m_handle != INVALID_HANDLE_VALUE;}
+    HalDevice::HalDevice(std::unique_ptr<ITransport> transport, DeviceType type)
+        : m_transport(std::move(transport)), m_type(type) {}
 
+#if defined(_WIN32)
     /**
-     * @brief 执行 DeviceIoControl 操作
-     * @param code 控制码
-     * @param in 输入缓冲区
-     * @param inLen 输入长度
-     * @param out 输出缓冲区
-     * @param outLen 输出长度
-     * @param retLen 实际返回长度
-     * @return bool 是否成功
+     * @brief 构造函数，以 SPBTESTTOOL 设备路径打开句柄
+     * @param path 设备路径
+     * @param type 设备类型 (Master/Slave/Interrupt)
      */
-    ChipResult<> HalDevice::Ioctl(DWORD code, const void* in, uint32_t inLen, void* out, uint32_t outLen, uint32_t* retLen) {
-        ChipResult<> result = std::unexpected(ChipError::InternalError);
-        for (int cnt = 0; cnt < 10; cnt++) {
-            result = PerformSyncIo(m_handle, m_lastError, [&](OVERLAPPED* pov, LPDWORD pBytes) {
-                return DeviceIoControl(m_handle, code, (LPVOID)in, inLen, out, outLen, pBytes, pov);
-            }, ChipError::CommunicationError, 0, false, (DWORD*)retLen);
-            if (result) break;
-        }
+    HalDevice::HalDevice(const wchar_t* path, DeviceType type)
+        : HalDevice(OpenSpbTestToolTransport(path, type), type) {}
+#endif
 
-        return result;
-    }
+    HalDevice::~HalDevice() = default;
 
     /**
-     * @brief 从设备读取原始数据
-     * @param buffer 缓冲区
-     * @param len 读取长度
-     * @return bool 是否成功
+     * @brief 检查设备是否已打开
+     * @return bool 是否有效
      */
-    ChipResult<> HalDevice::Read(void* buffer, uint32_t len) {
-        return PerformSyncIo(m_handle, m_lastError, [&](OVERLAPPED* pov, LPDWORD pBytes){
-            return ReadFile(m_handle, buffer, len, pBytes, pov);
-        }, ChipError::CommunicationError);
-    }
+    bool HalDevice::IsValid() const { return m_transport && m_transport->IsValid(); }
 
     /**
      * @brief 等待设备中断触发
-     * @return bool 是否成功触发
      */
-    ChipResult<> HalDevice::WaitInterrupt() {
-        if (!IsValid() || !m_ov.hEvent) { 
-            m_lastError = ERROR_INVALID_HANDLE;
-            return std::unexpected(ChipError::CommunicationError); 
-        }
-
-        ResetEvent(m_ov.hEvent);
-        
-        DWORD bytesReturned = 0;
-        BOOL res = DeviceIoControl(
-            m_handle,
-            SPI_IOCTL_WAIT_INT,
-            nullptr, 0,
-            nullptr, 0,
-            &bytesReturned, &m_ov
-        );
-
-        if (!res && GetLastError() != ERROR_IO_PENDING) {
-            m_lastError = GetLastError();
-            return std::unexpected(ChipError::CommunicationError);
-        }
-
-        DWORD waitResult = WaitForSingleObject(m_ov.hEvent, 200);
-
-        if (waitResult != WAIT_OBJECT_0) {
-            m_lastError = (waitResult == WAIT_FAILED) ? GetLastError() : ERROR_GEN_FAILURE;
-            return std::unexpected(ChipError::Timeout);
-        }
-
-        BOOL ok = GetOverlappedResult(m_handle, &m_ov, &bytesReturned, FALSE);
-        if (!ok) {
-            m_lastError = GetLastError();
-            return std::unexpected(ChipError::CommunicationError);
-        }
-
-        ResetEvent(m_ov.hEvent);
-        m_lastError = 0;
-        return {};
-    }
-
+    ChipResult<> HalDevice::WaitInterrupt() { return m_transport->WaitInterrupt(); }
 
     /**
      * @brief 通过总线读取数据
      * @param cmd 命令码
      * @param data 接收缓冲区
      * @param len 读取长度
-     * @return bool 是否成功
      */
     ChipResult<> HalDevice::ReadBus(uint8_t cmd, uint8_t* data, uint32_t len) {
-        size_t total_size = data_offset + len;
-
-        m_xfer_buffer.clear();
-
-        m_xfer_buffer.push_back(m_readOp);
-        m_xfer_buffer.push_back(cmd);
-        m_xfer_buffer.push_back(0x00);      //Dummy Byte
-        
-        m_xfer_buffer.resize(total_size, 0);
-
-        uint32_t retLen = 0;
-        auto res = Ioctl(SPI_IOCTL_FULL_DUPLEX, 
-                            m_xfer_buffer.data(), m_xfer_buffer.size(), 
-                            m_xfer_buffer.data(), m_xfer_buffer.size(), 
-                            &retLen);
-        
-        if (!res) return std::unexpected(ChipError::CommunicationError);
-
-        if (retLen < total_size) {
-            return std::unexpected(ChipError::CommunicationError);
-        }
-
-        memcpy(data, m_xfer_buffer.data() + data_offset, len);
-        
-        return {};
+        BusPhase phase{true, cmd, nullptr, nullptr, data, len};
+        CountOperation(BusOperation::Raw, 0);
+        return Transfer(BusOperation::Raw, &phase, 1);
     }
 
     /**
      * @brief 通过总线写入数据
      * @param cmd 命令码
-     * @param addr 地址 (可选)
+     * @param addr 地址 (可选，4 字节)
      * @param data 数据缓冲区
      * @param len 数据长度
-     * @return bool 是否成功
      */
     ChipResult<> HalDevice::WriteBus(const uint8_t cmd, const uint8_t* addr, const uint8_t* data, const uint32_t len) {
-        m_xfer_buffer.clear();
-
-        m_xfer_buffer.clear();
-        m_xfer_buffer.push_back(m_writeOp);
-        m_xfer_buffer.push_back(cmd);
-
-        if (addr != NULL) {
-            m_xfer_buffer.insert(m_xfer_buffer.end(), addr, addr + 4);
-        }
-        if (data != NULL) {
-            m_xfer_buffer.insert(m_xfer_buffer.end(), data, data + len);
-        }
-
-
-        return PerformSyncIo(m_handle, m_lastError, [&](OVERLAPPED* pov, LPDWORD pBytes){
-            return WriteFile(m_handle, m_xfer_buffer.data(), (DWORD)m_xfer_buffer.size(), NULL, pov);
-        }, ChipError::CommunicationError);
+        BusPhase phase{false, cmd, addr, data, nullptr, len};
+        CountOperation(BusOperation::Raw, 0);
+        return Transfer(BusOperation::Raw, &phase, 1);
     }
 
     /**
      * @brief 读取 ACPI 配置数据
-     * @param data 接收缓冲区
-     * @param len 读取长度
-     * @return bool 是否成功
      */
-    ChipResult<> HalDevice::ReadAcpi(uint8_t* data, uint32_t len) {
-        m_xfer_buffer.assign(len, 0);
-        
-        uint32_t retLen = 0;
-
-        auto res = Ioctl(SPI_IOCTL_READ_ACPI, nullptr, 0, m_xfer_buffer.data(), len, &retLen);
-        if (!res) return std::unexpected(ChipError::CommunicationError);
-
-        if (retLen < len) {
-            return std::unexpected(ChipError::CommunicationError);
-        }
-        
-        memcpy(data, m_xfer_buffer.data(), len);
-        return {};
-    }
+    ChipResult<> HalDevice::ReadAcpi(uint8_t* data, uint32_t len) { return m_transport->ReadAcpi(data, len); }
 
     /**
      * @brief 获取一帧完整的触摸数据
      * @param buffer 接收缓冲区
      * @param outLen 缓冲区长度
-     * @param retLen 实际返回长度
-     * @return bool 是否成功
+     * @param retLen 实际返回长度 (可为空)
      */
-    ChipResult<> HalDevice::GetFrame(void* buffer, uint32_t outLen, uint32_t *retLen){
-        return Ioctl(SPI_IOCTL_GET_FRAME, NULL, 0, buffer, outLen, retLen);
+    ChipResult<> HalDevice::GetFrame(void* buffer, uint32_t outLen, uint32_t* retLen) {
+        return m_transport->GetFrame(buffer, outLen, retLen);
+    }
+
+    ChipResult<IoTicket> HalDevice::SubmitFrame(uint32_t len, IoClock::time_point deadline) {
+        return m_transport->SubmitFrame(len, deadline);
+    }
+
+    ChipResult<> HalDevice::CompleteFrame(IoTicket ticket, void* buffer, uint32_t len, uint32_t* retLen) {
+        return m_transport->CompleteFrame(ticket, buffer, len, retLen);
     }
 
     /**
-     * @brief 设置 I/O 超时时间
-     * @param milisecond 毫秒数
-     * @return bool 是否成功
+     * @brief 设置 I/O 超时时间 (毫秒)
      */
-    ChipResult<> HalDevice::SetTimeOut(uint8_t milisecond) {
-        uint32_t timeout = static_cast<uint32_t>(milisecond);
-        return Ioctl(SPI_IOCTL_SET_TIMEOUT, &timeout, sizeof(timeout), NULL, 0, NULL);
+    ChipResult<> HalDevice::SetTimeOut(uint8_t millisecond) {
+        auto res = m_transport->SetTimeOut(millisecond);
+        if (res) m_frameTimeoutMs = millisecond;
+        return res;
     }
 
     /**
      * @brief 设置阻塞或非阻塞模式
      * @param state true 为阻塞, false 为非阻塞
-     * @return bool 是否成功
      */
-    ChipResult<> HalDevice::SetBlock(bool state) {
-        m_xfer_buffer.clear();
-
-        m_xfer_buffer.clear();
-        m_xfer_buffer.push_back(uint8_t(state));
-        m_xfer_buffer.resize(4, 0);
-
-        return Ioctl(SPI_IOCTL_SET_BLOCK, m_xfer_buffer.data(), 4, NULL, 0, NULL);          
-    }
+    ChipResult<> HalDevice::SetBlock(bool state) { return m_transport->SetBlock(state); }
 
     /**
      * @brief 设置设备复位状态
      * @param state true 为拉高复位, false 为拉低复位
-     * @return bool 是否成功
      */
     ChipResult<> HalDevice::SetReset(bool state) {
-        uint32_t val = state ? 1 : 0;
-        return Ioctl(SPI_IOCTL_SET_RESET, &val, sizeof(val), NULL, 0, NULL);  
+        InvalidateBusState();
+        return m_transport->SetReset(state);
     }
 
     /**
-     * @brief 打开中断监听
-     * @return bool 是否成功
+     * @brief 打开 / 关闭中断监听
      */
-    ChipResult<> HalDevice::IntOpen(void) {
-        return Ioctl(SPI_IOCTL_INT_OPEN, NULL, 0, NULL, 0, NULL);
-    }
+    ChipResult<> HalDevice::IntOpen(void) { return m_transport->IntOpen(); }
+    ChipResult<> HalDevice::IntClose(void) { return m_transport->IntClose(); }
 
     /**
-     * @brief 关闭中断监听
-     * @return bool 是否成功
+     * @brief 获取最后一次发生的错误码
+     * @return uint32_t 平台错误码 (Win32 GetLastError / errno)
      */
-    ChipResult<> HalDevice::IntClose(void) {
-        return Ioctl(SPI_IOCTL_INT_CLOSE, NULL, 0, NULL, 0, NULL);
-    }
+    uint32_t HalDevice::GetError() { return m_transport->GetError(); }
 
     /**
-     * @brief 获取最后一次发生的错误码
-     * @return DWORD Windows 错误码
+     * @brief 以一次后端 Transfer 执行多相；失败时作废已知的 burst 状态
      */
-    DWORD HalDevice::GetError() {
-        return m_lastError;
+    ChipResult<> HalDevice::Transfer(BusOperation op, const BusPhase* phases, size_t count) {
+        if (count == 0) return {};
+        CountTransfer(op, m_transport->BatchesTransfers() ? 1 : count, count);
+        if (auto res = m_transport->Transfer(phases, count); !res) {
+            InvalidateBusState();
+            return res;
+        }
+        for (size_t i = 0; i < count; ++i) Track(phases[i]);
+        return {};
     }
 
-    ChipResult<> HimaxProtocol::burst_enable(HalDevice *dev, bool isEnable) {
-        if (!dev || !dev->IsValid()) return std::unexpected(ChipError::CommunicationError);
-
-        uint8_t tmp_data[4]{};
-        tmp_data[0] = 0x31;
-
-        if (auto res = dev->WriteBus(0x13, nullptr, tmp_data, 1); !res) {
-            return res;
+    /**
+     * @brief 跟踪写入 conti / incr4 的值；写系统复位寄存器后总线接口随芯片复位
+     */
+    void HalDevice::Track(const BusPhase& phase) {
+        if (phase.read || phase.data == nullptr) return;
+        if (phase.cmd == kBusAhbAddr) {
+            if (phase.addr != nullptr) {
+                const uint32_t addr = phase.addr[0] | (phase.addr[1] << 8) | (phase.addr[2] << 16) |
+                                      (static_cast<uint32_t>(phase.addr[3]) << 24);
+                if (addr == kAddrSystemReset) InvalidateBusState();
+            }
+            return;
+        }
+        for (uint32_t i = 0; i < phase.len; ++i) {
+            const uint8_t reg = static_cast<uint8_t>(phase.cmd + i);
+            if (reg == kBusConti) m_conti = phase.data[i];
+            if (reg == kBusIncr4) m_incr4 = phase.data[i];
         }
+    }
 
-        tmp_data[0] = (0x12 | isEnable);
+    void HalDevice::CountOperation(BusOperation op, uint64_t burstSkipped) {
+        BusOperationStats& stats = m_stats[static_cast<size_t>(op)];
+        stats.calls.fetch_add(1, std::memory_order_relaxed);
+        if (burstSkipped) stats.burstSkipped.fetch_add(burstSkipped, std::memory_order_relaxed);
+    }
 
-        if (auto res = dev->WriteBus(0x0D, nullptr, tmp_data, 1); !res) {
-            return res;
+    void HalDevice::CountTransfer(BusOperation op, uint64_t roundTrips, uint64_t phases) {
+        BusOperationStats& stats = m_stats[static_cast<size_t>(op)];
+        stats.roundTrips.fetch_add(roundTrips, std::memory_order_relaxed);
+        stats.phases.fetch_add(phases, std::memory_order_relaxed);
+    }
+
+    void HalDevice::ResetStats() {
+        for (BusOperationStats& stats : m_stats) {
+            stats.calls.store(0, std::memory_order_relaxed);
+            stats.roundTrips.store(0, std::memory_order_relaxed);
+            stats.phases.store(0, std::memory_order_relaxed);
+            stats.burstSkipped.store(0, std::memory_order_relaxed);
         }
-        return {};
     }
 
     /**
@@ -433,48 +237,153 @@ namespace Himax {
         }
     }
 
-    ChipResult<> HimaxProtocol::register_read(HalDevice *dev, const uint32_t addr, uint8_t *buffer, uint32_t len) {
-        if (!dev || !dev->IsValid()) return std::unexpected(ChipError::CommunicationError);
+    // ---------------------------------------------------------
+    // BusTransaction
 
-        uint8_t tmp_data[4];
-        himax_parse_assign_cmd(addr, tmp_data, 4);
+    HimaxProtocol::BusTransaction::BusTransaction(HalDevice* dev, BusOperation op)
+        : m_dev(dev), m_op(op),
+          m_conti(dev ? dev->KnownConti() : -1),
+          m_incr4(dev ? dev->KnownIncr4() : -1) {
+        if (!dev || !dev->IsValid()) m_status = std::unexpected(ChipError::CommunicationError);
+    }
 
-        if (len > 256) {
-            return std::unexpected(ChipError::InvalidOperation);
-        }
-        if (len > 4) {
-            if (auto res = burst_enable(dev, true); !res) return res;
+    BusPhase& HimaxProtocol::BusTransaction::Push(uint8_t*& scratch) {
+        if (m_count == kMaxPhases) Flush();
+        scratch = m_scratch[m_count].data();
+        m_phases[m_count] = BusPhase{};
+        return m_phases[m_count++];
+    }
+
+    /**
+     * @brief 设置 burst 模式；conti / incr4 已是目标值的写被省去
+     */
+    HimaxProtocol::BusTransaction& HimaxProtocol::BusTransaction::Burst(bool enable) {
+        if (!m_status) return *this;
+        const int incr4 = kIncr4Base | (enable ? 1 : 0);
+        uint8_t* scratch;
+        if (m_conti == kContiValue) {
+            ++m_skipped;
         } else {
-            if (auto res = burst_enable(dev, false); !res) return res;
-        }
+            BusPhase& phase = Push(scratch);
+            scratch[0] = kContiValue;
+            phase.cmd = kBusConti;
+            phase.data = scratch;
+            phase.len = 1;
+            m_conti = kContiValue;
+        }
+        if (m_incr4 == incr4) {
+            ++m_skipped;
+        } else {
+            BusPhase& phase = Push(scratch);
+            scratch[0] = static_cast<uint8_t>(incr4);
+            phase.cmd = kBusIncr4;
+            phase.data = scratch;
+            phase.len = 1;
+            m_incr4 = incr4;
+        }
+        return *this;
+    }
 
-        if (auto res = dev->WriteBus(0x00, tmp_data, nullptr, 0); !res) {
-            return res;
-        }
+    /**
+     * @brief AHB 写：地址与数据合为一相。data 须保持有效到 Commit
+     *
+     * 与原厂流程一致：超过 4 字节开启 burst，否则关闭；只有已知 incr4 已是目标值时才省去该写
+     */
+    HimaxProtocol::BusTransaction& HimaxProtocol::BusTransaction::Write(uint32_t addr, const uint8_t* data, uint32_t len) {
+        if (!m_status) return *this;
+        Burst(len > 4);
+        uint8_t* scratch;
+        BusPhase& phase = Push(scratch);
+        himax_parse_assign_cmd(addr, scratch, 4);
+        phase.cmd = kBusAhbAddr;
+        phase.addr = scratch;
+        phase.data = data;
+        phase.len = len;
+        return *this;
+    }
 
-        tmp_data[0] = 0;
-        if (auto res = dev->WriteBus(0x0C, nullptr, tmp_data, 1); !res) {
-            return res;
-        }
+    /**
+     * @brief AHB 读：地址、读方向、读数据三相。out 在 Commit 成功后有效
+     */
+    HimaxProtocol::BusTransaction& HimaxProtocol::BusTransaction::Read(uint32_t addr, uint8_t* out, uint32_t len) {
+        if (!m_status) return *this;
+        if (len > 256) {
+            m_status = std::unexpected(ChipError::InvalidOperation);
+            return *this;
+        }
+        Burst(len > 4);
+
+        uint8_t* scratch;
+        BusPhase& address = Push(scratch);
+        himax_parse_assign_cmd(addr, scratch, 4);
+        address.cmd = kBusAhbAddr;
+        address.addr = scratch;
+
+        BusPhase& direction = Push(scratch);
+        scratch[0] = 0x00;
+        direction.cmd = kBusDirection;
+        direction.data = scratch;
+        direction.len = 1;
+
+        BusPhase& read = Push(scratch);
+        read.read = true;
+        read.cmd = kBusAhbData;
+        read.out = out;
+        read.len = len;
+        return *this;
+    }
 
-        if (auto res = dev->ReadBus(0x08, buffer, len); !res) {
-            return res;
-        }
-        
-        return {};
+    HimaxProtocol::BusTransaction& HimaxProtocol::BusTransaction::WriteBus(uint8_t cmd, const uint8_t* data, uint32_t len) {
+        if (!m_status) return *this;
+        uint8_t* scratch;
+        BusPhase& phase = Push(scratch);
+        phase.cmd = cmd;
+        phase.data = data;
+        phase.len = len;
+        for (uint32_t i = 0; i < len; ++i) {
+            const uint8_t reg = static_cast<uint8_t>(cmd + i);
+            if (reg == kBusConti) m_conti = data[i];
+            if (reg == kBusIncr4) m_incr4 = data[i];
+        }
+        return *this;
     }
 
-    ChipResult<> HimaxProtocol::register_write(HalDevice *dev, const uint32_t addr, const uint8_t *data, uint32_t len) {
-        if (!dev || !dev->IsValid()) return std::unexpected(ChipError::CommunicationError);
-        uint8_t tmp_data[4];
-        himax_parse_assign_cmd(addr, tmp_data, 4);
+    HimaxProtocol::BusTransaction& HimaxProtocol::BusTransaction::ReadBus(uint8_t cmd, uint8_t* out, uint32_t len) {
+        if (!m_status) return *this;
+        uint8_t* scratch;
+        BusPhase& phase = Push(scratch);
+        phase.read = true;
+        phase.cmd = cmd;
+        phase.out = out;
+        phase.len = len;
+        return *this;
+    }
 
-        if (len > 4) {
-            if (auto res = burst_enable(dev, 1); !res) return res;
-        } else {
-            if (auto res = burst_enable(dev, 0); !res) return res;
+    ChipResult<> HimaxProtocol::BusTransaction::Flush() {
+        if (m_status && m_count > 0) {
+            m_status = m_dev->Transfer(m_op, m_phases.data(), m_count);
+            if (!m_status) m_conti = m_incr4 = -1;
         }
-        return dev->WriteBus(0x00, tmp_data, data, len);
+        m_count = 0;
+        return m_status;
+    }
+
+    ChipResult<> HimaxProtocol::BusTransaction::Commit() {
+        if (m_dev) m_dev->CountOperation(m_op, m_skipped);
+        m_skipped = 0;
+        return Flush();
+    }
+
+    ChipResult<> HimaxProtocol::burst_enable(HalDevice *dev, bool isEnable) {
+        return BusTransaction(dev, BusOperation::BurstEnable).Burst(isEnable).Commit();
+    }
+
+    ChipResult<> HimaxProtocol::register_read(HalDevice *dev, const uint32_t addr, uint8_t *buffer, uint32_t len) {
+        return BusTransaction(dev, BusOperation::RegisterRead).Read(addr, buffer, len).Commit();
+    }
+
+    ChipResult<> HimaxProtocol::register_write(HalDevice *dev, const uint32_t addr, const uint8_t *data, uint32_t len) {
+        return BusTransaction(dev, BusOperation::RegisterWrite).Write(addr, data, len).Commit();
     }
 
     void HimaxProtocol::build_command_packet(uint8_t cmd_id, uint8_t cmd_val, uint8_t *packet) {
@@ -518,16 +427,11 @@ namespace Himax {
     }
 
     ChipResult<> HimaxProtocol::write_and_verify(HalDevice* dev, const uint32_t addr, const uint8_t* data, uint32_t len, uint32_t verify_len) {
-        if (!dev || !dev->IsValid()) return std::unexpected(ChipError::CommunicationError);
-
-        std::vector<uint8_t> write_buf(data, data + len);
         std::vector<uint8_t> read_buf(len, 0);
 
-        if (auto res = register_write(dev, addr, data, len); !res) {
-            return res;
-        }
-
-        if (auto res = register_read(dev, addr, read_buf.data(), len); !res) {
+        // 写入与回读在同一事务中提交
+        BusTransaction txn(dev, BusOperation::WriteAndVerify);
+        if (auto res = txn.Write(addr, data, len).Read(addr, read_buf.data(), len).Commit(); !res) {
             return res;
         }
 
@@ -539,7 +443,7 @@ namespace Himax {
             cmp_len = len;
         }
 
-        if (std::equal(write_buf.begin(), write_buf.begin() + cmp_len, read_buf.begin())) {
+        if (std::equal(data, data + cmp_len, read_buf.begin())) {
             return {};
         }
 
@@ -588,20 +492,12 @@ namespace Himax {
         std::array<uint8_t, 16> packet{};
         build_command_packet(cmd_id, cmd_val, packet.data());
 
-        // 写入命令包到对应 slot 地址
-        if (auto res = register_write(dev, addr, packet.data(), 16); !res) {
-            return res;
-        }
-
-        // 写入触发标记 (0xA8, 0x8A, cmd_id, 0x00)
+        // 写入命令包、触发标记 (0xA8, 0x8A, cmd_id, 0x00) 并读取确认，一次提交
         std::array<uint8_t, 4> trigger = {0xA8, 0x8A, cmd_id, 0x00};
-        if (auto res = register_write(dev, addr, trigger.data(), 4); !res) {
-            return res;
-        }
-
-        // 读取确认
         std::array<uint8_t, 16> read_buf{};
-        if (auto res = register_read(dev, addr, read_buf.data(), 16); !res) {
+        BusTransaction txn(dev, BusOperation::SendCommand);
+        txn.Write(addr, packet.data(), 16).Write(addr, trigger.data(), 4).Read(addr, read_buf.data(), 16);
+        if (auto res = txn.Commit(); !res) {
             return res;
         }
 
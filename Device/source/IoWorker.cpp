@@ -0,0 +1,144 @@
+#include "IoWorker.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace Himax {
+
+    IoWorker::IoWorker(Executor executor, size_t slots, size_t bufferBytes)
+        : m_executor(std::move(executor)), m_slots(std::max<size_t>(slots, 1)), m_queue(m_slots.size()) {
+        for (Slot& slot : m_slots) {
+            slot.buffer.resize(bufferBytes);
+            slot.request.data = slot.buffer.data();
+        }
+        m_thread = std::thread(&IoWorker::Run, this);
+    }
+
+    IoWorker::~IoWorker() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_submitted.notify_all();
+        if (m_thread.joinable()) m_thread.join();
+    }
+
+    /**
+     * @brief 取空闲槽并排队；没有空槽时最多等到 deadline
+     */
+    ChipResult<IoTicket> IoWorker::Submit(uint32_t op, uint32_t arg, const uint8_t* in, uint32_t len,
+                                          IoClock::time_point deadline) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (len > m_slots.front().buffer.size()) return std::unexpected(ChipError::InvalidOperation);
+        auto isFree = [](const Slot& s) { return s.state == State::Free; };
+        auto it = std::find_if(m_slots.begin(), m_slots.end(), isFree);
+        if (it == m_slots.end()) {
+            const bool freed = m_freed.wait_until(lock, deadline, [&] {
+                return std::any_of(m_slots.begin(), m_slots.end(), isFree);
+            });
+            if (!freed) return std::unexpected(ChipError::Timeout);
+            it = std::find_if(m_slots.begin(), m_slots.end(), isFree);
+        }
+
+        Slot& slot = *it;
+        slot.state = State::Queued;
+        slot.deadline = deadline;
+        slot.request.op = op;
+        slot.request.arg = arg;
+        slot.request.len = len;
+        slot.error = 0;
+        if (in != nullptr) std::memcpy(slot.buffer.data(), in, len);
+
+        const uint32_t index = static_cast<uint32_t>(it - m_slots.begin());
+        m_queue[(m_queueHead + m_queueSize) % m_queue.size()] = index;
+        ++m_queueSize;
+        lock.unlock();
+        m_submitted.notify_one();
+        return IoTicket{index, slot.generation};
+    }
+
+    /**
+     * @brief 等待到提交时的 deadline；超时则放弃请求 (排队中的不再执行，执行中的完成后回收)
+     */
+    ChipResult<uint32_t> IoWorker::Complete(IoTicket ticket, uint8_t* out, uint32_t outLen, uint32_t& error) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (ticket.slot >= m_slots.size()) return std::unexpected(ChipError::InvalidOperation);
+        Slot& slot = m_slots[ticket.slot];
+        if (slot.generation != ticket.generation || slot.state == State::Free || slot.state == State::Abandoned) {
+            return std::unexpected(ChipError::InvalidOperation);
+        }
+
+        const bool done = m_completed.wait_until(lock, slot.deadline, [&] { return slot.state == State::Done; });
+        if (!done) {
+            slot.state = State::Abandoned;
+            error = ETIMEDOUT;
+            return std::unexpected(ChipError::Timeout);
+        }
+
+        ChipResult<uint32_t> result = slot.result;
+        error = slot.error;
+        if (result && out != nullptr) std::memcpy(out, slot.buffer.data(), std::min(*result, outLen));
+        slot.state = State::Free;
+        ++slot.generation;
+        m_freed.notify_one();
+        return result;
+    }
+
+    size_t IoWorker::Abandoned() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return static_cast<size_t>(
+            std::count_if(m_slots.begin(), m_slots.end(), [](const Slot& s) { return s.state == State::Abandoned; }));
+    }
+
+    void IoWorker::WaitIdle() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [&] { return m_queueSize == 0 && !m_executing; });
+    }
+
+    void IoWorker::Run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            if (m_queueSize == 0) m_idle.notify_all();
+            m_submitted.wait(lock, [&] { return m_stop || m_queueSize > 0; });
+            if (m_queueSize == 0) return;   // m_stop 且队列已空
+
+            Slot& slot = m_slots[m_queue[m_queueHead]];
+            m_queueHead = (m_queueHead + 1) % m_queue.size();
+            --m_queueSize;
+
+            // 排队期间已被放弃或已过期的请求不再下发
+            if (slot.state == State::Abandoned || m_stop) {
+                slot.state = State::Free;
+                ++slot.generation;
+                m_freed.notify_one();
+                continue;
+            }
+            if (IoClock::now() >= slot.deadline) {
+                slot.result = std::unexpected(ChipError::Timeout);
+                slot.error = ETIMEDOUT;
+                slot.state = State::Done;
+                m_completed.notify_all();
+                continue;
+            }
+
+            slot.state = State::Running;
+            m_executing = true;
+            lock.unlock();
+            uint32_t error = 0;
+            ChipResult<uint32_t> result = m_executor(slot.request, error);
+            lock.lock();
+            m_executing = false;
+
+            if (slot.state == State::Abandoned) {
+                slot.state = State::Free;
+                ++slot.generation;
+                m_freed.notify_one();
+                continue;
+            }
+            slot.result = result;
+            slot.error = error;
+            slot.state = State::Done;
+            m_completed.notify_all();
+        }
+    }
+}
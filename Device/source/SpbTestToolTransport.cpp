@@ -0,0 +1,408 @@
+// SPBTESTTOOL 测试驱动后端 (Windows)：CreateFileW + overlapped DeviceIoControl
+#if defined(_WIN32)
+
+#include "HimaxTransport.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <windows.h>
+
+namespace {
+
+using Himax::ChipError;
+using Himax::ChipResult;
+using Himax::IoClock;
+using Himax::IoTicket;
+
+const DWORD SPI_IOCTL_INT_OPEN    = 0x4001c00; // 打开中断/初始化
+const DWORD SPI_IOCTL_INT_CLOSE   = 0x4001c04; // 关闭中断
+const DWORD SPI_IOCTL_WRITEREAD   = 0x4001c10; // [不常用] 偶见于特定初始化流
+const DWORD SPI_IOCTL_WAIT_INT    = 0x4001c20; // 等待中断触发
+const DWORD SPI_IOCTL_FULL_DUPLEX = 0x4001c24; // [核心] BusRead / 全双工读
+const DWORD SPI_IOCTL_GET_FRAME   = 0x4001c28; // 获取帧数据
+const DWORD SPI_IOCTL_SET_TIMEOUT = 0x4001c2c; // 设置超时
+const DWORD SPI_IOCTL_SET_BLOCK   = 0x4001c30; // 设置阻塞模式
+const DWORD SPI_IOCTL_SET_RESET   = 0x4001c34; // 复位设备
+const DWORD SPI_IOCTL_READ_ACPI   = 0x4001c38; // 读取 ACPI 配置
+
+const DWORD kWriteFileRequest = 0;              // 非 IOCTL：以 WriteFile 写总线
+
+constexpr size_t kRequestSlots = 4;             // 同时在途的请求上限 (含超时后尚未回收的)
+constexpr size_t kSlotBufferBytes = 0x4000 + 32;
+constexpr uint32_t kBusDeadlineMs = 500;        // 总线 / 控制 IOCTL 的截止时间
+constexpr uint32_t kWaitInterruptTimeoutMs = 200;
+constexpr uint8_t kDefaultFrameTimeoutMs = 100; // 驱动侧 GET_FRAME 的默认超时
+
+// 预分配的 overlapped 请求槽：事件与缓冲在打开设备时创建，之后反复使用。
+// 超时的请求先 CancelIoEx，驱动真正完成 (事件置位) 后才回收，期间缓冲仍归驱动所有
+struct IoSlot {
+    enum class State : uint8_t { Free, Pending, Abandoned };
+
+    OVERLAPPED ov = {};
+    State state = State::Free;
+    uint32_t generation = 0;
+    IoClock::time_point deadline{};
+    std::vector<uint8_t> buffer;
+};
+
+class SpbTestToolTransport final : public Himax::ITransport {
+public:
+    SpbTestToolTransport(const wchar_t* path, Himax::DeviceType type);
+    ~SpbTestToolTransport() override;
+
+    bool IsValid() const override { return m_handle != INVALID_HANDLE_VALUE; }
+    ChipResult<> ReadBus(uint8_t cmd, uint8_t* data, uint32_t len) override;
+    ChipResult<> WriteBus(uint8_t cmd, const uint8_t* addr, const uint8_t* data, uint32_t len) override;
+    ChipResult<> GetFrame(void* buffer, uint32_t outLen, uint32_t* retLen) override;
+    ChipResult<> SetReset(bool state) override;
+    ChipResult<> WaitInterrupt() override;
+    ChipResult<> IntOpen() override;
+    ChipResult<> IntClose() override;
+    ChipResult<> SetTimeOut(uint8_t millisecond) override;
+    ChipResult<> SetBlock(bool state) override;
+    ChipResult<> ReadAcpi(uint8_t* data, uint32_t len) override;
+    ChipResult<IoTicket> SubmitFrame(uint32_t len, IoClock::time_point deadline) override;
+    ChipResult<> CompleteFrame(IoTicket ticket, void* buffer, uint32_t len, uint32_t* retLen) override;
+    // 阻塞模式下驱动的 SPI_IOCTL_GET_FRAME 先等中断再读帧
+    bool FrameWaitsForInterrupt() const override { return m_block; }
+    uint32_t GetError() const override { return m_lastError; }
+
+private:
+    ChipResult<IoTicket> Submit(DWORD code, const void* in, uint32_t inLen, uint32_t outLen, IoClock::time_point deadline);
+    ChipResult<> Complete(IoTicket ticket, void* out, uint32_t outLen, uint32_t* retLen);
+    ChipResult<> Ioctl(DWORD code, const void* in, uint32_t inLen, void* out, uint32_t outLen, uint32_t* retLen,
+                       uint32_t deadlineMs = kBusDeadlineMs);
+    void Reclaim();
+    ChipResult<> Fail(ChipError error, DWORD err) {
+        m_lastError = err;
+        return std::unexpected(error);
+    }
+
+    HANDLE m_handle = INVALID_HANDLE_VALUE;
+    DWORD m_lastError = 0;
+    Himax::BusOpcodes m_ops;
+    uint8_t m_frameTimeoutMs = kDefaultFrameTimeoutMs;
+    bool m_block = true;   // 驱动默认阻塞
+    std::array<IoSlot, kRequestSlots> m_slots;
+    std::vector<uint8_t> m_xfer_buffer;
+};
+
+/**
+ * @brief 打开设备句柄并初始化请求槽
+ * @param path 设备路径
+ * @param type 设备类型 (Master/Slave/Interrupt)
+ */
+SpbTestToolTransport::SpbTestToolTransport(const wchar_t* path, Himax::DeviceType type) : m_ops(Himax::OpcodesFor(type)) {
+    m_xfer_buffer.reserve(kSlotBufferBytes);
+
+    m_handle = CreateFileW(
+        path,
+        GENERIC_ALL,
+        FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_FLAG_OVERLAPPED,
+        NULL
+    );
+    if (m_handle == INVALID_HANDLE_VALUE) {
+        m_lastError = GetLastError();
+        return;
+    }
+
+    for (IoSlot& slot : m_slots) {
+        slot.buffer.resize(kSlotBufferBytes);
+        slot.ov.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+        if (slot.ov.hEvent == nullptr) {
+            m_lastError = GetLastError();
+            CloseHandle(m_handle);
+            m_handle = INVALID_HANDLE_VALUE;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 取消全部在途请求并等待驱动释放缓冲后再关闭句柄
+ */
+SpbTestToolTransport::~SpbTestToolTransport() {
+    if (IsValid()) {
+        CancelIoEx(m_handle, nullptr);
+        for (IoSlot& slot : m_slots) {
+            if (slot.state != IoSlot::State::Free) {
+                DWORD bytes = 0;
+                GetOverlappedResult(m_handle, &slot.ov, &bytes, TRUE);
+            }
+        }
+        CloseHandle(m_handle);
+        m_handle = INVALID_HANDLE_VALUE;
+    }
+    for (IoSlot& slot : m_slots) {
+        if (slot.ov.hEvent) CloseHandle(slot.ov.hEvent);
+    }
+}
+
+/**
+ * @brief 回收已被驱动完成 (或取消) 的超时请求
+ */
+void SpbTestToolTransport::Reclaim() {
+    for (IoSlot& slot : m_slots) {
+        if (slot.state == IoSlot::State::Abandoned && HasOverlappedIoCompleted(&slot.ov)) {
+            slot.state = IoSlot::State::Free;
+            ++slot.generation;
+        }
+    }
+}
+
+/**
+ * @brief 在空闲槽上发起一次 overlapped 请求，立即返回
+ * @param code 控制码；kWriteFileRequest 表示 WriteFile
+ * @param in 输入数据，拷入槽内缓冲 (全双工时与输出共用)
+ * @param outLen 期望输出长度 (0 = 无输出)
+ * @param deadline Complete 最多等到此刻
+ */
+ChipResult<IoTicket> SpbTestToolTransport::Submit(DWORD code, const void* in, uint32_t inLen, uint32_t outLen,
+                                                  IoClock::time_point deadline) {
+    if (!IsValid()) {
+        m_lastError = ERROR_INVALID_HANDLE;
+        return std::unexpected(ChipError::CommunicationError);
+    }
+    if (std::max(inLen, outLen) > kSlotBufferBytes) {
+        m_lastError = ERROR_INVALID_PARAMETER;
+        return std::unexpected(ChipError::InvalidOperation);
+    }
+
+    auto isFree = [](const IoSlot& s) { return s.state == IoSlot::State::Free; };
+    Reclaim();
+    auto it = std::find_if(m_slots.begin(), m_slots.end(), isFree);
+    // 槽位被已放弃 (挂起) 的请求占住：等其中之一完成，最多到本请求的截止时间，
+    // 总线无响应时调用方因此按截止时间节流而不是反复立即失败
+    while (it == m_slots.end()) {
+        HANDLE events[kRequestSlots];
+        DWORD count = 0;
+        for (const IoSlot& slot : m_slots) {
+            if (slot.state == IoSlot::State::Abandoned) events[count++] = slot.ov.hEvent;
+        }
+        if (count == 0) {   // 全部是调用方尚未完成的请求
+            m_lastError = ERROR_BUSY;
+            return std::unexpected(ChipError::InternalError);
+        }
+        const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - IoClock::now()).count();
+        const DWORD wait = WaitForMultipleObjects(count, events, FALSE, static_cast<DWORD>(std::max<long long>(remaining, 0)));
+        if (wait == WAIT_TIMEOUT) {
+            m_lastError = ERROR_TIMEOUT;
+            return std::unexpected(ChipError::Timeout);
+        }
+        if (wait == WAIT_FAILED) {
+            m_lastError = GetLastError();
+            return std::unexpected(ChipError::CommunicationError);
+        }
+        Reclaim();
+        it = std::find_if(m_slots.begin(), m_slots.end(), isFree);
+    }
+
+    IoSlot& slot = *it;
+    if (in != nullptr && inLen > 0) std::memcpy(slot.buffer.data(), in, inLen);
+    HANDLE event = slot.ov.hEvent;
+    slot.ov = {};
+    slot.ov.hEvent = event;
+    ResetEvent(event);
+
+    BOOL res;
+    if (code == kWriteFileRequest) {
+        res = WriteFile(m_handle, slot.buffer.data(), inLen, nullptr, &slot.ov);
+    } else {
+        res = DeviceIoControl(m_handle, code,
+                              inLen ? slot.buffer.data() : nullptr, inLen,
+                              outLen ? slot.buffer.data() : nullptr, outLen,
+                              nullptr, &slot.ov);
+    }
+    if (!res && GetLastError() != ERROR_IO_PENDING) {
+        m_lastError = GetLastError();
+        return std::unexpected(ChipError::CommunicationError);
+    }
+
+    // 同步完成时事件同样已置位，统一由 Complete 收取结果
+    slot.state = IoSlot::State::Pending;
+    slot.deadline = deadline;
+    return IoTicket{static_cast<uint32_t>(it - m_slots.begin()), slot.generation};
+}
+
+/**
+ * @brief 等待请求完成，最多到提交时的 deadline；超时则取消并放弃该请求
+ */
+ChipResult<> SpbTestToolTransport::Complete(IoTicket ticket, void* out, uint32_t outLen, uint32_t* retLen) {
+    if (ticket.slot >= m_slots.size()) return Fail(ChipError::InvalidOperation, ERROR_INVALID_PARAMETER);
+    IoSlot& slot = m_slots[ticket.slot];
+    if (slot.generation != ticket.generation || slot.state != IoSlot::State::Pending) {
+        return Fail(ChipError::InvalidOperation, ERROR_INVALID_PARAMETER);
+    }
+
+    const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(slot.deadline - IoClock::now());
+    const DWORD waitMs = static_cast<DWORD>(std::max<int64_t>(remaining.count(), 0));
+    const DWORD waitResult = WaitForSingleObject(slot.ov.hEvent, waitMs);
+    if (waitResult != WAIT_OBJECT_0) {
+        const DWORD err = (waitResult == WAIT_FAILED) ? GetLastError() : ERROR_TIMEOUT;
+        CancelIoEx(m_handle, &slot.ov);
+        slot.state = IoSlot::State::Abandoned;
+        return Fail(waitResult == WAIT_TIMEOUT ? ChipError::Timeout : ChipError::CommunicationError, err);
+    }
+
+    DWORD bytes = 0;
+    const BOOL ok = GetOverlappedResult(m_handle, &slot.ov, &bytes, FALSE);
+    const DWORD err = ok ? 0 : GetLastError();
+    if (ok && out != nullptr) std::memcpy(out, slot.buffer.data(), std::min<DWORD>(bytes, outLen));
+    slot.state = IoSlot::State::Free;
+    ++slot.generation;
+
+    if (!ok) return Fail(ChipError::CommunicationError, err);
+    if (retLen) *retLen = bytes;
+    m_lastError = 0;
+    return {};
+}
+
+/**
+ * @brief 同步执行 DeviceIoControl (提交后等待完成，不重试)
+ * @param code 控制码
+ * @param in 输入缓冲区
+ * @param inLen 输入长度
+ * @param out 输出缓冲区
+ * @param outLen 输出长度
+ * @param retLen 实际返回长度
+ * @param deadlineMs 截止时间；驱动无响应时返回 Timeout 而不是无限等待
+ * @return ChipResult 是否成功
+ */
+ChipResult<> SpbTestToolTransport::Ioctl(DWORD code, const void* in, uint32_t inLen, void* out, uint32_t outLen,
+                                         uint32_t* retLen, uint32_t deadlineMs) {
+    auto ticket = Submit(code, in, inLen, outLen, IoClock::now() + std::chrono::milliseconds(deadlineMs));
+    if (!ticket) return std::unexpected(ticket.error());
+    return Complete(*ticket, out, outLen, retLen);
+}
+
+/**
+ * @brief 等待设备中断触发 (200 ms 超时)
+ */
+ChipResult<> SpbTestToolTransport::WaitInterrupt() {
+    return Ioctl(SPI_IOCTL_WAIT_INT, nullptr, 0, nullptr, 0, nullptr, kWaitInterruptTimeoutMs);
+}
+
+/**
+ * @brief 通过全双工 IOCTL 读取总线数据
+ */
+ChipResult<> SpbTestToolTransport::ReadBus(uint8_t cmd, uint8_t* data, uint32_t len) {
+    size_t total_size = Himax::kReadDataOffset + len;
+
+    m_xfer_buffer.clear();
+
+    m_xfer_buffer.push_back(m_ops.read);
+    m_xfer_buffer.push_back(cmd);
+    m_xfer_buffer.push_back(0x00);      //Dummy Byte
+
+    m_xfer_buffer.resize(total_size, 0);
+
+    uint32_t retLen = 0;
+    auto res = Ioctl(SPI_IOCTL_FULL_DUPLEX,
+                        m_xfer_buffer.data(), m_xfer_buffer.size(),
+                        m_xfer_buffer.data(), m_xfer_buffer.size(),
+                        &retLen);
+
+    if (!res) return res;
+
+    if (retLen < total_size) {
+        return std::unexpected(ChipError::CommunicationError);
+    }
+
+    memcpy(data, m_xfer_buffer.data() + Himax::kReadDataOffset, len);
+
+    return {};
+}
+
+/**
+ * @brief 通过 WriteFile 写入总线数据
+ */
+ChipResult<> SpbTestToolTransport::WriteBus(uint8_t cmd, const uint8_t* addr, const uint8_t* data, uint32_t len) {
+    m_xfer_buffer.clear();
+    m_xfer_buffer.push_back(m_ops.write);
+    m_xfer_buffer.push_back(cmd);
+
+    if (addr != NULL) {
+        m_xfer_buffer.insert(m_xfer_buffer.end(), addr, addr + 4);
+    }
+    if (data != NULL) {
+        m_xfer_buffer.insert(m_xfer_buffer.end(), data, data + len);
+    }
+
+    return Ioctl(kWriteFileRequest, m_xfer_buffer.data(), m_xfer_buffer.size(), nullptr, 0, nullptr);
+}
+
+ChipResult<> SpbTestToolTransport::ReadAcpi(uint8_t* data, uint32_t len) {
+    uint32_t retLen = 0;
+
+    auto res = Ioctl(SPI_IOCTL_READ_ACPI, nullptr, 0, data, len, &retLen);
+    if (!res) return res;
+
+    if (retLen < len) {
+        return std::unexpected(ChipError::CommunicationError);
+    }
+    return {};
+}
+
+ChipResult<IoTicket> SpbTestToolTransport::SubmitFrame(uint32_t len, IoClock::time_point deadline) {
+    return Submit(SPI_IOCTL_GET_FRAME, nullptr, 0, len, deadline);
+}
+
+ChipResult<> SpbTestToolTransport::CompleteFrame(IoTicket ticket, void* buffer, uint32_t len, uint32_t* retLen) {
+    return Complete(ticket, buffer, len, retLen);
+}
+
+/**
+ * @brief 同步取帧：截止时间为驱动侧超时加传输余量
+ */
+ChipResult<> SpbTestToolTransport::GetFrame(void* buffer, uint32_t outLen, uint32_t* retLen) {
+    return Ioctl(SPI_IOCTL_GET_FRAME, NULL, 0, buffer, outLen, retLen,
+                 m_frameTimeoutMs + Himax::kFrameDeadlineMarginMs);
+}
+
+ChipResult<> SpbTestToolTransport::SetTimeOut(uint8_t millisecond) {
+    uint32_t timeout = static_cast<uint32_t>(millisecond);
+    auto res = Ioctl(SPI_IOCTL_SET_TIMEOUT, &timeout, sizeof(timeout), NULL, 0, NULL);
+    if (res) m_frameTimeoutMs = millisecond;
+    return res;
+}
+
+ChipResult<> SpbTestToolTransport::SetBlock(bool state) {
+    m_xfer_buffer.clear();
+    m_xfer_buffer.push_back(uint8_t(state));
+    m_xfer_buffer.resize(4, 0);
+
+    auto res = Ioctl(SPI_IOCTL_SET_BLOCK, m_xfer_buffer.data(), 4, NULL, 0, NULL);
+    if (res) m_block = state;
+    return res;
+}
+
+ChipResult<> SpbTestToolTransport::SetReset(bool state) {
+    uint32_t val = state ? 1 : 0;
+    return Ioctl(SPI_IOCTL_SET_RESET, &val, sizeof(val), NULL, 0, NULL);
+}
+
+ChipResult<> SpbTestToolTransport::IntOpen() {
+    return Ioctl(SPI_IOCTL_INT_OPEN, NULL, 0, NULL, 0, NULL);
+}
+
+ChipResult<> SpbTestToolTransport::IntClose() {
+    return Ioctl(SPI_IOCTL_INT_CLOSE, NULL, 0, NULL, 0, NULL);
+}
+
+} // namespace
+
+namespace Himax {
+
+std::unique_ptr<ITransport> OpenSpbTestToolTransport(const wchar_t* path, DeviceType type) {
+    return std::make_unique<SpbTestToolTransport>(path, type);
+}
+
+} // namespace Himax
+
+#endif // _WIN32
@@ -0,0 +1,444 @@
+// spidev + GPIO 字符设备后端 (Linux)
+#if defined(__linux__)
+
+#include "HimaxTransport.h"
+#include "IoWorker.h"
+#include "Logger.h"
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <format>
+#include <memory>
+#include <vector>
+#include <fcntl.h>
+#include <linux/gpio.h>
+#include <linux/spi/spidev.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace {
+
+using Himax::ChipError;
+using Himax::ChipResult;
+
+constexpr uint8_t kFrameReadCmd = 0x08;        // 整帧读出与 AHB 读数据同一命令 (THP 驱动的 GET_FRAME 路径)
+constexpr int kWaitInterruptTimeoutMs = 200;   // 与 SPBTESTTOOL 的 WAIT_INT 一致
+constexpr uint32_t kFrameBufferBytes = 0x4000;
+constexpr size_t kFrameSlots = 4;               // 同时在途的取帧请求上限 (含超时后仍在执行的)
+// 取帧请求 (IoWorker::Request::op)
+constexpr uint32_t kFrameReadNow = 0;           // 直接读出芯片当前帧
+constexpr uint32_t kFrameWaitInterrupt = 1;     // 先等中断 (arg 为超时 ms)
+
+// spidev 单条消息 (全部 transfer 合计，拆成多段也一样) 受模块参数 bufsiz 限制 (默认 4096)。
+// 整帧读在一次 CS 有效期内完成，无法拆成多条消息；Master 需 >= 5063 + 3，须在内核命令行加
+// spidev.bufsiz=8192。打开时检查，不满足则打开失败 (GetError 为 EMSGSIZE)
+constexpr uint32_t kMasterFrameBytes = 5063;
+constexpr uint32_t kSlaveFrameBytes = 339;
+constexpr uint32_t kDefaultSpidevBufsiz = 4096;
+
+uint32_t SpidevMessageLimit() {
+    uint32_t limit = kDefaultSpidevBufsiz;
+    if (std::FILE* f = std::fopen("/sys/module/spidev/parameters/bufsiz", "r")) {
+        unsigned value = 0;
+        if (std::fscanf(f, "%u", &value) == 1 && value > 0) limit = value;
+        std::fclose(f);
+    }
+    return limit;
+}
+
+class SpidevTransport final : public Himax::ITransport {
+public:
+    SpidevTransport(const Himax::SpidevConfig& config, Himax::DeviceType type);
+    ~SpidevTransport() override;
+
+    bool IsValid() const override { return m_spiFd >= 0; }
+    ChipResult<> ReadBus(uint8_t cmd, uint8_t* data, uint32_t len) override;
+    ChipResult<> WriteBus(uint8_t cmd, const uint8_t* addr, const uint8_t* data, uint32_t len) override;
+    ChipResult<> GetFrame(void* buffer, uint32_t outLen, uint32_t* retLen) override;
+    ChipResult<> SetReset(bool state) override;
+    ChipResult<> WaitInterrupt() override;
+    ChipResult<> IntOpen() override;
+    ChipResult<> IntClose() override;
+    ChipResult<> SetTimeOut(uint8_t millisecond) override;
+    ChipResult<> SetBlock(bool state) override;
+    ChipResult<> ReadAcpi(uint8_t* data, uint32_t len) override;
+    ChipResult<> Transfer(const Himax::BusPhase* phases, size_t count) override;
+    ChipResult<Himax::IoTicket> SubmitFrame(uint32_t len, Himax::IoClock::time_point deadline) override;
+    ChipResult<> CompleteFrame(Himax::IoTicket ticket, void* buffer, uint32_t len, uint32_t* retLen) override;
+    // 与 SubmitFrame 选择 kFrameWaitInterrupt 的条件相同
+    bool FrameWaitsForInterrupt() const override {
+        return m_block && m_interruptFd.load(std::memory_order_relaxed) >= 0;
+    }
+    bool BatchesTransfers() const override { return true; }
+    uint32_t GetError() const override { return m_lastError; }
+
+private:
+    ChipResult<> Transfer(uint32_t len);
+    ChipResult<> WaitEdge(int timeoutMs, uint32_t& error) const;
+    ChipResult<uint32_t> ReadFrame(Himax::IoWorker::Request& request, uint32_t& error);
+    int RequestLine(int line, uint64_t flags, const char* consumer);
+    ChipResult<> Fail(ChipError error, int err = errno) {
+        m_lastError = static_cast<uint32_t>(err);
+        return std::unexpected(error);
+    }
+
+    Himax::SpidevConfig m_config;
+    Himax::BusOpcodes m_ops;
+    int m_spiFd = -1;
+    int m_chipFd = -1;        // gpiochip，仅在接了复位 / 中断脚时打开
+    int m_resetFd = -1;       // 复位脚 line request (输出)
+    // 中断脚 line request (下降沿事件)，IntOpen 时申请。调用线程写、取帧工作线程读
+    std::atomic<int> m_interruptFd{-1};
+    int m_timeoutMs = kWaitInterruptTimeoutMs;
+    uint32_t m_messageLimit = kDefaultSpidevBufsiz;   // 单条 SPI_IOC_MESSAGE 的总字节上限
+    bool m_block = true;
+    uint32_t m_lastError = 0;
+    std::vector<uint8_t> m_tx;
+    std::vector<uint8_t> m_rx;
+    std::vector<spi_ioc_transfer> m_message;
+    // 取帧在 m_frames 的工作线程上执行，收发缓冲独立于上面的总线缓冲
+    std::vector<uint8_t> m_frameTx;
+    std::vector<uint8_t> m_frameRx;
+    std::unique_ptr<Himax::IoWorker> m_frames;
+};
+
+SpidevTransport::SpidevTransport(const Himax::SpidevConfig& config, Himax::DeviceType type)
+    : m_config(config), m_ops(Himax::OpcodesFor(type)) {
+    m_tx.reserve(0x4000 + 32);
+    m_rx.reserve(0x4000 + 32);
+
+    int fd = open(m_config.spiDevice.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        m_lastError = static_cast<uint32_t>(errno);
+        return;
+    }
+    uint8_t bits = 8;
+    if (ioctl(fd, SPI_IOC_WR_MODE, &m_config.mode) < 0 ||
+        ioctl(fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0 ||
+        ioctl(fd, SPI_IOC_WR_MAX_SPEED_HZ, &m_config.speedHz) < 0) {
+        m_lastError = static_cast<uint32_t>(errno);
+        close(fd);
+        return;
+    }
+    m_messageLimit = SpidevMessageLimit();
+    const uint32_t frameMessage = Himax::kReadDataOffset + (type == Himax::DeviceType::Master ? kMasterFrameBytes : kSlaveFrameBytes);
+    if (m_messageLimit < frameMessage) {
+        LOG_ERROR("Device", "SpidevTransport", "Unconnected",
+                  "{}: spidev bufsiz {} is below the {}-byte frame read, boot with spidev.bufsiz=8192",
+                  m_config.spiDevice, m_messageLimit, frameMessage);
+        m_lastError = EMSGSIZE;
+        close(fd);
+        return;
+    }
+
+    if (m_config.resetLine >= 0 || m_config.interruptLine >= 0) {
+        m_chipFd = open(m_config.gpioChip.c_str(), O_RDWR | O_CLOEXEC);
+        if (m_chipFd < 0) {
+            m_lastError = static_cast<uint32_t>(errno);
+            close(fd);
+            return;
+        }
+    }
+    if (m_config.resetLine >= 0) {
+        // 初始为高电平 (不复位)，与 SetReset(true) 一致
+        m_resetFd = RequestLine(m_config.resetLine, GPIO_V2_LINE_FLAG_OUTPUT, "egotouch-reset");
+        if (m_resetFd < 0) {
+            close(fd);
+            return;
+        }
+    }
+    m_spiFd = fd;
+
+    // 整帧读的发送内容固定：[读操作码, 0x08, dummy, 0...]
+    m_frameTx.assign(Himax::kReadDataOffset + kFrameBufferBytes, 0);
+    m_frameTx[0] = m_ops.read;
+    m_frameTx[1] = kFrameReadCmd;
+    m_frameRx.resize(m_frameTx.size());
+    m_frames = std::make_unique<Himax::IoWorker>(
+        [this](Himax::IoWorker::Request& request, uint32_t& error) { return ReadFrame(request, error); },
+        kFrameSlots, kFrameBufferBytes);
+}
+
+SpidevTransport::~SpidevTransport() {
+    // 先等工作线程结束 (挂起的请求做完)，再关闭它用到的 fd
+    m_frames.reset();
+    for (int fd : {m_interruptFd.load(), m_resetFd, m_chipFd, m_spiFd}) {
+        if (fd >= 0) close(fd);
+    }
+}
+
+int SpidevTransport::RequestLine(int line, uint64_t flags, const char* consumer) {
+    gpio_v2_line_request request{};
+    request.offsets[0] = static_cast<uint32_t>(line);
+    request.num_lines = 1;
+    std::strncpy(request.consumer, consumer, sizeof(request.consumer) - 1);
+    request.config.flags = flags;
+    if (flags & GPIO_V2_LINE_FLAG_OUTPUT) {
+        request.config.num_attrs = 1;
+        request.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+        request.config.attrs[0].attr.values = 1;
+        request.config.attrs[0].mask = 1;
+    } else {
+        request.event_buffer_size = 16;
+    }
+    if (ioctl(m_chipFd, GPIO_V2_GET_LINE_IOCTL, &request) < 0) {
+        m_lastError = static_cast<uint32_t>(errno);
+        return -1;
+    }
+    return request.fd;
+}
+
+/**
+ * @brief 以 m_tx 的前 len 字节做一次全双工传输，结果写入 m_rx
+ */
+ChipResult<> SpidevTransport::Transfer(uint32_t len) {
+    if (!IsValid()) return Fail(ChipError::CommunicationError, EBADF);
+    m_rx.resize(len);
+
+    spi_ioc_transfer transfer{};
+    transfer.tx_buf = reinterpret_cast<uintptr_t>(m_tx.data());
+    transfer.rx_buf = reinterpret_cast<uintptr_t>(m_rx.data());
+    transfer.len = len;
+    transfer.speed_hz = m_config.speedHz;
+    transfer.bits_per_word = 8;
+    if (ioctl(m_spiFd, SPI_IOC_MESSAGE(1), &transfer) < 0) return Fail(ChipError::CommunicationError);
+
+    m_lastError = 0;
+    return {};
+}
+
+ChipResult<> SpidevTransport::ReadBus(uint8_t cmd, uint8_t* data, uint32_t len) {
+    m_tx.assign(Himax::kReadDataOffset + len, 0);
+    m_tx[0] = m_ops.read;
+    m_tx[1] = cmd;
+    if (auto res = Transfer(static_cast<uint32_t>(m_tx.size())); !res) return res;
+
+    std::memcpy(data, m_rx.data() + Himax::kReadDataOffset, len);
+    return {};
+}
+
+ChipResult<> SpidevTransport::WriteBus(uint8_t cmd, const uint8_t* addr, const uint8_t* data, uint32_t len) {
+    if (!IsValid()) return Fail(ChipError::CommunicationError, EBADF);
+    m_tx.clear();
+    m_tx.push_back(m_ops.write);
+    m_tx.push_back(cmd);
+    if (addr != nullptr) m_tx.insert(m_tx.end(), addr, addr + 4);
+    if (data != nullptr) m_tx.insert(m_tx.end(), data, data + len);
+
+    // 只写：不需要 rx 缓冲
+    spi_ioc_transfer transfer{};
+    transfer.tx_buf = reinterpret_cast<uintptr_t>(m_tx.data());
+    transfer.len = static_cast<uint32_t>(m_tx.size());
+    transfer.speed_hz = m_config.speedHz;
+    transfer.bits_per_word = 8;
+    if (ioctl(m_spiFd, SPI_IOC_MESSAGE(1), &transfer) < 0) return Fail(ChipError::CommunicationError);
+
+    m_lastError = 0;
+    return {};
+}
+
+/**
+ * @brief 多相合并为一条 SPI_IOC_MESSAGE：一次系统调用，相与相之间释放 CS
+ *
+ * 各相的 tx / rx 依次排在 m_tx / m_rx 中；整条消息同样受 bufsiz 限制，寄存器事务远小于此
+ */
+ChipResult<> SpidevTransport::Transfer(const Himax::BusPhase* phases, size_t count) {
+    if (!IsValid()) return Fail(ChipError::CommunicationError, EBADF);
+    if (count == 0) return {};
+
+    m_tx.clear();
+    for (size_t i = 0; i < count; ++i) {
+        const Himax::BusPhase& p = phases[i];
+        m_tx.push_back(p.read ? m_ops.read : m_ops.write);
+        m_tx.push_back(p.cmd);
+        if (p.read) {
+            m_tx.insert(m_tx.end(), Himax::kReadDataOffset - 2 + p.len, 0);
+        } else {
+            if (p.addr != nullptr) m_tx.insert(m_tx.end(), p.addr, p.addr + 4);
+            if (p.data != nullptr) m_tx.insert(m_tx.end(), p.data, p.data + p.len);
+        }
+    }
+    m_rx.resize(m_tx.size());
+
+    m_message.assign(count, spi_ioc_transfer{});
+    size_t offset = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const Himax::BusPhase& p = phases[i];
+        const uint32_t len = p.read ? Himax::kReadDataOffset + p.len
+                                    : 2 + (p.addr ? 4 : 0) + (p.data ? p.len : 0);
+        spi_ioc_transfer& transfer = m_message[i];
+        transfer.tx_buf = reinterpret_cast<uintptr_t>(m_tx.data() + offset);
+        if (p.read) transfer.rx_buf = reinterpret_cast<uintptr_t>(m_rx.data() + offset);
+        transfer.len = len;
+        transfer.speed_hz = m_config.speedHz;
+        transfer.bits_per_word = 8;
+        transfer.cs_change = (i + 1 < count) ? 1 : 0;   // 最后一相按默认在消息结束时释放 CS
+        offset += len;
+    }
+
+    // SPI_IOC_MESSAGE(n) 的 n 须为常量，这里按同样的编码以运行时长度构造请求码
+    const unsigned long request = _IOC(_IOC_WRITE, SPI_IOC_MAGIC, 0, count * sizeof(spi_ioc_transfer));
+    if (ioctl(m_spiFd, request, m_message.data()) < 0) return Fail(ChipError::CommunicationError);
+
+    offset = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const Himax::BusPhase& p = phases[i];
+        if (p.read) std::memcpy(p.out, m_rx.data() + offset + Himax::kReadDataOffset, p.len);
+        offset += m_message[i].len;
+    }
+    m_lastError = 0;
+    return {};
+}
+
+/**
+ * @brief 等待中断脚的下降沿；一次读空队列中积压的事件，只算一次中断
+ *
+ * 取帧时在工作线程上调用，错误码经 error 返回而不写 m_lastError
+ */
+ChipResult<> SpidevTransport::WaitEdge(int timeoutMs, uint32_t& error) const {
+    // 只取一次：IntClose 会等在途的取帧结束后才关闭该 fd
+    const int fd = m_interruptFd.load(std::memory_order_acquire);
+    if (fd < 0) {
+        error = ENODEV;
+        return std::unexpected(ChipError::InvalidOperation);
+    }
+
+    pollfd pfd{fd, POLLIN, 0};
+    const int ready = poll(&pfd, 1, timeoutMs);
+    if (ready <= 0) {
+        error = ready == 0 ? ETIMEDOUT : static_cast<uint32_t>(errno);
+        return std::unexpected(ready == 0 ? ChipError::Timeout : ChipError::CommunicationError);
+    }
+
+    gpio_v2_line_event events[16];
+    if (read(fd, events, sizeof(events)) < static_cast<ssize_t>(sizeof(gpio_v2_line_event))) {
+        error = static_cast<uint32_t>(errno);
+        return std::unexpected(ChipError::CommunicationError);
+    }
+    error = 0;
+    return {};
+}
+
+ChipResult<> SpidevTransport::WaitInterrupt() {
+    return WaitEdge(kWaitInterruptTimeoutMs, m_lastError);
+}
+
+/**
+ * @brief 工作线程上的整帧读，数据写入槽内缓冲
+ */
+ChipResult<uint32_t> SpidevTransport::ReadFrame(Himax::IoWorker::Request& request, uint32_t& error) {
+    if (request.op == kFrameWaitInterrupt) {
+        if (auto res = WaitEdge(static_cast<int>(request.arg), error); !res) return std::unexpected(res.error());
+    }
+
+    if (Himax::kReadDataOffset + request.len > m_messageLimit) {
+        error = EMSGSIZE;
+        return std::unexpected(ChipError::InvalidOperation);
+    }
+    spi_ioc_transfer transfer{};
+    transfer.tx_buf = reinterpret_cast<uintptr_t>(m_frameTx.data());
+    transfer.rx_buf = reinterpret_cast<uintptr_t>(m_frameRx.data());
+    transfer.len = Himax::kReadDataOffset + request.len;
+    transfer.speed_hz = m_config.speedHz;
+    transfer.bits_per_word = 8;
+    if (ioctl(m_spiFd, SPI_IOC_MESSAGE(1), &transfer) < 0) {
+        error = static_cast<uint32_t>(errno);
+        return std::unexpected(ChipError::CommunicationError);
+    }
+
+    std::memcpy(request.data, m_frameRx.data() + Himax::kReadDataOffset, request.len);
+    error = 0;
+    return request.len;
+}
+
+ChipResult<Himax::IoTicket> SpidevTransport::SubmitFrame(uint32_t len, Himax::IoClock::time_point deadline) {
+    if (!IsValid()) {
+        m_lastError = EBADF;
+        return std::unexpected(ChipError::CommunicationError);
+    }
+    // 阻塞模式且接了中断脚时等下一帧就绪；否则直接读出芯片当前帧
+    const uint32_t op = FrameWaitsForInterrupt() ? kFrameWaitInterrupt : kFrameReadNow;
+    auto ticket = m_frames->Submit(op, static_cast<uint32_t>(m_timeoutMs), nullptr, len, deadline);
+    if (!ticket) m_lastError = ticket.error() == ChipError::Timeout ? ETIMEDOUT : EINVAL;
+    return ticket;
+}
+
+ChipResult<> SpidevTransport::CompleteFrame(Himax::IoTicket ticket, void* buffer, uint32_t len, uint32_t* retLen) {
+    auto res = m_frames->Complete(ticket, static_cast<uint8_t*>(buffer), len, m_lastError);
+    if (!res) return std::unexpected(res.error());
+    if (retLen) *retLen = *res;
+    return {};
+}
+
+ChipResult<> SpidevTransport::GetFrame(void* buffer, uint32_t outLen, uint32_t* retLen) {
+    const auto deadline = Himax::IoClock::now() + std::chrono::milliseconds(m_timeoutMs + Himax::kFrameDeadlineMarginMs);
+    auto ticket = SubmitFrame(outLen, deadline);
+    if (!ticket) return std::unexpected(ticket.error());
+    return CompleteFrame(*ticket, buffer, outLen, retLen);
+}
+
+ChipResult<> SpidevTransport::SetReset(bool state) {
+    if (m_resetFd < 0) return Fail(ChipError::InvalidOperation, ENODEV);
+
+    gpio_v2_line_values values{};
+    values.bits = state ? 1 : 0;
+    values.mask = 1;
+    if (ioctl(m_resetFd, GPIO_V2_LINE_SET_VALUES_IOCTL, &values) < 0) return Fail(ChipError::CommunicationError);
+
+    m_lastError = 0;
+    return {};
+}
+
+ChipResult<> SpidevTransport::IntOpen() {
+    if (!IsValid()) return Fail(ChipError::CommunicationError, EBADF);
+    // 未接中断脚 (如 Slave)：GetFrame 不等待，视为成功
+    if (m_config.interruptLine < 0 || m_interruptFd.load(std::memory_order_relaxed) >= 0) return {};
+
+    const int fd = RequestLine(m_config.interruptLine, GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_FALLING,
+                               "egotouch-int");
+    if (fd < 0) return std::unexpected(ChipError::CommunicationError);
+    m_interruptFd.store(fd, std::memory_order_release);
+    return {};
+}
+
+/**
+ * @brief 先摘下 fd，再等工作线程上在途 / 已放弃的取帧结束后关闭，避免其 poll 到已关闭或被复用的 fd
+ */
+ChipResult<> SpidevTransport::IntClose() {
+    const int fd = m_interruptFd.exchange(-1, std::memory_order_acq_rel);
+    if (fd >= 0) {
+        m_frames->WaitIdle();
+        close(fd);
+    }
+    return {};
+}
+
+ChipResult<> SpidevTransport::SetTimeOut(uint8_t millisecond) {
+    m_timeoutMs = millisecond;
+    return {};
+}
+
+ChipResult<> SpidevTransport::SetBlock(bool state) {
+    m_block = state;
+    return {};
+}
+
+ChipResult<> SpidevTransport::ReadAcpi(uint8_t*, uint32_t) {
+    // ACPI 配置只存在于 Windows 驱动；Linux 上的等价信息来自设备树
+    return Fail(ChipError::InvalidOperation, ENOTSUP);
+}
+
+} // namespace
+
+namespace Himax {
+
+std::unique_ptr<ITransport> OpenSpidevTransport(const SpidevConfig& config, DeviceType type) {
+    return std::make_unique<SpidevTransport>(config, type);
+}
+
+} // namespace Himax
+
+#endif // __linux__
@@ -0,0 +1,174 @@
+// CentroidExtractor 每帧开销基准 (0 / 1 / 5 / 10 指)
+// 对比原 BFS 连通域与 ComponentLabeler (含矩累加)，并统计每帧堆分配次数。
+//
+//   CentroidBench [iterations]
+
+#include "CentroidExtractor.h"
+#include "ComponentLabeler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::atomic<size_t> g_allocCount{0};
+
+} // namespace
+
+// 全局 operator new 计数替换；GCC 会把 malloc/free 配对误报为 new/delete 不匹配
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+using Engine::HeatmapFrame;
+
+constexpr int kRows = 40;
+constexpr int kCols = 60;
+constexpr int kThreshold = 80;
+
+// 以高斯峰模拟手指，峰值 600~1200，sigma 1.2~1.8 (约 5x5 个有效像素)
+void BuildScene(HeatmapFrame& frame, int fingers, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> posX(3.f, kCols - 4.f), posY(3.f, kRows - 4.f);
+    std::uniform_real_distribution<float> peak(600.f, 1200.f), sigma(1.2f, 1.8f);
+    std::uniform_int_distribution<int> noise(-20, 20);
+
+    float field[kRows][kCols] = {};
+    for (int f = 0; f < fingers; ++f) {
+        const float fx = posX(rng), fy = posY(rng), a = peak(rng), s = sigma(rng);
+        for (int y = 0; y < kRows; ++y) {
+            for (int x = 0; x < kCols; ++x) {
+                const float d2 = (x - fx) * (x - fx) + (y - fy) * (y - fy);
+                field[y][x] += a * std::exp(-d2 / (2.f * s * s));
+            }
+        }
+    }
+    for (int y = 0; y < kRows; ++y) {
+        for (int x = 0; x < kCols; ++x) {
+            frame.heatmapMatrix[y][x] = static_cast<int16_t>(std::max(0, static_cast<int>(field[y][x]) + noise(rng)));
+        }
+    }
+}
+
+// 原 CentroidExtractor 的 BFS 连通域，作为对照组与正确性基准
+std::vector<std::vector<Engine::TouchPoint>> LegacyBfsBlobs(const HeatmapFrame& frame, int threshold) {
+    std::vector<bool> visited(kRows * kCols, false);
+    std::vector<std::vector<Engine::TouchPoint>> blobs;
+    for (int y = 0; y < kRows; ++y) {
+        for (int x = 0; x < kCols; ++x) {
+            if (visited[y * kCols + x] || frame.heatmapMatrix[y][x] < threshold) continue;
+            std::vector<Engine::TouchPoint> blob;
+            std::vector<std::pair<int, int>> queue;
+            queue.push_back({x, y});
+            visited[y * kCols + x] = true;
+            size_t head = 0;
+            while (head < queue.size()) {
+                auto [cx, cy] = queue[head++];
+                blob.push_back({static_cast<float>(cx), static_cast<float>(cy), static_cast<float>(frame.heatmapMatrix[cy][cx])});
+                static const int dxs[] = {-1, 0, 1, -1, 1, -1, 0, 1};
+                static const int dys[] = {-1, -1, -1, 0, 0, 1, 1, 1};
+                for (int i = 0; i < 8; ++i) {
+                    int nx = cx + dxs[i], ny = cy + dys[i];
+                    if (nx >= 0 && nx < kCols && ny >= 0 && ny < kRows) {
+                        int nIdx = ny * kCols + nx;
+                        if (!visited[nIdx] && frame.heatmapMatrix[ny][nx] >= threshold) {
+                            visited[nIdx] = true;
+                            queue.push_back({nx, ny});
+                        }
+                    }
+                }
+            }
+            blobs.push_back(std::move(blob));
+        }
+    }
+    return blobs;
+}
+
+// 连通域集合、顺序与像素数必须一致，矩中的 Σw 须与 BFS 像素强度和相等
+bool SameBlobs(const HeatmapFrame& frame, Engine::ComponentLabeler& labeler) {
+    auto legacy = LegacyBfsBlobs(frame, kThreshold);
+    if (labeler.Label(frame.heatmapMatrix, kThreshold) != static_cast<int>(legacy.size())) return false;
+    for (size_t b = 0; b < legacy.size(); ++b) {
+        std::vector<bool> mask(kRows * kCols, false);
+        int64_t sumW = 0;
+        for (const auto& p : legacy[b]) {
+            mask[static_cast<int>(p.y) * kCols + static_cast<int>(p.x)] = true;
+            sumW += static_cast<int64_t>(p.weight);
+        }
+        const Engine::BlobMoments moments = labeler.Moments(static_cast<int>(b));
+        if (moments.count != static_cast<int>(legacy[b].size()) || moments.sumW != sumW) return false;
+        bool inside = true;
+        labeler.ForEachPixel(static_cast<int>(b), [&](int x, int y) { inside = inside && mask[y * kCols + x]; });
+        if (!inside) return false;
+    }
+    return true;
+}
+
+template <typename Fn>
+double NsPerFrame(int iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) fn(i);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 20000;
+    constexpr int kScenes = 64;
+
+    std::printf("%-8s %14s %14s %16s %14s\n", "fingers", "bfs ns/frame", "uf ns/frame", "extract ns/frame", "allocs/frame");
+    for (int fingers : {0, 1, 5, 10}) {
+        static HeatmapFrame scenes[kScenes];
+        auto* labeler = new Engine::ComponentLabeler();
+        for (int s = 0; s < kScenes; ++s) {
+            BuildScene(scenes[s], fingers, 1000u * fingers + s);
+            if (!SameBlobs(scenes[s], *labeler)) {
+                std::printf("blob mismatch: fingers=%d scene=%d\n", fingers, s);
+                return 1;
+            }
+        }
+
+        volatile size_t sink = 0;
+        double bfsNs = NsPerFrame(iterations, [&](int i) {
+            sink = sink + LegacyBfsBlobs(scenes[i % kScenes], kThreshold).size();
+        });
+        double ufNs = NsPerFrame(iterations, [&](int i) {
+            sink = sink + labeler->Label(scenes[i % kScenes].heatmapMatrix, kThreshold);
+        });
+
+        auto* extractor = new Engine::CentroidExtractor();
+        HeatmapFrame work{};
+        work.contacts.reserve(64);
+        const size_t allocBefore = g_allocCount.load();
+        double extractNs = NsPerFrame(iterations, [&](int i) {
+            std::memcpy(work.heatmapMatrix, scenes[i % kScenes].heatmapMatrix, sizeof(work.heatmapMatrix));
+            extractor->Process(work);
+        });
+        const double allocs = static_cast<double>(g_allocCount.load() - allocBefore) / iterations;
+
+        std::printf("%-8d %14.1f %14.1f %16.1f %14.2f\n", fingers, bfsNs, ufNs, extractNs, allocs);
+        delete extractor;
+        delete labeler;
+    }
+    return 0;
+}
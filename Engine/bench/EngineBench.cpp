@@ -0,0 +1,418 @@
+// Engine 全处理器 / 全管线基准 (EngineBench)
+// SceneGenerator 预置场景 (idle / 1 指 / 5 指 / 手掌 / 并指 / 横扫) 与 DVR 录制帧，逐个
+// IFrameProcessor、完整 FramePipeline (融合 / 非融合)、帧编解码 (FrameCodec) 以及逐帧异常检测计时，
+// 输出 ns/帧、周期/帧、堆分配次数/帧；合成场景的完整管线行另附与真值比对的位置误差 /
+// 漏报 / 误报，编解码行另附平均编码帧长。
+// 输出为 CSV (默认) 或 JSON，便于 CI 存档与回归比对。
+//
+//   EngineBench [--iterations N] [--scene-frames N] [--rate Hz] [--dvr file.egdvr]... [--json]
+//
+// 说明：
+// - 单处理器基准的输入是“前序阶段处理后的帧”，每次调用前恢复热力图，恢复拷贝的
+//   开销单独测量后扣除。
+// - 单处理器基准强制启用该处理器；完整管线按出厂默认配置 (与 Coordinator 一致)。
+// - cycles 在 x86 上为 TSC 参考周期，其它平台输出 0。
+// - DVR 场景的输入为录制文件中保存的原始帧 (DvrRecord::raw)，经完整解析与处理。
+// - 计时前先用轨边边界值对拍各可用 SIMD 后端的饱和计数内核 (与按定义的计数及 Scalar 比较)，
+//   不一致时退出 (返回 1)。
+
+#include "AnomalyDetector.h"
+#include "BaselineSubtraction.h"
+#include "CentroidExtractor.h"
+#include "DvrMappedReader.h"
+#include "DynamicDeadzoneFilter.h"
+#include "FrameCodec.h"
+#include "FramePipeline.h"
+#include "GaussianFilter.h"
+#include "MasterFrameParser.h"
+#include "SceneGenerator.h"
+#include "SignalConditioningFilter.h"
+#include "SimdKernels.h"
+#include "SpatialSharpenFilter.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define ENGINE_BENCH_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define ENGINE_BENCH_TSC 1
+#endif
+
+namespace {
+
+std::atomic<size_t> g_allocCount{0};
+
+} // namespace
+
+// 全局 operator new 计数替换；GCC 会把 malloc/free 配对误报为 new/delete 不匹配
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+using Engine::HeatmapFrame;
+
+constexpr int kRawFrameBytes = 5063 + 339;
+constexpr int kRepetitions = 5;    // 取中位数
+
+uint64_t ReadCycles() {
+#if defined(ENGINE_BENCH_TSC)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// ---------------------------------------------------------
+// 场景
+
+struct Scene {
+    std::string name;
+    std::vector<HeatmapFrame> frames;                    // 仅 rawData 有效
+    std::vector<std::vector<Engine::SceneContact>> truth; // 合成场景的逐帧真值，DVR 场景为空
+};
+
+std::vector<Scene> BuildSyntheticScenes(int frameCount, double frameRateHz) {
+    std::vector<Scene> scenes;
+    for (Engine::SceneConfig config : Engine::SceneGenerator::Presets()) {
+        config.frameRateHz = frameRateHz;
+        Engine::SceneGenerator generator(config);
+        Scene scene{config.name, {}, {}};
+        for (int i = 0; i < frameCount; ++i) {
+            HeatmapFrame frame;
+            scene.truth.push_back(generator.Next(frame));
+            scene.frames.push_back(std::move(frame));
+        }
+        scenes.push_back(std::move(scene));
+    }
+    return scenes;
+}
+
+// DVR 录制 (.egdvr，StreamRecorder / Coordinator 导出)：直接使用记录中的 Master + Slave 原始数据，
+// 与设备读出的帧逐字节一致。原始数据被截断或缺失的记录 (kRawTruncated / rawSize 为 0) 被跳过
+bool LoadDvrScene(const std::string& path, Scene& scene) {
+    Engine::DvrMappedReader reader;
+    if (!reader.Open(path)) return false;
+
+    scene.name = "dvr:" + path.substr(path.find_last_of("/\\") + 1);
+    for (size_t i = 0; i < reader.FrameCount(); ++i) {
+        const Engine::DvrRecord* record = reader.Record(i);
+        if (!record) return false;
+        if (record->rawSize == 0 || (record->flags & Engine::DvrRecord::kRawTruncated)) continue;
+
+        const size_t size = std::min<size_t>(record->rawSize, kRawFrameBytes);
+        HeatmapFrame frame;
+        frame.rawData.assign(kRawFrameBytes, 0);
+        std::memcpy(frame.rawData.data(), record->raw, size);
+        scene.frames.push_back(std::move(frame));
+    }
+    return !scene.frames.empty();
+}
+
+// ---------------------------------------------------------
+// SIMD 对拍
+
+// LoadLe16CountRail 的轨边两端 (0 / margin / 0xFFFF - margin / 0xFFFF) 及其相邻值，
+// 长度取非向量宽度整数倍，覆盖向量主循环与标量尾部
+bool CheckRailKernels() {
+    using namespace Engine::Simd;
+    const uint16_t margins[] = {0, 1, 16, 4096, 0x7FFF};
+    const Backend backends[] = {Backend::Scalar, Backend::Neon, Backend::Sse41, Backend::Avx2};
+    const Backend active = Kernels().backend;
+    bool ok = true;
+    for (uint16_t margin : margins) {
+        const uint16_t edges[] = {0, margin, static_cast<uint16_t>(margin + 1), static_cast<uint16_t>(0xFFFE - margin),
+                                  static_cast<uint16_t>(0xFFFF - margin), 0xFFFF, 0x7FFF, 0x8000};
+        std::vector<uint8_t> src;
+        std::vector<int16_t> expected;
+        size_t expectedRail = 0;
+        for (size_t i = 0; i < 67; ++i) {
+            const uint16_t value = edges[i % std::size(edges)];
+            src.push_back(static_cast<uint8_t>(value));
+            src.push_back(static_cast<uint8_t>(value >> 8));
+            expected.push_back(static_cast<int16_t>(value));
+            expectedRail += value <= margin || value >= 0xFFFF - margin;
+        }
+        for (Backend backend : backends) {
+            if (!SelectBackend(backend)) continue;
+            std::vector<int16_t> dst(expected.size());
+            const size_t rail = Kernels().LoadLe16CountRail(src.data(), dst.data(), dst.size(), margin);
+            if (rail != expectedRail || dst != expected) {
+                std::fprintf(stderr, "LoadLe16CountRail mismatch on %s (margin %u): rail %zu, expected %zu\n",
+                             BackendName(backend), margin, rail, expectedRail);
+                ok = false;
+            }
+        }
+    }
+    SelectBackend(active);
+    return ok;
+}
+
+// ---------------------------------------------------------
+// 计时
+
+struct Measurement {
+    double nsPerFrame = 0.0;
+    double cyclesPerFrame = 0.0;
+    double allocsPerFrame = 0.0;
+};
+
+// fn(i) 处理第 i 帧；重复 kRepetitions 次取 ns 中位数
+Measurement Measure(int iterations, const std::function<void(int)>& fn) {
+    for (int i = 0; i < iterations / 10 + 1; ++i) fn(i);  // 预热 (含有状态处理器的历史)
+
+    std::vector<Measurement> runs;
+    for (int r = 0; r < kRepetitions; ++r) {
+        const size_t allocBefore = g_allocCount.load(std::memory_order_relaxed);
+        const uint64_t cyclesBefore = ReadCycles();
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) fn(i);
+        const auto end = std::chrono::steady_clock::now();
+        const uint64_t cyclesAfter = ReadCycles();
+
+        Measurement m;
+        m.nsPerFrame = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+        m.cyclesPerFrame = static_cast<double>(cyclesAfter - cyclesBefore) / iterations;
+        m.allocsPerFrame = static_cast<double>(g_allocCount.load(std::memory_order_relaxed) - allocBefore) / iterations;
+        runs.push_back(m);
+    }
+    std::sort(runs.begin(), runs.end(), [](const Measurement& a, const Measurement& b) { return a.nsPerFrame < b.nsPerFrame; });
+    return runs[runs.size() / 2];
+}
+
+struct ProcessorFactory {
+    const char* key;
+    std::function<std::unique_ptr<Engine::IFrameProcessor>()> make;
+};
+
+// 与 Coordinator 中的管线顺序一致
+const std::vector<ProcessorFactory>& Processors() {
+    static const std::vector<ProcessorFactory> factories = {
+        {"MasterFrameParser", [] { return std::make_unique<Engine::MasterFrameParser>(); }},
+        {"BaselineSubtraction", [] { return std::make_unique<Engine::BaselineSubtraction>(); }},
+        {"DynamicDeadzoneFilter", [] { return std::make_unique<Engine::DynamicDeadzoneFilter>(); }},
+        {"SignalConditioningFilter", [] { return std::make_unique<Engine::SignalConditioningFilter>(); }},
+        {"GaussianFilter", [] { return std::make_unique<Engine::GaussianFilter>(); }},
+        {"SpatialSharpenFilter", [] { return std::make_unique<Engine::SpatialSharpenFilter>(); }},
+        {"CentroidExtractor", [] { return std::make_unique<Engine::CentroidExtractor>(); }},
+    };
+    return factories;
+}
+
+struct Result {
+    std::string scene;
+    std::string stage;
+    int frames = 0;
+    Measurement m;
+    bool scored = false;         // 仅合成场景的完整管线行带精度
+    Engine::ContactScore score{};
+    double bytesPerFrame = 0.0;  // 仅编解码行：按时间顺序编码的平均帧长
+};
+
+void BenchScene(const Scene& scene, int iterations, std::vector<Result>& results) {
+    const int n = static_cast<int>(scene.frames.size());
+    const auto& factories = Processors();
+
+    // 各阶段的输入帧：stageInputs[k][i] = 第 i 帧经过前 k 个处理器后的结果
+    std::vector<std::vector<HeatmapFrame>> stageInputs(factories.size());
+    std::vector<HeatmapFrame> processed = scene.frames;   // 全部处理器之后的输出 (编解码输入)
+    {
+        std::vector<std::unique_ptr<Engine::IFrameProcessor>> chain;
+        for (const auto& f : factories) chain.push_back(f.make());
+        for (size_t k = 0; k < factories.size(); ++k) {
+            stageInputs[k] = processed;
+            for (auto& frame : processed) chain[k]->Process(frame);
+        }
+    }
+
+    HeatmapFrame work;
+    work.rawData.assign(kRawFrameBytes, 0);
+    work.contacts.reserve(64);
+
+    // 每次调用前恢复热力图的拷贝开销，从单处理器结果中扣除
+    const Measurement copy = Measure(iterations, [&](int i) {
+        std::memcpy(work.heatmapMatrix, stageInputs[1][i % n].heatmapMatrix, sizeof(work.heatmapMatrix));
+    });
+
+    for (size_t k = 0; k < factories.size(); ++k) {
+        auto processor = factories[k].make();
+        processor->SetEnabled(true);   // 默认关闭的处理器 (SpatialSharpenFilter) 也要计时
+        const std::vector<HeatmapFrame>& inputs = stageInputs[k];
+        Measurement m = Measure(iterations, [&](int i) {
+            const HeatmapFrame& in = inputs[i % n];
+            std::memcpy(work.heatmapMatrix, in.heatmapMatrix, sizeof(work.heatmapMatrix));
+            if (k == 0) std::memcpy(work.rawData.data(), in.rawData.data(), kRawFrameBytes);
+            processor->Process(work);
+        });
+        if (k != 0) {
+            m.nsPerFrame = std::max(0.0, m.nsPerFrame - copy.nsPerFrame);
+            m.cyclesPerFrame = std::max(0.0, m.cyclesPerFrame - copy.cyclesPerFrame);
+        }
+        results.push_back({scene.name, factories[k].key, n, m});
+    }
+
+    // 完整管线：解析器每帧从 rawData 重写热力图，无需恢复
+    for (bool fused : {true, false}) {
+        Engine::FramePipeline pipeline;
+        for (const auto& f : factories) pipeline.AddProcessor(f.make());
+        pipeline.SetFrontEndFusion(fused);
+        pipeline.SetProfilingEnabled(false);
+        const Measurement m = Measure(iterations, [&](int i) {
+            std::memcpy(work.rawData.data(), scene.frames[i % n].rawData.data(), kRawFrameBytes);
+            pipeline.Execute(work);
+        });
+        Result result{scene.name, fused ? "Pipeline(fused)" : "Pipeline(unfused)", n, m};
+
+        // 精度：按时间顺序再跑一遍场景，与真值逐帧比对 (有状态处理器已被计时阶段预热)
+        if (!scene.truth.empty()) {
+            result.scored = true;
+            for (int i = 0; i < n; ++i) {
+                std::memcpy(work.rawData.data(), scene.frames[i].rawData.data(), kRawFrameBytes);
+                pipeline.Execute(work);
+                result.score.Accumulate(Engine::ScoreContacts(scene.truth[i], work.contacts));
+            }
+        }
+        results.push_back(std::move(result));
+    }
+
+    // 帧编解码 (录制 / IPC)：原始数据 + 处理后矩阵 + 触点，按时间顺序编码，默认关键帧间隔
+    std::vector<std::vector<uint8_t>> encoded(n);
+    size_t encodedBytes = 0;
+    {
+        Engine::FrameEncoder encoder;
+        for (int i = 0; i < n; ++i) {
+            encoder.Encode(processed[i], encoded[i]);
+            encodedBytes += encoded[i].size();
+        }
+    }
+    Engine::FrameEncoder encoder;
+    std::vector<uint8_t> buffer;
+    buffer.reserve(64 << 10);
+    Result encodeResult{scene.name, "Codec(encode)", n, Measure(iterations, [&](int i) {
+        buffer.clear();
+        encoder.Encode(processed[i % n], buffer);
+    })};
+    encodeResult.bytesPerFrame = static_cast<double>(encodedBytes) / n;
+    results.push_back(encodeResult);
+
+    // 每轮从第 0 帧 (关键帧) 开始顺序解码
+    Engine::FrameDecoder decoder;
+    HeatmapFrame decoded;
+    decoded.rawData.reserve(kRawFrameBytes);
+    decoded.contacts.reserve(64);
+    Result decodeResult{scene.name, "Codec(decode)", n, Measure(iterations, [&](int i) {
+        decoder.Decode(encoded[i % n], decoded);
+    })};
+    decodeResult.bytesPerFrame = encodeResult.bytesPerFrame;
+    results.push_back(decodeResult);
+
+    // 逐帧异常检测 (处理线程上每帧执行)：输入为管线输出，按时间顺序循环
+    Engine::AnomalyDetector detector;
+    results.push_back({scene.name, "AnomalyDetector", n, Measure(iterations, [&](int i) {
+        detector.Inspect(processed[i % n]);
+    })});
+}
+
+void PrintCsv(const std::vector<Result>& results) {
+    std::printf("scene,stage,frames,ns_per_frame,cycles_per_frame,allocs_per_frame,"
+                "mean_error,max_error,missed,ghosts,bytes_per_frame\n");
+    for (const Result& r : results) {
+        std::printf("%s,%s,%d,%.1f,%.1f,%.3f", r.scene.c_str(), r.stage.c_str(), r.frames,
+                    r.m.nsPerFrame, r.m.cyclesPerFrame, r.m.allocsPerFrame);
+        if (r.scored) {
+            std::printf(",%.3f,%.3f,%d,%d,", r.score.MeanError(), r.score.maxError, r.score.missed, r.score.ghosts);
+        } else {
+            std::printf(",,,,,");
+        }
+        if (r.bytesPerFrame > 0.0) std::printf("%.1f", r.bytesPerFrame);
+        std::printf("\n");
+    }
+}
+
+void PrintJson(const std::vector<Result>& results, int iterations) {
+    std::printf("{\n  \"iterations\": %d,\n  \"results\": [\n", iterations);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        std::printf("    {\"scene\": \"%s\", \"stage\": \"%s\", \"frames\": %d, \"ns_per_frame\": %.1f, "
+                    "\"cycles_per_frame\": %.1f, \"allocs_per_frame\": %.3f",
+                    r.scene.c_str(), r.stage.c_str(), r.frames, r.m.nsPerFrame, r.m.cyclesPerFrame,
+                    r.m.allocsPerFrame);
+        if (r.scored) {
+            std::printf(", \"mean_error\": %.3f, \"max_error\": %.3f, \"missed\": %d, \"ghosts\": %d",
+                        r.score.MeanError(), r.score.maxError, r.score.missed, r.score.ghosts);
+        }
+        if (r.bytesPerFrame > 0.0) std::printf(", \"bytes_per_frame\": %.1f", r.bytesPerFrame);
+        std::printf("}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    std::printf("  ]\n}\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int iterations = 5000;
+    int sceneFrames = 64;
+    double frameRateHz = 240.0;
+    bool json = false;
+    std::vector<std::string> dvrFiles;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--scene-frames" && i + 1 < argc) {
+            sceneFrames = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--rate" && i + 1 < argc) {
+            frameRateHz = std::max(1.0, std::atof(argv[++i]));
+        } else if (arg == "--dvr" && i + 1 < argc) {
+            dvrFiles.push_back(argv[++i]);
+        } else if (arg == "--json") {
+            json = true;
+        } else {
+            std::fprintf(stderr, "usage: %s [--iterations N] [--scene-frames N] [--rate Hz] [--dvr file.egdvr]... [--json]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (!CheckRailKernels()) return 1;
+
+    std::vector<Scene> scenes = BuildSyntheticScenes(sceneFrames, frameRateHz);
+    for (const std::string& path : dvrFiles) {
+        Scene scene;
+        if (!LoadDvrScene(path, scene)) {
+            std::fprintf(stderr, "failed to load DVR frames from %s\n", path.c_str());
+            return 1;
+        }
+        scenes.push_back(std::move(scene));
+    }
+
+    std::vector<Result> results;
+    for (const Scene& scene : scenes) {
+        BenchScene(scene, iterations, results);
+    }
+
+    if (json) PrintJson(results, iterations);
+    else PrintCsv(results);
+    return 0;
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include "EngineTypes.h"
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace Engine {
+
+// ---------------------------------------------------------
+// 逐帧异常检测 (Anomaly Detector)
+// 在处理线程上对管线输出做常数级检查，命中时由上层 (App::AnomalySnapshotter) 自动截取
+// 前后若干帧存档，替代人工盯屏按 "Export DVR"。
+// 只读取触点列表、时间戳与解析器顺带统计的饱和格数，不扫描热力图矩阵；
+// 状态为定长数组，Inspect 不分配内存。
+
+enum AnomalyKind : uint32_t {
+    kAnomalyCountJump  = 1u << 0,   // 相邻帧触点数突变
+    kAnomalyGhost      = 1u << 1,   // 只存在一帧的触点 (前后帧附近都没有)
+    kAnomalyFlipFlop   = 1u << 2,   // 触点数在短窗口内反复增减 (分裂 / 合并来回切换)
+    kAnomalyFrameGap   = 1u << 3,   // 帧间隔远大于近期均值，或时间戳倒退
+    kAnomalySaturation = 1u << 4,   // 饱和格数达到阈值
+};
+
+inline constexpr int kAnomalyKindCount = 5;
+
+// 单个类别的名称 ("count-jump" 等)，bit 为 AnomalyKind 之一
+const char* AnomalyKindName(uint32_t bit);
+// 掩码 -> "count-jump+ghost"；0 时为空串
+std::string FormatAnomalyMask(uint32_t mask);
+
+struct AnomalyConfig {
+    uint32_t enabledMask = 0x1F;       // 参与检测的类别
+    int countJump = 2;                 // |n(t) - n(t-1)| >= countJump 视为突变
+    float ghostRadius = 3.0f;          // 前后帧在该半径 (格) 内有触点即不算 ghost (含快速滑动的位移)
+    int flipFlopReversals = 3;         // 窗口内触点数增减方向反转次数达到该值 (<= 16)
+    int flipFlopWindow = 8;            // 帧
+    float gapFactor = 2.5f;            // 帧间隔 > gapFactor x 近期均值
+    uint32_t saturatedCells = 1;       // 饱和格数阈值
+};
+
+struct AnomalyCounters {
+    uint64_t frames = 0;
+    std::array<uint64_t, kAnomalyKindCount> hits{};   // 按 AnomalyKind 的位序
+};
+
+class AnomalyDetector {
+public:
+    static constexpr int kMaxTrackedContacts = 16;   // 超出部分不参与 ghost 判断
+    static constexpr int kMaxReversals = 16;
+
+    explicit AnomalyDetector(const AnomalyConfig& config = {}) { SetConfig(config); }
+
+    // 检查一帧 (管线输出)，返回命中的 AnomalyKind 掩码。
+    // ghost 需要后一帧确认，因此在其出现的下一帧报告
+    uint32_t Inspect(const HeatmapFrame& frame);
+
+    // 清空历史 (如来源切换、回放跳转)；计数保留
+    void Reset();
+
+    // 越界的阈值被截断到有效范围
+    void SetConfig(const AnomalyConfig& config);
+    const AnomalyConfig& Config() const { return m_config; }
+    const AnomalyCounters& Counters() const { return m_counters; }
+
+private:
+    // 只有前 count 个有效，不做清零
+    struct Points {
+        int count = 0;
+        float x[kMaxTrackedContacts];
+        float y[kMaxTrackedContacts];
+    };
+
+    bool CheckGhost() const;
+    static bool HasNeighbour(const Points& points, float x, float y, float radius2);
+
+    AnomalyConfig m_config;
+    AnomalyCounters m_counters;
+    uint64_t m_frameIndex = 0;      // Reset 以来的帧数
+
+    // 最近三帧的触点位置，按 m_current 轮转：m_current 为本帧，(m_current + 2) % 3 为上一帧
+    std::array<Points, 3> m_points{};
+    int m_current = 0;
+
+    int m_lastCount = 0;
+    int m_lastDirection = 0;        // 上一次非零增减的方向 (+1 / -1)
+    // 最近的方向反转发生的帧 (环形)；只在反转时读写，常态每帧无开销
+    std::array<uint64_t, kMaxReversals> m_reversalFrames{};
+    int m_reversalHead = 0;
+    int m_reversalCount = 0;
+
+    uint64_t m_lastTimestamp = 0;
+    int64_t m_meanInterval = 0;     // 帧间隔均值 (ns)：前 16 帧为算术平均，之后为 1/16 指数滑动平均
+    int m_intervalSamples = 0;
+    float m_ghostRadius2 = 9.0f;
+    int64_t m_gapFactorQ4 = 40;     // gapFactor 的 1/16 定点表示，判断时不做浮点运算
+};
+
+} // namespace Engine
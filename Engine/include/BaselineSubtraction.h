@@ -7,6 +7,9 @@ class BaselineSubtraction : public IFrameProcessor {
 public:
     bool Process(HeatmapFrame& frame) override;
     std::string GetName() const override { return "Baseline Subtraction & Deadzone"; }
+
+    bool GetFrontEndStage(FrontEndStage& stage) const override;
+    void ContributeFrontEnd(FrontEndParams& params) override;
 };
 
 } // namespace Engine
@@ -1,5 +1,7 @@
 #pragma once
 #include "IFrameProcessor.h"
+#include "ComponentLabeler.h"
+#include <span>
 #include <vector>
 #include <cmath>
 #include <algorithm>
@@ -18,17 +20,40 @@ struct FingerCenter {
     float total_weight;
 };
 
+// 单个连通域的切分结果 (最多切成两指)，定长返回避免每帧堆分配
+struct SegmentResult {
+    FingerCenter centers[2];
+    int count = 0;
+};
+
+// 仅凭连通域矩得出的形状判决
+struct BlobAnalysis {
+    FingerCenter merged;      // 整体加权质心
+    bool needs_split = false; // true 时需逐像素 K-Means 切分
+    FingerCenter seeds[2];    // 沿主轴的 K-Means 初始中心
+};
+
+// 切分判决阈值：原为编译期常量，现随 CentroidExtractor 实例保存，
+// 经 DescribeParams 暴露给 UI 面板与参数扫描 (ParamSweep)
+struct SegmenterParams {
+    // --- 经过 DVR 回放数据验证的最佳动态阈值 ---
+    float aspectRatioThreshold = 1.9f;
+    float maxMinorAxisVariance = 5.0f;  // 从4.0放宽，允许拖拽时的“彗尾”变形
+    float minPhysicalDistance = 1.8f;   // 从2.5缩紧，允许双指在滑动时互相挤压靠得更近
+    float hugeWeightThreshold = 7000.f; // 新增：绝对重压阈值（对抗肩部融合）
+};
+
 class TouchSegmenter {
 public:
-    // --- 经过 DVR 回放数据验证的最佳动态阈值 ---
-    static constexpr float ASPECT_RATIO_THRESHOLD = 1.9f; 
-    static constexpr float MAX_MINOR_AXIS_VARIANCE = 5.0f; // 从4.0放宽，允许拖拽时的“彗尾”变形
-    static constexpr float MIN_PHYSICAL_DISTANCE = 1.8f;   // 从2.5缩紧，允许双指在滑动时互相挤压靠得更近
-    static constexpr float HUGE_WEIGHT_THRESHOLD = 7000.f; // 新增：绝对重压阈值（对抗肩部融合）
-
-    static std::vector<FingerCenter> analyze_and_segment_blob(
-        const std::vector<TouchPoint>& blob, 
-        const int16_t global_grid[40][60]);
+    // 快速路径：质心 / PCA / 判决全部由矩计算，不访问像素
+    static BlobAnalysis analyze_blob(const BlobMoments& moments, const SegmenterParams& params);
+
+    // 慢速路径：仅对 needs_split 的连通域执行 K-Means 与物理距离 / 谷值校验
+    static SegmentResult split_blob(
+        const BlobAnalysis& analysis,
+        std::span<const TouchPoint> blob, 
+        const int16_t global_grid[40][60],
+        const SegmenterParams& params);
 };
 
 class CentroidExtractor : public IFrameProcessor {
@@ -39,14 +64,19 @@ public:
     bool Process(HeatmapFrame& frame) override;
     std::string GetName() const override { return "PCA-KMeans Centroid Extractor"; }
 
-    void DrawConfigUI() override;
+    const char* GetDescription() const override;
+    void DescribeParams(std::vector<ParamDesc>& params) override;
 
 private:
     float CalculateGaussianParaboloid(const HeatmapFrame& frame, int cx, int cy, float& outY) const;
 
+    ComponentLabeler m_labeler;
+    TouchPoint m_blobPoints[ComponentLabeler::kPixels];
+
     int m_algorithm = 1; // 0 for Native PCA, 1 for Gaussian Paraboloid
     int m_peakThreshold = 80; // 建议默认底噪下调到 80，提高边缘响应
     float m_minPeakDist = 4.0f;
+    SegmenterParams m_segmenter;
 };
 
 } // namespace Engine
\ No newline at end of file
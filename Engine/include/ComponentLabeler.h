@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+
+namespace Engine {
+
+// 单个连通域的原始矩 (w 为像素强度，x / y 为像素坐标)，整数累加结果精确
+struct BlobMoments {
+    int64_t sumW = 0;
+    int64_t sumWX = 0;
+    int64_t sumWY = 0;
+    int64_t sumWXX = 0;
+    int64_t sumWXY = 0;
+    int64_t sumWYY = 0;
+    int count = 0;
+    int minX = 0, minY = 0, maxX = 0, maxY = 0;   // 包围盒 (含端点)
+    int16_t peak = 0;                              // 最大强度，并列时取光栅顺序第一个
+    int peakX = 0, peakY = 0;
+};
+
+// 8 连通域标记器 (Two-pass Union-Find Connected Component Labeler)
+// 在带 1 像素零边框的标签平面上扫描，邻域访问无需越界判断；
+// 行最大值低于阈值的整行直接跳过，后续各遍只遍历前景像素列表。
+// 标记的同时以 SoA 形式按临时标签累加原始矩，合并时并入根标签，
+// 因此质心 / PCA 判决无需展开逐像素数据。
+// 全部存储在构造时固定分配，每帧零堆分配。
+//
+// 输出与原 BFS 逐域一致：连通域按其首个像素的光栅顺序编号。
+class ComponentLabeler {
+public:
+    static constexpr int kRows = 40;
+    static constexpr int kCols = 60;
+    static constexpr int kPixels = kRows * kCols;
+
+    ComponentLabeler();
+
+    // 标记 grid 中 >= threshold 的像素并累加各连通域的矩，返回连通域数量
+    int Label(const int16_t grid[kRows][kCols], int threshold);
+
+    int ComponentCount() const { return m_componentCount; }
+
+    BlobMoments Moments(int component) const;
+
+    // 按光栅顺序访问第 component 个连通域的像素：fn(x, y)
+    // 只扫描该连通域的包围盒，供需要逐像素数据的少数连通域 (K-Means 切分) 使用
+    template <typename Fn>
+    void ForEachPixel(int component, Fn&& fn) const {
+        const uint16_t root = m_rootOf[component];
+        for (int y = m_minY[root]; y <= m_maxY[root]; ++y) {
+            const uint16_t* row = m_labels + (y + 1) * kStride + 1;
+            for (int x = m_minX[root]; x <= m_maxX[root]; ++x) {
+                if (row[x] && m_final[row[x]] == component) fn(x, y);
+            }
+        }
+    }
+
+private:
+    static constexpr int kStride = kCols + 2;
+    // 新临时标签要求 W 邻居为背景，每行至多 kCols / 2 个
+    static constexpr int kMaxLabels = kRows * ((kCols + 1) / 2) + 1;
+
+    uint16_t FindRoot(uint16_t label);
+    void Merge(uint16_t a, uint16_t b);
+
+    uint16_t m_labels[(kRows + 2) * kStride];  // 0 = 背景 / 边框，只有上一帧的前景像素需要清除
+    uint16_t m_foreground[kPixels];            // 前景像素光栅索引 (光栅顺序)
+    int m_foregroundCount = 0;
+    uint16_t m_parent[kMaxLabels];
+    uint16_t m_final[kMaxLabels];              // 临时标签 -> 连通域编号
+    uint16_t m_rootOf[kMaxLabels];             // 连通域编号 -> 根标签 (矩存放位置)
+    int m_componentCount = 0;
+
+    // 按临时标签存放的矩 (SoA)
+    int64_t m_sumW[kMaxLabels];
+    int64_t m_sumWX[kMaxLabels];
+    int64_t m_sumWY[kMaxLabels];
+    int64_t m_sumWXX[kMaxLabels];
+    int64_t m_sumWXY[kMaxLabels];
+    int64_t m_sumWYY[kMaxLabels];
+    int32_t m_count[kMaxLabels];
+    uint8_t m_minX[kMaxLabels], m_minY[kMaxLabels], m_maxX[kMaxLabels], m_maxY[kMaxLabels];
+    int16_t m_peak[kMaxLabels];
+    uint16_t m_peakPixel[kMaxLabels];
+};
+
+} // namespace Engine
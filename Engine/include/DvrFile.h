@@ -0,0 +1,212 @@
+#pragma once
+#include "EngineTypes.h"
+#include "FrameCodec.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace Engine {
+
+// ---------------------------------------------------------
+// DVR 二进制录制格式 (.egdvr)，小端，版本 1
+//
+//   [DvrFileHeader 64B][DvrRecord 0]...[DvrRecord N-1][DvrIndexEntry x N][DvrFooter 32B]
+//
+// - 记录定长且按 64 字节对齐：第 i 帧位于 headerSize + i * recordSize，可直接 mmap
+//   后按下标访问，无需解析。
+// - 文件尾的索引 (序号 + 时间戳) 供按时间定位；未正常关闭 (无 footer) 的文件仍可按
+//   (文件长度 - 头) / recordSize 恢复出完整写入的记录。
+// - 结构体只含定宽字段且自然对齐，MSVC / GCC / Clang 在 x64 与 ARM64 上布局一致。
+//
+// 压缩文件 (flags & kDvrCompressed，recordSize = 0) 以变长块代替定长记录：
+//
+//   [DvrFileHeader][DvrChunkHeader + FrameEncoder 数据] x N[DvrIndexEntry x N][DvrChunkIndexEntry x N][DvrFooter]
+//
+// - 每 keyframeInterval 帧一个关键帧，随机访问时从最近的关键帧向后解码。
+// - 无 footer 时沿块头逐块扫描恢复。
+
+static_assert(std::endian::native == std::endian::little, "DVR files are little-endian");
+
+inline constexpr char kDvrMagic[8] = {'E', 'G', 'T', 'D', 'V', 'R', '\0', '\0'};
+inline constexpr char kDvrIndexMagic[8] = {'E', 'G', 'T', 'D', 'V', 'R', 'I', 'X'};
+inline constexpr uint16_t kDvrVersion = 1;
+
+enum DvrFileFlags : uint16_t {
+    kDvrCompressed = 1 << 0,   // 记录为 FrameEncoder 变长块
+};
+
+struct DvrFileHeader {
+    char magic[8];
+    uint16_t version;
+    uint16_t headerSize;       // = sizeof(DvrFileHeader)，读者据此跳到第一条记录
+    uint32_t recordSize;       // = sizeof(DvrRecord)；压缩文件为 0
+    uint32_t rawCapacity;      // 每条记录的原始数据区容量
+    uint32_t masterBytes;      // 5063
+    uint32_t slaveBytes;       // 339
+    uint16_t rows;             // 40
+    uint16_t cols;             // 60
+    uint16_t maxContacts;
+    uint16_t flags;            // DvrFileFlags
+    uint32_t keyframeInterval; // 压缩文件的关键帧间隔，非压缩为 0
+    uint64_t configHash;       // FramePipeline::ConfigHash()，录制时的管线配置
+    uint64_t createdUnixNs;    // 文件创建时刻 (system_clock)
+    uint8_t reserved[8];
+};
+static_assert(sizeof(DvrFileHeader) == 64);
+
+struct DvrContact {
+    int32_t id;
+    float x;
+    float y;
+    int32_t state;
+    int32_t area;
+};
+static_assert(sizeof(DvrContact) == 20);
+
+struct DvrRecord {
+    static constexpr int kMaxContacts = 16;
+    static constexpr size_t kRawCapacity = 5432;   // >= 5063 + 339，补齐到 64 字节整数倍
+
+    enum Flags : uint16_t {
+        kContactsTruncated = 1 << 0,   // 触点数超过 kMaxContacts，只保存了前 kMaxContacts 个
+        kRawTruncated = 1 << 1,        // 原始数据超过 kRawCapacity
+    };
+
+    uint64_t sequence;                 // 写入顺序号 (从 0 起)
+    uint64_t timestamp;                // HeatmapFrame::timestamp
+    uint64_t traceNs[6];               // FrameTrace: readStart, readDone, enqueue, dequeue, processed, published
+    uint32_t stageNs[FrameTrace::kMaxStages];
+    uint16_t rawSize;                  // raw 中的有效字节数
+    uint8_t stageCount;
+    uint8_t contactCount;
+    uint16_t flags;
+    uint16_t reserved;
+    int16_t heatmap[40][60];           // 管线处理后的矩阵
+    DvrContact contacts[kMaxContacts];
+    uint8_t raw[kRawCapacity];         // Master + Slave 原始数据
+};
+static_assert(sizeof(DvrRecord) % 64 == 0, "records must stay 64-byte aligned in the file");
+static_assert(offsetof(DvrRecord, heatmap) % 8 == 0);
+
+struct DvrIndexEntry {
+    uint64_t sequence;
+    uint64_t timestamp;
+};
+
+// 压缩文件中每帧数据前的块头
+struct DvrChunkHeader {
+    enum Flags : uint16_t {
+        kKeyframe = 1 << 0,
+    };
+
+    uint32_t size;             // 其后 FrameEncoder 数据的字节数
+    uint16_t flags;
+    uint16_t reserved;
+    uint64_t timestamp;        // 与块内时间戳相同，供恢复索引时不解码
+};
+static_assert(sizeof(DvrChunkHeader) == 16);
+
+// 单块上限，防止损坏的块头导致超大分配 (正常块远小于一条 DvrRecord)
+inline constexpr uint32_t kDvrMaxChunkSize = 1u << 20;
+
+// 压缩文件在 DvrIndexEntry 之后追加的块位置表
+struct DvrChunkIndexEntry {
+    uint64_t offset;           // DvrChunkHeader 的文件偏移
+    uint32_t size;             // 块数据字节数 (不含块头)
+    uint16_t flags;            // DvrChunkHeader::Flags
+    uint16_t reserved;
+};
+static_assert(sizeof(DvrChunkIndexEntry) == 16);
+
+struct DvrFooter {
+    char magic[8];             // kDvrIndexMagic
+    uint64_t indexOffset;      // 第一条 DvrIndexEntry 的文件偏移
+    uint64_t recordCount;
+    uint64_t reserved;
+};
+static_assert(sizeof(DvrFooter) == 32);
+
+// 帧 <-> 记录 (纯内存转换，不分配)
+void EncodeDvrRecord(const HeatmapFrame& frame, uint64_t sequence, DvrRecord& record);
+void DecodeDvrRecord(const DvrRecord& record, HeatmapFrame& frame);
+
+// 顺序写入器：Open 写文件头，Append 每帧一次 fwrite，Close 追加索引与 footer。
+// compressed 时以 FrameEncoder 编码为变长块 (见文件头注释)。
+// 不是线程安全的；由调用方保证单线程使用。
+class DvrWriter {
+public:
+    DvrWriter() = default;
+    ~DvrWriter();
+    DvrWriter(const DvrWriter&) = delete;
+    DvrWriter& operator=(const DvrWriter&) = delete;
+
+    bool Open(const std::string& path, uint64_t configHash, bool compressed = false, uint32_t keyframeInterval = 60);
+    bool Append(const HeatmapFrame& frame);
+    // 写索引与 footer 并关闭；失败时文件仍可被读者按定长记录 / 块头恢复
+    bool Close();
+
+    bool IsOpen() const { return m_file != nullptr; }
+    uint64_t RecordCount() const { return m_index.size(); }
+    // 已写入的字节数 (含文件头，不含 Close 时追加的索引)
+    uint64_t BytesWritten() const { return m_bytesWritten; }
+
+private:
+    FILE* m_file = nullptr;
+    DvrRecord m_scratch{};
+    std::vector<DvrIndexEntry> m_index;
+    uint64_t m_bytesWritten = 0;
+    bool m_ok = false;
+
+    bool m_compressed = false;
+    FrameEncoder m_encoder;
+    std::vector<uint8_t> m_chunk;      // 块头 + 编码数据
+    std::vector<DvrChunkIndexEntry> m_chunks;
+};
+
+// 随机访问读取器 (stdio)：Open 校验文件头并载入索引
+class DvrReader {
+public:
+    DvrReader() = default;
+    ~DvrReader();
+    DvrReader(const DvrReader&) = delete;
+    DvrReader& operator=(const DvrReader&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    const DvrFileHeader& Header() const { return m_header; }
+    bool IsCompressed() const { return (m_header.flags & kDvrCompressed) != 0; }
+    size_t RecordCount() const { return m_index.size(); }
+    const std::vector<DvrIndexEntry>& Index() const { return m_index; }
+    // 文件缺少 footer (录制中断) 时为 true，索引由记录本身重建
+    bool IsRecovered() const { return m_recovered; }
+
+    // 压缩文件按顺序读取时每帧只解码一次；跳转时从最近的关键帧解码到目标帧
+    bool ReadRecord(size_t index, DvrRecord& record);
+    bool ReadFrame(size_t index, HeatmapFrame& frame);
+
+private:
+    bool LoadIndex(uint64_t fileSize);
+    bool RecoverIndex(uint64_t fileSize);
+    bool DecodeChunk(size_t index, HeatmapFrame& frame);
+
+    FILE* m_file = nullptr;
+    DvrFileHeader m_header{};
+    std::vector<DvrIndexEntry> m_index;
+    bool m_recovered = false;
+
+    std::vector<DvrChunkIndexEntry> m_chunks;
+    std::vector<uint8_t> m_chunk;
+    FrameDecoder m_decoder;
+    size_t m_decodedIndex = SIZE_MAX;  // m_decoder 当前参考帧对应的记录下标
+};
+
+// 把 DVR 文件转换为文本 CSV，布局沿用原 TriggerDVRExport ("--- Frame [i] --- TS"、40 行热力图、触点列表)，
+// 但每帧多一行 Trace (延迟区段，us)，触点最多 DvrRecord::kMaxContacts (16) 个，多出的在录制时已截断；
+// includeRawSuffix 时每帧附带 Master (128 words) / Slave (166 words) 尾部数据
+bool ConvertDvrToCsv(const std::string& dvrPath, const std::string& csvPath, bool includeRawSuffix = false);
+
+} // namespace Engine
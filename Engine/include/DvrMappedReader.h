@@ -0,0 +1,129 @@
+#pragma once
+#include "DvrFile.h"
+#include "FrameCodec.h"
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Engine {
+
+// 只读内存映射文件 (Windows: CreateFileMapping / MapViewOfFile，其它平台: mmap)
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+    const uint8_t* Data() const { return m_data; }
+    uint64_t Size() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    uint64_t m_size = 0;
+#if defined(_WIN32)
+    void* m_file = nullptr;      // HANDLE
+    void* m_mapping = nullptr;   // HANDLE
+#endif
+};
+
+// 内存映射的 DVR 读取器 (Memory-Mapped DVR Reader)
+// 整个文件只映射不读入，按帧号 / 时间戳 O(log n) 定位，页面由系统按需换入，
+// 数小时的录制也只占用实际访问到的内存。
+// - 非压缩文件：Record() 直接返回映射内存中的 DvrRecord (零拷贝)，footer 中的索引同样
+//   直接引用映射内存。
+// - 压缩文件：Record() 解码到内部缓存；顺序前进每帧只解码一次，跳转从最近关键帧解码。
+// - 无 footer (录制中断或仍在写入) 时与 DvrReader 相同地从记录 / 块头重建索引，
+//   只能看到打开那一刻已写入的帧。
+// 不是线程安全的。
+class DvrMappedReader {
+public:
+    DvrMappedReader() = default;
+    DvrMappedReader(const DvrMappedReader&) = delete;
+    DvrMappedReader& operator=(const DvrMappedReader&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return m_file.IsOpen(); }
+    const std::string& Path() const { return m_path; }
+    const DvrFileHeader& Header() const { return m_header; }
+    bool IsCompressed() const { return (m_header.flags & kDvrCompressed) != 0; }
+    bool IsRecovered() const { return m_recovered; }
+
+    size_t FrameCount() const { return m_index.size(); }
+    std::span<const DvrIndexEntry> Index() const { return m_index; }
+    uint64_t FirstTimestamp() const { return m_index.empty() ? 0 : m_index.front().timestamp; }
+    uint64_t LastTimestamp() const { return m_index.empty() ? 0 : m_index.back().timestamp; }
+
+    // 时间戳不晚于 timestamp 的最后一帧；早于第一帧时返回 0 (二分查找)
+    size_t FindByTimestamp(uint64_t timestamp) const;
+
+    // 第 index 帧的记录；失败返回 nullptr。
+    // 非压缩文件的指针在 Close 前一直有效，压缩文件的指针在下一次 Record / ReadFrame 前有效。
+    const DvrRecord* Record(size_t index);
+    bool ReadFrame(size_t index, HeatmapFrame& frame);
+
+private:
+    bool LoadIndex();
+    void RecoverIndex();
+    bool DecodeTo(size_t index);
+
+    MappedFile m_file;
+    std::string m_path;
+    DvrFileHeader m_header{};
+    bool m_recovered = false;
+
+    // 指向映射内存；footer 缺失或索引未对齐时改为指向 m_owned*
+    std::span<const DvrIndexEntry> m_index;
+    std::span<const DvrChunkIndexEntry> m_chunks;
+    std::vector<DvrIndexEntry> m_ownedIndex;
+    std::vector<DvrChunkIndexEntry> m_ownedChunks;
+
+    FrameDecoder m_decoder;
+    HeatmapFrame m_decoded;
+    std::unique_ptr<DvrRecord> m_record;
+    size_t m_decodedIndex = SIZE_MAX;   // m_decoded 对应的帧
+    size_t m_recordIndex = SIZE_MAX;    // m_record 对应的帧
+};
+
+// 一组录制文件 (例如 StreamRecorder 轮转出的 session_*.egdvr) 拼接成的一条时间线。
+// 帧号为全局连续编号；文件按创建时间排序，时间戳定位假设各文件的时间戳依次递增
+// (同一次运行内的录制成立)。
+class DvrSession {
+public:
+    // path 为单个 .egdvr 文件，或目录 (打开其中全部 .egdvr 文件)；无法解析的文件被跳过。
+    // 返回是否至少打开了一个含有帧的文件
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return !m_files.empty(); }
+    size_t FileCount() const { return m_files.size(); }
+    const DvrMappedReader& File(size_t i) const { return *m_files[i]; }
+    size_t SkippedFiles() const { return m_skipped; }
+
+    size_t FrameCount() const { return m_firstFrame.empty() ? 0 : m_firstFrame.back(); }
+    uint64_t FirstTimestamp() const { return m_files.empty() ? 0 : m_files.front()->FirstTimestamp(); }
+    uint64_t LastTimestamp() const { return m_files.empty() ? 0 : m_files.back()->LastTimestamp(); }
+    uint64_t Timestamp(size_t index) const;
+
+    // 全局帧号 -> (文件下标, 文件内帧号)
+    std::pair<size_t, size_t> Locate(size_t index) const;
+    // 时间戳不晚于 timestamp 的最后一帧 (先按文件、再在文件内二分)
+    size_t FindByTimestamp(uint64_t timestamp) const;
+
+    const DvrRecord* Record(size_t index);
+    bool ReadFrame(size_t index, HeatmapFrame& frame);
+
+private:
+    std::vector<std::unique_ptr<DvrMappedReader>> m_files;
+    std::vector<size_t> m_firstFrame;   // m_firstFrame[i] = 第 i 个文件的首帧全局编号，末尾追加总帧数
+    size_t m_skipped = 0;
+};
+
+} // namespace Engine
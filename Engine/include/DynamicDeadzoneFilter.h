@@ -16,7 +16,11 @@ public:
     bool Process(HeatmapFrame& frame) override;
     std::string GetName() const override { return "Dynamic Row Deadzone"; }
 
-    void DrawConfigUI() override;
+    const char* GetDescription() const override;
+    void DescribeParams(std::vector<ParamDesc>& params) override;
+
+    bool GetFrontEndStage(FrontEndStage& stage) const override;
+    void ContributeFrontEnd(FrontEndParams& params) override;
 
 private:
     int m_shrinkPercent = 20; // 默认取行最高峰的 20% 作为噪声截断线
@@ -1,4 +1,5 @@
 #pragma once
+#include "FrameTrace.h"
 #include <vector>
 #include <cstdint>
 #include <array>
@@ -25,10 +26,17 @@ struct HeatmapFrame {
     // 从 heatmap 中解析出来的触控点列表
     std::vector<TouchContact> contacts;
 
-    // 时间戳或其他元数据
+    // 采样时间戳 (TraceNowNs，设备读完该帧的时刻)
     uint64_t timestamp;
 
-    HeatmapFrame() : timestamp(0) {
+    // 端到端延迟打点
+    FrameTrace trace;
+
+    // 原始值贴近 0 / 0xFFFF 的格数 (ADC 饱和)，由 MasterFrameParser 在加载时顺带统计；
+    // 不写入录制文件，回放时重新计算
+    uint32_t saturatedCells;
+
+    HeatmapFrame() : timestamp(0), saturatedCells(0) {
         // 初始化矩阵全0
         for (int i=0; i<40; ++i) {
             for (int j=0; j<60; ++j) {
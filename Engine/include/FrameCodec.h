@@ -0,0 +1,71 @@
+#pragma once
+#include "EngineTypes.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Engine {
+
+// ---------------------------------------------------------
+// 帧编解码 (Delta + Zero-Run Frame Codec)，无损
+//
+// 每帧两个 16-bit 平面：原始数据 (Master + Slave，按小端字对齐到热力图所在的奇数偏移)
+// 与处理后的 heatmapMatrix。
+//   - 关键帧：平面内与左邻元素做差分 (空间预测)，不依赖任何前序帧
+//   - 增量帧：与上一帧同位置元素做差分 (时间预测)
+// 差分经 zigzag 映射后每 16 个元素一块打包，块头一个字节：
+//   0x80 | (k - 1)  k 个连续全零块 (零游程，k <= 128)
+//   w = 1~16        本块 16 个值按 w 位紧密打包，随后 2w 字节
+// 差分 / 逆差分 / 零段扫描走 Simd::Kernels()，位打包为标量 (块间无依赖，不逐字节解析长度)。
+// 触点、时间戳、打点随帧以 varint 保存。编码器每 keyframeInterval 帧强制一个关键帧，
+// 读者可从任一关键帧开始解码。
+
+class FrameEncoder {
+public:
+    explicit FrameEncoder(uint32_t keyframeInterval = 60);
+
+    // 把一帧编码后追加到 out；返回本帧是否为关键帧
+    bool Encode(const HeatmapFrame& frame, std::vector<uint8_t>& out);
+
+    // 下一帧强制输出关键帧 (例如新文件开始、消费者重连)
+    void ForceKeyframe() { m_forceKeyframe = true; }
+
+    uint32_t KeyframeInterval() const { return m_keyframeInterval; }
+
+private:
+    uint32_t m_keyframeInterval;
+    uint32_t m_sinceKeyframe = 0;
+    bool m_forceKeyframe = true;
+
+    size_t m_rawSize = 0;
+    uint64_t m_prevTimestamp = 0;
+    std::vector<int16_t> m_prevRaw;     // 上一帧的原始数据字
+    std::vector<int16_t> m_curRaw;
+    int16_t m_prevMatrix[40 * 60] = {};
+    std::vector<uint16_t> m_zigzag;     // 差分暂存
+    std::vector<uint8_t> m_tokens;      // token 暂存 (按最坏情况预留)
+};
+
+class FrameDecoder {
+public:
+    FrameDecoder();
+
+    // 解码一帧 (必须按编码顺序喂入；从关键帧开始)。数据损坏、或尚未遇到关键帧就收到增量帧时
+    // 返回 false，此后需要重新从关键帧开始。
+    bool Decode(std::span<const uint8_t> data, HeatmapFrame& frame);
+
+    // 丢弃参考帧状态 (跳转时使用)
+    void Reset() { m_hasReference = false; }
+
+    static bool IsKeyframe(std::span<const uint8_t> data);
+
+private:
+    bool m_hasReference = false;
+    size_t m_rawSize = 0;
+    uint64_t m_prevTimestamp = 0;
+    std::vector<int16_t> m_prevRaw;
+    int16_t m_prevMatrix[40 * 60] = {};
+    std::vector<uint16_t> m_zigzag;
+};
+
+} // namespace Engine
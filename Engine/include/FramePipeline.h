@@ -1,5 +1,7 @@
 #pragma once
 #include "IFrameProcessor.h"
+#include "LatencyHistogram.h"
+#include <atomic>
 #include <vector>
 #include <memory>
 
@@ -19,8 +21,46 @@ public:
     // Retrieve all processors to allow GUI to toggle them
     const std::vector<std::unique_ptr<IFrameProcessor>>& GetProcessors() const;
 
+    // 管线配置指纹：处理器顺序、名称、启用状态与全部 DescribeParams 参数值的 FNV-1a 哈希。
+    // 随录制文件保存，用于判断回放时的配置是否与录制时一致；应在修改参数的线程 (GUI) 调用。
+    uint64_t ConfigHash() const;
+
+    // 相邻逐点阶段融合开关 (默认开启)；关闭后逐个调用 Process，用于对拍与基准
+    void SetFrontEndFusion(bool enabled) { m_fuseFrontEnd = enabled; }
+    bool IsFrontEndFusionEnabled() const { return m_fuseFrontEnd; }
+
+    // --- 延迟统计 (Latency Instrumentation) ---
+    // 开启时 Execute 以 steady_clock 为每个处理器计时并计数；关闭时只多一次分支判断。
+    // 统计由处理线程写入，可在任意线程读取。
+    void SetProfilingEnabled(bool enabled) { m_profiling.store(enabled, std::memory_order_relaxed); }
+    bool IsProfilingEnabled() const { return m_profiling.load(std::memory_order_relaxed); }
+
+    // 与 GetProcessors() 下标一一对应；处理器被融合执行时只累加 calls，耗时计入 GetFrontEndStats()
+    const ProcessorStats& GetProcessorStats(size_t index) const { return *m_stats[index]; }
+    // 融合执行的逐点区间 (一次遍历覆盖多个处理器)
+    const ProcessorStats& GetFrontEndStats() const { return m_frontEndStats; }
+    // 整个 Execute 的耗时，drops 为被丢弃的帧数
+    const ProcessorStats& GetPipelineStats() const { return m_pipelineStats; }
+
+    // 请求清零全部统计，由处理线程在下一次 Execute 开始时执行
+    void ResetStats() { m_resetStats.store(true, std::memory_order_relaxed); }
+
 private:
+    // 从 begin 开始、阶段顺序严格递增的逐点处理器区间的结束位置 (不含)
+    size_t FindFrontEndRun(size_t begin) const;
+    void ExecuteFrontEnd(size_t begin, size_t end, HeatmapFrame& frame);
+
      std::vector<std::unique_ptr<IFrameProcessor>> m_processors;
+     std::vector<std::unique_ptr<ProcessorStats>> m_stats;   // 与 m_processors 同步增删 / 换位
+     bool m_fuseFrontEnd = true;
+
+     std::atomic<bool> m_profiling{true};
+     std::atomic<bool> m_resetStats{false};
+     ProcessorStats m_frontEndStats;
+     ProcessorStats m_pipelineStats;
 };
 
+// 出厂默认处理链 (Coordinator 与离线工具共用同一份顺序与默认参数)，追加到 pipeline 末尾
+void AddDefaultProcessors(FramePipeline& pipeline);
+
 } // namespace Engine
@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace Engine {
+
+// 全链路统一的单调时钟 (ns)，跨线程可比较
+inline uint64_t TraceNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// 单帧端到端时间戳 (Frame Latency Trace)，0 表示该点未打点
+// 采集线程：readStart -> readDone -> enqueue；处理线程：dequeue -> processed -> published
+struct FrameTrace {
+    static constexpr int kMaxStages = 16;
+
+    uint64_t readStartNs = 0;   // 开始等待 / 读取设备帧
+    uint64_t readDoneNs = 0;    // Chip::GetFrame 返回 (Master + Slave 均已读完)
+    uint64_t enqueueNs = 0;     // 推入采集 -> 处理队列
+    uint64_t dequeueNs = 0;     // 处理线程取出
+    uint64_t processedNs = 0;   // FramePipeline::Execute 完成
+    // 已发布给 GUI (三缓冲 Publish 返回)、交给录制 / DVR 之前。此时 GUI 可能已在读该帧，
+    // 因此只经 StampPublished 写入，并发读取经 PublishedNs
+    alignas(std::atomic_ref<uint64_t>::required_alignment) uint64_t publishedNs = 0;
+
+    // 按处理器下标记录的阶段耗时 (ns)，仅在管线开启统计时写入；
+    // 融合执行的逐点区间整体计入其第一个处理器，其余成员为 0
+    uint32_t stageNs[kMaxStages] = {};
+    uint8_t stageCount = 0;
+
+    uint64_t DeviceIoNs() const { return Span(readStartNs, readDoneNs); }
+    uint64_t QueueNs() const { return Span(readDoneNs, dequeueNs); }
+    uint64_t ProcessingNs() const { return Span(dequeueNs, processedNs); }
+    uint64_t PublicationNs() const { return Span(processedNs, PublishedNs()); }
+    uint64_t EndToEndNs() const { return Span(readStartNs, PublishedNs()); }
+
+    void StampPublished(uint64_t ns) { std::atomic_ref<uint64_t>(publishedNs).store(ns, std::memory_order_relaxed); }
+    uint64_t PublishedNs() const {
+        return std::atomic_ref<uint64_t>(const_cast<uint64_t&>(publishedNs)).load(std::memory_order_relaxed);
+    }
+
+private:
+    static uint64_t Span(uint64_t from, uint64_t to) { return (from && to >= from) ? to - from : 0; }
+};
+
+} // namespace Engine
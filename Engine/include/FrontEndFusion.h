@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+
+namespace Engine {
+
+// 前端逐点阶段 (Point-wise Front-End Stage)
+// 枚举值即融合内核中的固定执行顺序：基线 -> 死区 -> IIR + 截底。
+// 只有管线中按此顺序相邻排列的阶段才会被 FramePipeline 合并。
+enum class FrontEndStage : uint8_t {
+    Baseline = 0,
+    Deadzone = 1,
+    Conditioning = 2,
+};
+
+// 各逐点阶段在本帧贡献的参数，由 IFrameProcessor::ContributeFrontEnd 填写。
+// 阶段被禁用时不填写对应字段，融合内核跳过该步骤，行为与单独执行 Process 一致。
+struct FrontEndParams {
+    // BaselineSubtraction: x = int16(x - baseline)
+    bool subtractBaseline = false;
+    int16_t baseline = 0;
+
+    // DynamicDeadzoneFilter: x = max(0, x - globalMax * shrinkPercent / 100)
+    bool deadzone = false;
+    int32_t shrinkPercent = 0;
+
+    // SignalConditioningFilter: IIR (仅正信号) + 线性截底
+    bool conditioning = false;
+    int32_t alpha = 1000;
+    int16_t noiseFloor = 0;
+    int16_t* history = nullptr;    // 40 * 60 历史帧，由处理器持有
+    bool seedHistory = false;      // 首帧：以本帧输入作为历史
+};
+
+} // namespace Engine
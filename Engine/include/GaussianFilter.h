@@ -12,7 +12,8 @@ public:
     bool Process(HeatmapFrame& frame) override;
     std::string GetName() const override { return "3x3 Gaussian Filter"; }
 
-    void DrawConfigUI() override;
+    const char* GetDescription() const override;
+    void DescribeParams(std::vector<ParamDesc>& params) override;
 
 private:
     std::vector<int16_t> m_temp;
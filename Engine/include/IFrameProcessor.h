@@ -1,6 +1,9 @@
 #pragma once
 #include "EngineTypes.h"
+#include "FrontEndFusion.h"
+#include "ProcessorParams.h"
 #include <string>
+#include <vector>
 
 namespace Engine {
 
@@ -13,7 +16,7 @@ namespace Engine {
  * 模块设计原则：
  * 1. 顺序无关性：在合理排序后，各模块应独立完成其功能。
  * 2. 帧驱动：每一帧数据流入 Pipeline 后由各 Processor 链式处理。
- * 3. 可控性：支持动态使能/禁用，并可通过 UI 导出特定参数供调试。
+ * 3. 可控性：支持动态使能/禁用，并通过参数描述符导出可调参数 (UI 面板由上层适配层绘制)。
  */
 class IFrameProcessor {
 public:
@@ -29,8 +32,20 @@ public:
     virtual bool IsEnabled() const { return m_enabled; }
     virtual void SetEnabled(bool enabled) { m_enabled = enabled; }
 
-    // Draw ImGui configuration panel for specific parameters
-    virtual void DrawConfigUI() {}
+    // 一句话说明，由 UI 面板显示在参数上方
+    virtual const char* GetDescription() const { return ""; }
+
+    // 追加本处理器的可调参数描述符 (指向成员，调用方可直接读写)
+    virtual void DescribeParams(std::vector<ParamDesc>& params) { (void)params; }
+
+    // 逐点融合钩子 (Point-wise Fusion Hook)
+    // 逐点阶段返回 true 并给出其在融合内核中的位置；FramePipeline 会把相邻的
+    // 逐点阶段合并为一次向量化遍历，此时不再调用它们的 Process。
+    virtual bool GetFrontEndStage(FrontEndStage& stage) const { (void)stage; return false; }
+
+    // 融合执行时代替 Process 被调用：写入本帧参数并完成与 Process 相同的状态更新
+    // (包括禁用时的状态复位)。
+    virtual void ContributeFrontEnd(FrontEndParams& params) { (void)params; }
 
 protected:
     bool m_enabled = true;
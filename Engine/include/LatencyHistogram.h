@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Engine {
+
+// 延迟分布摘要 (单位 ns)；分位数取所在桶的上界，误差 < 1/32
+struct LatencySummary {
+    uint64_t count = 0;
+    uint64_t p50 = 0;
+    uint64_t p90 = 0;
+    uint64_t p99 = 0;
+    uint64_t max = 0;
+    double mean = 0.0;
+};
+
+// HDR 风格对数-线性直方图 (Log-Linear Latency Histogram)
+// 每个 2 的幂区间再均分为 32 个子桶，1 ns ~ 137 s 范围内相对误差恒定，内存固定约 8.5 KB。
+// 单写者：Record / Clear 只能由同一线程 (处理线程) 调用，只用 relaxed load + store，无锁前缀指令；
+// Summarize 可在任意线程并发调用，得到的是近似一致的快照 (足够用于监控)。
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 5;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kMaxExponent = 37;  // 2^37 ns ≈ 137 s，更大的值计入最后一个桶
+    static constexpr size_t kBucketCount = kSubBuckets + (kMaxExponent - kSubBucketBits + 1) * kSubBuckets;
+
+    void Record(uint64_t ns) {
+        Bump(m_buckets[BucketIndex(ns)]);
+        m_sum.store(m_sum.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+        if (ns > m_max.load(std::memory_order_relaxed)) m_max.store(ns, std::memory_order_relaxed);
+    }
+
+    void Clear();
+
+    LatencySummary Summarize() const;
+
+    static size_t BucketIndex(uint64_t ns);
+    // 桶内最大值 (含)
+    static uint64_t BucketUpperBound(size_t index);
+
+private:
+    static void Bump(std::atomic<uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> m_buckets[kBucketCount] = {};
+    std::atomic<uint64_t> m_sum{0};
+    std::atomic<uint64_t> m_max{0};
+};
+
+// 单个处理器 (或融合区间、整条管线) 的运行统计
+struct ProcessorStats {
+    LatencyHistogram latency;
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> drops{0};   // Process 返回 false 的次数
+
+    void Clear() {
+        latency.Clear();
+        calls.store(0, std::memory_order_relaxed);
+        drops.store(0, std::memory_order_relaxed);
+    }
+};
+
+} // namespace Engine
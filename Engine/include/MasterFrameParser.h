@@ -7,6 +7,11 @@ class MasterFrameParser : public IFrameProcessor {
 public:
     bool Process(HeatmapFrame& frame) override;
     std::string GetName() const override { return "Master Frame Parser"; }
+    void DescribeParams(std::vector<ParamDesc>& params) override;
+
+private:
+    // 原始值距 0 或 0xFFFF 不超过该值即计为饱和格 (HeatmapFrame::saturatedCells)
+    int m_railMargin = 16;
 };
 
 } // namespace Engine
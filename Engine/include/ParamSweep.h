@@ -0,0 +1,126 @@
+#pragma once
+#include "FramePipeline.h"
+#include "SceneGenerator.h"
+#include "WorkStealingPool.h"
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Engine {
+
+// ---------------------------------------------------------
+// 离线参数扫描 (Parameter Sweep)
+// 把管线的一组参数组合在合成场景 (带真值) 与录制文件 (无真值) 上逐帧重放并评分，
+// 按综合代价排序。每个 (参数组合, 输入) 任务新建一条独立管线，IIR 历史、基线等
+// 处理器状态互不共享，任务在 WorkStealingPool 上并行执行。
+// 参数只经由 ParamDesc 读写，新增的可调参数无需改动本模块即可参与扫描。
+
+// 一个扫描维度：管线中的一个 ParamDesc
+struct SweepAxis {
+    std::string key;     // "处理器名/参数名"；参数名在管线中唯一时可省略处理器名
+    double min = 0.0;
+    double max = 0.0;
+    int steps = 1;       // 网格点数 (含两端)；1 = 只取 min
+};
+
+// 一组参数取值，与 axes 一一对应
+using SweepPoint = std::vector<double>;
+
+// 扫描输入：合成场景 (recording 为空) 或 .egdvr 文件 / 录制目录
+struct SweepInput {
+    std::string name;
+    SceneConfig scene;
+    int frames = 480;        // 合成场景帧数
+    std::string recording;   // 非空时为录制输入 (见 DvrSession)
+
+    bool HasTruth() const { return recording.empty(); }
+};
+
+struct SweepMetrics {
+    uint64_t frames = 0;           // 参与评分的帧 (不含预热帧)
+    ContactScore score;            // 仅有真值的输入
+    uint64_t splits = 0;           // 误报中紧挨着一个已匹配手指的部分 (一指报成多点)，是 ghosts 的子集
+    uint64_t merges = 0;           // 漏报中附近检测点已匹配给另一手指的部分 (多指报成一点)，是 missed 的子集
+    uint64_t countChanges = 0;     // 相邻帧检测点数变化 (有真值时只计真值点数不变的帧)
+    double jitterSum = 0.0;        // 有真值：相邻帧定位误差向量之差的模；无真值：位置二阶差分的模
+    uint64_t jitterSamples = 0;
+    bool failed = false;           // 管线无法构建或录制无法打开，指标无效
+
+    double MeanJitter() const { return jitterSamples ? jitterSum / jitterSamples : 0.0; }
+    void Accumulate(const SweepMetrics& other);
+};
+
+// 综合代价 = 各项归一化指标的加权和 (越小越好)。
+// 误分裂 / 误合并从误报 / 漏报中分出来单独计权，每个点只计一次
+struct SweepWeights {
+    double error = 1.0;      // 平均定位误差 (格)
+    double missed = 2.0;     // 其余漏报 / 真值点数
+    double ghosts = 2.0;     // 其余误报 / 真值点数
+    double splits = 4.0;     // 误分裂 / 真值点数
+    double merges = 4.0;     // 误合并 / 真值点数
+    double jitter = 4.0;     // 平均抖动 (格)
+    double flicker = 1.0;    // 点数跳变 / 帧数
+};
+
+double SweepCost(const SweepMetrics& metrics, const SweepWeights& weights);
+
+struct SweepResult {
+    SweepPoint point;
+    SweepMetrics metrics;
+    double cost = 0.0;
+    bool failed = false;     // 任一输入评估失败；排在全部成功的结果之后，不参与排名
+};
+
+// --- 参数空间采样 ---
+std::vector<SweepPoint> GridPoints(std::span<const SweepAxis> axes);
+std::vector<SweepPoint> RandomPoints(std::span<const SweepAxis> axes, size_t count, uint64_t seed);
+// 在 center 附近 (每轴范围 x radius 内) 均匀采样并截断到轴范围，用于逐轮收缩的局部细化
+std::vector<SweepPoint> LocalPoints(std::span<const SweepAxis> axes, const SweepPoint& center, double radius,
+                                    size_t count, uint64_t seed);
+
+// 管线全部可调参数，键为 "处理器名/参数名"
+std::vector<std::pair<std::string, ParamDesc>> ListParams(FramePipeline& pipeline);
+// 按键查找参数；找不到或参数名不唯一时返回 false 并写出原因
+bool FindParam(FramePipeline& pipeline, const std::string& key, ParamDesc& out, std::string* error = nullptr);
+
+class ParamSweep {
+public:
+    using PipelineFactory = std::function<void(FramePipeline&)>;
+
+    ParamSweep(std::vector<SweepAxis> axes, std::vector<SweepInput> inputs,
+               PipelineFactory factory = AddDefaultProcessors);
+
+    // 检查每个轴都能在管线中解析、每个录制输入都能打开且含有帧；失败时写出原因
+    bool Validate(std::string& error) const;
+
+    // 出厂默认配置在各轴上的取值 (作为对照行)
+    SweepPoint DefaultPoint() const;
+
+    // 各组合写入管线后实际生效的取值 (截断到参数范围、整型参数四舍五入)；
+    // 取值相同的组合评估结果相同，可据此去重
+    std::vector<SweepPoint> EffectivePoints(std::span<const SweepPoint> points) const;
+
+    // 并行评估全部 points，返回按 cost 升序排列的结果 (失败的组合排在最后)
+    std::vector<SweepResult> Evaluate(std::span<const SweepPoint> points, WorkStealingPool& pool) const;
+
+    // 单个 (参数组合, 输入) 的评分；在调用线程上新建独立管线执行
+    SweepMetrics EvaluateOne(const SweepPoint& point, const SweepInput& input) const;
+
+    const std::vector<SweepAxis>& Axes() const { return m_axes; }
+    const std::vector<SweepInput>& Inputs() const { return m_inputs; }
+
+    SweepWeights weights;
+    int warmupFrames = 16;        // 每个输入开头不评分的帧 (基线 / IIR 收敛)
+    float matchDistance = 2.0f;   // 检测点与真值的匹配半径 (格)
+
+private:
+    bool BuildPipeline(FramePipeline& pipeline, const SweepPoint& point) const;
+
+    std::vector<SweepAxis> m_axes;
+    std::vector<SweepInput> m_inputs;
+    PipelineFactory m_factory;
+};
+
+} // namespace Engine
@@ -0,0 +1,72 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <span>
+
+namespace Engine {
+
+enum class ParamType {
+    Int,
+    Float,
+    Choice,   // int 下标，取值为 choices 中的一项
+};
+
+// 可调参数描述符 (Parameter Reflection)
+// 处理器通过 DescribeParams 暴露指向自身成员的描述符，UI 面板、参数扫描、回放工具
+// 都只经由描述符读写参数，算法核心因此不依赖任何 UI 库。
+struct ParamDesc {
+    const char* name = "";
+    ParamType type = ParamType::Int;
+    int* intValue = nullptr;                 // Int / Choice
+    float* floatValue = nullptr;             // Float
+    float min = 0.0f;
+    float max = 0.0f;
+    const char* format = nullptr;            // 显示格式 (printf 风格)，nullptr 为默认
+    std::span<const char* const> choices;    // Choice 的选项标签
+
+    static ParamDesc Int(const char* name, int* value, int min, int max, const char* format = nullptr) {
+        ParamDesc d;
+        d.name = name;
+        d.type = ParamType::Int;
+        d.intValue = value;
+        d.min = static_cast<float>(min);
+        d.max = static_cast<float>(max);
+        d.format = format;
+        return d;
+    }
+
+    static ParamDesc Float(const char* name, float* value, float min, float max, const char* format = nullptr) {
+        ParamDesc d;
+        d.name = name;
+        d.type = ParamType::Float;
+        d.floatValue = value;
+        d.min = min;
+        d.max = max;
+        d.format = format;
+        return d;
+    }
+
+    static ParamDesc Choice(const char* name, int* value, std::span<const char* const> choices) {
+        ParamDesc d;
+        d.name = name;
+        d.type = ParamType::Choice;
+        d.intValue = value;
+        d.min = 0.0f;
+        d.max = static_cast<float>(choices.empty() ? 0 : choices.size() - 1);
+        d.choices = choices;
+        return d;
+    }
+
+    double Get() const {
+        return type == ParamType::Float ? static_cast<double>(*floatValue) : static_cast<double>(*intValue);
+    }
+
+    // 写入前截断到 [min, max]，整型参数四舍五入
+    void Set(double value) const {
+        value = std::clamp(value, static_cast<double>(min), static_cast<double>(max));
+        if (type == ParamType::Float) *floatValue = static_cast<float>(value);
+        else *intValue = static_cast<int>(std::lround(value));
+    }
+};
+
+} // namespace Engine
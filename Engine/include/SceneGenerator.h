@@ -0,0 +1,131 @@
+#pragma once
+#include "EngineTypes.h"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Engine {
+
+// ---------------------------------------------------------
+// 合成热力图场景 (Synthetic Heatmap Scene)
+// 生成与真实设备格式一致的原始帧 (Master 5063 + Slave 339 字节，热力图为
+// Master 偏移 7 处的 40x60 小端 uint16)，可直接交给 MasterFrameParser，
+// 并给出每帧触点的真值位置，用于无硬件的压力、精度与延迟测试。
+// 随机数为自带的确定性序列，同一配置在任意平台 / 编译器上生成相同帧。
+
+enum class ContactKind : uint8_t {
+    Finger,
+    Palm,
+};
+
+// 一个触点在时间轴上的轨迹：start -> end 线性移动，可叠加圆周运动
+struct SceneTrack {
+    int id = 1;
+    ContactKind kind = ContactKind::Finger;
+    float amplitude = 900.0f;     // 峰值 (扣基线后的信号量)
+    float sigmaX = 1.5f;          // 高斯半宽 (格)
+    float sigmaY = 1.5f;
+    float angle = 0.0f;           // 椭圆主轴方向 (弧度)
+
+    double startTime = 0.0;       // 秒，[startTime, endTime) 内存在
+    double endTime = 1e9;
+    float startX = 30.0f, startY = 20.0f;
+    float endX = 30.0f, endY = 20.0f;
+    float moveDuration = 0.0f;    // start -> end 用时 (秒)，0 为停在 start
+    bool pingPong = false;        // 到达 end 后往返，用于长时间负载场景
+
+    float circleRadius = 0.0f;    // 圆周运动半径 (格)，0 为纯线性
+    float circleHz = 0.0f;        // 圆周运动频率
+};
+
+struct SceneNoise {
+    uint16_t baseline = 0x7FFE;       // 原始值基底
+    float whiteNoise = 12.0f;         // 逐点高斯噪声标准差
+    float rowCommonMode = 15.0f;      // 逐行共模噪声标准差 (每帧每行一个随机偏移)
+    float baselineDrift = 25.0f;      // 基底正弦漂移幅度
+    float baselineDriftPeriod = 4.0f; // 漂移周期 (秒)
+};
+
+struct SceneConfig {
+    std::string name = "scene";
+    double frameRateHz = 240.0;
+    uint64_t seed = 1;
+    SceneNoise noise;
+    std::vector<SceneTrack> tracks;
+};
+
+// 单帧中一个触点的真值 (热力图坐标：x 为列 0~59，y 为行 0~39)
+struct SceneContact {
+    int id;
+    ContactKind kind;
+    float x;
+    float y;
+    float amplitude;
+    float sigma;     // 较大的高斯半宽，Palm 据此划定不计 ghost 的范围
+};
+
+class SceneGenerator {
+public:
+    static constexpr int kRows = 40;
+    static constexpr int kCols = 60;
+    static constexpr size_t kMasterFrameBytes = 5063;
+    static constexpr size_t kSlaveFrameBytes = 339;
+    static constexpr size_t kRawFrameBytes = kMasterFrameBytes + kSlaveFrameBytes;
+    static constexpr size_t kHeatmapOffset = 7;
+
+    explicit SceneGenerator(SceneConfig config);
+
+    // 生成下一帧：写入 frame.rawData (调整为 kRawFrameBytes) 与 frame.timestamp
+    // (合成时钟，ns)，并返回本帧触点真值 (引用在下一次调用前有效)
+    const std::vector<SceneContact>& Next(HeatmapFrame& frame);
+
+    // 回到第 0 帧 (随机序列一并复位)
+    void Reset();
+
+    uint64_t FrameIndex() const { return m_frameIndex; }
+    double CurrentTime() const { return m_frameIndex / m_config.frameRateHz; }
+    const SceneConfig& Config() const { return m_config; }
+
+    // --- 预置场景 ---
+    static SceneConfig Idle();
+    static SceneConfig OneFinger();
+    static SceneConfig FiveFingers();
+    static SceneConfig Palm();
+    static SceneConfig MergedFingers();   // 两指由 8 格逐渐靠拢到 2 格，"肩部"融合
+    static SceneConfig Swipe();           // 单指横扫 + 圆周抖动
+    static std::vector<SceneConfig> Presets();
+
+private:
+    uint32_t NextRandom();
+    float NextGaussian();
+
+    SceneConfig m_config;
+    uint64_t m_frameIndex = 0;
+    uint64_t m_rngState = 0;
+    std::vector<SceneContact> m_truth;
+    float m_signal[kRows][kCols];
+};
+
+// ---------------------------------------------------------
+// 精度评估：按最近邻把检测触点匹配到真值 (距离 <= maxDistance 格)
+
+struct ContactScore {
+    int truthCount = 0;
+    int detectedCount = 0;
+    int matched = 0;
+    int missed = 0;        // 真值未被匹配
+    int ghosts = 0;        // 检测结果未匹配到真值
+    double sumError = 0.0; // 已匹配对的位置误差之和 (格)
+    double maxError = 0.0;
+
+    double MeanError() const { return matched ? sumError / matched : 0.0; }
+    void Accumulate(const ContactScore& other);
+};
+
+// 只统计 Finger 真值；Palm 不参与匹配，落在手掌 2 sigma 内的未匹配检测点也不算 ghost
+// (是否对手掌报点由上层策略决定)
+ContactScore ScoreContacts(std::span<const SceneContact> truth, std::span<const TouchContact> detected,
+                           float maxDistance = 2.0f);
+
+} // namespace Engine
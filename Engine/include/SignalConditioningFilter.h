@@ -16,7 +16,11 @@ public:
     bool Process(HeatmapFrame& frame) override;
     std::string GetName() const override { return "Signal Conditioning (IIR + Clip)"; }
 
-    void DrawConfigUI() override;
+    const char* GetDescription() const override;
+    void DescribeParams(std::vector<ParamDesc>& params) override;
+
+    bool GetFrontEndStage(FrontEndStage& stage) const override;
+    void ContributeFrontEnd(FrontEndParams& params) override;
 
 private:
     int16_t m_historyData[40 * 60];
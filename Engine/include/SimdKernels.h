@@ -0,0 +1,111 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace Engine::Simd {
+
+/**
+ * @brief 可移植 SIMD 内核层 (Portable SIMD Kernel Layer)
+ *
+ * 所有 IFrameProcessor 的逐点 / 卷积热点循环统一走这里的函数表。
+ * 同一个 Engine 二进制在启动时通过 CPUID / HWCAP 探测 CPU 能力，选出最优后端：
+ *   - ARM64 平板：NEON
+ *   - x86 回放 / 分析机：AVX2 > SSE4.1
+ *   - 其它或被强制关闭：Scalar
+ *
+ * 约定：每个后端的输出必须与 Scalar 参考实现逐位一致 (bit-identical)，
+ * 包括 int16 回绕减法、整除截断等细节，保证切换后端不会改变触点结果。
+ */
+enum class Backend : uint8_t {
+    Scalar = 0,
+    Neon,
+    Sse41,
+    Avx2,
+};
+
+// 融合前端内核的逐帧参数 (由 FramePipeline 从 FrontEndParams 解析得到)
+// 逐点顺序: 基线减法 -> 死区推顶 -> IIR (仅正信号) -> 截底
+struct FrontEndArgs {
+    int16_t baseline = 0;          // 0 即不做基线减法
+    bool deadzone = false;
+    int16_t shrinkValue = 0;       // 已由全局最大值解析出的死区水位 (> 0)
+    bool conditioning = false;
+    int32_t alpha = 1000;
+    int16_t noiseFloor = 0;
+    int16_t* history = nullptr;
+    bool seedHistory = false;      // true 时以 IIR 输入本身作为历史帧
+};
+
+struct KernelTable {
+    Backend backend;
+    const char* name;
+
+    // 小端 16-bit 原始流 -> int16 矩阵 (src 无对齐要求)
+    void (*LoadLe16)(const uint8_t* src, int16_t* dst, size_t count);
+
+    // 同 LoadLe16，并返回原始值 (uint16) 落在轨边 [0, margin] 或 [0xFFFF - margin, 0xFFFF] 内的个数
+    // (ADC 饱和格)；margin < 0x8000
+    size_t (*LoadLe16CountRail)(const uint8_t* src, int16_t* dst, size_t count, uint16_t margin);
+
+    // data[i] = int16(data[i] - value)，回绕语义 (与 vsubq_s16 一致)
+    void (*SubConst)(int16_t* data, size_t count, int16_t value);
+
+    // 返回 max(init, data[0..count))
+    int16_t (*ReduceMax)(const int16_t* data, size_t count, int16_t init);
+
+    // data[i] = max(0, int16(data[i] - value))
+    void (*SubClampZero)(int16_t* data, size_t count, int16_t value);
+
+    // IIR 时域平滑：data[i] > 0 时 data[i] = (data[i] * alpha + history[i] * (1000 - alpha)) / 1000，
+    // 随后无条件 history[i] = data[i]
+    void (*IirBlendPositive)(int16_t* data, int16_t* history, size_t count, int32_t alpha);
+
+    // 返回 max(init, int16(data[i] - value))，只读；死区水位的预扫描
+    int16_t (*SubReduceMax)(const int16_t* data, size_t count, int16_t value, int16_t init);
+
+    // 融合前端：一次加载、一次存储完成 FrontEndArgs 描述的全部逐点阶段，
+    // 结果与依次调用 SubConst / SubClampZero / IirBlendPositive / SubClampZero 逐位一致
+    void (*FrontEndApply)(int16_t* data, size_t count, const FrontEndArgs& args);
+
+    // 3x3 可变中心权重高斯，仅写 dst 的内部像素 (边框保持不变)
+    // 核: [1 2 1; 2 c 2; 1 2 1] / (12 + c)
+    void (*Gaussian3x3)(const int16_t* src, int16_t* dst, int rows, int cols, int32_t centerWeight);
+
+    // 拉普拉斯反锐化，仅写 dst 的内部像素:
+    // dst = clamp(center + int32(strength * (4c - t - b - l - r)), 0, 4095)
+    void (*Sharpen3x3)(const int16_t* src, int16_t* dst, int rows, int cols, float strength);
+
+    // --- 帧编解码 (FrameCodec) ---
+    // out[i] = zigzag(int16(cur[i] - prev[i]))，zigzag(d) = (d << 1) ^ (d >> 15)；cur 与 prev 可错位重叠
+    void (*DeltaZigZag)(const int16_t* cur, const int16_t* prev, uint16_t* out, size_t count);
+
+    // DeltaZigZag 的逆运算：out[i] = int16(prev[i] + unzigzag(z[i]))；out 可与 prev 相同 (原地)
+    void (*UnZigZagAdd)(const uint16_t* z, const int16_t* prev, int16_t* out, size_t count);
+
+    // 返回 [begin, count) 中第一个非零元素的下标，全为零时返回 count
+    size_t (*FindNonZero)(const uint16_t* data, size_t begin, size_t count);
+};
+
+// 当前生效的内核表 (首次调用时自动探测)
+const KernelTable& Kernels();
+
+// 当前 CPU 上可用的最佳后端
+Backend DetectBestBackend();
+
+// 运行时是否支持某个后端 (编译期未包含或 CPU 不支持均返回 false)
+bool IsBackendSupported(Backend backend);
+
+// 强制切换后端 (基准测试 / 对拍用)，不支持时返回 false 且保持原后端
+bool SelectBackend(Backend backend);
+
+const char* BackendName(Backend backend);
+
+namespace detail {
+    // 各后端的函数表，编译目标不匹配时返回 nullptr
+    const KernelTable* ScalarKernels();
+    const KernelTable* NeonKernels();
+    const KernelTable* Sse41Kernels();
+    const KernelTable* Avx2Kernels();
+}
+
+} // namespace Engine::Simd
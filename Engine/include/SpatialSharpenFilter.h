@@ -16,11 +16,13 @@ public:
     bool IsEnabled() const override { return m_enabled; }
     void SetEnabled(bool enabled) override { m_enabled = enabled; }
     
-    void DrawConfigUI() override;
+    const char* GetDescription() const override;
+    void DescribeParams(std::vector<ParamDesc>& params) override;
 
 private:
     bool m_enabled = false; // Default off, let the user toggle when needed
     float m_strength = 1.0f; // Sharpening factor
+    int16_t m_temp[40 * 60]{}; // 邻域快照，避免每帧堆分配
 };
 
 } // namespace Engine
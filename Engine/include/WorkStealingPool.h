@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Engine {
+
+// 工作窃取线程池 (Work-Stealing Thread Pool)
+// 每个工作线程一条双端队列：自己从尾部取 (LIFO，缓存友好)，空闲时从其它线程队列
+// 头部窃取 (FIFO，先偷大块任务)。面向粗粒度任务 (整段录制的回放 / 评分)，
+// 队列用互斥锁保护即可，无需无锁 deque。
+class WorkStealingPool {
+public:
+    // threads = 0 时使用 std::thread::hardware_concurrency()
+    explicit WorkStealingPool(unsigned threads = 0);
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // 任意线程可提交；工作线程内提交的任务进入本线程队列，外部提交按轮转分发
+    void Submit(std::function<void()> task);
+
+    // 阻塞到已提交的任务全部执行完毕 (不可在工作线程内调用)
+    void Wait();
+
+    unsigned ThreadCount() const { return static_cast<unsigned>(m_workers.size()); }
+    // 从其它线程队列窃取成功的次数
+    uint64_t Steals() const { return m_steals.load(std::memory_order_relaxed); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void WorkerLoop(unsigned index);
+    bool TryPop(unsigned index, std::function<void()>& task);
+    bool TrySteal(unsigned thief, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_mutex;                  // 保护休眠 / 唤醒与完成通知
+    std::condition_variable m_workReady;
+    std::condition_variable m_allDone;
+    size_t m_queued = 0;                 // 已提交未取走的任务 (m_mutex 保护)
+    size_t m_outstanding = 0;            // 已提交未完成的任务 (m_mutex 保护)
+    bool m_stopping = false;
+
+    std::atomic<unsigned> m_nextQueue{0};
+    std::atomic<uint64_t> m_steals{0};
+};
+
+} // namespace Engine
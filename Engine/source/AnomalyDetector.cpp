@@ -0,0 +1,152 @@
+#include "AnomalyDetector.h"
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+
+namespace Engine {
+
+namespace {
+
+constexpr const char* kKindNames[kAnomalyKindCount] = {
+    "count-jump", "ghost", "flip-flop", "frame-gap", "saturation",
+};
+
+// 帧间隔均值至少积累这么多样本后才判断 frame-gap
+constexpr int kGapWarmupSamples = 8;
+constexpr int kIntervalShift = 4;   // EMA 系数 1/16
+
+} // namespace
+
+const char* AnomalyKindName(uint32_t bit) {
+    if (!std::has_single_bit(bit) || std::countr_zero(bit) >= kAnomalyKindCount) return "unknown";
+    return kKindNames[std::countr_zero(bit)];
+}
+
+std::string FormatAnomalyMask(uint32_t mask) {
+    std::string text;
+    for (int i = 0; i < kAnomalyKindCount; ++i) {
+        if (!(mask & (1u << i))) continue;
+        if (!text.empty()) text += '+';
+        text += kKindNames[i];
+    }
+    return text;
+}
+
+void AnomalyDetector::SetConfig(const AnomalyConfig& config) {
+    m_config = config;
+    m_config.countJump = std::max(1, m_config.countJump);
+    m_config.flipFlopReversals = std::clamp(m_config.flipFlopReversals, 1, kMaxReversals);
+    m_config.flipFlopWindow = std::max(1, m_config.flipFlopWindow);
+    m_config.gapFactor = std::max(1.0f, m_config.gapFactor);
+    m_config.saturatedCells = std::max(1u, m_config.saturatedCells);
+    m_gapFactorQ4 = static_cast<int64_t>(m_config.gapFactor * (1 << kIntervalShift) + 0.5f);
+    m_ghostRadius2 = m_config.ghostRadius * m_config.ghostRadius;
+}
+
+void AnomalyDetector::Reset() {
+    m_frameIndex = 0;
+    m_points = {};
+    m_current = 0;
+    m_lastCount = 0;
+    m_lastDirection = 0;
+    m_reversalHead = 0;
+    m_reversalCount = 0;
+    m_lastTimestamp = 0;
+    m_meanInterval = 0;
+    m_intervalSamples = 0;
+}
+
+bool AnomalyDetector::HasNeighbour(const Points& points, float x, float y, float radius2) {
+    for (int i = 0; i < points.count; ++i) {
+        const float dx = points.x[i] - x;
+        const float dy = points.y[i] - y;
+        if (dx * dx + dy * dy <= radius2) return true;
+    }
+    return false;
+}
+
+// 上一帧的某个触点在它前后两帧的邻域内都找不到对应点 -> 只存在了一帧
+bool AnomalyDetector::CheckGhost() const {
+    const Points& current = m_points[m_current];
+    const Points& previous = m_points[(m_current + 2) % 3];
+    const Points& beforePrevious = m_points[(m_current + 1) % 3];
+    for (int i = 0; i < previous.count; ++i) {
+        if (!HasNeighbour(beforePrevious, previous.x[i], previous.y[i], m_ghostRadius2) &&
+            !HasNeighbour(current, previous.x[i], previous.y[i], m_ghostRadius2)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t AnomalyDetector::Inspect(const HeatmapFrame& frame) {
+    ++m_counters.frames;
+    uint32_t mask = 0;
+    const int count = static_cast<int>(frame.contacts.size());
+
+    if (m_frameIndex > 0) {
+        // 触点数突变与来回切换 (只看增减方向，方向反转的帧号记入环形表)
+        const int delta = count - m_lastCount;
+        if (std::abs(delta) >= m_config.countJump) mask |= kAnomalyCountJump;
+        if (delta != 0) {
+            const int direction = delta > 0 ? 1 : -1;
+            if (m_lastDirection != 0 && direction != m_lastDirection) {
+                m_reversalFrames[m_reversalHead] = m_frameIndex;
+                m_reversalHead = (m_reversalHead + 1) % kMaxReversals;
+                m_reversalCount = std::min(m_reversalCount + 1, kMaxReversals);
+                const int need = m_config.flipFlopReversals;
+                if (m_reversalCount >= need) {
+                    const uint64_t oldest = m_reversalFrames[(m_reversalHead + kMaxReversals - need) % kMaxReversals];
+                    if (m_frameIndex - oldest < static_cast<uint64_t>(m_config.flipFlopWindow)) {
+                        mask |= kAnomalyFlipFlop;
+                        m_reversalCount = 0;   // 同一段来回切换只报告一次
+                    }
+                }
+            }
+            m_lastDirection = direction;
+        }
+
+        // 帧间隔：倒退 / 重复的时间戳直接命中；否则与近期均值比较，所有间隔都计入均值，
+        // 帧率整体变化后均值随之收敛，不会持续报告
+        if (frame.timestamp <= m_lastTimestamp) {
+            mask |= kAnomalyFrameGap;
+        } else {
+            const int64_t interval = static_cast<int64_t>(frame.timestamp - m_lastTimestamp);
+            if (m_intervalSamples >= kGapWarmupSamples &&
+                (interval << kIntervalShift) > m_gapFactorQ4 * m_meanInterval) {
+                mask |= kAnomalyFrameGap;
+            }
+            if (m_intervalSamples < (1 << kIntervalShift)) {
+                ++m_intervalSamples;
+                m_meanInterval += (interval - m_meanInterval) / m_intervalSamples;
+            } else {
+                m_meanInterval += (interval - m_meanInterval) >> kIntervalShift;
+            }
+        }
+    }
+    m_lastCount = count;
+    m_lastTimestamp = frame.timestamp;
+
+    if (frame.saturatedCells >= m_config.saturatedCells) mask |= kAnomalySaturation;
+
+    // ghost：本帧写入最旧的槽位；需要前两帧，因此第 3 帧起判断
+    if (m_config.enabledMask & kAnomalyGhost) {
+        m_current = (m_current + 1) % 3;
+        Points& current = m_points[m_current];
+        current.count = std::min(count, kMaxTrackedContacts);
+        for (int i = 0; i < current.count; ++i) {
+            current.x[i] = frame.contacts[i].x;
+            current.y[i] = frame.contacts[i].y;
+        }
+        if (m_frameIndex >= 2 && CheckGhost()) mask |= kAnomalyGhost;
+    }
+    ++m_frameIndex;
+
+    mask &= m_config.enabledMask;
+    for (uint32_t bits = mask; bits; bits &= bits - 1) {
+        ++m_counters.hits[std::countr_zero(bits)];
+    }
+    return mask;
+}
+
+} // namespace Engine
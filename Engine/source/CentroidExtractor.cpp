@@ -1,5 +1,4 @@
 #include "CentroidExtractor.h"
-#include "imgui.h"
 #include <cmath>
 #include <algorithm>
 #include <vector>
@@ -7,34 +6,26 @@
 
 namespace Engine {
 
-std::vector<FingerCenter> TouchSegmenter::analyze_and_segment_blob(
-    const std::vector<TouchPoint>& blob, 
-    const int16_t global_grid[40][60])
+BlobAnalysis TouchSegmenter::analyze_blob(const BlobMoments& moments, const SegmenterParams& params)
 {
-    if (blob.empty()) return {};
-    
     // 1. Basic Centroid
-    float sum_weight = 0.f, sum_x = 0.f, sum_y = 0.f;
-    for (const auto& p : blob) {
-        sum_weight += p.weight;
-        sum_x += p.x * p.weight; 
-        sum_y += p.y * p.weight;
-    }
-    float mean_x = sum_x / sum_weight; 
-    float mean_y = sum_y / sum_weight;
-
-    if (blob.size() < 4) return { {mean_x, mean_y, sum_weight} };
-
-    // 2. PCA
-    float c_xx = 0.f, c_xy = 0.f, c_yy = 0.f;
-    for (const auto& p : blob) {
-        float dx = p.x - mean_x; 
-        float dy = p.y - mean_y;
-        c_xx += p.weight * dx * dx; 
-        c_xy += p.weight * dx * dy; 
-        c_yy += p.weight * dy * dy;
-    }
-    c_xx /= sum_weight; c_xy /= sum_weight; c_yy /= sum_weight;
+    // 矩为精确整数，换算到 double 后再求均值与中心矩，避免大数相消的精度损失
+    const double sum_w = static_cast<double>(moments.sumW);
+    const double mx = moments.sumWX / sum_w;
+    const double my = moments.sumWY / sum_w;
+    float sum_weight = static_cast<float>(moments.sumW);
+    float mean_x = static_cast<float>(mx);
+    float mean_y = static_cast<float>(my);
+
+    BlobAnalysis analysis;
+    analysis.merged = {mean_x, mean_y, sum_weight};
+
+    if (moments.count < 4) return analysis;
+
+    // 2. PCA (加权协方差 = E[xx] - E[x]E[x])
+    float c_xx = static_cast<float>(moments.sumWXX / sum_w - mx * mx);
+    float c_xy = static_cast<float>(moments.sumWXY / sum_w - mx * my);
+    float c_yy = static_cast<float>(moments.sumWYY / sum_w - my * my);
 
     float b = c_xx + c_yy;
     float c = c_xx * c_yy - c_xy * c_xy;
@@ -46,25 +37,41 @@ std::vector<FingerCenter> TouchSegmenter::analyze_and_segment_blob(
     float aspect_ratio = lambda1 / lambda2;
 
     // Defense 1: Fat Thumb Check
-    if (lambda2 > MAX_MINOR_AXIS_VARIANCE) {
-        return { {mean_x, mean_y, sum_weight} }; 
+    if (lambda2 > params.maxMinorAxisVariance) {
+        return analysis; 
     }
 
     // === 【核心修改：Decision Engine 增加绝对热力阈值干预】 ===
     // 如果长宽比超过阈值，或者总重量极大（对抗肩部融合的斜坡被隐藏），都强行进入切分！
-    bool is_merged = (aspect_ratio > ASPECT_RATIO_THRESHOLD) || (sum_weight > HUGE_WEIGHT_THRESHOLD);
+    bool is_merged = (aspect_ratio > params.aspectRatioThreshold) || (sum_weight > params.hugeWeightThreshold);
     if (!is_merged) {
-        return { {mean_x, mean_y, sum_weight} }; 
+        return analysis; 
     }
 
     // Initialize K-Means centers along the major axis
+    // 注意：仅因超重 (aspect ≈ 1) 进入切分时主轴方向由协方差的微小差异决定，种子方向对舍入敏感，
+    // 切分结果可能随矩的精度翻转 (距离恰在 minPhysicalDistance 附近)
     float vx = c_xy, vy = lambda1 - c_xx;
     float norm = std::sqrt(vx*vx + vy*vy);
     if (norm > 1e-5f) { vx /= norm; vy /= norm; } else { vx = 1; vy = 0; }
     
     float spread = std::sqrt(lambda1);
-    FingerCenter center1 { mean_x + 0.4f * spread * vx, mean_y + 0.4f * spread * vy, 0.f };
-    FingerCenter center2 { mean_x - 0.4f * spread * vx, mean_y - 0.4f * spread * vy, 0.f };
+    analysis.needs_split = true;
+    analysis.seeds[0] = { mean_x + 0.4f * spread * vx, mean_y + 0.4f * spread * vy, 0.f };
+    analysis.seeds[1] = { mean_x - 0.4f * spread * vx, mean_y - 0.4f * spread * vy, 0.f };
+    return analysis;
+}
+
+SegmentResult TouchSegmenter::split_blob(
+    const BlobAnalysis& analysis,
+    std::span<const TouchPoint> blob, 
+    const int16_t global_grid[40][60],
+    const SegmenterParams& params)
+{
+    const SegmentResult merged { { analysis.merged }, 1 };
+    const float sum_weight = analysis.merged.total_weight;
+    FingerCenter center1 = analysis.seeds[0];
+    FingerCenter center2 = analysis.seeds[1];
 
     // K-Means Iteration (4 times is enough for convergence)
     for (int iter = 0; iter < 4; ++iter) {
@@ -87,8 +94,8 @@ std::vector<FingerCenter> TouchSegmenter::analyze_and_segment_blob(
 
     // Defense 2: Physical Bone-Distance Check
     float final_dist = std::sqrt(std::pow(center1.x - center2.x, 2) + std::pow(center1.y - center2.y, 2));
-    if (final_dist < MIN_PHYSICAL_DISTANCE) {
-        return { {mean_x, mean_y, sum_weight} }; 
+    if (final_dist < params.minPhysicalDistance) {
+        return merged; 
     }
 
     // Defense 3: Valley Profile Check
@@ -106,18 +113,17 @@ std::vector<FingerCenter> TouchSegmenter::analyze_and_segment_blob(
 
     if (mid_val >= std::min(c1_val, c2_val)) {
         // === 【同步修改：这里也应使用常量而非写死 8000】 ===
-        if (sum_weight < HUGE_WEIGHT_THRESHOLD) {
-            return { {mean_x, mean_y, sum_weight} };
+        if (sum_weight < params.hugeWeightThreshold) {
+            return merged;
         }
     }
 
-    return {center1, center2};
+    return { {center1, center2}, 2 };
 }
 
 // ---------------------------------------------------------
-// 后续的 CentroidExtractor::Process 与原版完全保持一致，无需修改。
-// 因为你的 BFS 和 8连通域算法写得非常标准且高效！
-// ...
+// CentroidExtractor::Process 的 8 连通域划分由 ComponentLabeler 完成，
+// 连通域及其顺序与原 BFS 版本一致，但每帧不再有任何堆分配。
 
 CentroidExtractor::CentroidExtractor() {}
 CentroidExtractor::~CentroidExtractor() {}
@@ -126,59 +132,29 @@ bool CentroidExtractor::Process(HeatmapFrame& frame) {
     if (!m_enabled) return true;
 
     frame.contacts.clear();
-    const int numRows = 40;
-    const int numCols = 60;
-    
+
     int touchId = 1;
 
-    // 1. Connected Component Labeling (BFS) to gather Blobs
-    std::vector<bool> visited(numRows * numCols, false);
-    std::vector<std::vector<TouchPoint>> blobs;
-
-    for (int y = 0; y < numRows; ++y) {
-        for (int x = 0; x < numCols; ++x) {
-            float val = static_cast<float>(frame.heatmapMatrix[y][x]);
-            if (!visited[y * numCols + x] && val >= m_peakThreshold) {
-                // Found a new unvisited pixel above threshold, start BFS
-                std::vector<TouchPoint> currentBlob;
-                std::vector<std::pair<int, int>> queue;
-                queue.push_back({x, y});
-                visited[y * numCols + x] = true;
-                
-                size_t head = 0;
-                while (head < queue.size()) {
-                    auto p = queue[head++];
-                    int cx = p.first;
-                    int cy = p.second;
-                    currentBlob.push_back({static_cast<float>(cx), static_cast<float>(cy), static_cast<float>(frame.heatmapMatrix[cy][cx])});
-                    
-                    // 8-connectivity to boldly merge diagonally touching pixels into the same blob
-                    static const int dxs[] = {-1, 0, 1, -1, 1, -1, 0, 1};
-                    static const int dys[] = {-1, -1, -1, 0, 0, 1, 1, 1};
-                    for (int i = 0; i < 8; ++i) {
-                        int nx = cx + dxs[i];
-                        int ny = cy + dys[i];
-                        if (nx >= 0 && nx < numCols && ny >= 0 && ny < numRows) {
-                            int nIdx = ny * numCols + nx;
-                            if (!visited[nIdx] && frame.heatmapMatrix[ny][nx] >= m_peakThreshold) {
-                                visited[nIdx] = true;
-                                queue.push_back({nx, ny});
-                            }
-                        }
-                    }
-                }
-                if (!currentBlob.empty()) {
-                    blobs.push_back(std::move(currentBlob));
-                }
-            }
-        }
-    }
+    // 1. Connected Component Labeling (8-connectivity union-find) + blob moments
+    const int blobCount = m_labeler.Label(frame.heatmapMatrix, m_peakThreshold);
 
     // 2. Segment each blob
-    for (const auto& blob : blobs) {
-        std::vector<FingerCenter> centers = TouchSegmenter::analyze_and_segment_blob(blob, frame.heatmapMatrix);
+    for (int blobIdx = 0; blobIdx < blobCount; ++blobIdx) {
+        const BlobAnalysis analysis = TouchSegmenter::analyze_blob(m_labeler.Moments(blobIdx), m_segmenter);
+
+        SegmentResult segment { { analysis.merged }, 1 };
+        if (analysis.needs_split) {
+            // 只有进入 K-Means 的连通域才展开逐像素数据
+            size_t count = 0;
+            m_labeler.ForEachPixel(blobIdx, [&](int x, int y) {
+                m_blobPoints[count++] = {static_cast<float>(x), static_cast<float>(y), static_cast<float>(frame.heatmapMatrix[y][x])};
+            });
+            segment = TouchSegmenter::split_blob(
+                analysis, std::span<const TouchPoint>(m_blobPoints, count), frame.heatmapMatrix, m_segmenter);
+        }
         
-        for (const auto& c : centers) {
+        for (int ci = 0; ci < segment.count; ++ci) {
+            const FingerCenter& c = segment.centers[ci];
             TouchContact tc;
             tc.id = touchId++;
             // CalculateGaussianParaboloid handles subpixel resolution. 
@@ -234,12 +210,18 @@ float CentroidExtractor::CalculateGaussianParaboloid(const HeatmapFrame& frame,
     return cx + dx;
 }
 
-void CentroidExtractor::DrawConfigUI() {
-    ImGui::TextWrapped("PCA-KMeans Algorithm for Smart Centroid Extraction:");
-    ImGui::RadioButton("Native PCA Weight Centroid", &m_algorithm, 0);
-    ImGui::RadioButton("2D Paraboloid Refinement", &m_algorithm, 1);
-    
-    ImGui::SliderInt("Peak Detection Threshold", &m_peakThreshold, 50, 2000);
+const char* CentroidExtractor::GetDescription() const {
+    return "PCA-KMeans Algorithm for Smart Centroid Extraction:";
+}
+
+void CentroidExtractor::DescribeParams(std::vector<ParamDesc>& params) {
+    static constexpr const char* kAlgorithms[] = {"Native PCA Weight Centroid", "2D Paraboloid Refinement"};
+    params.push_back(ParamDesc::Choice("Centroid Algorithm", &m_algorithm, kAlgorithms));
+    params.push_back(ParamDesc::Int("Peak Detection Threshold", &m_peakThreshold, 50, 2000));
+    params.push_back(ParamDesc::Float("Split Aspect Ratio", &m_segmenter.aspectRatioThreshold, 1.0f, 5.0f, "%.2f"));
+    params.push_back(ParamDesc::Float("Max Minor Axis Variance", &m_segmenter.maxMinorAxisVariance, 1.0f, 12.0f, "%.2f"));
+    params.push_back(ParamDesc::Float("Min Split Distance", &m_segmenter.minPhysicalDistance, 0.5f, 6.0f, "%.2f"));
+    params.push_back(ParamDesc::Float("Heavy Blob Weight", &m_segmenter.hugeWeightThreshold, 1000.0f, 30000.0f, "%.0f"));
 }
 
 } // namespace Engine
@@ -0,0 +1,161 @@
+#include "ComponentLabeler.h"
+#include "SimdKernels.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace Engine {
+
+ComponentLabeler::ComponentLabeler() {
+    // 整个平面只在这里清零一次，之后每帧只清除上一帧写过的前景标签
+    std::memset(m_labels, 0, sizeof(m_labels));
+}
+
+uint16_t ComponentLabeler::FindRoot(uint16_t label) {
+    uint16_t root = label;
+    while (m_parent[root] != root) root = m_parent[root];
+    // 路径压缩
+    while (m_parent[label] != root) {
+        uint16_t next = m_parent[label];
+        m_parent[label] = root;
+        label = next;
+    }
+    return root;
+}
+
+void ComponentLabeler::Merge(uint16_t a, uint16_t b) {
+    uint16_t ra = FindRoot(a);
+    uint16_t rb = FindRoot(b);
+    // 总是挂到较小的根上：根即连通域内最早出现的临时标签，保证编号与 BFS 扫描顺序一致
+    if (ra < rb) m_parent[rb] = ra;
+    else if (rb < ra) m_parent[ra] = rb;
+}
+
+int ComponentLabeler::Label(const int16_t grid[kRows][kCols], int threshold) {
+    auto planeIndex = [](int pixel) { return (pixel / kCols + 1) * kStride + pixel % kCols + 1; };
+
+    for (int i = 0; i < m_foregroundCount; ++i) {
+        m_labels[planeIndex(m_foreground[i])] = 0;
+    }
+    m_foregroundCount = 0;
+
+    const Simd::KernelTable& kernels = Simd::Kernels();
+    uint16_t nextLabel = 1;
+
+    // 1. 第一遍：按光栅顺序分配临时标签，只看已扫描的 W / NW / N / NE 四邻域，
+    //    同时把像素的矩累加到其临时标签上 (不做 Find)
+    for (int y = 0; y < kRows; ++y) {
+        const int16_t* src = grid[y];
+        // 无触摸的行占绝大多数，整行最大值低于阈值时跳过 (平面上该行已全为 0)
+        if (kernels.ReduceMax(src, kCols, std::numeric_limits<int16_t>::min()) < threshold) continue;
+
+        uint16_t* row = m_labels + (y + 1) * kStride + 1;
+        const uint16_t* up = row - kStride;
+        for (int x = 0; x < kCols; ++x) {
+            if (src[x] < threshold) continue;
+
+            uint16_t label;
+            // N 与 W / NW / NE 均相邻，它们此前已并入同一集合
+            if (up[x]) {
+                label = up[x];
+            } else if (up[x + 1]) {
+                // NE 与 W、NW 互不相邻，需要显式合并
+                label = up[x + 1];
+                if (up[x - 1]) Merge(up[x + 1], up[x - 1]);
+                else if (row[x - 1]) Merge(up[x + 1], row[x - 1]);
+            } else if (up[x - 1]) {
+                label = up[x - 1];
+            } else if (row[x - 1]) {
+                label = row[x - 1];
+            } else {
+                label = nextLabel++;
+                m_parent[label] = label;
+                m_sumW[label] = m_sumWX[label] = m_sumWY[label] = 0;
+                m_sumWXX[label] = m_sumWXY[label] = m_sumWYY[label] = 0;
+                m_count[label] = 0;
+                m_minX[label] = m_maxX[label] = static_cast<uint8_t>(x);
+                m_minY[label] = m_maxY[label] = static_cast<uint8_t>(y);
+                m_peak[label] = src[x];
+                m_peakPixel[label] = static_cast<uint16_t>(y * kCols + x);
+            }
+            row[x] = label;
+
+            const int64_t w = src[x];
+            m_sumW[label] += w;
+            m_sumWX[label] += w * x;
+            m_sumWY[label] += w * y;
+            m_sumWXX[label] += w * x * x;
+            m_sumWXY[label] += w * x * y;
+            m_sumWYY[label] += w * y * y;
+            ++m_count[label];
+            // 行内 x 递增、y 只增不减，只需更新一侧
+            if (x < m_minX[label]) m_minX[label] = static_cast<uint8_t>(x);
+            if (x > m_maxX[label]) m_maxX[label] = static_cast<uint8_t>(x);
+            m_maxY[label] = static_cast<uint8_t>(y);
+            if (src[x] > m_peak[label]) {
+                m_peak[label] = src[x];
+                m_peakPixel[label] = static_cast<uint16_t>(y * kCols + x);
+            }
+
+            m_foreground[m_foregroundCount++] = static_cast<uint16_t>(y * kCols + x);
+        }
+    }
+
+    // 2. 非根标签的矩并入根标签 (根总是更小，降序处理)
+    for (uint16_t label = nextLabel - 1; label >= 1; --label) {
+        if (m_parent[label] == label) continue;
+        const uint16_t root = FindRoot(label);
+        m_sumW[root] += m_sumW[label];
+        m_sumWX[root] += m_sumWX[label];
+        m_sumWY[root] += m_sumWY[label];
+        m_sumWXX[root] += m_sumWXX[label];
+        m_sumWXY[root] += m_sumWXY[label];
+        m_sumWYY[root] += m_sumWYY[label];
+        m_count[root] += m_count[label];
+        m_minX[root] = std::min(m_minX[root], m_minX[label]);
+        m_maxX[root] = std::max(m_maxX[root], m_maxX[label]);
+        m_minY[root] = std::min(m_minY[root], m_minY[label]);
+        m_maxY[root] = std::max(m_maxY[root], m_maxY[label]);
+        if (m_peak[label] > m_peak[root] ||
+            (m_peak[label] == m_peak[root] && m_peakPixel[label] < m_peakPixel[root])) {
+            m_peak[root] = m_peak[label];
+            m_peakPixel[root] = m_peakPixel[label];
+        }
+    }
+
+    // 3. 临时标签 -> 连通域编号。非根标签的父节点编号总是更小，升序一遍即可
+    m_componentCount = 0;
+    for (uint16_t label = 1; label < nextLabel; ++label) {
+        const uint16_t parent = m_parent[label];
+        if (parent == label) {
+            m_rootOf[m_componentCount] = label;
+            m_final[label] = static_cast<uint16_t>(m_componentCount++);
+        } else {
+            m_final[label] = m_final[parent];
+        }
+    }
+
+    return m_componentCount;
+}
+
+BlobMoments ComponentLabeler::Moments(int component) const {
+    const uint16_t root = m_rootOf[component];
+    BlobMoments m;
+    m.sumW = m_sumW[root];
+    m.sumWX = m_sumWX[root];
+    m.sumWY = m_sumWY[root];
+    m.sumWXX = m_sumWXX[root];
+    m.sumWXY = m_sumWXY[root];
+    m.sumWYY = m_sumWYY[root];
+    m.count = m_count[root];
+    m.minX = m_minX[root];
+    m.minY = m_minY[root];
+    m.maxX = m_maxX[root];
+    m.maxY = m_maxY[root];
+    m.peak = m_peak[root];
+    m.peakX = m_peakPixel[root] % kCols;
+    m.peakY = m_peakPixel[root] / kCols;
+    return m;
+}
+
+} // namespace Engine
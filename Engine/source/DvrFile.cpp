@@ -0,0 +1,467 @@
+#include "DvrFile.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <memory>
+
+namespace Engine {
+
+namespace {
+
+FILE* OpenFile(const std::string& path, const char* mode) {
+#if defined(_MSC_VER)
+    FILE* fp = nullptr;
+    return fopen_s(&fp, path.c_str(), mode) == 0 ? fp : nullptr;
+#else
+    return std::fopen(path.c_str(), mode);
+#endif
+}
+
+// 64 位文件偏移 (长时间录制会超过 2 GB)
+bool SeekTo(FILE* fp, uint64_t offset) {
+#if defined(_MSC_VER)
+    return _fseeki64(fp, static_cast<int64_t>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(fp, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+uint64_t FileSize(FILE* fp) {
+#if defined(_MSC_VER)
+    if (_fseeki64(fp, 0, SEEK_END) != 0) return 0;
+    const int64_t size = _ftelli64(fp);
+#else
+    if (fseeko(fp, 0, SEEK_END) != 0) return 0;
+    const int64_t size = ftello(fp);
+#endif
+    return size > 0 ? static_cast<uint64_t>(size) : 0;
+}
+
+bool ReadExact(FILE* fp, void* dst, size_t size) {
+    return std::fread(dst, 1, size, fp) == size;
+}
+
+bool WriteExact(FILE* fp, const void* src, size_t size) {
+    return std::fwrite(src, 1, size, fp) == size;
+}
+
+// 文本输出缓冲：整数 / 定点数用 to_chars 拼接，整行一次写出
+class LineBuffer {
+public:
+    void Int(long long v) { m_pos = std::to_chars(m_buf + m_pos, m_buf + sizeof(m_buf), v).ptr - m_buf; }
+    void Fixed(double v, int precision) {
+        m_pos = std::to_chars(m_buf + m_pos, m_buf + sizeof(m_buf), v, std::chars_format::fixed, precision).ptr - m_buf;
+    }
+    void Text(const char* s) {
+        const size_t n = std::min(std::strlen(s), sizeof(m_buf) - m_pos);
+        std::memcpy(m_buf + m_pos, s, n);
+        m_pos += n;
+    }
+    void Char(char c) {
+        if (m_pos < sizeof(m_buf)) m_buf[m_pos++] = c;
+    }
+    bool Flush(FILE* fp) {
+        const bool ok = WriteExact(fp, m_buf, m_pos);
+        m_pos = 0;
+        return ok;
+    }
+
+private:
+    char m_buf[1024];
+    size_t m_pos = 0;
+};
+
+bool WriteWords(FILE* out, LineBuffer& line, const DvrRecord& record, size_t offset, int words) {
+    bool ok = true;
+    for (int i = 0; i < words; ++i) {
+        const size_t at = offset + static_cast<size_t>(i) * 2;
+        const int v = at + 1 < record.rawSize ? (record.raw[at] | (record.raw[at + 1] << 8)) : 0;
+        line.Int(v);
+        if (i + 1 < words) line.Char((i + 1) % 16 == 0 ? '\n' : ',');
+        if ((i + 1) % 16 == 0) ok &= line.Flush(out);
+    }
+    line.Char('\n');
+    return line.Flush(out) && ok;
+}
+
+} // namespace
+
+// ---------------------------------------------------------
+// 帧 <-> 记录
+
+void EncodeDvrRecord(const HeatmapFrame& frame, uint64_t sequence, DvrRecord& record) {
+    record.sequence = sequence;
+    record.timestamp = frame.timestamp;
+
+    const FrameTrace& t = frame.trace;
+    const uint64_t trace[6] = {t.readStartNs, t.readDoneNs, t.enqueueNs, t.dequeueNs, t.processedNs, t.PublishedNs()};
+    std::memcpy(record.traceNs, trace, sizeof(trace));
+    std::memcpy(record.stageNs, t.stageNs, sizeof(record.stageNs));
+    record.stageCount = t.stageCount;
+
+    record.flags = 0;
+    record.reserved = 0;
+    std::memcpy(record.heatmap, frame.heatmapMatrix, sizeof(record.heatmap));
+
+    const size_t contactCount = std::min<size_t>(frame.contacts.size(), DvrRecord::kMaxContacts);
+    if (contactCount < frame.contacts.size()) record.flags |= DvrRecord::kContactsTruncated;
+    record.contactCount = static_cast<uint8_t>(contactCount);
+    for (size_t i = 0; i < contactCount; ++i) {
+        const TouchContact& c = frame.contacts[i];
+        record.contacts[i] = {c.id, c.x, c.y, c.state, c.area};
+    }
+    std::memset(record.contacts + contactCount, 0, (DvrRecord::kMaxContacts - contactCount) * sizeof(DvrContact));
+
+    const size_t rawSize = std::min(frame.rawData.size(), DvrRecord::kRawCapacity);
+    if (rawSize < frame.rawData.size()) record.flags |= DvrRecord::kRawTruncated;
+    record.rawSize = static_cast<uint16_t>(rawSize);
+    if (rawSize) std::memcpy(record.raw, frame.rawData.data(), rawSize);
+    std::memset(record.raw + rawSize, 0, DvrRecord::kRawCapacity - rawSize);
+}
+
+void DecodeDvrRecord(const DvrRecord& record, HeatmapFrame& frame) {
+    frame.timestamp = record.timestamp;
+
+    FrameTrace& t = frame.trace;
+    t.readStartNs = record.traceNs[0];
+    t.readDoneNs = record.traceNs[1];
+    t.enqueueNs = record.traceNs[2];
+    t.dequeueNs = record.traceNs[3];
+    t.processedNs = record.traceNs[4];
+    t.publishedNs = record.traceNs[5];
+    std::memcpy(t.stageNs, record.stageNs, sizeof(t.stageNs));
+    t.stageCount = record.stageCount;
+
+    std::memcpy(frame.heatmapMatrix, record.heatmap, sizeof(frame.heatmapMatrix));
+
+    const size_t contactCount = std::min<size_t>(record.contactCount, DvrRecord::kMaxContacts);
+    frame.contacts.clear();
+    for (size_t i = 0; i < contactCount; ++i) {
+        const DvrContact& c = record.contacts[i];
+        frame.contacts.push_back({c.id, c.x, c.y, c.state, c.area});
+    }
+
+    const size_t rawSize = std::min<size_t>(record.rawSize, DvrRecord::kRawCapacity);
+    frame.rawData.assign(record.raw, record.raw + rawSize);
+}
+
+// ---------------------------------------------------------
+// DvrWriter
+
+DvrWriter::~DvrWriter() {
+    Close();
+}
+
+bool DvrWriter::Open(const std::string& path, uint64_t configHash, bool compressed, uint32_t keyframeInterval) {
+    Close();
+    m_file = OpenFile(path, "wb");
+    if (!m_file) return false;
+    // 整块记录直接落盘，避免 stdio 再拷贝一次
+    std::setvbuf(m_file, nullptr, _IONBF, 0);
+
+    DvrFileHeader header{};
+    std::memcpy(header.magic, kDvrMagic, sizeof(header.magic));
+    header.version = kDvrVersion;
+    header.headerSize = sizeof(DvrFileHeader);
+    header.recordSize = compressed ? 0 : sizeof(DvrRecord);
+    header.rawCapacity = static_cast<uint32_t>(DvrRecord::kRawCapacity);
+    header.masterBytes = 5063;
+    header.slaveBytes = 339;
+    header.rows = 40;
+    header.cols = 60;
+    header.maxContacts = DvrRecord::kMaxContacts;
+    header.flags = compressed ? kDvrCompressed : 0;
+    header.keyframeInterval = compressed ? keyframeInterval : 0;
+    header.configHash = configHash;
+    header.createdUnixNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+
+    m_index.clear();
+    m_chunks.clear();
+    m_compressed = compressed;
+    if (compressed) m_encoder = FrameEncoder(keyframeInterval);   // 新文件从关键帧开始
+    m_ok = WriteExact(m_file, &header, sizeof(header));
+    m_bytesWritten = m_ok ? sizeof(header) : 0;
+    return m_ok;
+}
+
+bool DvrWriter::Append(const HeatmapFrame& frame) {
+    if (!m_file || !m_ok) return false;
+    const uint64_t sequence = m_index.size();
+    if (!m_compressed) {
+        EncodeDvrRecord(frame, sequence, m_scratch);
+        m_ok = WriteExact(m_file, &m_scratch, sizeof(m_scratch));
+        if (m_ok) {
+            m_index.push_back({sequence, frame.timestamp});
+            m_bytesWritten += sizeof(m_scratch);
+        }
+        return m_ok;
+    }
+
+    // 块头与编码数据拼在同一缓冲区，一次写出
+    m_chunk.resize(sizeof(DvrChunkHeader));
+    const bool keyframe = m_encoder.Encode(frame, m_chunk);
+    DvrChunkHeader chunk{};
+    chunk.size = static_cast<uint32_t>(m_chunk.size() - sizeof(DvrChunkHeader));
+    chunk.flags = keyframe ? DvrChunkHeader::kKeyframe : 0;
+    chunk.timestamp = frame.timestamp;
+    std::memcpy(m_chunk.data(), &chunk, sizeof(chunk));
+
+    m_ok = WriteExact(m_file, m_chunk.data(), m_chunk.size());
+    if (m_ok) {
+        m_index.push_back({sequence, frame.timestamp});
+        m_chunks.push_back({m_bytesWritten, chunk.size, chunk.flags, 0});
+        m_bytesWritten += m_chunk.size();
+    }
+    return m_ok;
+}
+
+bool DvrWriter::Close() {
+    if (!m_file) return false;
+
+    bool ok = m_ok;
+    if (ok) {
+        DvrFooter footer{};
+        std::memcpy(footer.magic, kDvrIndexMagic, sizeof(footer.magic));
+        footer.indexOffset = m_bytesWritten;
+        footer.recordCount = m_index.size();
+        ok = WriteExact(m_file, m_index.data(), m_index.size() * sizeof(DvrIndexEntry)) &&
+             WriteExact(m_file, m_chunks.data(), m_chunks.size() * sizeof(DvrChunkIndexEntry)) &&
+             WriteExact(m_file, &footer, sizeof(footer));
+    }
+    ok = (std::fclose(m_file) == 0) && ok;
+    m_file = nullptr;
+    m_ok = false;
+    return ok;
+}
+
+// ---------------------------------------------------------
+// DvrReader
+
+DvrReader::~DvrReader() {
+    Close();
+}
+
+void DvrReader::Close() {
+    if (m_file) std::fclose(m_file);
+    m_file = nullptr;
+    m_index.clear();
+    m_chunks.clear();
+    m_recovered = false;
+    m_decoder.Reset();
+    m_decodedIndex = SIZE_MAX;
+}
+
+bool DvrReader::Open(const std::string& path) {
+    Close();
+    m_file = OpenFile(path, "rb");
+    if (!m_file) return false;
+
+    if (!ReadExact(m_file, &m_header, sizeof(m_header)) ||
+        std::memcmp(m_header.magic, kDvrMagic, sizeof(kDvrMagic)) != 0 ||
+        m_header.version != kDvrVersion ||
+        m_header.headerSize != sizeof(DvrFileHeader) ||
+        (m_header.flags & ~kDvrCompressed) != 0 ||
+        m_header.recordSize != (IsCompressed() ? 0 : sizeof(DvrRecord))) {
+        Close();
+        return false;
+    }
+
+    const uint64_t fileSize = FileSize(m_file);
+    if (LoadIndex(fileSize)) return true;
+
+    // 录制中断：从记录 / 块头本身重建索引
+    m_index.clear();
+    m_chunks.clear();
+    m_recovered = true;
+    return RecoverIndex(fileSize);
+}
+
+// 正常关闭的文件：footer 与索引自洽
+bool DvrReader::LoadIndex(uint64_t fileSize) {
+    const uint64_t recordsBegin = m_header.headerSize;
+    const uint64_t entrySize = sizeof(DvrIndexEntry) + (IsCompressed() ? sizeof(DvrChunkIndexEntry) : 0);
+
+    DvrFooter footer{};
+    if (fileSize < recordsBegin + sizeof(DvrFooter) || !SeekTo(m_file, fileSize - sizeof(DvrFooter)) ||
+        !ReadExact(m_file, &footer, sizeof(footer)) ||
+        std::memcmp(footer.magic, kDvrIndexMagic, sizeof(kDvrIndexMagic)) != 0 ||
+        footer.indexOffset < recordsBegin || footer.recordCount > fileSize / entrySize ||
+        footer.indexOffset + footer.recordCount * entrySize + sizeof(DvrFooter) != fileSize) {
+        return false;
+    }
+    if (!IsCompressed() && footer.indexOffset != recordsBegin + footer.recordCount * m_header.recordSize) return false;
+
+    m_index.resize(footer.recordCount);
+    if (!SeekTo(m_file, footer.indexOffset) ||
+        !ReadExact(m_file, m_index.data(), m_index.size() * sizeof(DvrIndexEntry))) {
+        return false;
+    }
+    if (!IsCompressed()) return true;
+
+    m_chunks.resize(footer.recordCount);
+    if (!ReadExact(m_file, m_chunks.data(), m_chunks.size() * sizeof(DvrChunkIndexEntry))) return false;
+    return std::all_of(m_chunks.begin(), m_chunks.end(), [&](const DvrChunkIndexEntry& c) {
+        return c.offset >= recordsBegin && c.size <= kDvrMaxChunkSize &&
+               c.offset + sizeof(DvrChunkHeader) + c.size <= footer.indexOffset;
+    });
+}
+
+bool DvrReader::RecoverIndex(uint64_t fileSize) {
+    const uint64_t recordsBegin = m_header.headerSize;
+    if (!IsCompressed()) {
+        // 按定长记录恢复，从每条记录头部取序号与时间戳
+        const uint64_t count = fileSize > recordsBegin ? (fileSize - recordsBegin) / m_header.recordSize : 0;
+        m_index.reserve(count);
+        for (uint64_t i = 0; i < count; ++i) {
+            DvrIndexEntry entry{};
+            if (!SeekTo(m_file, recordsBegin + i * m_header.recordSize) || !ReadExact(m_file, &entry, sizeof(entry))) break;
+            m_index.push_back(entry);
+        }
+        return true;
+    }
+
+    // 沿块头逐块前进，遇到不完整或不合理的块即停止
+    uint64_t offset = recordsBegin;
+    DvrChunkHeader chunk{};
+    while (offset + sizeof(DvrChunkHeader) <= fileSize && SeekTo(m_file, offset) &&
+           ReadExact(m_file, &chunk, sizeof(chunk))) {
+        if (chunk.size == 0 || chunk.size > kDvrMaxChunkSize || offset + sizeof(DvrChunkHeader) + chunk.size > fileSize) break;
+        m_index.push_back({m_index.size(), chunk.timestamp});
+        m_chunks.push_back({offset, chunk.size, chunk.flags, 0});
+        offset += sizeof(DvrChunkHeader) + chunk.size;
+    }
+    return true;
+}
+
+bool DvrReader::DecodeChunk(size_t index, HeatmapFrame& frame) {
+    const DvrChunkIndexEntry& chunk = m_chunks[index];
+    m_chunk.resize(chunk.size);
+    if (!SeekTo(m_file, chunk.offset + sizeof(DvrChunkHeader)) || !ReadExact(m_file, m_chunk.data(), m_chunk.size()) ||
+        !m_decoder.Decode(m_chunk, frame)) {
+        m_decodedIndex = SIZE_MAX;
+        return false;
+    }
+    m_decodedIndex = index;
+    return true;
+}
+
+bool DvrReader::ReadRecord(size_t index, DvrRecord& record) {
+    if (!m_file || index >= m_index.size()) return false;
+    if (IsCompressed()) {
+        HeatmapFrame frame;
+        if (!ReadFrame(index, frame)) return false;
+        EncodeDvrRecord(frame, m_index[index].sequence, record);
+        return true;
+    }
+    return SeekTo(m_file, m_header.headerSize + static_cast<uint64_t>(index) * m_header.recordSize) &&
+           ReadExact(m_file, &record, sizeof(record));
+}
+
+bool DvrReader::ReadFrame(size_t index, HeatmapFrame& frame) {
+    if (!m_file || index >= m_index.size()) return false;
+    if (!IsCompressed()) {
+        auto record = std::make_unique<DvrRecord>();
+        if (!ReadRecord(index, *record)) return false;
+        DecodeDvrRecord(*record, frame);
+        return true;
+    }
+
+    // 从目标帧之前最近的关键帧开始；解码器的参考帧已在两者之间时直接接着解
+    size_t start = index;
+    while (start > 0 && !(m_chunks[start].flags & DvrChunkHeader::kKeyframe)) --start;
+    if (m_decodedIndex != SIZE_MAX && m_decodedIndex >= start && m_decodedIndex < index) start = m_decodedIndex + 1;
+    for (size_t i = start; i <= index; ++i) {
+        if (!DecodeChunk(i, frame)) return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------
+// CSV 转换
+
+bool ConvertDvrToCsv(const std::string& dvrPath, const std::string& csvPath, bool includeRawSuffix) {
+    DvrReader reader;
+    if (!reader.Open(dvrPath)) return false;
+    FILE* out = OpenFile(csvPath, "w");
+    if (!out) return false;
+
+    auto record = std::make_unique<DvrRecord>();
+    LineBuffer line;
+    bool ok = true;
+    for (size_t i = 0; ok && i < reader.RecordCount(); ++i) {
+        // 读失败 (文件损坏 / 截断) 不能当作转换完成
+        if (!reader.ReadRecord(i, *record)) {
+            ok = false;
+            break;
+        }
+
+        line.Text("--- Frame [");
+        line.Int(static_cast<long long>(i));
+        line.Text("] --- TS: ");
+        line.Int(static_cast<long long>(record->timestamp));
+        line.Char('\n');
+        ok &= line.Flush(out);
+
+        // 与 FrameTrace 的区段定义一致 (未打点为 0)
+        auto span = [&](int from, int to) {
+            const uint64_t a = record->traceNs[from], b = record->traceNs[to];
+            return (a && b >= a) ? (b - a) / 1000.0 : 0.0;
+        };
+        const double spans[5] = {span(0, 1), span(1, 3), span(3, 4), span(4, 5), span(0, 5)};
+        const char* labels[5] = {"Trace(us): io=", ", queue=", ", proc=", ", pub=", ", e2e="};
+        for (int k = 0; k < 5; ++k) {
+            line.Text(labels[k]);
+            line.Fixed(spans[k], 1);
+        }
+        line.Char('\n');
+        ok &= line.Flush(out);
+
+        for (int y = 0; y < 40; ++y) {
+            for (int x = 0; x < 60; ++x) {
+                line.Int(record->heatmap[y][x]);
+                if (x != 59) line.Char(',');
+            }
+            line.Char('\n');
+            ok &= line.Flush(out);
+        }
+
+        line.Text("Contacts: ");
+        line.Int(record->contactCount);
+        line.Char('\n');
+        ok &= line.Flush(out);
+        for (int c = 0; c < record->contactCount && c < DvrRecord::kMaxContacts; ++c) {
+            const DvrContact& contact = record->contacts[c];
+            line.Text("ID:");
+            line.Int(contact.id);
+            line.Text(", X:");
+            line.Fixed(contact.x, 3);
+            line.Text(", Y:");
+            line.Fixed(contact.y, 3);
+            line.Text(", State:");
+            line.Int(contact.state);
+            line.Text(", Area:");
+            line.Int(contact.area);
+            line.Char('\n');
+            ok &= line.Flush(out);
+        }
+
+        if (includeRawSuffix) {
+            line.Text("--- Master Frame Suffix (128 words) ---\n");
+            ok &= line.Flush(out);
+            ok &= WriteWords(out, line, *record, 4807, 128);
+            line.Text("--- Slave Frame Suffix (166 words) ---\n");
+            ok &= line.Flush(out);
+            ok &= WriteWords(out, line, *record, 5070, 166);
+        }
+
+        line.Char('\n');
+        ok &= line.Flush(out);
+    }
+
+    const bool closed = std::fclose(out) == 0;
+    return ok && closed;
+}
+
+} // namespace Engine
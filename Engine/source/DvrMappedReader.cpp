@@ -0,0 +1,342 @@
+#include "DvrMappedReader.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Engine {
+
+namespace fs = std::filesystem;
+
+// ---------------------------------------------------------
+// MappedFile
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::string& path) {
+    Close();
+#if defined(_WIN32)
+    // 允许录制器同时写入 / 轮转删除
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    m_file = file;
+    m_mapping = mapping;
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<uint64_t>(size.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    void* view = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);   // 映射独立于文件描述符存在
+    if (view == MAP_FAILED) return false;
+    ::madvise(view, static_cast<size_t>(st.st_size), MADV_RANDOM);
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<uint64_t>(st.st_size);
+#endif
+    return true;
+}
+
+void MappedFile::Close() {
+#if defined(_WIN32)
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file) CloseHandle(m_file);
+    m_mapping = nullptr;
+    m_file = nullptr;
+#else
+    if (m_data) ::munmap(const_cast<uint8_t*>(m_data), static_cast<size_t>(m_size));
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+// ---------------------------------------------------------
+// DvrMappedReader
+
+bool DvrMappedReader::Open(const std::string& path) {
+    Close();
+    if (!m_file.Open(path) || m_file.Size() < sizeof(DvrFileHeader)) {
+        Close();
+        return false;
+    }
+    std::memcpy(&m_header, m_file.Data(), sizeof(m_header));
+    if (std::memcmp(m_header.magic, kDvrMagic, sizeof(kDvrMagic)) != 0 ||
+        m_header.version != kDvrVersion ||
+        m_header.headerSize != sizeof(DvrFileHeader) ||
+        (m_header.flags & ~kDvrCompressed) != 0 ||
+        m_header.recordSize != (IsCompressed() ? 0 : sizeof(DvrRecord))) {
+        Close();
+        return false;
+    }
+
+    m_path = path;
+    if (!LoadIndex()) {
+        m_recovered = true;
+        RecoverIndex();
+    }
+    return true;
+}
+
+void DvrMappedReader::Close() {
+    m_file.Close();
+    m_path.clear();
+    m_header = {};
+    m_recovered = false;
+    m_index = {};
+    m_chunks = {};
+    m_ownedIndex.clear();
+    m_ownedChunks.clear();
+    m_decoder.Reset();
+    m_decodedIndex = SIZE_MAX;
+    m_recordIndex = SIZE_MAX;
+}
+
+// 正常关闭的文件：校验 footer，索引直接引用映射内存 (未对齐时拷贝一份)
+bool DvrMappedReader::LoadIndex() {
+    const uint8_t* data = m_file.Data();
+    const uint64_t fileSize = m_file.Size();
+    const uint64_t recordsBegin = m_header.headerSize;
+    const uint64_t entrySize = sizeof(DvrIndexEntry) + (IsCompressed() ? sizeof(DvrChunkIndexEntry) : 0);
+
+    if (fileSize < recordsBegin + sizeof(DvrFooter)) return false;
+    DvrFooter footer{};
+    std::memcpy(&footer, data + fileSize - sizeof(DvrFooter), sizeof(footer));
+    if (std::memcmp(footer.magic, kDvrIndexMagic, sizeof(kDvrIndexMagic)) != 0 ||
+        footer.indexOffset < recordsBegin || footer.recordCount > fileSize / entrySize ||
+        footer.indexOffset + footer.recordCount * entrySize + sizeof(DvrFooter) != fileSize) {
+        return false;
+    }
+    if (!IsCompressed() && footer.indexOffset != recordsBegin + footer.recordCount * m_header.recordSize) return false;
+
+    const size_t count = static_cast<size_t>(footer.recordCount);
+    const uint8_t* indexBegin = data + footer.indexOffset;
+    const uint8_t* chunksBegin = indexBegin + count * sizeof(DvrIndexEntry);
+    if (reinterpret_cast<uintptr_t>(indexBegin) % alignof(DvrIndexEntry) == 0) {
+        m_index = {reinterpret_cast<const DvrIndexEntry*>(indexBegin), count};
+    } else {
+        m_ownedIndex.resize(count);
+        std::memcpy(m_ownedIndex.data(), indexBegin, count * sizeof(DvrIndexEntry));
+        m_index = m_ownedIndex;
+    }
+    if (!IsCompressed()) return true;
+
+    if (reinterpret_cast<uintptr_t>(chunksBegin) % alignof(DvrChunkIndexEntry) == 0) {
+        m_chunks = {reinterpret_cast<const DvrChunkIndexEntry*>(chunksBegin), count};
+    } else {
+        m_ownedChunks.resize(count);
+        std::memcpy(m_ownedChunks.data(), chunksBegin, count * sizeof(DvrChunkIndexEntry));
+        m_chunks = m_ownedChunks;
+    }
+    const bool valid = std::all_of(m_chunks.begin(), m_chunks.end(), [&](const DvrChunkIndexEntry& c) {
+        return c.offset >= recordsBegin && c.size <= kDvrMaxChunkSize &&
+               c.offset + sizeof(DvrChunkHeader) + c.size <= footer.indexOffset;
+    });
+    if (!valid) {
+        m_index = {};
+        m_chunks = {};
+        m_ownedIndex.clear();
+        m_ownedChunks.clear();
+    }
+    return valid;
+}
+
+void DvrMappedReader::RecoverIndex() {
+    const uint8_t* data = m_file.Data();
+    const uint64_t fileSize = m_file.Size();
+    const uint64_t recordsBegin = m_header.headerSize;
+
+    if (!IsCompressed()) {
+        // 定长记录：序号与时间戳位于每条记录开头
+        const uint64_t count = (fileSize - recordsBegin) / m_header.recordSize;
+        m_ownedIndex.resize(static_cast<size_t>(count));
+        for (uint64_t i = 0; i < count; ++i) {
+            std::memcpy(&m_ownedIndex[i], data + recordsBegin + i * m_header.recordSize, sizeof(DvrIndexEntry));
+        }
+    } else {
+        // 沿块头逐块前进，遇到不完整或不合理的块即停止
+        uint64_t offset = recordsBegin;
+        DvrChunkHeader chunk{};
+        while (offset + sizeof(DvrChunkHeader) <= fileSize) {
+            std::memcpy(&chunk, data + offset, sizeof(chunk));
+            if (chunk.size == 0 || chunk.size > kDvrMaxChunkSize ||
+                offset + sizeof(DvrChunkHeader) + chunk.size > fileSize) {
+                break;
+            }
+            m_ownedIndex.push_back({m_ownedIndex.size(), chunk.timestamp});
+            m_ownedChunks.push_back({offset, chunk.size, chunk.flags, 0});
+            offset += sizeof(DvrChunkHeader) + chunk.size;
+        }
+    }
+    m_index = m_ownedIndex;
+    m_chunks = m_ownedChunks;
+}
+
+size_t DvrMappedReader::FindByTimestamp(uint64_t timestamp) const {
+    const auto it = std::upper_bound(m_index.begin(), m_index.end(), timestamp,
+                                     [](uint64_t ts, const DvrIndexEntry& e) { return ts < e.timestamp; });
+    return it == m_index.begin() ? 0 : static_cast<size_t>(it - m_index.begin()) - 1;
+}
+
+// 压缩文件：把 m_decoded 推进到第 index 帧
+bool DvrMappedReader::DecodeTo(size_t index) {
+    if (m_decodedIndex == index) return true;
+
+    // 从目标帧之前最近的关键帧开始；已解码帧位于两者之间时直接接着解
+    size_t start = index;
+    while (start > 0 && !(m_chunks[start].flags & DvrChunkHeader::kKeyframe)) --start;
+    if (m_decodedIndex != SIZE_MAX && m_decodedIndex >= start && m_decodedIndex < index) start = m_decodedIndex + 1;
+
+    for (size_t i = start; i <= index; ++i) {
+        const DvrChunkIndexEntry& chunk = m_chunks[i];
+        const uint8_t* payload = m_file.Data() + chunk.offset + sizeof(DvrChunkHeader);
+        if (!m_decoder.Decode({payload, chunk.size}, m_decoded)) {
+            m_decodedIndex = SIZE_MAX;
+            return false;
+        }
+        m_decodedIndex = i;
+    }
+    return true;
+}
+
+const DvrRecord* DvrMappedReader::Record(size_t index) {
+    if (!IsOpen() || index >= m_index.size()) return nullptr;
+    if (!IsCompressed()) {
+        // 记录在文件中按 64 字节对齐，映射基址按页对齐
+        return reinterpret_cast<const DvrRecord*>(m_file.Data() + m_header.headerSize +
+                                                  static_cast<uint64_t>(index) * m_header.recordSize);
+    }
+    if (m_recordIndex == index) return m_record.get();
+    if (!DecodeTo(index)) return nullptr;
+    if (!m_record) m_record = std::make_unique<DvrRecord>();
+    EncodeDvrRecord(m_decoded, m_index[index].sequence, *m_record);
+    m_recordIndex = index;
+    return m_record.get();
+}
+
+bool DvrMappedReader::ReadFrame(size_t index, HeatmapFrame& frame) {
+    if (!IsOpen() || index >= m_index.size()) return false;
+    if (!IsCompressed()) {
+        DecodeDvrRecord(*Record(index), frame);
+        return true;
+    }
+    if (!DecodeTo(index)) return false;
+    frame.rawData.assign(m_decoded.rawData.begin(), m_decoded.rawData.end());
+    std::memcpy(frame.heatmapMatrix, m_decoded.heatmapMatrix, sizeof(frame.heatmapMatrix));
+    frame.contacts.assign(m_decoded.contacts.begin(), m_decoded.contacts.end());
+    frame.timestamp = m_decoded.timestamp;
+    frame.trace = m_decoded.trace;
+    return true;
+}
+
+// ---------------------------------------------------------
+// DvrSession
+
+bool DvrSession::Open(const std::string& path) {
+    Close();
+
+    std::vector<std::string> paths;
+    std::error_code ec;
+    if (fs::is_directory(path, ec)) {
+        for (const auto& item : fs::directory_iterator(path, ec)) {
+            if (item.is_regular_file(ec) && item.path().extension() == ".egdvr") paths.push_back(item.path().string());
+        }
+    } else {
+        paths.push_back(path);
+    }
+
+    for (const std::string& file : paths) {
+        auto reader = std::make_unique<DvrMappedReader>();
+        if (reader->Open(file) && reader->FrameCount() > 0) {
+            m_files.push_back(std::move(reader));
+        } else {
+            ++m_skipped;
+        }
+    }
+    // 创建时间相同 (同一秒内轮转) 时按文件名中的序号兜底
+    std::sort(m_files.begin(), m_files.end(), [](const auto& a, const auto& b) {
+        if (a->Header().createdUnixNs != b->Header().createdUnixNs) {
+            return a->Header().createdUnixNs < b->Header().createdUnixNs;
+        }
+        return a->Path() < b->Path();
+    });
+
+    m_firstFrame.push_back(0);
+    for (const auto& file : m_files) m_firstFrame.push_back(m_firstFrame.back() + file->FrameCount());
+    return !m_files.empty();
+}
+
+void DvrSession::Close() {
+    m_files.clear();
+    m_firstFrame.clear();
+    m_skipped = 0;
+}
+
+std::pair<size_t, size_t> DvrSession::Locate(size_t index) const {
+    // m_firstFrame 末尾是总帧数，upper_bound 落在目标文件之后
+    const auto it = std::upper_bound(m_firstFrame.begin(), m_firstFrame.end() - 1, index);
+    const size_t file = static_cast<size_t>(it - m_firstFrame.begin()) - 1;
+    return {file, index - m_firstFrame[file]};
+}
+
+uint64_t DvrSession::Timestamp(size_t index) const {
+    if (index >= FrameCount()) return 0;
+    const auto [file, local] = Locate(index);
+    return m_files[file]->Index()[local].timestamp;
+}
+
+size_t DvrSession::FindByTimestamp(uint64_t timestamp) const {
+    if (m_files.empty()) return 0;
+    const auto it = std::upper_bound(m_files.begin(), m_files.end(), timestamp,
+                                     [](uint64_t ts, const auto& f) { return ts < f->FirstTimestamp(); });
+    const size_t file = it == m_files.begin() ? 0 : static_cast<size_t>(it - m_files.begin()) - 1;
+    return m_firstFrame[file] + m_files[file]->FindByTimestamp(timestamp);
+}
+
+const DvrRecord* DvrSession::Record(size_t index) {
+    if (index >= FrameCount()) return nullptr;
+    const auto [file, local] = Locate(index);
+    return m_files[file]->Record(local);
+}
+
+bool DvrSession::ReadFrame(size_t index, HeatmapFrame& frame) {
+    if (index >= FrameCount()) return false;
+    const auto [file, local] = Locate(index);
+    return m_files[file]->ReadFrame(local, frame);
+}
+
+} // namespace Engine
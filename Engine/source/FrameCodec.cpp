@@ -0,0 +1,369 @@
+#include "FrameCodec.h"
+#include "SimdKernels.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace Engine {
+
+namespace {
+
+constexpr size_t kMatrixCells = 40 * 60;
+constexpr uint8_t kFlagKeyframe = 0x01;
+constexpr int kTraceFields = 6;
+
+// ---- varint (LEB128) ----
+
+void PutVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+bool GetVarint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        const uint8_t b = *p++;
+        v |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+uint64_t ZigZag64(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+int64_t UnZigZag64(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+void PutFixed(std::vector<uint8_t>& out, const void* src, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(src);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+bool GetFixed(const uint8_t*& p, const uint8_t* end, void* dst, size_t size) {
+    if (static_cast<size_t>(end - p) < size) return false;
+    std::memcpy(dst, p, size);
+    p += size;
+    return true;
+}
+
+// ---- 平面打包：16 元素一块，零块游程 + 按块位宽打包 ----
+
+constexpr size_t kBlock = 16;
+constexpr uint8_t kZeroRunFlag = 0x80;   // 0x80 | (k - 1)：k 个连续全零块 (k <= 128)
+
+size_t MaxPlaneBytes(size_t n) { return (n + kBlock - 1) / kBlock * (1 + kBlock * 2); }
+
+// 写入 dst (至少 MaxPlaneBytes(n) 字节)，返回写入末尾
+uint8_t* PackPlane(const uint16_t* z, size_t n, uint8_t* dst) {
+    const auto findNonZero = Simd::Kernels().FindNonZero;
+    uint16_t tail[kBlock];
+    size_t i = 0;
+    while (i < n) {
+        const size_t count = std::min(kBlock, n - i);
+        const uint16_t* block = z + i;
+        if (count < kBlock) {
+            std::memcpy(tail, block, count * sizeof(uint16_t));
+            std::fill(tail + count, tail + kBlock, uint16_t{0});
+            block = tail;
+        }
+        uint32_t bitsUsed = 0;
+        for (size_t j = 0; j < kBlock; ++j) bitsUsed |= block[j];
+
+        if (bitsUsed == 0) {
+            // 零段交给向量扫描，按整块计数
+            const size_t next = findNonZero(z, i, n);
+            size_t blocks = std::max<size_t>(1, (next - i) / kBlock);
+            if (next == n) blocks = (n - i + kBlock - 1) / kBlock;
+            i += blocks * kBlock;
+            for (; blocks > 0; blocks -= std::min<size_t>(blocks, 128)) {
+                *dst++ = static_cast<uint8_t>(kZeroRunFlag | (std::min<size_t>(blocks, 128) - 1));
+            }
+            continue;
+        }
+
+        const uint32_t width = static_cast<uint32_t>(std::bit_width(bitsUsed));
+        *dst++ = static_cast<uint8_t>(width);
+        uint32_t acc = 0;
+        uint32_t bits = 0;
+        for (size_t j = 0; j < kBlock; ++j) {
+            acc |= static_cast<uint32_t>(block[j]) << bits;
+            bits += width;
+            if (bits >= 16) {
+                dst[0] = static_cast<uint8_t>(acc);
+                dst[1] = static_cast<uint8_t>(acc >> 8);
+                dst += 2;
+                acc >>= 16;
+                bits -= 16;
+            }
+        }
+        i += kBlock;
+    }
+    return dst;
+}
+
+bool UnpackPlane(const uint8_t* p, const uint8_t* end, uint16_t* z, size_t n) {
+    uint16_t tail[kBlock];
+    size_t i = 0;
+    while (i < n) {
+        if (p == end) return false;
+        const uint8_t header = *p++;
+        if (header & kZeroRunFlag) {
+            const size_t elements = std::min(n - i, (static_cast<size_t>(header & 0x7F) + 1) * kBlock);
+            std::fill(z + i, z + i + elements, uint16_t{0});
+            i += elements;
+            continue;
+        }
+
+        const uint32_t width = header;
+        if (width == 0 || width > 16 || static_cast<size_t>(end - p) < width * 2) return false;
+        const size_t count = std::min(kBlock, n - i);
+        uint16_t* block = count < kBlock ? tail : z + i;
+        const uint32_t mask = (1u << width) - 1;
+        uint32_t acc = 0;
+        uint32_t bits = 0;
+        for (size_t j = 0; j < kBlock; ++j) {
+            if (bits < width) {
+                acc |= static_cast<uint32_t>(p[0] | (p[1] << 8)) << bits;
+                p += 2;
+                bits += 16;
+            }
+            block[j] = static_cast<uint16_t>(acc & mask);
+            acc >>= width;
+            bits -= width;
+        }
+        if (block == tail) std::memcpy(z + i, tail, count * sizeof(uint16_t));
+        i += count;
+    }
+    return p == end;
+}
+
+void AppendPlane(std::vector<uint8_t>& out, std::vector<uint8_t>& tokens, const uint16_t* z, size_t n) {
+    if (tokens.size() < MaxPlaneBytes(n)) tokens.resize(MaxPlaneBytes(n));
+    const size_t size = static_cast<size_t>(PackPlane(z, n, tokens.data()) - tokens.data());
+    PutVarint(out, size);
+    out.insert(out.end(), tokens.begin(), tokens.begin() + static_cast<ptrdiff_t>(size));
+}
+
+bool ReadPlane(const uint8_t*& p, const uint8_t* end, uint16_t* z, size_t n) {
+    uint64_t size = 0;
+    if (!GetVarint(p, end, size) || size > static_cast<uint64_t>(end - p)) return false;
+    const uint8_t* planeEnd = p + size;
+    const bool ok = UnpackPlane(p, planeEnd, z, n);
+    p = planeEnd;
+    return ok;
+}
+
+// 关键帧：与左邻差分 (首元素与 0 差分)
+void SpatialDelta(const int16_t* cur, uint16_t* z, size_t n) {
+    if (n == 0) return;
+    const int16_t zero = 0;
+    Simd::Kernels().DeltaZigZag(cur, &zero, z, 1);
+    Simd::Kernels().DeltaZigZag(cur + 1, cur, z + 1, n - 1);
+}
+
+// 空间差分的逆运算是前缀和，逐元素依赖，保持标量
+void SpatialUndelta(const uint16_t* z, int16_t* out, size_t n) {
+    uint16_t acc = 0;
+    for (size_t i = 0; i < n; ++i) {
+        acc = static_cast<uint16_t>(acc + ((z[i] >> 1) ^ static_cast<uint16_t>(0u - (z[i] & 1u))));
+        out[i] = static_cast<int16_t>(acc);
+    }
+}
+
+// 原始数据按 [首字节][小端字 x W][末字节 (奇数长度时)] 拆分，使热力图 (偏移 7) 落在字边界
+size_t RawWordCount(size_t rawSize) { return rawSize ? (rawSize - 1) / 2 : 0; }
+bool RawHasTail(size_t rawSize) { return rawSize && ((rawSize - 1) & 1); }
+
+constexpr uint64_t FrameTrace::* kTraceFieldPtrs[kTraceFields] = {
+    &FrameTrace::readStartNs, &FrameTrace::readDoneNs, &FrameTrace::enqueueNs,
+    &FrameTrace::dequeueNs,   &FrameTrace::processedNs, &FrameTrace::publishedNs,
+};
+
+} // namespace
+
+// ---------------------------------------------------------
+// FrameEncoder
+
+FrameEncoder::FrameEncoder(uint32_t keyframeInterval)
+    : m_keyframeInterval(keyframeInterval) {
+    m_zigzag.resize(kMatrixCells);
+}
+
+bool FrameEncoder::Encode(const HeatmapFrame& frame, std::vector<uint8_t>& out) {
+    const size_t rawSize = frame.rawData.size();
+    const size_t words = RawWordCount(rawSize);
+    const bool keyframe = m_forceKeyframe || m_keyframeInterval <= 1 || m_sinceKeyframe >= m_keyframeInterval ||
+                          rawSize != m_rawSize;
+
+    out.push_back(keyframe ? kFlagKeyframe : 0);
+    PutVarint(out, rawSize);
+    if (rawSize) out.push_back(frame.rawData[0]);
+    if (RawHasTail(rawSize)) out.push_back(frame.rawData[rawSize - 1]);
+
+    // 时间戳：关键帧存绝对值，增量帧存与上一帧之差
+    if (keyframe) PutFixed(out, &frame.timestamp, sizeof(frame.timestamp));
+    else PutVarint(out, ZigZag64(static_cast<int64_t>(frame.timestamp - m_prevTimestamp)));
+
+    // 打点：存在位图 + 相对本帧时间戳的偏移 (publishedNs 在帧对 GUI 可见后才写入，经原子访问)
+    uint64_t traceNs[kTraceFields];
+    for (int k = 0; k < kTraceFields - 1; ++k) traceNs[k] = frame.trace.*kTraceFieldPtrs[k];
+    traceNs[kTraceFields - 1] = frame.trace.PublishedNs();
+    uint8_t traceMask = 0;
+    for (int k = 0; k < kTraceFields; ++k) {
+        if (traceNs[k]) traceMask |= static_cast<uint8_t>(1u << k);
+    }
+    out.push_back(traceMask);
+    for (int k = 0; k < kTraceFields; ++k) {
+        if (traceMask & (1u << k)) {
+            PutVarint(out, ZigZag64(static_cast<int64_t>(traceNs[k] - frame.timestamp)));
+        }
+    }
+    const uint8_t stageCount = std::min<uint8_t>(frame.trace.stageCount, FrameTrace::kMaxStages);
+    out.push_back(stageCount);
+    for (int k = 0; k < stageCount; ++k) PutVarint(out, frame.trace.stageNs[k]);
+
+    PutVarint(out, frame.contacts.size());
+    for (const TouchContact& c : frame.contacts) {
+        PutVarint(out, ZigZag64(c.id));
+        PutFixed(out, &c.x, sizeof(c.x));
+        PutFixed(out, &c.y, sizeof(c.y));
+        PutVarint(out, ZigZag64(c.state));
+        PutVarint(out, ZigZag64(c.area));
+    }
+
+    const Simd::KernelTable& kernels = Simd::Kernels();
+
+    // 原始数据平面
+    m_curRaw.resize(words);
+    m_zigzag.resize(std::max(words, kMatrixCells));
+    if (words) {
+        kernels.LoadLe16(frame.rawData.data() + 1, m_curRaw.data(), words);
+        if (keyframe) SpatialDelta(m_curRaw.data(), m_zigzag.data(), words);
+        else kernels.DeltaZigZag(m_curRaw.data(), m_prevRaw.data(), m_zigzag.data(), words);
+    }
+    AppendPlane(out, m_tokens, m_zigzag.data(), words);
+
+    // 处理后矩阵平面
+    const int16_t* matrix = &frame.heatmapMatrix[0][0];
+    if (keyframe) SpatialDelta(matrix, m_zigzag.data(), kMatrixCells);
+    else kernels.DeltaZigZag(matrix, m_prevMatrix, m_zigzag.data(), kMatrixCells);
+    AppendPlane(out, m_tokens, m_zigzag.data(), kMatrixCells);
+
+    m_prevRaw.swap(m_curRaw);
+    std::memcpy(m_prevMatrix, matrix, sizeof(m_prevMatrix));
+    m_prevTimestamp = frame.timestamp;
+    m_rawSize = rawSize;
+    m_sinceKeyframe = keyframe ? 1 : m_sinceKeyframe + 1;
+    m_forceKeyframe = false;
+    return keyframe;
+}
+
+// ---------------------------------------------------------
+// FrameDecoder
+
+FrameDecoder::FrameDecoder() {
+    m_zigzag.resize(kMatrixCells);
+}
+
+bool FrameDecoder::IsKeyframe(std::span<const uint8_t> data) {
+    return !data.empty() && (data[0] & kFlagKeyframe);
+}
+
+bool FrameDecoder::Decode(std::span<const uint8_t> data, HeatmapFrame& frame) {
+    const uint8_t* p = data.data();
+    const uint8_t* end = p + data.size();
+    // 任一步失败都使参考帧失效，直到下一个关键帧
+    auto fail = [this] {
+        m_hasReference = false;
+        return false;
+    };
+
+    if (p == end) return fail();
+    const bool keyframe = (*p++ & kFlagKeyframe) != 0;
+    if (!keyframe && !m_hasReference) return fail();
+
+    uint64_t rawSize = 0;
+    if (!GetVarint(p, end, rawSize) || rawSize > 0xFFFF) return fail();
+    if (!keyframe && rawSize != m_rawSize) return fail();
+    const size_t words = RawWordCount(static_cast<size_t>(rawSize));
+    uint8_t lead = 0, tail = 0;
+    if (rawSize && !GetFixed(p, end, &lead, 1)) return fail();
+    if (RawHasTail(static_cast<size_t>(rawSize)) && !GetFixed(p, end, &tail, 1)) return fail();
+
+    uint64_t timestamp = 0;
+    if (keyframe) {
+        if (!GetFixed(p, end, &timestamp, sizeof(timestamp))) return fail();
+    } else {
+        uint64_t delta = 0;
+        if (!GetVarint(p, end, delta)) return fail();
+        timestamp = m_prevTimestamp + static_cast<uint64_t>(UnZigZag64(delta));
+    }
+    frame.timestamp = timestamp;
+
+    uint8_t traceMask = 0;
+    if (!GetFixed(p, end, &traceMask, 1)) return fail();
+    FrameTrace trace;
+    for (int k = 0; k < kTraceFields; ++k) {
+        if (!(traceMask & (1u << k))) continue;
+        uint64_t v = 0;
+        if (!GetVarint(p, end, v)) return fail();
+        trace.*kTraceFieldPtrs[k] = timestamp + static_cast<uint64_t>(UnZigZag64(v));
+    }
+    uint8_t stageCount = 0;
+    if (!GetFixed(p, end, &stageCount, 1) || stageCount > FrameTrace::kMaxStages) return fail();
+    trace.stageCount = stageCount;
+    for (int k = 0; k < stageCount; ++k) {
+        uint64_t v = 0;
+        if (!GetVarint(p, end, v) || v > UINT32_MAX) return fail();
+        trace.stageNs[k] = static_cast<uint32_t>(v);
+    }
+    frame.trace = trace;
+
+    uint64_t contactCount = 0;
+    if (!GetVarint(p, end, contactCount) || contactCount > static_cast<uint64_t>(end - p)) return fail();
+    frame.contacts.clear();
+    for (uint64_t i = 0; i < contactCount; ++i) {
+        uint64_t id = 0, state = 0, area = 0;
+        TouchContact c{};
+        if (!GetVarint(p, end, id) || !GetFixed(p, end, &c.x, sizeof(c.x)) || !GetFixed(p, end, &c.y, sizeof(c.y)) ||
+            !GetVarint(p, end, state) || !GetVarint(p, end, area)) {
+            return fail();
+        }
+        c.id = static_cast<int>(UnZigZag64(id));
+        c.state = static_cast<int>(UnZigZag64(state));
+        c.area = static_cast<int>(UnZigZag64(area));
+        frame.contacts.push_back(c);
+    }
+
+    const Simd::KernelTable& kernels = Simd::Kernels();
+
+    // 原始数据平面
+    m_zigzag.resize(std::max(words, kMatrixCells));
+    if (!ReadPlane(p, end, m_zigzag.data(), words)) return fail();
+    m_prevRaw.resize(words);
+    if (keyframe) SpatialUndelta(m_zigzag.data(), m_prevRaw.data(), words);
+    else kernels.UnZigZagAdd(m_zigzag.data(), m_prevRaw.data(), m_prevRaw.data(), words);
+
+    frame.rawData.resize(static_cast<size_t>(rawSize));
+    if (rawSize) {
+        frame.rawData[0] = lead;
+        std::memcpy(frame.rawData.data() + 1, m_prevRaw.data(), words * sizeof(int16_t));   // 小端
+        if (RawHasTail(static_cast<size_t>(rawSize))) frame.rawData[static_cast<size_t>(rawSize) - 1] = tail;
+    }
+
+    // 处理后矩阵平面
+    if (!ReadPlane(p, end, m_zigzag.data(), kMatrixCells)) return fail();
+    if (keyframe) SpatialUndelta(m_zigzag.data(), m_prevMatrix, kMatrixCells);
+    else kernels.UnZigZagAdd(m_zigzag.data(), m_prevMatrix, m_prevMatrix, kMatrixCells);
+    std::memcpy(frame.heatmapMatrix, m_prevMatrix, sizeof(m_prevMatrix));
+
+    if (p != end) return fail();
+
+    m_hasReference = true;
+    m_rawSize = static_cast<size_t>(rawSize);
+    m_prevTimestamp = timestamp;
+    return true;
+}
+
+} // namespace Engine
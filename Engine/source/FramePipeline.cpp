@@ -1,47 +1,212 @@
 #include "FramePipeline.h"
+#include "BaselineSubtraction.h"
+#include "CentroidExtractor.h"
+#include "DynamicDeadzoneFilter.h"
+#include "GaussianFilter.h"
+#include "MasterFrameParser.h"
+#include "SignalConditioningFilter.h"
+#include "SimdKernels.h"
+#include "SpatialSharpenFilter.h"
 #include <algorithm>
+#include <cstring>
 
 namespace Engine {
 
+namespace {
+
+void Bump(std::atomic<uint64_t>& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void HashBytes(uint64_t& hash, const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+}
+
+} // namespace
+
 void FramePipeline::AddProcessor(std::unique_ptr<IFrameProcessor> processor) {
     if (processor) {
         m_processors.push_back(std::move(processor));
+        m_stats.push_back(std::make_unique<ProcessorStats>());
     }
 }
 
 void FramePipeline::RemoveProcessor(const std::string& name) {
-    m_processors.erase(
-        std::remove_if(m_processors.begin(), m_processors.end(),
-            [&name](const std::unique_ptr<IFrameProcessor>& p) {
-                return p->GetName() == name;
-            }),
-        m_processors.end());
+    // 统计与处理器同下标，逐个成对删除
+    for (size_t i = m_processors.size(); i-- > 0;) {
+        if (m_processors[i]->GetName() == name) {
+            m_processors.erase(m_processors.begin() + i);
+            m_stats.erase(m_stats.begin() + i);
+        }
+    }
 }
 
 void FramePipeline::MoveProcessorUp(size_t index) {
     if (index > 0 && index < m_processors.size()) {
         std::swap(m_processors[index], m_processors[index - 1]);
+        std::swap(m_stats[index], m_stats[index - 1]);
     }
 }
 
 void FramePipeline::MoveProcessorDown(size_t index) {
     if (index >= 0 && index + 1 < m_processors.size()) {
         std::swap(m_processors[index], m_processors[index + 1]);
+        std::swap(m_stats[index], m_stats[index + 1]);
+    }
+}
+
+uint64_t FramePipeline::ConfigHash() const {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    std::vector<ParamDesc> params;
+    for (const auto& processor : m_processors) {
+        const std::string name = processor->GetName();
+        HashBytes(hash, name.data(), name.size() + 1);
+        const uint8_t enabled = processor->IsEnabled() ? 1 : 0;
+        HashBytes(hash, &enabled, sizeof(enabled));
+
+        params.clear();
+        processor->DescribeParams(params);
+        for (const ParamDesc& param : params) {
+            HashBytes(hash, param.name, std::strlen(param.name) + 1);
+            const double value = param.Get();
+            HashBytes(hash, &value, sizeof(value));
+        }
     }
+    const uint8_t fused = m_fuseFrontEnd ? 1 : 0;
+    HashBytes(hash, &fused, sizeof(fused));
+    return hash;
 }
 
 bool FramePipeline::Execute(HeatmapFrame& frame) {
-    for (auto& processor : m_processors) {
-        if (!processor->Process(frame)) {
+    if (m_resetStats.exchange(false, std::memory_order_relaxed)) {
+        for (auto& stats : m_stats) stats->Clear();
+        m_frontEndStats.Clear();
+        m_pipelineStats.Clear();
+    }
+
+    const bool profiling = m_profiling.load(std::memory_order_relaxed);
+    const uint64_t frameStart = profiling ? TraceNowNs() : 0;
+    uint64_t stageStart = frameStart;
+    if (profiling) {
+        frame.trace.stageCount = static_cast<uint8_t>(std::min<size_t>(m_processors.size(), FrameTrace::kMaxStages));
+        std::fill_n(frame.trace.stageNs, frame.trace.stageCount, 0u);
+    }
+
+    // 相邻阶段共用时间戳：上一阶段的结束即下一阶段的开始
+    auto finishStage = [&](ProcessorStats& stats, size_t index) {
+        const uint64_t now = TraceNowNs();
+        stats.latency.Record(now - stageStart);
+        Bump(stats.calls);
+        if (index < FrameTrace::kMaxStages) {
+            frame.trace.stageNs[index] = static_cast<uint32_t>(std::min<uint64_t>(now - stageStart, UINT32_MAX));
+        }
+        stageStart = now;
+    };
+    auto finishFrame = [&](bool kept) {
+        if (!profiling) return;
+        m_pipelineStats.latency.Record(TraceNowNs() - frameStart);
+        Bump(m_pipelineStats.calls);
+        if (!kept) Bump(m_pipelineStats.drops);
+    };
+
+    for (size_t i = 0; i < m_processors.size();) {
+        if (m_fuseFrontEnd) {
+            // 两个及以上相邻逐点阶段合并为一次遍历 (逐点阶段从不丢帧)
+            const size_t runEnd = FindFrontEndRun(i);
+            if (runEnd - i >= 2) {
+                ExecuteFrontEnd(i, runEnd, frame);
+                if (profiling) {
+                    finishStage(m_frontEndStats, i);
+                    for (size_t j = i; j < runEnd; ++j) Bump(m_stats[j]->calls);
+                }
+                i = runEnd;
+                continue;
+            }
+        }
+        const bool kept = m_processors[i]->Process(frame);
+        if (profiling) {
+            finishStage(*m_stats[i], i);
+            if (!kept) Bump(m_stats[i]->drops);
+        }
+        if (!kept) {
             // If any processor returns false, the frame is dropped
+            finishFrame(false);
             return false;
         }
+        ++i;
     }
+    finishFrame(true);
     return true;
 }
 
+size_t FramePipeline::FindFrontEndRun(size_t begin) const {
+    FrontEndStage prev;
+    if (!m_processors[begin]->GetFrontEndStage(prev)) return begin;
+
+    size_t end = begin + 1;
+    FrontEndStage next;
+    while (end < m_processors.size() && m_processors[end]->GetFrontEndStage(next) && next > prev) {
+        prev = next;
+        ++end;
+    }
+    return end;
+}
+
+void FramePipeline::ExecuteFrontEnd(size_t begin, size_t end, HeatmapFrame& frame) {
+    FrontEndParams params;
+    for (size_t i = begin; i < end; ++i) {
+        m_processors[i]->ContributeFrontEnd(params);
+    }
+
+    const int numPixels = 40 * 60;
+    int16_t* frameData = &frame.heatmapMatrix[0][0];
+    const Simd::KernelTable& kernels = Simd::Kernels();
+
+    Simd::FrontEndArgs args;
+    args.baseline = params.subtractBaseline ? params.baseline : 0;
+
+    if (params.deadzone) {
+        // 死区水位依赖基线后的全局最大值，这一趟只读预扫描无法融合掉
+        int16_t globalMax = kernels.SubReduceMax(frameData, numPixels, args.baseline, 0);
+        if (globalMax > 0) {
+            int16_t shrinkVal = static_cast<int16_t>((static_cast<int32_t>(globalMax) * params.shrinkPercent) / 100);
+            if (shrinkVal > 0) {
+                args.deadzone = true;
+                args.shrinkValue = shrinkVal;
+            }
+        }
+    }
+
+    if (params.conditioning) {
+        args.conditioning = true;
+        // alpha >= 1000 时原路径直接拷贝历史帧，等价于 alpha = 1000 的混合
+        args.alpha = std::min(params.alpha, 1000);
+        args.noiseFloor = params.noiseFloor;
+        args.history = params.history;
+        args.seedHistory = params.seedHistory;
+    }
+
+    if (args.baseline == 0 && !args.deadzone && !args.conditioning) return;
+    kernels.FrontEndApply(frameData, numPixels, args);
+}
+
 const std::vector<std::unique_ptr<IFrameProcessor>>& FramePipeline::GetProcessors() const {
     return m_processors;
 }
 
+void AddDefaultProcessors(FramePipeline& pipeline) {
+    pipeline.AddProcessor(std::make_unique<MasterFrameParser>());
+    pipeline.AddProcessor(std::make_unique<BaselineSubtraction>());
+    pipeline.AddProcessor(std::make_unique<DynamicDeadzoneFilter>());
+    pipeline.AddProcessor(std::make_unique<SignalConditioningFilter>());
+    pipeline.AddProcessor(std::make_unique<GaussianFilter>());
+    // Unsharp masking filter to separate highly merged fingers *before* extraction
+    pipeline.AddProcessor(std::make_unique<SpatialSharpenFilter>());
+    pipeline.AddProcessor(std::make_unique<CentroidExtractor>());
+}
+
 } // namespace Engine
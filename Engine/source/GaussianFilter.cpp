@@ -1,6 +1,7 @@
 #include "GaussianFilter.h"
-#include "imgui.h"
+#include "SimdKernels.h"
 #include <algorithm>
+#include <cstring>
 
 namespace Engine {
 
@@ -17,48 +18,25 @@ bool GaussianFilter::Process(HeatmapFrame& frame) {
     const int numCols = 60;
 
     // Copy original data to temp buffer
-    for (int y = 0; y < numRows; ++y) {
-        for (int x = 0; x < numCols; ++x) {
-            m_temp[y * numCols + x] = frame.heatmapMatrix[y][x];
-        }
-    }
+    std::memcpy(m_temp.data(), &frame.heatmapMatrix[0][0], numRows * numCols * sizeof(int16_t));
 
     // 可变中心权重的高斯核模型：
     // 1        2        1
     // 2 m_centerWeight  2
     // 1        2        1
     // Sum = 12 + m_centerWeight
-    int32_t kernelSum = 12 + m_centerWeight;
-
-    for (int y = 1; y < numRows - 1; ++y) {
-        for (int x = 1; x < numCols - 1; ++x) {
-            int32_t sum = 0;
-            
-            // Top row
-            sum += m_temp[(y - 1) * numCols + (x - 1)] * 1;
-            sum += m_temp[(y - 1) * numCols + (x    )] * 2;
-            sum += m_temp[(y - 1) * numCols + (x + 1)] * 1;
-            
-            // Middle row
-            sum += m_temp[(y    ) * numCols + (x - 1)] * 2;
-            sum += m_temp[(y    ) * numCols + (x    )] * m_centerWeight;
-            sum += m_temp[(y    ) * numCols + (x + 1)] * 2;
-            
-            // Bottom row
-            sum += m_temp[(y + 1) * numCols + (x - 1)] * 1;
-            sum += m_temp[(y + 1) * numCols + (x    )] * 2;
-            sum += m_temp[(y + 1) * numCols + (x + 1)] * 1;
-
-            frame.heatmapMatrix[y][x] = static_cast<int16_t>(sum / kernelSum);
-        }
-    }
+    // 仅更新内部像素，边框保持原值
+    Simd::Kernels().Gaussian3x3(m_temp.data(), &frame.heatmapMatrix[0][0], numRows, numCols, m_centerWeight);
 
     return true;
 }
 
-void GaussianFilter::DrawConfigUI() {
-    ImGui::TextWrapped("Increase Center Weight to reduce blurring.");
-    ImGui::SliderInt("Center Kernel Weight", &m_centerWeight, 1, 30);
+const char* GaussianFilter::GetDescription() const {
+    return "Increase Center Weight to reduce blurring.";
+}
+
+void GaussianFilter::DescribeParams(std::vector<ParamDesc>& params) {
+    params.push_back(ParamDesc::Int("Center Kernel Weight", &m_centerWeight, 1, 30));
 }
 
 } // namespace Engine
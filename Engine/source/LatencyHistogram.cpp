@@ -0,0 +1,62 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <bit>
+
+namespace Engine {
+
+size_t LatencyHistogram::BucketIndex(uint64_t ns) {
+    if (ns < kSubBuckets) return static_cast<size_t>(ns);
+
+    // 最高位指数 e >= kSubBucketBits，取其下 kSubBucketBits 位作为子桶号
+    const int exponent = std::bit_width(ns) - 1;
+    if (exponent > kMaxExponent) return kBucketCount - 1;
+    const int shift = exponent - kSubBucketBits;
+    const size_t sub = static_cast<size_t>((ns >> shift) & (kSubBuckets - 1));
+    return static_cast<size_t>(shift + 1) * kSubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(size_t index) {
+    if (index < kSubBuckets) return index;
+    const int shift = static_cast<int>(index / kSubBuckets) - 1;
+    const uint64_t sub = index % kSubBuckets;
+    const uint64_t lower = (uint64_t{kSubBuckets} + sub) << shift;
+    return lower + ((uint64_t{1} << shift) - 1);
+}
+
+void LatencyHistogram::Clear() {
+    for (auto& bucket : m_buckets) bucket.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+LatencySummary LatencyHistogram::Summarize() const {
+    LatencySummary summary;
+
+    uint64_t counts[kBucketCount];
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        summary.count += counts[i];
+    }
+    if (summary.count == 0) return summary;
+
+    summary.max = m_max.load(std::memory_order_relaxed);
+    summary.mean = static_cast<double>(m_sum.load(std::memory_order_relaxed)) / summary.count;
+
+    // 第 ceil(q * count) 个样本所在桶
+    auto rankOf = [&](uint64_t permille) { return std::max<uint64_t>(1, (summary.count * permille + 999) / 1000); };
+    const uint64_t ranks[3] = {rankOf(500), rankOf(900), rankOf(990)};
+    uint64_t* outputs[3] = {&summary.p50, &summary.p90, &summary.p99};
+
+    uint64_t seen = 0;
+    int next = 0;
+    for (size_t i = 0; i < kBucketCount && next < 3; ++i) {
+        seen += counts[i];
+        while (next < 3 && seen >= ranks[next]) {
+            // 上界不超过实际最大值 (读取期间写者仍在更新，max 也可能略旧)
+            *outputs[next++] = summary.max ? std::min(BucketUpperBound(i), summary.max) : BucketUpperBound(i);
+        }
+    }
+    return summary;
+}
+
+} // namespace Engine
@@ -1,5 +1,5 @@
 #include "MasterFrameParser.h"
-#include <arm_neon.h>
+#include "SimdKernels.h"
 #include <cstring>
 #include <stdexcept>
 
@@ -11,24 +11,24 @@ bool MasterFrameParser::Process(HeatmapFrame& frame) {
     // 根据需求：Master 帧原始长度 5063 字节
     // 跳过前 7 字节，取中间 4800 字节 (40 TX * 60 RX * 2 Byte)
     if (frame.rawData.size() < 5063) {
+        frame.saturatedCells = 0;   // 未解析，不能沿用该帧对象上一次的计数
         return true; 
     }
 
     const uint8_t* raw_ptr = frame.rawData.data() + 7;
     int16_t* heat_ptr = reinterpret_cast<int16_t*>(frame.heatmapMatrix); 
 
-    // 4800 字节 = 2400 个 uint16_t 数据
-    // 每次处理 8 个数据 (128位寄存器)，共 300 次循环
-    // NEON Intrinsics 展开
-    for (int i = 0; i < 2400; i += 8) {
-        // 从无对齐的 uint8_t 内存流加载 8 个 uint16_t 数据 -> 128 bit 寄存器
-        uint16x8_t raw_vals = vld1q_u16(reinterpret_cast<const uint16_t*>(raw_ptr + i * 2));
-        
-        // 直接存入 HeatmapMatrix 的 int16_t 数组中 (强制转化)
-        vst1q_s16(heat_ptr + i, vreinterpretq_s16_u16(raw_vals));
-    }
+    // 4800 字节 = 2400 个 uint16_t 数据，从无对齐的 uint8_t 内存流加载
+    // 向量宽度由运行时选中的 SIMD 后端决定 (NEON / SSE4.1 / AVX2 / Scalar)；
+    // 饱和格计数融合在同一遍加载中，不额外扫描矩阵
+    frame.saturatedCells = static_cast<uint32_t>(
+        Simd::Kernels().LoadLe16CountRail(raw_ptr, heat_ptr, 2400, static_cast<uint16_t>(m_railMargin)));
 
     return true;
 }
 
+void MasterFrameParser::DescribeParams(std::vector<ParamDesc>& params) {
+    params.push_back(ParamDesc::Int("Saturation Margin", &m_railMargin, 0, 4096));
+}
+
 } // namespace Engine
@@ -0,0 +1,394 @@
+#include "ParamSweep.h"
+#include "DvrMappedReader.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace Engine {
+
+namespace {
+
+// SplitMix64：与平台无关的确定性随机序列，同一 seed 在任意机器上得到相同采样点
+uint64_t NextRandom(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+double NextUnit(uint64_t& state) {
+    return static_cast<double>(NextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+float Distance(float ax, float ay, float bx, float by) {
+    return std::hypot(ax - bx, ay - by);
+}
+
+// 逐帧评分的跨帧状态 (一个任务一份)
+class FrameScorer {
+public:
+    FrameScorer(SweepMetrics& metrics, float matchDistance) : m_metrics(metrics), m_match(matchDistance) {}
+
+    // 有真值：漏报 / 误报 / 定位误差 + 分裂 / 合并 + 误差向量抖动
+    void Score(std::span<const SceneContact> truth, std::span<const TouchContact> detected) {
+        m_metrics.score.Accumulate(ScoreContacts(truth, detected, m_match));
+
+        // 手指真值与检测点按距离从近到远贪心一对一匹配
+        m_pairs.clear();
+        int fingers = 0;
+        for (size_t t = 0; t < truth.size(); ++t) {
+            if (truth[t].kind != ContactKind::Finger) continue;
+            ++fingers;
+            for (size_t d = 0; d < detected.size(); ++d) {
+                const float dist = Distance(detected[d].x, detected[d].y, truth[t].x, truth[t].y);
+                if (dist <= 2.0f * m_match) m_pairs.push_back({dist, t, d});
+            }
+        }
+        std::sort(m_pairs.begin(), m_pairs.end(), [](const Pair& a, const Pair& b) { return a.dist < b.dist; });
+        m_truthMatch.assign(truth.size(), kNone);
+        m_detectedMatch.assign(detected.size(), kNone);
+        for (const Pair& pair : m_pairs) {
+            if (pair.dist > m_match || m_truthMatch[pair.truth] != kNone || m_detectedMatch[pair.detected] != kNone) continue;
+            m_truthMatch[pair.truth] = pair.detected;
+            m_detectedMatch[pair.detected] = pair.truth;
+        }
+
+        // 误分裂：未匹配的检测点紧挨着一个已匹配的手指；误合并：未匹配的手指附近 (2 倍半径)
+        // 的检测点已被另一个手指占用。m_pairs 已按距离排序，取每个对象的第一次出现即最近者
+        m_seenTruth.assign(truth.size(), false);
+        m_seenDetected.assign(detected.size(), false);
+        for (const Pair& pair : m_pairs) {
+            if (!m_seenDetected[pair.detected]) {
+                m_seenDetected[pair.detected] = true;
+                if (m_detectedMatch[pair.detected] == kNone && pair.dist <= m_match &&
+                    m_truthMatch[pair.truth] != kNone) {
+                    ++m_metrics.splits;
+                }
+            }
+            if (!m_seenTruth[pair.truth]) {
+                m_seenTruth[pair.truth] = true;
+                if (m_truthMatch[pair.truth] == kNone && m_detectedMatch[pair.detected] != kNone) ++m_metrics.merges;
+            }
+        }
+
+        m_errors.clear();
+        for (size_t t = 0; t < truth.size(); ++t) {
+            if (m_truthMatch[t] == kNone) continue;
+            const float ex = detected[m_truthMatch[t]].x - truth[t].x;
+            const float ey = detected[m_truthMatch[t]].y - truth[t].y;
+            for (const TrackError& prev : m_prevErrors) {
+                if (prev.id != truth[t].id) continue;
+                m_metrics.jitterSum += std::hypot(ex - prev.ex, ey - prev.ey);
+                ++m_metrics.jitterSamples;
+                break;
+            }
+            m_errors.push_back({truth[t].id, ex, ey});
+        }
+        m_prevErrors.swap(m_errors);
+
+        if (m_frames > 0 && fingers == m_prevFingers && detected.size() != m_prevCount) ++m_metrics.countChanges;
+        m_prevFingers = fingers;
+        Advance(detected);
+    }
+
+    // 无真值：最近邻关联相邻三帧，取位置二阶差分 (匀速运动为 0) 作为抖动
+    void Score(std::span<const TouchContact> detected) {
+        for (const TouchContact& d : detected) {
+            const Point* p1 = Nearest(m_prev1, d.x, d.y);
+            if (!p1) continue;
+            const Point* p2 = Nearest(m_prev2, p1->x, p1->y);
+            if (!p2) continue;
+            m_metrics.jitterSum += std::hypot(d.x - 2.0f * p1->x + p2->x, d.y - 2.0f * p1->y + p2->y);
+            ++m_metrics.jitterSamples;
+        }
+        if (m_frames > 0 && detected.size() != m_prevCount) ++m_metrics.countChanges;
+        Advance(detected);
+    }
+
+private:
+    static constexpr size_t kNone = SIZE_MAX;
+
+    struct Point { float x, y; };
+    struct TrackError { int id; float ex, ey; };
+    struct Pair { float dist; size_t truth; size_t detected; };
+
+    const Point* Nearest(const std::vector<Point>& points, float x, float y) const {
+        const Point* nearest = nullptr;
+        float best = m_match;
+        for (const Point& p : points) {
+            const float dist = Distance(p.x, p.y, x, y);
+            if (dist <= best) {
+                best = dist;
+                nearest = &p;
+            }
+        }
+        return nearest;
+    }
+
+    void Advance(std::span<const TouchContact> detected) {
+        m_prev2.swap(m_prev1);
+        m_prev1.clear();
+        for (const TouchContact& d : detected) m_prev1.push_back({d.x, d.y});
+        m_prevCount = detected.size();
+        ++m_frames;
+        ++m_metrics.frames;
+    }
+
+    SweepMetrics& m_metrics;
+    float m_match;
+    uint64_t m_frames = 0;
+    size_t m_prevCount = 0;
+    int m_prevFingers = 0;
+    std::vector<Point> m_prev1, m_prev2;
+    std::vector<TrackError> m_errors, m_prevErrors;
+    std::vector<Pair> m_pairs;
+    std::vector<size_t> m_truthMatch, m_detectedMatch;
+    std::vector<bool> m_seenTruth, m_seenDetected;
+};
+
+} // namespace
+
+void SweepMetrics::Accumulate(const SweepMetrics& other) {
+    frames += other.frames;
+    score.Accumulate(other.score);
+    splits += other.splits;
+    merges += other.merges;
+    countChanges += other.countChanges;
+    jitterSum += other.jitterSum;
+    jitterSamples += other.jitterSamples;
+    failed = failed || other.failed;
+}
+
+double SweepCost(const SweepMetrics& m, const SweepWeights& w) {
+    double cost = w.jitter * m.MeanJitter();
+    if (m.frames) cost += w.flicker * static_cast<double>(m.countChanges) / m.frames;
+    if (m.score.truthCount) {
+        const double truth = m.score.truthCount;
+        cost += w.error * m.score.MeanError();
+        // splits 是 ghosts 的子集、merges 是 missed 的子集 (落在手掌上的分裂点不算误报，故取下限 0)
+        const double ghosts = std::max(0.0, static_cast<double>(m.score.ghosts) - static_cast<double>(m.splits));
+        const double missed = std::max(0.0, static_cast<double>(m.score.missed) - static_cast<double>(m.merges));
+        cost += w.missed * missed / truth;
+        cost += w.ghosts * ghosts / truth;
+        cost += w.splits * m.splits / truth;
+        cost += w.merges * m.merges / truth;
+    }
+    return cost;
+}
+
+// ---------------------------------------------------------
+// 参数空间采样
+
+std::vector<SweepPoint> GridPoints(std::span<const SweepAxis> axes) {
+    std::vector<SweepPoint> points;
+    if (axes.empty()) return points;
+    size_t total = 1;
+    for (const SweepAxis& axis : axes) total *= static_cast<size_t>(std::max(1, axis.steps));
+    points.reserve(total);
+
+    // 混合进制计数：第一个轴变化最快
+    std::vector<int> digit(axes.size(), 0);
+    for (size_t n = 0; n < total; ++n) {
+        SweepPoint point(axes.size());
+        for (size_t a = 0; a < axes.size(); ++a) {
+            const int steps = std::max(1, axes[a].steps);
+            point[a] = steps == 1 ? axes[a].min
+                                  : axes[a].min + (axes[a].max - axes[a].min) * digit[a] / (steps - 1);
+        }
+        points.push_back(std::move(point));
+        for (size_t a = 0; a < axes.size(); ++a) {
+            if (++digit[a] < std::max(1, axes[a].steps)) break;
+            digit[a] = 0;
+        }
+    }
+    return points;
+}
+
+std::vector<SweepPoint> RandomPoints(std::span<const SweepAxis> axes, size_t count, uint64_t seed) {
+    std::vector<SweepPoint> points(count, SweepPoint(axes.size()));
+    uint64_t state = seed;
+    for (SweepPoint& point : points) {
+        for (size_t a = 0; a < axes.size(); ++a) {
+            point[a] = axes[a].min + (axes[a].max - axes[a].min) * NextUnit(state);
+        }
+    }
+    return points;
+}
+
+std::vector<SweepPoint> LocalPoints(std::span<const SweepAxis> axes, const SweepPoint& center, double radius,
+                                    size_t count, uint64_t seed) {
+    std::vector<SweepPoint> points(count, SweepPoint(axes.size()));
+    uint64_t state = seed;
+    for (SweepPoint& point : points) {
+        for (size_t a = 0; a < axes.size(); ++a) {
+            const double lo = std::min(axes[a].min, axes[a].max);
+            const double hi = std::max(axes[a].min, axes[a].max);
+            const double offset = (2.0 * NextUnit(state) - 1.0) * radius * (hi - lo);
+            point[a] = std::clamp(center[a] + offset, lo, hi);
+        }
+    }
+    return points;
+}
+
+// ---------------------------------------------------------
+// 参数绑定
+
+std::vector<std::pair<std::string, ParamDesc>> ListParams(FramePipeline& pipeline) {
+    std::vector<std::pair<std::string, ParamDesc>> list;
+    std::vector<ParamDesc> params;
+    for (const auto& processor : pipeline.GetProcessors()) {
+        params.clear();
+        processor->DescribeParams(params);
+        for (const ParamDesc& param : params) {
+            list.emplace_back(processor->GetName() + "/" + param.name, param);
+        }
+    }
+    return list;
+}
+
+bool FindParam(FramePipeline& pipeline, const std::string& key, ParamDesc& out, std::string* error) {
+    // 处理器名中不含 '/'：第一个 '/' 之前为处理器名
+    const size_t slash = key.find('/');
+    const std::string processorName = slash == std::string::npos ? std::string() : key.substr(0, slash);
+    const std::string paramName = slash == std::string::npos ? key : key.substr(slash + 1);
+
+    int found = 0;
+    for (const auto& [fullKey, param] : ListParams(pipeline)) {
+        if (param.name != paramName) continue;
+        if (!processorName.empty() && fullKey.compare(0, processorName.size() + 1, processorName + "/") != 0) continue;
+        out = param;
+        ++found;
+    }
+    if (found == 1) return true;
+    if (error) *error = found == 0 ? "unknown parameter '" + key + "'"
+                                   : "parameter '" + key + "' is ambiguous, prefix it with the processor name";
+    return false;
+}
+
+// ---------------------------------------------------------
+// ParamSweep
+
+ParamSweep::ParamSweep(std::vector<SweepAxis> axes, std::vector<SweepInput> inputs, PipelineFactory factory)
+    : m_axes(std::move(axes)), m_inputs(std::move(inputs)), m_factory(std::move(factory)) {}
+
+bool ParamSweep::Validate(std::string& error) const {
+    FramePipeline pipeline;
+    m_factory(pipeline);
+    for (const SweepAxis& axis : m_axes) {
+        ParamDesc param;
+        if (!FindParam(pipeline, axis.key, param, &error)) return false;
+    }
+    for (const SweepInput& input : m_inputs) {
+        if (input.HasTruth()) continue;
+        DvrSession session;
+        if (!session.Open(input.recording)) {
+            error = "cannot open recording '" + input.recording + "' (no readable .egdvr frames)";
+            return false;
+        }
+    }
+    return true;
+}
+
+SweepPoint ParamSweep::DefaultPoint() const {
+    FramePipeline pipeline;
+    m_factory(pipeline);
+    SweepPoint point;
+    for (const SweepAxis& axis : m_axes) {
+        ParamDesc param;
+        point.push_back(FindParam(pipeline, axis.key, param) ? param.Get() : axis.min);
+    }
+    return point;
+}
+
+std::vector<SweepPoint> ParamSweep::EffectivePoints(std::span<const SweepPoint> points) const {
+    FramePipeline pipeline;
+    m_factory(pipeline);
+    std::vector<ParamDesc> params(m_axes.size());
+    for (size_t a = 0; a < m_axes.size(); ++a) FindParam(pipeline, m_axes[a].key, params[a]);
+
+    std::vector<SweepPoint> effective;
+    effective.reserve(points.size());
+    for (const SweepPoint& point : points) {
+        SweepPoint& out = effective.emplace_back(point);
+        for (size_t a = 0; a < params.size() && a < out.size(); ++a) {
+            if (!params[a].intValue && !params[a].floatValue) continue;   // 未解析的轴 (Validate 会报告)
+            params[a].Set(out[a]);
+            out[a] = params[a].Get();
+        }
+    }
+    return effective;
+}
+
+bool ParamSweep::BuildPipeline(FramePipeline& pipeline, const SweepPoint& point) const {
+    m_factory(pipeline);
+    pipeline.SetProfilingEnabled(false);
+    for (size_t a = 0; a < m_axes.size() && a < point.size(); ++a) {
+        ParamDesc param;
+        if (!FindParam(pipeline, m_axes[a].key, param)) return false;
+        param.Set(point[a]);
+    }
+    return true;
+}
+
+SweepMetrics ParamSweep::EvaluateOne(const SweepPoint& point, const SweepInput& input) const {
+    SweepMetrics metrics;
+    FramePipeline pipeline;
+    if (!BuildPipeline(pipeline, point)) {
+        metrics.failed = true;
+        return metrics;
+    }
+
+    FrameScorer scorer(metrics, matchDistance);
+    HeatmapFrame frame{};
+    if (input.HasTruth()) {
+        SceneGenerator generator(input.scene);
+        for (int i = 0; i < input.frames; ++i) {
+            const std::vector<SceneContact>& truth = generator.Next(frame);
+            if (!pipeline.Execute(frame) || i < warmupFrames) continue;
+            scorer.Score(truth, frame.contacts);
+        }
+    } else {
+        // 每个任务各自映射文件：页面由系统共享，解码缓存与管线状态各自独立
+        DvrSession session;
+        if (!session.Open(input.recording)) {
+            metrics.failed = true;
+            return metrics;
+        }
+        for (size_t i = 0; i < session.FrameCount(); ++i) {
+            const DvrRecord* record = session.Record(i);
+            if (!record) break;
+            frame.rawData.assign(record->raw, record->raw + std::min<size_t>(record->rawSize, sizeof(record->raw)));
+            frame.timestamp = record->timestamp;
+            if (!pipeline.Execute(frame) || i < static_cast<size_t>(warmupFrames)) continue;
+            scorer.Score(frame.contacts);
+        }
+    }
+    return metrics;
+}
+
+std::vector<SweepResult> ParamSweep::Evaluate(std::span<const SweepPoint> points, WorkStealingPool& pool) const {
+    // 每个 (组合, 输入) 一个任务，结果写入各自的槽位，无需加锁
+    std::vector<SweepMetrics> partial(points.size() * m_inputs.size());
+    for (size_t p = 0; p < points.size(); ++p) {
+        for (size_t i = 0; i < m_inputs.size(); ++i) {
+            pool.Submit([this, &points, &partial, p, i] {
+                partial[p * m_inputs.size() + i] = EvaluateOne(points[p], m_inputs[i]);
+            });
+        }
+    }
+    pool.Wait();
+
+    std::vector<SweepResult> results(points.size());
+    for (size_t p = 0; p < points.size(); ++p) {
+        results[p].point = points[p];
+        for (size_t i = 0; i < m_inputs.size(); ++i) results[p].metrics.Accumulate(partial[p * m_inputs.size() + i]);
+        results[p].cost = SweepCost(results[p].metrics, weights);
+        results[p].failed = results[p].metrics.failed;
+    }
+    std::stable_sort(results.begin(), results.end(), [](const SweepResult& a, const SweepResult& b) {
+        return a.failed != b.failed ? b.failed : a.cost < b.cost;
+    });
+    return results;
+}
+
+} // namespace Engine
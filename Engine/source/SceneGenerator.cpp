@@ -0,0 +1,251 @@
+#include "SceneGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+namespace Engine {
+
+namespace {
+
+struct Point {
+    float x, y;
+};
+
+// 轨迹在 t 时刻的位置 (线性 / 往返 + 圆周)
+Point TrackPosition(const SceneTrack& track, double t) {
+    double u = 0.0;
+    if (track.moveDuration > 0.0f) {
+        u = (t - track.startTime) / track.moveDuration;
+        if (track.pingPong) {
+            u = std::fmod(std::max(u, 0.0), 2.0);
+            if (u > 1.0) u = 2.0 - u;
+        } else {
+            u = std::clamp(u, 0.0, 1.0);
+        }
+    }
+    Point p{static_cast<float>(track.startX + (track.endX - track.startX) * u),
+            static_cast<float>(track.startY + (track.endY - track.startY) * u)};
+    if (track.circleRadius > 0.0f) {
+        const double phase = 2.0 * std::numbers::pi * track.circleHz * (t - track.startTime);
+        p.x += track.circleRadius * static_cast<float>(std::cos(phase));
+        p.y += track.circleRadius * static_cast<float>(std::sin(phase));
+    }
+    return p;
+}
+
+// 旋转椭圆高斯叠加到信号场，只遍历 4 sigma 包围盒
+void SplatGaussian(float (&signal)[SceneGenerator::kRows][SceneGenerator::kCols], const SceneTrack& track, Point c) {
+    const float sx = std::max(track.sigmaX, 0.1f);
+    const float sy = std::max(track.sigmaY, 0.1f);
+    const float reach = 4.0f * std::max(sx, sy);
+    const int x0 = std::max(0, static_cast<int>(std::floor(c.x - reach)));
+    const int x1 = std::min(SceneGenerator::kCols - 1, static_cast<int>(std::ceil(c.x + reach)));
+    const int y0 = std::max(0, static_cast<int>(std::floor(c.y - reach)));
+    const int y1 = std::min(SceneGenerator::kRows - 1, static_cast<int>(std::ceil(c.y + reach)));
+
+    const float cs = std::cos(track.angle), sn = std::sin(track.angle);
+    const float ix = 1.0f / (2.0f * sx * sx), iy = 1.0f / (2.0f * sy * sy);
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            const float dx = x - c.x, dy = y - c.y;
+            const float u = dx * cs + dy * sn;
+            const float v = -dx * sn + dy * cs;
+            signal[y][x] += track.amplitude * std::exp(-(u * u * ix + v * v * iy));
+        }
+    }
+}
+
+} // namespace
+
+SceneGenerator::SceneGenerator(SceneConfig config)
+    : m_config(std::move(config)) {
+    if (m_config.frameRateHz <= 0.0) m_config.frameRateHz = 240.0;
+    m_truth.reserve(m_config.tracks.size());
+    Reset();
+}
+
+void SceneGenerator::Reset() {
+    m_frameIndex = 0;
+    m_rngState = m_config.seed;
+}
+
+// SplitMix64：状态简单、可跨平台复现 (std::normal_distribution 的实现因库而异)
+uint32_t SceneGenerator::NextRandom() {
+    uint64_t z = (m_rngState += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return static_cast<uint32_t>((z ^ (z >> 31)) >> 32);
+}
+
+// 4 个均匀分布之和 (Irwin-Hall) 近似标准正态，尾部截断在 ±3.46 sigma
+float SceneGenerator::NextGaussian() {
+    constexpr float kScale = 1.0f / 4294967296.0f;
+    float sum = 0.0f;
+    for (int i = 0; i < 4; ++i) sum += static_cast<float>(NextRandom()) * kScale;
+    return (sum - 2.0f) * 1.7320508f;
+}
+
+const std::vector<SceneContact>& SceneGenerator::Next(HeatmapFrame& frame) {
+    const double t = CurrentTime();
+    const SceneNoise& noise = m_config.noise;
+
+    m_truth.clear();
+    for (auto& row : m_signal) std::fill(std::begin(row), std::end(row), 0.0f);
+    for (const SceneTrack& track : m_config.tracks) {
+        if (t < track.startTime || t >= track.endTime) continue;
+        const Point c = TrackPosition(track, t);
+        SplatGaussian(m_signal, track, c);
+        m_truth.push_back({track.id, track.kind, c.x, c.y, track.amplitude, std::max(track.sigmaX, track.sigmaY)});
+    }
+
+    float drift = 0.0f;
+    if (noise.baselineDrift != 0.0f && noise.baselineDriftPeriod > 0.0f) {
+        drift = noise.baselineDrift * static_cast<float>(std::sin(2.0 * std::numbers::pi * t / noise.baselineDriftPeriod));
+    }
+
+    frame.rawData.assign(kRawFrameBytes, 0);
+    uint8_t* dst = frame.rawData.data() + kHeatmapOffset;
+    for (int y = 0; y < kRows; ++y) {
+        const float rowOffset = static_cast<float>(noise.baseline) + drift + noise.rowCommonMode * NextGaussian();
+        for (int x = 0; x < kCols; ++x) {
+            const float v = rowOffset + m_signal[y][x] + noise.whiteNoise * NextGaussian();
+            const uint16_t raw = static_cast<uint16_t>(std::clamp(std::lround(v), 0l, 0xFFFFl));
+            *dst++ = static_cast<uint8_t>(raw & 0xFF);
+            *dst++ = static_cast<uint8_t>(raw >> 8);
+        }
+    }
+
+    frame.contacts.clear();
+    frame.timestamp = static_cast<uint64_t>(std::llround(t * 1e9));
+    ++m_frameIndex;
+    return m_truth;
+}
+
+// ---------------------------------------------------------
+// 预置场景
+
+SceneConfig SceneGenerator::Idle() {
+    SceneConfig c;
+    c.name = "idle";
+    c.seed = 1;
+    return c;
+}
+
+SceneConfig SceneGenerator::OneFinger() {
+    SceneConfig c;
+    c.name = "finger1";
+    c.seed = 2;
+    c.tracks.push_back({.id = 1, .amplitude = 900.f, .startX = 30.f, .startY = 20.f, .endX = 30.f, .endY = 20.f,
+                        .circleRadius = 0.3f, .circleHz = 2.f});
+    return c;
+}
+
+SceneConfig SceneGenerator::FiveFingers() {
+    SceneConfig c;
+    c.name = "finger5";
+    c.seed = 3;
+    const struct { float x, y, peak, sigma; } fingers[] = {
+        {10.f, 12.f, 850.f, 1.5f}, {22.f, 8.f, 1000.f, 1.6f}, {34.f, 7.f, 950.f, 1.5f},
+        {46.f, 10.f, 900.f, 1.4f}, {15.f, 30.f, 1100.f, 1.7f},
+    };
+    int id = 1;
+    for (const auto& f : fingers) {
+        c.tracks.push_back({.id = id++, .amplitude = f.peak, .sigmaX = f.sigma, .sigmaY = f.sigma,
+                            .startX = f.x, .startY = f.y, .endX = f.x + 2.f, .endY = f.y + 1.f,
+                            .moveDuration = 1.f, .pingPong = true});
+    }
+    return c;
+}
+
+SceneConfig SceneGenerator::Palm() {
+    SceneConfig c;
+    c.name = "palm";
+    c.seed = 4;
+    c.tracks.push_back({.id = 1, .kind = ContactKind::Palm, .amplitude = 1500.f, .sigmaX = 6.0f, .sigmaY = 4.5f,
+                        .angle = 0.3f, .startX = 28.f, .startY = 24.f, .endX = 28.f, .endY = 24.f});
+    return c;
+}
+
+SceneConfig SceneGenerator::MergedFingers() {
+    SceneConfig c;
+    c.name = "merged";
+    c.seed = 5;
+    c.tracks.push_back({.id = 1, .amplitude = 1000.f, .sigmaX = 1.6f, .sigmaY = 1.6f,
+                        .startX = 26.f, .startY = 20.f, .endX = 29.f, .endY = 20.f,
+                        .moveDuration = 2.f, .pingPong = true});
+    c.tracks.push_back({.id = 2, .amplitude = 950.f, .sigmaX = 1.6f, .sigmaY = 1.6f,
+                        .startX = 34.f, .startY = 20.5f, .endX = 31.f, .endY = 20.5f,
+                        .moveDuration = 2.f, .pingPong = true});
+    return c;
+}
+
+SceneConfig SceneGenerator::Swipe() {
+    SceneConfig c;
+    c.name = "swipe";
+    c.seed = 6;
+    c.tracks.push_back({.id = 1, .amplitude = 950.f, .startX = 6.f, .startY = 20.f, .endX = 54.f, .endY = 20.f,
+                        .moveDuration = 0.5f, .pingPong = true, .circleRadius = 1.5f, .circleHz = 3.f});
+    return c;
+}
+
+std::vector<SceneConfig> SceneGenerator::Presets() {
+    return {Idle(), OneFinger(), FiveFingers(), Palm(), MergedFingers(), Swipe()};
+}
+
+// ---------------------------------------------------------
+// 精度评估
+
+void ContactScore::Accumulate(const ContactScore& other) {
+    truthCount += other.truthCount;
+    detectedCount += other.detectedCount;
+    matched += other.matched;
+    missed += other.missed;
+    ghosts += other.ghosts;
+    sumError += other.sumError;
+    maxError = std::max(maxError, other.maxError);
+}
+
+ContactScore ScoreContacts(std::span<const SceneContact> truth, std::span<const TouchContact> detected,
+                           float maxDistance) {
+    ContactScore score;
+    score.detectedCount = static_cast<int>(detected.size());
+
+    struct Pair {
+        float dist;
+        size_t truth, detected;
+    };
+    std::vector<Pair> pairs;
+    for (size_t i = 0; i < truth.size(); ++i) {
+        if (truth[i].kind != ContactKind::Finger) continue;
+        ++score.truthCount;
+        for (size_t j = 0; j < detected.size(); ++j) {
+            const float dist = std::hypot(truth[i].x - detected[j].x, truth[i].y - detected[j].y);
+            if (dist <= maxDistance) pairs.push_back({dist, i, j});
+        }
+    }
+
+    // 贪心：距离从小到大逐对匹配，每个真值 / 检测点最多用一次
+    std::sort(pairs.begin(), pairs.end(), [](const Pair& a, const Pair& b) { return a.dist < b.dist; });
+    std::vector<bool> truthUsed(truth.size(), false), detectedUsed(detected.size(), false);
+    for (const Pair& p : pairs) {
+        if (truthUsed[p.truth] || detectedUsed[p.detected]) continue;
+        truthUsed[p.truth] = detectedUsed[p.detected] = true;
+        ++score.matched;
+        score.sumError += p.dist;
+        score.maxError = std::max(score.maxError, static_cast<double>(p.dist));
+    }
+
+    score.missed = score.truthCount - score.matched;
+    for (size_t j = 0; j < detected.size(); ++j) {
+        if (detectedUsed[j]) continue;
+        const bool onPalm = std::any_of(truth.begin(), truth.end(), [&](const SceneContact& t) {
+            return t.kind == ContactKind::Palm &&
+                   std::hypot(t.x - detected[j].x, t.y - detected[j].y) <= 2.0f * t.sigma;
+        });
+        if (!onPalm) ++score.ghosts;
+    }
+    return score;
+}
+
+} // namespace Engine
@@ -1,12 +1,8 @@
 #include "SignalConditioningFilter.h"
-#include "imgui.h"
+#include "SimdKernels.h"
 #include <algorithm>
 #include <cstring>
 
-#if defined(_M_ARM64)
-#include <arm_neon.h>
-#endif
-
 namespace Engine {
 
 SignalConditioningFilter::SignalConditioningFilter() : m_hasHistory(false) {
@@ -23,10 +19,10 @@ bool SignalConditioningFilter::Process(HeatmapFrame& frame) {
 
     const int numPixels = 40 * 60;
     int16_t* frameData16 = &frame.heatmapMatrix[0][0];
+    const Simd::KernelTable& kernels = Simd::Kernels();
 
     // 1. IIR 时域滤波 (Exponential Moving Average)
     const int32_t alpha = m_alpha;       // Current frame weight (0-1000)
-    const int32_t beta = 1000 - alpha;
 
     if (!m_hasHistory) {
         std::memcpy(m_historyData, frameData16, numPixels * sizeof(int16_t));
@@ -35,16 +31,8 @@ bool SignalConditioningFilter::Process(HeatmapFrame& frame) {
 
     // If alpha is 1000, IIR is effectively disabled.
     if (alpha < 1000) {
-        for (int i = 0; i < numPixels; ++i) {
-            // Apply IIR only to positive signals to keep noise floor stable
-            if (frameData16[i] > 0) {
-                int32_t val = frameData16[i];
-                int32_t hist = m_historyData[i];
-                val = (val * alpha + hist * beta) / 1000;
-                frameData16[i] = static_cast<int16_t>(val);
-            }
-            m_historyData[i] = frameData16[i];
-        }
+        // Apply IIR only to positive signals to keep noise floor stable
+        kernels.IirBlendPositive(frameData16, m_historyData, numPixels, alpha);
     } else {
         std::memcpy(m_historyData, frameData16, numPixels * sizeof(int16_t));
     }
@@ -52,41 +40,38 @@ bool SignalConditioningFilter::Process(HeatmapFrame& frame) {
     // 2. 线性底噪切除水平面 (Water-level Clipping)
     // 算法：对于 > noiseFloor 的信号，减去 noiseFloor。对于 =< noiseFloor 的信号，归零。
     // 特性：保证抛物面的连续性，不会出现阶梯掉崖式反相撕裂！
+    // 核心公式: result = max(0, Data - Floor)
+    kernels.SubClampZero(frameData16, numPixels, static_cast<int16_t>(m_noiseFloor));
 
-#if defined(_M_ARM64)
-    int i = 0;
-    int16x8_t vZero = vdupq_n_s16(0);
-    int16x8_t vFloor = vdupq_n_s16((int16_t)m_noiseFloor);
-    
-    for (; i <= numPixels - 8; i += 8) {
-        int16x8_t vData = vld1q_s16(&frameData16[i]);
-        
-        // 核心公式: result = max(0, Data - Floor)
-        int16x8_t vSubbed = vsubq_s16(vData, vFloor);
-        int16x8_t result = vmaxq_s16(vZero, vSubbed);
-        
-        vst1q_s16(&frameData16[i], result);
-    }
-    
-    // 剩余尾部处理
-    for (; i < numPixels; ++i) {
-        int16_t v = frameData16[i];
-        frameData16[i] = std::max<int16_t>(0, v - m_noiseFloor);
-    }
-#else
-    for (int i = 0; i < numPixels; ++i) {
-        int16_t v = frameData16[i];
-        frameData16[i] = std::max<int16_t>(0, v - m_noiseFloor);
-    }
-#endif
+    return true;
+}
 
+bool SignalConditioningFilter::GetFrontEndStage(FrontEndStage& stage) const {
+    stage = FrontEndStage::Conditioning;
     return true;
 }
 
-void SignalConditioningFilter::DrawConfigUI() {
-    ImGui::TextWrapped("IIR Smooths temporal noise. Cut-off Floor prevents blocky tearing by slicing the baseline continuously.");
-    ImGui::SliderInt("IIR Alpha", &m_alpha, 100, 1000, "%d (1000 = Direct No History)");
-    ImGui::SliderInt("Noise Cut-off Floor", &m_noiseFloor, 0, 500);
+void SignalConditioningFilter::ContributeFrontEnd(FrontEndParams& params) {
+    if (!m_enabled) {
+        m_hasHistory = false;
+        return;
+    }
+    params.conditioning = true;
+    params.alpha = m_alpha;
+    params.noiseFloor = static_cast<int16_t>(m_noiseFloor);
+    params.history = m_historyData;
+    // 首帧以 IIR 输入作为历史：混合结果恰为输入本身，等价于 Process 中的 memcpy
+    params.seedHistory = !m_hasHistory;
+    m_hasHistory = true;
+}
+
+const char* SignalConditioningFilter::GetDescription() const {
+    return "IIR Smooths temporal noise. Cut-off Floor prevents blocky tearing by slicing the baseline continuously.";
+}
+
+void SignalConditioningFilter::DescribeParams(std::vector<ParamDesc>& params) {
+    params.push_back(ParamDesc::Int("IIR Alpha", &m_alpha, 100, 1000, "%d (1000 = Direct No History)"));
+    params.push_back(ParamDesc::Int("Noise Cut-off Floor", &m_noiseFloor, 0, 500));
 }
 
 } // namespace Engine
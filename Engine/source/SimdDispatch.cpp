@@ -0,0 +1,167 @@
+#include "SimdKernels.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ENGINE_SIMD_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if (defined(__aarch64__) || defined(_M_ARM64)) && defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+namespace Engine::Simd {
+
+namespace {
+
+#if defined(ENGINE_SIMD_X86)
+void CpuId(int leaf, int subleaf, unsigned regs[4]) {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, leaf, subleaf);
+    for (int i = 0; i < 4; ++i) regs[i] = static_cast<unsigned>(info[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+unsigned long long ReadXcr0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned eax = 0, edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+}
+
+bool CpuHasSse41() {
+    unsigned regs[4]{};
+    CpuId(1, 0, regs);
+    return (regs[2] & (1u << 19)) != 0;
+}
+
+bool CpuHasAvx2() {
+    unsigned regs[4]{};
+    CpuId(0, 0, regs);
+    if (regs[0] < 7) return false;
+
+    CpuId(1, 0, regs);
+    const bool osxsave = (regs[2] & (1u << 27)) != 0;
+    const bool avx = (regs[2] & (1u << 28)) != 0;
+    if (!osxsave || !avx) return false;
+
+    // 操作系统必须同时保存 XMM/YMM 状态，否则 AVX 指令会触发 #UD
+    if ((ReadXcr0() & 0x6) != 0x6) return false;
+
+    CpuId(7, 0, regs);
+    return (regs[1] & (1u << 5)) != 0;
+}
+#endif
+
+bool CpuHasNeon() {
+#if (defined(__aarch64__) || defined(_M_ARM64)) && defined(__linux__)
+    return (getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0;
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    return true;
+#else
+    return false;
+#endif
+}
+
+const KernelTable* TableFor(Backend backend) {
+    switch (backend) {
+    case Backend::Scalar:
+        return detail::ScalarKernels();
+    case Backend::Neon:
+        return CpuHasNeon() ? detail::NeonKernels() : nullptr;
+#if defined(ENGINE_SIMD_X86)
+    case Backend::Sse41:
+        return CpuHasSse41() ? detail::Sse41Kernels() : nullptr;
+    case Backend::Avx2:
+        return CpuHasAvx2() ? detail::Avx2Kernels() : nullptr;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+// 环境变量 EGOTOUCH_SIMD=scalar|neon|sse41|avx2 用于 CI 上分别基准测试各后端
+bool ParseBackendOverride(Backend& out) {
+    const char* env = std::getenv("EGOTOUCH_SIMD");
+    if (!env || !*env) return false;
+    const struct { const char* key; Backend value; } kNames[] = {
+        {"scalar", Backend::Scalar}, {"neon", Backend::Neon},
+        {"sse41", Backend::Sse41}, {"avx2", Backend::Avx2},
+    };
+    for (const auto& entry : kNames) {
+        if (std::strcmp(env, entry.key) == 0) {
+            out = entry.value;
+            return true;
+        }
+    }
+    return false;
+}
+
+const KernelTable* InitialTable() {
+    Backend requested;
+    if (ParseBackendOverride(requested)) {
+        if (const KernelTable* table = TableFor(requested)) return table;
+    }
+    return TableFor(DetectBestBackend());
+}
+
+std::atomic<const KernelTable*> g_active{nullptr};
+
+} // namespace
+
+Backend DetectBestBackend() {
+    const Backend preference[] = {Backend::Neon, Backend::Avx2, Backend::Sse41};
+    for (Backend backend : preference) {
+        if (TableFor(backend)) return backend;
+    }
+    return Backend::Scalar;
+}
+
+bool IsBackendSupported(Backend backend) {
+    return TableFor(backend) != nullptr;
+}
+
+const KernelTable& Kernels() {
+    const KernelTable* table = g_active.load(std::memory_order_acquire);
+    if (!table) {
+        // 多线程同时首次调用时结果一致，重复探测无副作用
+        const KernelTable* expected = nullptr;
+        table = InitialTable();
+        if (!g_active.compare_exchange_strong(expected, table, std::memory_order_acq_rel)) {
+            table = expected;
+        }
+    }
+    return *table;
+}
+
+bool SelectBackend(Backend backend) {
+    const KernelTable* table = TableFor(backend);
+    if (!table) return false;
+    g_active.store(table, std::memory_order_release);
+    return true;
+}
+
+const char* BackendName(Backend backend) {
+    switch (backend) {
+    case Backend::Scalar: return "scalar";
+    case Backend::Neon: return "neon";
+    case Backend::Sse41: return "sse4.1";
+    case Backend::Avx2: return "avx2";
+    default: return "unknown";
+    }
+}
+
+} // namespace Engine::Simd
@@ -0,0 +1,295 @@
+#include "SimdKernels.h"
+
+#if HIMAX_ENABLE_X86_SIMD && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86))
+#define ENGINE_SIMD_AVX2 1
+#include <immintrin.h>
+#include <algorithm>
+#include <bit>
+#endif
+
+// AVX2 后端 (x86 回放 / 分析机的首选路径)
+// 本文件在 GCC/Clang 下以 -mavx2、MSVC 下以 /arch:AVX2 单独编译，运行时需 CPUID + XCR0 双重确认。
+
+namespace Engine::Simd {
+
+#if defined(ENGINE_SIMD_AVX2)
+
+namespace {
+
+inline __m256i Load16(const int16_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+inline void Store16(int16_t* p, __m256i v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+inline __m256i Load8Widen(const int16_t* p) {
+    return _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+inline void Store8Narrow(int16_t* p, __m256i v) {
+    __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), packed);
+}
+
+// 有符号 int32 除以 1000 (向零截断)，见 SSE4.1 版本说明
+inline __m256i DivBy1000(__m256i n) {
+    const __m256i magic = _mm256_set1_epi32(274877907);
+    __m256i prodEven = _mm256_mul_epi32(n, magic);
+    __m256i prodOdd = _mm256_mul_epi32(_mm256_srli_epi64(n, 32), magic);
+    __m256i hi = _mm256_blend_epi32(_mm256_srli_epi64(prodEven, 32), prodOdd, 0xAA);
+    __m256i q = _mm256_srai_epi32(hi, 6);
+    return _mm256_sub_epi32(q, _mm256_srai_epi32(n, 31));
+}
+
+void LoadLe16(const uint8_t* src, int16_t* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        Store16(dst + i, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 2)));
+    }
+    for (; i < count; ++i) {
+        dst[i] = static_cast<int16_t>(src[i * 2] | (src[i * 2 + 1] << 8));
+    }
+}
+
+// 无符号比较与计数方式见 SSE4.1 版本
+size_t LoadLe16CountRail(const uint8_t* src, int16_t* dst, size_t count, uint16_t margin) {
+    const __m256i vShift = _mm256_set1_epi16(static_cast<int16_t>(uint32_t{margin} + 1));
+    const __m256i vLimit = _mm256_set1_epi16(static_cast<int16_t>(uint32_t{margin} * 2 + 1));
+    const __m256i vNegOne = _mm256_set1_epi16(-1);
+    __m256i vCount = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 2));
+        Store16(dst + i, raw);
+        const __m256i shifted = _mm256_add_epi16(raw, vShift);
+        const __m256i hit = _mm256_cmpeq_epi16(_mm256_min_epu16(shifted, vLimit), shifted);
+        vCount = _mm256_add_epi32(vCount, _mm256_madd_epi16(hit, vNegOne));
+    }
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(vCount), _mm256_extracti128_si256(vCount, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return static_cast<uint32_t>(_mm_cvtsi128_si32(sum)) +
+           detail::ScalarKernels()->LoadLe16CountRail(src + i * 2, dst + i, count - i, margin);
+}
+
+void SubConst(int16_t* data, size_t count, int16_t value) {
+    const __m256i vValue = _mm256_set1_epi16(value);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        Store16(data + i, _mm256_sub_epi16(Load16(data + i), vValue));
+    }
+    for (; i < count; ++i) {
+        data[i] = static_cast<int16_t>(data[i] - value);
+    }
+}
+
+int16_t ReduceMax(const int16_t* data, size_t count, int16_t init) {
+    __m256i vMax = _mm256_set1_epi16(init);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        vMax = _mm256_max_epi16(vMax, Load16(data + i));
+    }
+    __m128i m = _mm_max_epi16(_mm256_castsi256_si128(vMax), _mm256_extracti128_si256(vMax, 1));
+    m = _mm_max_epi16(m, _mm_srli_si128(m, 8));
+    m = _mm_max_epi16(m, _mm_srli_si128(m, 4));
+    m = _mm_max_epi16(m, _mm_srli_si128(m, 2));
+    int16_t result = static_cast<int16_t>(_mm_extract_epi16(m, 0));
+    for (; i < count; ++i) {
+        result = std::max(result, data[i]);
+    }
+    return result;
+}
+
+void SubClampZero(int16_t* data, size_t count, int16_t value) {
+    const __m256i vValue = _mm256_set1_epi16(value);
+    const __m256i vZero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        Store16(data + i, _mm256_max_epi16(vZero, _mm256_sub_epi16(Load16(data + i), vValue)));
+    }
+    for (; i < count; ++i) {
+        data[i] = std::max<int16_t>(0, static_cast<int16_t>(data[i] - value));
+    }
+}
+
+void IirBlendPositive(int16_t* data, int16_t* history, size_t count, int32_t alpha) {
+    if (alpha < 0 || alpha > 1000) {
+        detail::ScalarKernels()->IirBlendPositive(data, history, count, alpha);
+        return;
+    }
+    const __m256i vAlpha = _mm256_set1_epi32(alpha);
+    const __m256i vBeta = _mm256_set1_epi32(1000 - alpha);
+    const __m256i vZero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i cur = Load16(data + i);
+        __m256i lo = _mm256_add_epi32(_mm256_mullo_epi32(Load8Widen(data + i), vAlpha),
+                                      _mm256_mullo_epi32(Load8Widen(history + i), vBeta));
+        __m256i hi = _mm256_add_epi32(_mm256_mullo_epi32(Load8Widen(data + i + 8), vAlpha),
+                                      _mm256_mullo_epi32(Load8Widen(history + i + 8), vBeta));
+        // packs 按 128-bit lane 交错，permute 恢复原始顺序
+        __m256i blended = _mm256_permute4x64_epi64(_mm256_packs_epi32(DivBy1000(lo), DivBy1000(hi)), 0xD8);
+        __m256i result = _mm256_blendv_epi8(cur, blended, _mm256_cmpgt_epi16(cur, vZero));
+        Store16(data + i, result);
+        Store16(history + i, result);
+    }
+    if (i < count) {
+        detail::ScalarKernels()->IirBlendPositive(data + i, history + i, count - i, alpha);
+    }
+}
+
+int16_t SubReduceMax(const int16_t* data, size_t count, int16_t value, int16_t init) {
+    const __m256i vValue = _mm256_set1_epi16(value);
+    __m256i vMax = _mm256_set1_epi16(init);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        vMax = _mm256_max_epi16(vMax, _mm256_sub_epi16(Load16(data + i), vValue));
+    }
+    __m128i m = _mm_max_epi16(_mm256_castsi256_si128(vMax), _mm256_extracti128_si256(vMax, 1));
+    m = _mm_max_epi16(m, _mm_srli_si128(m, 8));
+    m = _mm_max_epi16(m, _mm_srli_si128(m, 4));
+    m = _mm_max_epi16(m, _mm_srli_si128(m, 2));
+    int16_t result = static_cast<int16_t>(_mm_extract_epi16(m, 0));
+    for (; i < count; ++i) {
+        result = std::max(result, static_cast<int16_t>(data[i] - value));
+    }
+    return result;
+}
+
+void FrontEndApply(int16_t* data, size_t count, const FrontEndArgs& args) {
+    if (args.conditioning && (args.alpha < 0 || args.alpha > 1000)) {
+        detail::ScalarKernels()->FrontEndApply(data, count, args);
+        return;
+    }
+    const __m256i vBaseline = _mm256_set1_epi16(args.baseline);
+    const __m256i vShrink = _mm256_set1_epi16(args.shrinkValue);
+    const __m256i vFloor = _mm256_set1_epi16(args.noiseFloor);
+    const __m256i vAlpha = _mm256_set1_epi32(args.alpha);
+    const __m256i vBeta = _mm256_set1_epi32(1000 - args.alpha);
+    const __m256i vZero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i cur = _mm256_sub_epi16(Load16(data + i), vBaseline);
+        if (args.deadzone) {
+            cur = _mm256_max_epi16(vZero, _mm256_sub_epi16(cur, vShrink));
+        }
+        if (args.conditioning) {
+            __m256i hist = args.seedHistory ? cur : Load16(args.history + i);
+            __m256i lo = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(cur)), vAlpha),
+                                          _mm256_mullo_epi32(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(hist)), vBeta));
+            __m256i hi = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(cur, 1)), vAlpha),
+                                          _mm256_mullo_epi32(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(hist, 1)), vBeta));
+            __m256i blended = _mm256_permute4x64_epi64(_mm256_packs_epi32(DivBy1000(lo), DivBy1000(hi)), 0xD8);
+            cur = _mm256_blendv_epi8(cur, blended, _mm256_cmpgt_epi16(cur, vZero));
+            Store16(args.history + i, cur);
+            cur = _mm256_max_epi16(vZero, _mm256_sub_epi16(cur, vFloor));
+        }
+        Store16(data + i, cur);
+    }
+    if (i < count) {
+        FrontEndArgs tail = args;
+        if (tail.history) tail.history += i;
+        detail::ScalarKernels()->FrontEndApply(data + i, count - i, tail);
+    }
+}
+
+void Gaussian3x3(const int16_t* src, int16_t* dst, int rows, int cols, int32_t centerWeight) {
+    const int32_t kernelSum = 12 + centerWeight;
+    if (cols - 2 < 8 || centerWeight < 0 || kernelSum >= 512) {
+        detail::ScalarKernels()->Gaussian3x3(src, dst, rows, cols, centerWeight);
+        return;
+    }
+    const __m256i vCenter = _mm256_set1_epi32(centerWeight);
+    const __m256 vKernelSum = _mm256_set1_ps(static_cast<float>(kernelSum));
+
+    for (int y = 1; y < rows - 1; ++y) {
+        const int16_t* top = src + (y - 1) * cols;
+        const int16_t* mid = src + y * cols;
+        const int16_t* bot = src + (y + 1) * cols;
+        int16_t* out = dst + y * cols;
+        for (int x = 1; x < cols - 1; x += 8) {
+            const int bx = std::min(x, cols - 1 - 8);
+            __m256i corners = _mm256_add_epi32(_mm256_add_epi32(Load8Widen(top + bx - 1), Load8Widen(top + bx + 1)),
+                                               _mm256_add_epi32(Load8Widen(bot + bx - 1), Load8Widen(bot + bx + 1)));
+            __m256i edges = _mm256_add_epi32(_mm256_add_epi32(Load8Widen(top + bx), Load8Widen(bot + bx)),
+                                             _mm256_add_epi32(Load8Widen(mid + bx - 1), Load8Widen(mid + bx + 1)));
+            __m256i sum = _mm256_add_epi32(corners, _mm256_slli_epi32(edges, 1));
+            sum = _mm256_add_epi32(sum, _mm256_mullo_epi32(Load8Widen(mid + bx), vCenter));
+            Store8Narrow(out + bx, _mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(sum), vKernelSum)));
+        }
+    }
+}
+
+void Sharpen3x3(const int16_t* src, int16_t* dst, int rows, int cols, float strength) {
+    if (cols - 2 < 8) {
+        detail::ScalarKernels()->Sharpen3x3(src, dst, rows, cols, strength);
+        return;
+    }
+    const __m256 vStrength = _mm256_set1_ps(strength);
+    const __m256i vZero = _mm256_setzero_si256();
+    const __m256i vMax = _mm256_set1_epi32(4095);
+
+    for (int y = 1; y < rows - 1; ++y) {
+        const int16_t* top = src + (y - 1) * cols;
+        const int16_t* mid = src + y * cols;
+        const int16_t* bot = src + (y + 1) * cols;
+        int16_t* out = dst + y * cols;
+        for (int x = 1; x < cols - 1; x += 8) {
+            const int bx = std::min(x, cols - 1 - 8);
+            __m256i c = Load8Widen(mid + bx);
+            __m256i neighbours = _mm256_add_epi32(_mm256_add_epi32(Load8Widen(top + bx), Load8Widen(bot + bx)),
+                                                  _mm256_add_epi32(Load8Widen(mid + bx - 1), Load8Widen(mid + bx + 1)));
+            __m256i laplace = _mm256_sub_epi32(_mm256_slli_epi32(c, 2), neighbours);
+            __m256i delta = _mm256_cvttps_epi32(_mm256_mul_ps(vStrength, _mm256_cvtepi32_ps(laplace)));
+            __m256i sharpened = _mm256_min_epi32(_mm256_max_epi32(_mm256_add_epi32(c, delta), vZero), vMax);
+            Store8Narrow(out + bx, sharpened);
+        }
+    }
+}
+
+void DeltaZigZag(const int16_t* cur, const int16_t* prev, uint16_t* out, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i d = _mm256_sub_epi16(Load16(cur + i), Load16(prev + i));
+        __m256i z = _mm256_xor_si256(_mm256_slli_epi16(d, 1), _mm256_srai_epi16(d, 15));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), z);
+    }
+    detail::ScalarKernels()->DeltaZigZag(cur + i, prev + i, out + i, count - i);
+}
+
+void UnZigZagAdd(const uint16_t* z, const int16_t* prev, int16_t* out, size_t count) {
+    const __m256i vOne = _mm256_set1_epi16(1);
+    const __m256i vZero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(z + i));
+        __m256i d = _mm256_xor_si256(_mm256_srli_epi16(v, 1), _mm256_sub_epi16(vZero, _mm256_and_si256(v, vOne)));
+        Store16(out + i, _mm256_add_epi16(Load16(prev + i), d));
+    }
+    detail::ScalarKernels()->UnZigZagAdd(z + i, prev + i, out + i, count - i);
+}
+
+size_t FindNonZero(const uint16_t* data, size_t begin, size_t count) {
+    const __m256i vZero = _mm256_setzero_si256();
+    size_t i = begin;
+    for (; i + 16 <= count; i += 16) {
+        __m256i eq = _mm256_cmpeq_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), vZero);
+        const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(eq));
+        if (mask != 0xFFFFFFFFu) return i + std::countr_zero(~mask) / 2;
+    }
+    return detail::ScalarKernels()->FindNonZero(data, i, count);
+}
+
+constexpr KernelTable kAvx2Table{
+    Backend::Avx2, "avx2",
+    LoadLe16, LoadLe16CountRail, SubConst, ReduceMax, SubClampZero, IirBlendPositive,
+    SubReduceMax, FrontEndApply, Gaussian3x3, Sharpen3x3,
+    DeltaZigZag, UnZigZagAdd, FindNonZero,
+};
+
+} // namespace
+
+const KernelTable* detail::Avx2Kernels() { return &kAvx2Table; }
+
+#else
+
+const KernelTable* detail::Avx2Kernels() { return nullptr; }
+
+#endif
+
+} // namespace Engine::Simd
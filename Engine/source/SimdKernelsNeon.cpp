@@ -0,0 +1,289 @@
+#include "SimdKernels.h"
+
+#if HIMAX_ENABLE_NEON && (defined(__aarch64__) || defined(_M_ARM64))
+#define ENGINE_SIMD_NEON 1
+#include <arm_neon.h>
+#include <algorithm>
+#endif
+
+// NEON 后端 (ARM64 平板的主力路径)
+// AArch64 ABI 保证 ASIMD 必然存在，HWCAP 探测仅用于防御性确认。
+
+namespace Engine::Simd {
+
+#if defined(ENGINE_SIMD_NEON)
+
+namespace {
+
+// 有符号 int32 除以 1000 (向零截断)：高 32 位乘积再算术右移 6 位，负数 +1
+inline int32x4_t DivBy1000(int32x4_t n) {
+    const int32x2_t magic = vdup_n_s32(274877907);
+    int32x2_t qLo = vshrn_n_s64(vmull_s32(vget_low_s32(n), magic), 32);
+    int32x2_t qHi = vshrn_n_s64(vmull_s32(vget_high_s32(n), magic), 32);
+    int32x4_t q = vshrq_n_s32(vcombine_s32(qLo, qHi), 6);
+    return vsubq_s32(q, vshrq_n_s32(n, 31));
+}
+
+void LoadLe16(const uint8_t* src, int16_t* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        // 从无对齐的 uint8_t 内存流加载 8 个 uint16_t 数据 -> 128 bit 寄存器
+        uint8x16_t raw = vld1q_u8(src + i * 2);
+        vst1q_s16(dst + i, vreinterpretq_s16_u8(raw));
+    }
+    for (; i < count; ++i) {
+        dst[i] = static_cast<int16_t>(src[i * 2] | (src[i * 2 + 1] << 8));
+    }
+}
+
+// 平移与上限见 Scalar 版本
+size_t LoadLe16CountRail(const uint8_t* src, int16_t* dst, size_t count, uint16_t margin) {
+    const uint16x8_t vShift = vdupq_n_u16(static_cast<uint16_t>(uint32_t{margin} + 1));
+    const uint16x8_t vLimit = vdupq_n_u16(static_cast<uint16_t>(uint32_t{margin} * 2 + 1));
+    uint32x4_t vCount = vdupq_n_u32(0);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        uint16x8_t raw = vreinterpretq_u16_u8(vld1q_u8(src + i * 2));
+        vst1q_s16(dst + i, vreinterpretq_s16_u16(raw));
+        // 命中通道为 0xFFFF，右移 15 位得 1，两两累加到 uint32
+        uint16x8_t hit = vcleq_u16(vaddq_u16(raw, vShift), vLimit);
+        vCount = vpadalq_u16(vCount, vshrq_n_u16(hit, 15));
+    }
+    return vaddvq_u32(vCount) + detail::ScalarKernels()->LoadLe16CountRail(src + i * 2, dst + i, count - i, margin);
+}
+
+void SubConst(int16_t* data, size_t count, int16_t value) {
+    const int16x8_t vValue = vdupq_n_s16(value);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        vst1q_s16(data + i, vsubq_s16(vld1q_s16(data + i), vValue));
+    }
+    for (; i < count; ++i) {
+        data[i] = static_cast<int16_t>(data[i] - value);
+    }
+}
+
+int16_t ReduceMax(const int16_t* data, size_t count, int16_t init) {
+    int16x8_t vMax = vdupq_n_s16(init);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        vMax = vmaxq_s16(vMax, vld1q_s16(data + i));
+    }
+    int16_t result = vmaxvq_s16(vMax);
+    for (; i < count; ++i) {
+        result = std::max(result, data[i]);
+    }
+    return result;
+}
+
+void SubClampZero(int16_t* data, size_t count, int16_t value) {
+    const int16x8_t vValue = vdupq_n_s16(value);
+    const int16x8_t vZero = vdupq_n_s16(0);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        // 结果 = max(0, vData - value)
+        vst1q_s16(data + i, vmaxq_s16(vZero, vsubq_s16(vld1q_s16(data + i), vValue)));
+    }
+    for (; i < count; ++i) {
+        data[i] = std::max<int16_t>(0, static_cast<int16_t>(data[i] - value));
+    }
+}
+
+void IirBlendPositive(int16_t* data, int16_t* history, size_t count, int32_t alpha) {
+    if (alpha < 0 || alpha > 1000) {
+        detail::ScalarKernels()->IirBlendPositive(data, history, count, alpha);
+        return;
+    }
+    const int32_t beta = 1000 - alpha;
+    const int16x8_t vZero = vdupq_n_s16(0);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t cur = vld1q_s16(data + i);
+        int16x8_t hist = vld1q_s16(history + i);
+        int32x4_t lo = vmlaq_n_s32(vmulq_n_s32(vmovl_s16(vget_low_s16(cur)), alpha),
+                                   vmovl_s16(vget_low_s16(hist)), beta);
+        int32x4_t hi = vmlaq_n_s32(vmulq_n_s32(vmovl_s16(vget_high_s16(cur)), alpha),
+                                   vmovl_s16(vget_high_s16(hist)), beta);
+        int16x8_t blended = vcombine_s16(vmovn_s32(DivBy1000(lo)), vmovn_s32(DivBy1000(hi)));
+        int16x8_t result = vbslq_s16(vcgtq_s16(cur, vZero), blended, cur);
+        vst1q_s16(data + i, result);
+        vst1q_s16(history + i, result);
+    }
+    if (i < count) {
+        detail::ScalarKernels()->IirBlendPositive(data + i, history + i, count - i, alpha);
+    }
+}
+
+int16_t SubReduceMax(const int16_t* data, size_t count, int16_t value, int16_t init) {
+    const int16x8_t vValue = vdupq_n_s16(value);
+    int16x8_t vMax = vdupq_n_s16(init);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        vMax = vmaxq_s16(vMax, vsubq_s16(vld1q_s16(data + i), vValue));
+    }
+    int16_t result = vmaxvq_s16(vMax);
+    for (; i < count; ++i) {
+        result = std::max(result, static_cast<int16_t>(data[i] - value));
+    }
+    return result;
+}
+
+void FrontEndApply(int16_t* data, size_t count, const FrontEndArgs& args) {
+    if (args.conditioning && (args.alpha < 0 || args.alpha > 1000)) {
+        detail::ScalarKernels()->FrontEndApply(data, count, args);
+        return;
+    }
+    const int16x8_t vBaseline = vdupq_n_s16(args.baseline);
+    const int16x8_t vShrink = vdupq_n_s16(args.shrinkValue);
+    const int16x8_t vFloor = vdupq_n_s16(args.noiseFloor);
+    const int16x8_t vZero = vdupq_n_s16(0);
+    const int32_t alpha = args.alpha;
+    const int32_t beta = 1000 - args.alpha;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t cur = vsubq_s16(vld1q_s16(data + i), vBaseline);
+        if (args.deadzone) {
+            cur = vmaxq_s16(vZero, vsubq_s16(cur, vShrink));
+        }
+        if (args.conditioning) {
+            int16x8_t hist = args.seedHistory ? cur : vld1q_s16(args.history + i);
+            int32x4_t lo = vmlaq_n_s32(vmulq_n_s32(vmovl_s16(vget_low_s16(cur)), alpha),
+                                       vmovl_s16(vget_low_s16(hist)), beta);
+            int32x4_t hi = vmlaq_n_s32(vmulq_n_s32(vmovl_high_s16(cur), alpha), vmovl_high_s16(hist), beta);
+            int16x8_t blended = vcombine_s16(vmovn_s32(DivBy1000(lo)), vmovn_s32(DivBy1000(hi)));
+            cur = vbslq_s16(vcgtq_s16(cur, vZero), blended, cur);
+            vst1q_s16(args.history + i, cur);
+            cur = vmaxq_s16(vZero, vsubq_s16(cur, vFloor));
+        }
+        vst1q_s16(data + i, cur);
+    }
+    if (i < count) {
+        FrontEndArgs tail = args;
+        if (tail.history) tail.history += i;
+        detail::ScalarKernels()->FrontEndApply(data + i, count - i, tail);
+    }
+}
+
+void Gaussian3x3(const int16_t* src, int16_t* dst, int rows, int cols, int32_t centerWeight) {
+    const int32_t kernelSum = 12 + centerWeight;
+    // 浮点除法截断仅在 |sum| < 2^24 且 kernelSum < 512 时与整除逐位一致
+    if (cols - 2 < 8 || centerWeight < 0 || kernelSum >= 512) {
+        detail::ScalarKernels()->Gaussian3x3(src, dst, rows, cols, centerWeight);
+        return;
+    }
+    const float32x4_t vKernelSum = vdupq_n_f32(static_cast<float>(kernelSum));
+
+    auto sum4 = [&](int32x4_t tl, int32x4_t tc, int32x4_t tr, int32x4_t ml, int32x4_t mc, int32x4_t mr,
+                    int32x4_t bl, int32x4_t bc, int32x4_t br) {
+        int32x4_t corners = vaddq_s32(vaddq_s32(tl, tr), vaddq_s32(bl, br));
+        int32x4_t edges = vaddq_s32(vaddq_s32(tc, bc), vaddq_s32(ml, mr));
+        int32x4_t sum = vmlaq_n_s32(vaddq_s32(corners, vshlq_n_s32(edges, 1)), mc, centerWeight);
+        return vcvtq_s32_f32(vdivq_f32(vcvtq_f32_s32(sum), vKernelSum));
+    };
+
+    for (int y = 1; y < rows - 1; ++y) {
+        const int16_t* top = src + (y - 1) * cols;
+        const int16_t* mid = src + y * cols;
+        const int16_t* bot = src + (y + 1) * cols;
+        int16_t* out = dst + y * cols;
+        for (int x = 1; x < cols - 1; x += 8) {
+            // 最后一块右对齐到边界：重叠部分由 src 重新计算，结果相同
+            const int bx = std::min(x, cols - 1 - 8);
+            int16x8_t t0 = vld1q_s16(top + bx - 1), t1 = vld1q_s16(top + bx), t2 = vld1q_s16(top + bx + 1);
+            int16x8_t m0 = vld1q_s16(mid + bx - 1), m1 = vld1q_s16(mid + bx), m2 = vld1q_s16(mid + bx + 1);
+            int16x8_t b0 = vld1q_s16(bot + bx - 1), b1 = vld1q_s16(bot + bx), b2 = vld1q_s16(bot + bx + 1);
+            int32x4_t lo = sum4(vmovl_s16(vget_low_s16(t0)), vmovl_s16(vget_low_s16(t1)), vmovl_s16(vget_low_s16(t2)),
+                                vmovl_s16(vget_low_s16(m0)), vmovl_s16(vget_low_s16(m1)), vmovl_s16(vget_low_s16(m2)),
+                                vmovl_s16(vget_low_s16(b0)), vmovl_s16(vget_low_s16(b1)), vmovl_s16(vget_low_s16(b2)));
+            int32x4_t hi = sum4(vmovl_high_s16(t0), vmovl_high_s16(t1), vmovl_high_s16(t2),
+                                vmovl_high_s16(m0), vmovl_high_s16(m1), vmovl_high_s16(m2),
+                                vmovl_high_s16(b0), vmovl_high_s16(b1), vmovl_high_s16(b2));
+            vst1q_s16(out + bx, vcombine_s16(vmovn_s32(lo), vmovn_s32(hi)));
+        }
+    }
+}
+
+void Sharpen3x3(const int16_t* src, int16_t* dst, int rows, int cols, float strength) {
+    if (cols - 2 < 8) {
+        detail::ScalarKernels()->Sharpen3x3(src, dst, rows, cols, strength);
+        return;
+    }
+    const int32x4_t vZero = vdupq_n_s32(0);
+    const int32x4_t vMax = vdupq_n_s32(4095);
+
+    auto sharpen4 = [&](int32x4_t t, int32x4_t b, int32x4_t l, int32x4_t r, int32x4_t c) {
+        int32x4_t laplace = vsubq_s32(vshlq_n_s32(c, 2), vaddq_s32(vaddq_s32(t, b), vaddq_s32(l, r)));
+        int32x4_t delta = vcvtq_s32_f32(vmulq_n_f32(vcvtq_f32_s32(laplace), strength));
+        return vminq_s32(vmaxq_s32(vaddq_s32(c, delta), vZero), vMax);
+    };
+
+    for (int y = 1; y < rows - 1; ++y) {
+        const int16_t* top = src + (y - 1) * cols;
+        const int16_t* mid = src + y * cols;
+        const int16_t* bot = src + (y + 1) * cols;
+        int16_t* out = dst + y * cols;
+        for (int x = 1; x < cols - 1; x += 8) {
+            const int bx = std::min(x, cols - 1 - 8);
+            int16x8_t t = vld1q_s16(top + bx), b = vld1q_s16(bot + bx);
+            int16x8_t l = vld1q_s16(mid + bx - 1), c = vld1q_s16(mid + bx), r = vld1q_s16(mid + bx + 1);
+            int32x4_t lo = sharpen4(vmovl_s16(vget_low_s16(t)), vmovl_s16(vget_low_s16(b)),
+                                    vmovl_s16(vget_low_s16(l)), vmovl_s16(vget_low_s16(r)),
+                                    vmovl_s16(vget_low_s16(c)));
+            int32x4_t hi = sharpen4(vmovl_high_s16(t), vmovl_high_s16(b), vmovl_high_s16(l),
+                                    vmovl_high_s16(r), vmovl_high_s16(c));
+            vst1q_s16(out + bx, vcombine_s16(vmovn_s32(lo), vmovn_s32(hi)));
+        }
+    }
+}
+
+void DeltaZigZag(const int16_t* cur, const int16_t* prev, uint16_t* out, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t d = vsubq_s16(vld1q_s16(cur + i), vld1q_s16(prev + i));
+        int16x8_t z = veorq_s16(vshlq_n_s16(d, 1), vshrq_n_s16(d, 15));
+        vst1q_u16(out + i, vreinterpretq_u16_s16(z));
+    }
+    detail::ScalarKernels()->DeltaZigZag(cur + i, prev + i, out + i, count - i);
+}
+
+void UnZigZagAdd(const uint16_t* z, const int16_t* prev, int16_t* out, size_t count) {
+    const uint16x8_t vOne = vdupq_n_u16(1);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        uint16x8_t v = vld1q_u16(z + i);
+        int16x8_t sign = vnegq_s16(vreinterpretq_s16_u16(vandq_u16(v, vOne)));
+        int16x8_t d = veorq_s16(vreinterpretq_s16_u16(vshrq_n_u16(v, 1)), sign);
+        vst1q_s16(out + i, vaddq_s16(vld1q_s16(prev + i), d));
+    }
+    detail::ScalarKernels()->UnZigZagAdd(z + i, prev + i, out + i, count - i);
+}
+
+size_t FindNonZero(const uint16_t* data, size_t begin, size_t count) {
+    size_t i = begin;
+    // 32 个元素一组做横向 max，长零段每组只需一次判断
+    for (; i + 32 <= count; i += 32) {
+        uint16x8_t any = vorrq_u16(vorrq_u16(vld1q_u16(data + i), vld1q_u16(data + i + 8)),
+                                   vorrq_u16(vld1q_u16(data + i + 16), vld1q_u16(data + i + 24)));
+        if (vmaxvq_u16(any) != 0) break;
+    }
+    return detail::ScalarKernels()->FindNonZero(data, i, count);
+}
+
+constexpr KernelTable kNeonTable{
+    Backend::Neon, "neon",
+    LoadLe16, LoadLe16CountRail, SubConst, ReduceMax, SubClampZero, IirBlendPositive,
+    SubReduceMax, FrontEndApply, Gaussian3x3, Sharpen3x3,
+    DeltaZigZag, UnZigZagAdd, FindNonZero,
+};
+
+} // namespace
+
+const KernelTable* detail::NeonKernels() { return &kNeonTable; }
+
+#else
+
+const KernelTable* detail::NeonKernels() { return nullptr; }
+
+#endif
+
+} // namespace Engine::Simd
@@ -0,0 +1,153 @@
+#include "SimdKernels.h"
+#include <algorithm>
+#include <cstring>
+
+// Scalar 参考实现：所有向量后端都以此为逐位对拍基准。
+
+namespace Engine::Simd {
+
+namespace {
+
+void LoadLe16(const uint8_t* src, int16_t* dst, size_t count) {
+    // 目标平台 (ARM64 / x86) 均为小端，直接按字节拷贝即可
+    std::memcpy(dst, src, count * sizeof(int16_t));
+}
+
+size_t LoadLe16CountRail(const uint8_t* src, int16_t* dst, size_t count, uint16_t margin) {
+    std::memcpy(dst, src, count * sizeof(int16_t));
+    // 两段轨边共 2 * margin + 2 个取值：平移 margin + 1 后 0xFFFF - margin 落到 0、margin 落到
+    // 2 * margin + 1，即 x + margin + 1 (mod 2^16) <= 2 * margin + 1。margin < 0x8000 时两者均不超过 16 位
+    const uint16_t shift = static_cast<uint16_t>(uint32_t{margin} + 1);
+    const uint16_t limit = static_cast<uint16_t>(uint32_t{margin} * 2 + 1);
+    size_t rail = 0;
+    for (size_t i = 0; i < count; ++i) {
+        rail += static_cast<uint16_t>(static_cast<uint16_t>(dst[i]) + shift) <= limit;
+    }
+    return rail;
+}
+
+void SubConst(int16_t* data, size_t count, int16_t value) {
+    for (size_t i = 0; i < count; ++i) {
+        data[i] = static_cast<int16_t>(data[i] - value);
+    }
+}
+
+int16_t ReduceMax(const int16_t* data, size_t count, int16_t init) {
+    int16_t result = init;
+    for (size_t i = 0; i < count; ++i) {
+        result = std::max(result, data[i]);
+    }
+    return result;
+}
+
+void SubClampZero(int16_t* data, size_t count, int16_t value) {
+    for (size_t i = 0; i < count; ++i) {
+        data[i] = std::max<int16_t>(0, static_cast<int16_t>(data[i] - value));
+    }
+}
+
+void IirBlendPositive(int16_t* data, int16_t* history, size_t count, int32_t alpha) {
+    const int32_t beta = 1000 - alpha;
+    for (size_t i = 0; i < count; ++i) {
+        // Apply IIR only to positive signals to keep noise floor stable
+        if (data[i] > 0) {
+            int32_t val = data[i];
+            int32_t hist = history[i];
+            data[i] = static_cast<int16_t>((val * alpha + hist * beta) / 1000);
+        }
+        history[i] = data[i];
+    }
+}
+
+int16_t SubReduceMax(const int16_t* data, size_t count, int16_t value, int16_t init) {
+    int16_t result = init;
+    for (size_t i = 0; i < count; ++i) {
+        result = std::max(result, static_cast<int16_t>(data[i] - value));
+    }
+    return result;
+}
+
+void FrontEndApply(int16_t* data, size_t count, const FrontEndArgs& args) {
+    const int32_t beta = 1000 - args.alpha;
+    for (size_t i = 0; i < count; ++i) {
+        int16_t val = static_cast<int16_t>(data[i] - args.baseline);
+        if (args.deadzone) {
+            val = std::max<int16_t>(0, static_cast<int16_t>(val - args.shrinkValue));
+        }
+        if (args.conditioning) {
+            if (val > 0) {
+                int32_t hist = args.seedHistory ? val : args.history[i];
+                val = static_cast<int16_t>((val * args.alpha + hist * beta) / 1000);
+            }
+            args.history[i] = val;
+            val = std::max<int16_t>(0, static_cast<int16_t>(val - args.noiseFloor));
+        }
+        data[i] = val;
+    }
+}
+
+void Gaussian3x3(const int16_t* src, int16_t* dst, int rows, int cols, int32_t centerWeight) {
+    const int32_t kernelSum = 12 + centerWeight;
+    for (int y = 1; y < rows - 1; ++y) {
+        const int16_t* top = src + (y - 1) * cols;
+        const int16_t* mid = src + y * cols;
+        const int16_t* bot = src + (y + 1) * cols;
+        int16_t* out = dst + y * cols;
+        for (int x = 1; x < cols - 1; ++x) {
+            int32_t sum = 0;
+            sum += top[x - 1] * 1 + top[x] * 2 + top[x + 1] * 1;
+            sum += mid[x - 1] * 2 + mid[x] * centerWeight + mid[x + 1] * 2;
+            sum += bot[x - 1] * 1 + bot[x] * 2 + bot[x + 1] * 1;
+            out[x] = static_cast<int16_t>(sum / kernelSum);
+        }
+    }
+}
+
+void Sharpen3x3(const int16_t* src, int16_t* dst, int rows, int cols, float strength) {
+    for (int y = 1; y < rows - 1; ++y) {
+        const int16_t* top = src + (y - 1) * cols;
+        const int16_t* mid = src + y * cols;
+        const int16_t* bot = src + (y + 1) * cols;
+        int16_t* out = dst + y * cols;
+        for (int x = 1; x < cols - 1; ++x) {
+            int32_t center = mid[x];
+            int32_t laplace = (4 * center) - top[x] - bot[x] - mid[x - 1] - mid[x + 1];
+            int32_t sharpened = center + static_cast<int32_t>(strength * laplace);
+            out[x] = static_cast<int16_t>(std::clamp(sharpened, 0, 4095));
+        }
+    }
+}
+
+void DeltaZigZag(const int16_t* cur, const int16_t* prev, uint16_t* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const int16_t d = static_cast<int16_t>(cur[i] - prev[i]);
+        out[i] = static_cast<uint16_t>((static_cast<uint16_t>(d) << 1) ^ static_cast<uint16_t>(d >> 15));
+    }
+}
+
+void UnZigZagAdd(const uint16_t* z, const int16_t* prev, int16_t* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const uint16_t d = static_cast<uint16_t>((z[i] >> 1) ^ static_cast<uint16_t>(0u - (z[i] & 1u)));
+        out[i] = static_cast<int16_t>(prev[i] + static_cast<int16_t>(d));
+    }
+}
+
+size_t FindNonZero(const uint16_t* data, size_t begin, size_t count) {
+    for (size_t i = begin; i < count; ++i) {
+        if (data[i]) return i;
+    }
+    return count;
+}
+
+constexpr KernelTable kScalarTable{
+    Backend::Scalar, "scalar",
+    LoadLe16, LoadLe16CountRail, SubConst, ReduceMax, SubClampZero, IirBlendPositive,
+    SubReduceMax, FrontEndApply, Gaussian3x3, Sharpen3x3,
+    DeltaZigZag, UnZigZagAdd, FindNonZero,
+};
+
+} // namespace
+
+const KernelTable* detail::ScalarKernels() { return &kScalarTable; }
+
+} // namespace Engine::Simd
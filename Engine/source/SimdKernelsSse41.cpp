@@ -0,0 +1,304 @@
+#include "SimdKernels.h"
+
+#if HIMAX_ENABLE_X86_SIMD && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86))
+#define ENGINE_SIMD_SSE41 1
+#include <smmintrin.h>
+#include <algorithm>
+#include <bit>
+#endif
+
+// SSE4.1 后端 (x86 回放 / 分析机的兜底向量路径)
+// 本文件在 GCC/Clang 下以 -msse4.1 单独编译，运行时只有 CPUID 确认后才会被选中。
+
+namespace Engine::Simd {
+
+#if defined(ENGINE_SIMD_SSE41)
+
+namespace {
+
+inline __m128i Load(const int16_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+inline void Store(int16_t* p, __m128i v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+inline __m128i WidenLo(__m128i v) { return _mm_cvtepi16_epi32(v); }
+inline __m128i WidenHi(__m128i v) { return _mm_cvtepi16_epi32(_mm_srli_si128(v, 8)); }
+
+// 有符号 int32 除以 1000 (向零截断)，与编译器对常量除法的乘法-移位展开一致:
+// q = ((int64)n * 274877907) >> 38, 再对负数 +1
+inline __m128i DivBy1000(__m128i n) {
+    const __m128i magic = _mm_set1_epi32(274877907);
+    __m128i prodEven = _mm_mul_epi32(n, magic);                      // lanes 0, 2
+    __m128i prodOdd = _mm_mul_epi32(_mm_srli_epi64(n, 32), magic);   // lanes 1, 3
+    __m128i hi = _mm_blend_epi16(_mm_srli_epi64(prodEven, 32), prodOdd, 0xCC);
+    __m128i q = _mm_srai_epi32(hi, 6);
+    return _mm_sub_epi32(q, _mm_srai_epi32(n, 31));
+}
+
+void LoadLe16(const uint8_t* src, int16_t* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        Store(dst + i, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2)));
+    }
+    for (; i < count; ++i) {
+        dst[i] = static_cast<int16_t>(src[i * 2] | (src[i * 2 + 1] << 8));
+    }
+}
+
+// 平移与上限见 Scalar 版本；无符号比较用 min_epu16 + cmpeq 实现，命中的 -1 通道经 madd 两两求和到 int32，
+// 长输入不溢出
+size_t LoadLe16CountRail(const uint8_t* src, int16_t* dst, size_t count, uint16_t margin) {
+    const __m128i vShift = _mm_set1_epi16(static_cast<int16_t>(uint32_t{margin} + 1));
+    const __m128i vLimit = _mm_set1_epi16(static_cast<int16_t>(uint32_t{margin} * 2 + 1));
+    const __m128i vNegOne = _mm_set1_epi16(-1);
+    __m128i vCount = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+        Store(dst + i, raw);
+        const __m128i shifted = _mm_add_epi16(raw, vShift);
+        const __m128i hit = _mm_cmpeq_epi16(_mm_min_epu16(shifted, vLimit), shifted);
+        vCount = _mm_add_epi32(vCount, _mm_madd_epi16(hit, vNegOne));
+    }
+    vCount = _mm_add_epi32(vCount, _mm_shuffle_epi32(vCount, _MM_SHUFFLE(1, 0, 3, 2)));
+    vCount = _mm_add_epi32(vCount, _mm_shuffle_epi32(vCount, _MM_SHUFFLE(2, 3, 0, 1)));
+    return static_cast<uint32_t>(_mm_cvtsi128_si32(vCount)) +
+           detail::ScalarKernels()->LoadLe16CountRail(src + i * 2, dst + i, count - i, margin);
+}
+
+void SubConst(int16_t* data, size_t count, int16_t value) {
+    const __m128i vValue = _mm_set1_epi16(value);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        Store(data + i, _mm_sub_epi16(Load(data + i), vValue));
+    }
+    for (; i < count; ++i) {
+        data[i] = static_cast<int16_t>(data[i] - value);
+    }
+}
+
+int16_t ReduceMax(const int16_t* data, size_t count, int16_t init) {
+    __m128i vMax = _mm_set1_epi16(init);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        vMax = _mm_max_epi16(vMax, Load(data + i));
+    }
+    vMax = _mm_max_epi16(vMax, _mm_srli_si128(vMax, 8));
+    vMax = _mm_max_epi16(vMax, _mm_srli_si128(vMax, 4));
+    vMax = _mm_max_epi16(vMax, _mm_srli_si128(vMax, 2));
+    int16_t result = static_cast<int16_t>(_mm_extract_epi16(vMax, 0));
+    for (; i < count; ++i) {
+        result = std::max(result, data[i]);
+    }
+    return result;
+}
+
+void SubClampZero(int16_t* data, size_t count, int16_t value) {
+    const __m128i vValue = _mm_set1_epi16(value);
+    const __m128i vZero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        Store(data + i, _mm_max_epi16(vZero, _mm_sub_epi16(Load(data + i), vValue)));
+    }
+    for (; i < count; ++i) {
+        data[i] = std::max<int16_t>(0, static_cast<int16_t>(data[i] - value));
+    }
+}
+
+void IirBlendPositive(int16_t* data, int16_t* history, size_t count, int32_t alpha) {
+    if (alpha < 0 || alpha > 1000) {
+        // 超出凸组合范围时结果可能溢出 int16，交给标量路径保持回绕语义
+        detail::ScalarKernels()->IirBlendPositive(data, history, count, alpha);
+        return;
+    }
+    const __m128i vAlpha = _mm_set1_epi32(alpha);
+    const __m128i vBeta = _mm_set1_epi32(1000 - alpha);
+    const __m128i vZero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i cur = Load(data + i);
+        __m128i hist = Load(history + i);
+        __m128i lo = _mm_add_epi32(_mm_mullo_epi32(WidenLo(cur), vAlpha), _mm_mullo_epi32(WidenLo(hist), vBeta));
+        __m128i hi = _mm_add_epi32(_mm_mullo_epi32(WidenHi(cur), vAlpha), _mm_mullo_epi32(WidenHi(hist), vBeta));
+        __m128i blended = _mm_packs_epi32(DivBy1000(lo), DivBy1000(hi));
+        __m128i result = _mm_blendv_epi8(cur, blended, _mm_cmpgt_epi16(cur, vZero));
+        Store(data + i, result);
+        Store(history + i, result);
+    }
+    if (i < count) {
+        detail::ScalarKernels()->IirBlendPositive(data + i, history + i, count - i, alpha);
+    }
+}
+
+int16_t SubReduceMax(const int16_t* data, size_t count, int16_t value, int16_t init) {
+    const __m128i vValue = _mm_set1_epi16(value);
+    __m128i vMax = _mm_set1_epi16(init);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        vMax = _mm_max_epi16(vMax, _mm_sub_epi16(Load(data + i), vValue));
+    }
+    vMax = _mm_max_epi16(vMax, _mm_srli_si128(vMax, 8));
+    vMax = _mm_max_epi16(vMax, _mm_srli_si128(vMax, 4));
+    vMax = _mm_max_epi16(vMax, _mm_srli_si128(vMax, 2));
+    int16_t result = static_cast<int16_t>(_mm_extract_epi16(vMax, 0));
+    for (; i < count; ++i) {
+        result = std::max(result, static_cast<int16_t>(data[i] - value));
+    }
+    return result;
+}
+
+void FrontEndApply(int16_t* data, size_t count, const FrontEndArgs& args) {
+    if (args.conditioning && (args.alpha < 0 || args.alpha > 1000)) {
+        detail::ScalarKernels()->FrontEndApply(data, count, args);
+        return;
+    }
+    const __m128i vBaseline = _mm_set1_epi16(args.baseline);
+    const __m128i vShrink = _mm_set1_epi16(args.shrinkValue);
+    const __m128i vFloor = _mm_set1_epi16(args.noiseFloor);
+    const __m128i vAlpha = _mm_set1_epi32(args.alpha);
+    const __m128i vBeta = _mm_set1_epi32(1000 - args.alpha);
+    const __m128i vZero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i cur = _mm_sub_epi16(Load(data + i), vBaseline);
+        if (args.deadzone) {
+            cur = _mm_max_epi16(vZero, _mm_sub_epi16(cur, vShrink));
+        }
+        if (args.conditioning) {
+            __m128i hist = args.seedHistory ? cur : Load(args.history + i);
+            __m128i lo = _mm_add_epi32(_mm_mullo_epi32(WidenLo(cur), vAlpha), _mm_mullo_epi32(WidenLo(hist), vBeta));
+            __m128i hi = _mm_add_epi32(_mm_mullo_epi32(WidenHi(cur), vAlpha), _mm_mullo_epi32(WidenHi(hist), vBeta));
+            __m128i blended = _mm_packs_epi32(DivBy1000(lo), DivBy1000(hi));
+            cur = _mm_blendv_epi8(cur, blended, _mm_cmpgt_epi16(cur, vZero));
+            Store(args.history + i, cur);
+            cur = _mm_max_epi16(vZero, _mm_sub_epi16(cur, vFloor));
+        }
+        Store(data + i, cur);
+    }
+    if (i < count) {
+        FrontEndArgs tail = args;
+        if (tail.history) tail.history += i;
+        detail::ScalarKernels()->FrontEndApply(data + i, count - i, tail);
+    }
+}
+
+void Gaussian3x3(const int16_t* src, int16_t* dst, int rows, int cols, int32_t centerWeight) {
+    const int32_t kernelSum = 12 + centerWeight;
+    // 浮点除法截断仅在 |sum| < 2^24 且 kernelSum < 512 时与整除逐位一致
+    if (cols - 2 < 8 || centerWeight < 0 || kernelSum >= 512) {
+        detail::ScalarKernels()->Gaussian3x3(src, dst, rows, cols, centerWeight);
+        return;
+    }
+    const __m128i vCenter = _mm_set1_epi32(centerWeight);
+    const __m128 vKernelSum = _mm_set1_ps(static_cast<float>(kernelSum));
+
+    auto sum4 = [&](__m128i tl, __m128i tc, __m128i tr, __m128i ml, __m128i mc, __m128i mr,
+                    __m128i bl, __m128i bc, __m128i br) {
+        __m128i corners = _mm_add_epi32(_mm_add_epi32(tl, tr), _mm_add_epi32(bl, br));
+        __m128i edges = _mm_add_epi32(_mm_add_epi32(tc, bc), _mm_add_epi32(ml, mr));
+        __m128i sum = _mm_add_epi32(corners, _mm_slli_epi32(edges, 1));
+        sum = _mm_add_epi32(sum, _mm_mullo_epi32(mc, vCenter));
+        return _mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(sum), vKernelSum));
+    };
+
+    for (int y = 1; y < rows - 1; ++y) {
+        const int16_t* top = src + (y - 1) * cols;
+        const int16_t* mid = src + y * cols;
+        const int16_t* bot = src + (y + 1) * cols;
+        int16_t* out = dst + y * cols;
+        for (int x = 1; x < cols - 1; x += 8) {
+            // 最后一块右对齐到边界：重叠部分由 src 重新计算，结果相同
+            const int bx = std::min(x, cols - 1 - 8);
+            __m128i t0 = Load(top + bx - 1), t1 = Load(top + bx), t2 = Load(top + bx + 1);
+            __m128i m0 = Load(mid + bx - 1), m1 = Load(mid + bx), m2 = Load(mid + bx + 1);
+            __m128i b0 = Load(bot + bx - 1), b1 = Load(bot + bx), b2 = Load(bot + bx + 1);
+            __m128i lo = sum4(WidenLo(t0), WidenLo(t1), WidenLo(t2), WidenLo(m0), WidenLo(m1), WidenLo(m2),
+                              WidenLo(b0), WidenLo(b1), WidenLo(b2));
+            __m128i hi = sum4(WidenHi(t0), WidenHi(t1), WidenHi(t2), WidenHi(m0), WidenHi(m1), WidenHi(m2),
+                              WidenHi(b0), WidenHi(b1), WidenHi(b2));
+            Store(out + bx, _mm_packs_epi32(lo, hi));
+        }
+    }
+}
+
+void Sharpen3x3(const int16_t* src, int16_t* dst, int rows, int cols, float strength) {
+    if (cols - 2 < 8) {
+        detail::ScalarKernels()->Sharpen3x3(src, dst, rows, cols, strength);
+        return;
+    }
+    const __m128 vStrength = _mm_set1_ps(strength);
+    const __m128i vZero = _mm_setzero_si128();
+    const __m128i vMax = _mm_set1_epi32(4095);
+
+    auto sharpen4 = [&](__m128i t, __m128i b, __m128i l, __m128i r, __m128i c) {
+        __m128i laplace = _mm_sub_epi32(_mm_slli_epi32(c, 2),
+                                        _mm_add_epi32(_mm_add_epi32(t, b), _mm_add_epi32(l, r)));
+        __m128i delta = _mm_cvttps_epi32(_mm_mul_ps(vStrength, _mm_cvtepi32_ps(laplace)));
+        __m128i sharpened = _mm_add_epi32(c, delta);
+        return _mm_min_epi32(_mm_max_epi32(sharpened, vZero), vMax);
+    };
+
+    for (int y = 1; y < rows - 1; ++y) {
+        const int16_t* top = src + (y - 1) * cols;
+        const int16_t* mid = src + y * cols;
+        const int16_t* bot = src + (y + 1) * cols;
+        int16_t* out = dst + y * cols;
+        for (int x = 1; x < cols - 1; x += 8) {
+            const int bx = std::min(x, cols - 1 - 8);
+            __m128i t = Load(top + bx), b = Load(bot + bx);
+            __m128i l = Load(mid + bx - 1), c = Load(mid + bx), r = Load(mid + bx + 1);
+            __m128i lo = sharpen4(WidenLo(t), WidenLo(b), WidenLo(l), WidenLo(r), WidenLo(c));
+            __m128i hi = sharpen4(WidenHi(t), WidenHi(b), WidenHi(l), WidenHi(r), WidenHi(c));
+            Store(out + bx, _mm_packs_epi32(lo, hi));
+        }
+    }
+}
+
+void DeltaZigZag(const int16_t* cur, const int16_t* prev, uint16_t* out, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i d = _mm_sub_epi16(Load(cur + i), Load(prev + i));
+        __m128i z = _mm_xor_si128(_mm_slli_epi16(d, 1), _mm_srai_epi16(d, 15));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), z);
+    }
+    detail::ScalarKernels()->DeltaZigZag(cur + i, prev + i, out + i, count - i);
+}
+
+void UnZigZagAdd(const uint16_t* z, const int16_t* prev, int16_t* out, size_t count) {
+    const __m128i vOne = _mm_set1_epi16(1);
+    const __m128i vZero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(z + i));
+        __m128i d = _mm_xor_si128(_mm_srli_epi16(v, 1), _mm_sub_epi16(vZero, _mm_and_si128(v, vOne)));
+        Store(out + i, _mm_add_epi16(Load(prev + i), d));
+    }
+    detail::ScalarKernels()->UnZigZagAdd(z + i, prev + i, out + i, count - i);
+}
+
+size_t FindNonZero(const uint16_t* data, size_t begin, size_t count) {
+    const __m128i vZero = _mm_setzero_si128();
+    size_t i = begin;
+    for (; i + 8 <= count; i += 8) {
+        __m128i eq = _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), vZero);
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(eq));
+        if (mask != 0xFFFFu) return i + std::countr_zero(~mask) / 2;
+    }
+    return detail::ScalarKernels()->FindNonZero(data, i, count);
+}
+
+constexpr KernelTable kSse41Table{
+    Backend::Sse41, "sse4.1",
+    LoadLe16, LoadLe16CountRail, SubConst, ReduceMax, SubClampZero, IirBlendPositive,
+    SubReduceMax, FrontEndApply, Gaussian3x3, Sharpen3x3,
+    DeltaZigZag, UnZigZagAdd, FindNonZero,
+};
+
+} // namespace
+
+const KernelTable* detail::Sse41Kernels() { return &kSse41Table; }
+
+#else
+
+const KernelTable* detail::Sse41Kernels() { return nullptr; }
+
+#endif
+
+} // namespace Engine::Simd
@@ -0,0 +1,99 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+namespace Engine {
+
+namespace {
+// 当前线程所属的线程池与队列下标 (非工作线程为 nullptr)
+thread_local const WorkStealingPool* t_pool = nullptr;
+thread_local unsigned t_index = 0;
+} // namespace
+
+WorkStealingPool::WorkStealingPool(unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    m_queues.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) m_queues.push_back(std::make_unique<Queue>());
+    m_workers.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) m_workers.emplace_back(&WorkStealingPool::WorkerLoop, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_workReady.notify_all();
+    for (std::thread& worker : m_workers) worker.join();
+}
+
+void WorkStealingPool::Submit(std::function<void()> task) {
+    const unsigned target = t_pool == this ? t_index
+                                           : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % ThreadCount();
+    // 先计数再入队：计数不会小于实际任务数，工作线程不会在有任务时休眠
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_queued;
+        ++m_outstanding;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_queues[target]->mutex);
+        m_queues[target]->tasks.push_back(std::move(task));
+    }
+    m_workReady.notify_one();
+}
+
+void WorkStealingPool::Wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_allDone.wait(lock, [this] { return m_outstanding == 0; });
+}
+
+bool WorkStealingPool::TryPop(unsigned index, std::function<void()>& task) {
+    Queue& queue = *m_queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::TrySteal(unsigned thief, std::function<void()>& task) {
+    const unsigned count = ThreadCount();
+    for (unsigned k = 1; k < count; ++k) {
+        Queue& queue = *m_queues[(thief + k) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        m_steals.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::WorkerLoop(unsigned index) {
+    t_pool = this;
+    t_index = index;
+    for (;;) {
+        std::function<void()> task;
+        if (!TryPop(index, task) && !TrySteal(index, task)) {
+            // m_queued 为 0 时所有队列确实为空，可以休眠；否则任务正在入队，重试
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_workReady.wait(lock, [this] { return m_stopping || m_queued > 0; });
+            if (m_stopping && m_queued == 0) return;
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_queued;
+        }
+        task();
+        bool done = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            done = --m_outstanding == 0;
+        }
+        if (done) m_allDone.notify_all();
+    }
+}
+
+} // namespace Engine
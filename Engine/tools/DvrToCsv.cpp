@@ -0,0 +1,55 @@
+// DVR 二进制录制 (.egdvr) -> 文本 CSV 转换工具
+// 布局沿用旧版 TriggerDVRExport 的 CSV (每帧 "--- Frame [i] --- TS"、40 行热力图、触点列表)，
+// 另加每帧一行 Trace (延迟区段)；触点最多 16 个 (DvrRecord::kMaxContacts)。解析旧格式的脚本需跳过 Trace 行。
+//
+//   DvrToCsv input.egdvr [output.csv] [--raw] [--info]
+//
+// --raw  每帧追加 Master / Slave 尾部数据
+// --info 只打印文件头与记录数
+
+#include "DvrFile.h"
+#include <cstdio>
+#include <string>
+
+int main(int argc, char** argv) {
+    std::string input, output;
+    bool includeRaw = false;
+    bool infoOnly = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--raw") includeRaw = true;
+        else if (arg == "--info") infoOnly = true;
+        else if (input.empty()) input = arg;
+        else if (output.empty()) output = arg;
+        else { input.clear(); break; }   // 多余参数：打印用法
+    }
+    if (input.empty()) {
+        std::fprintf(stderr, "usage: %s input.egdvr [output.csv] [--raw] [--info]\n", argv[0]);
+        return 2;
+    }
+
+    Engine::DvrReader reader;
+    if (!reader.Open(input)) {
+        std::fprintf(stderr, "not a readable DVR file: %s\n", input.c_str());
+        return 1;
+    }
+    const Engine::DvrFileHeader& header = reader.Header();
+    std::printf("%s: v%u, %zu frames, record %u bytes, config 0x%016llx%s\n", input.c_str(), header.version,
+                reader.RecordCount(), header.recordSize, static_cast<unsigned long long>(header.configHash),
+                reader.IsRecovered() ? " (recovered, no index footer)" : "");
+    reader.Close();
+    if (infoOnly) return 0;
+
+    if (output.empty()) {
+        const size_t dot = input.find_last_of('.');
+        const size_t slash = input.find_last_of("/\\");
+        output = (dot != std::string::npos && (slash == std::string::npos || dot > slash) ? input.substr(0, dot) : input) + ".csv";
+    }
+    if (!Engine::ConvertDvrToCsv(input, output, includeRaw)) {
+        std::fprintf(stderr, "failed to convert %s -> %s\n", input.c_str(), output.c_str());
+        return 1;
+    }
+    std::printf("wrote %s\n", output.c_str());
+    return 0;
+}
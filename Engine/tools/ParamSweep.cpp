@@ -0,0 +1,252 @@
+// 离线参数扫描工具 (ParamSweep)
+// 在合成场景 (带真值) 与 .egdvr 录制上批量评估管线参数组合，全部核心并行
+// (Engine::WorkStealingPool)，按综合代价排序输出；出厂默认配置总是作为对照行参与评估。
+//
+//   ParamSweep --param key=min:max[:steps]... [--scene name[:frames]]... [--dvr path]...
+//              [--random N] [--refine rounds] [--refine-samples N] [--seed S]
+//              [--threads N] [--top K] [--csv out.csv]
+//   ParamSweep --list
+//
+// 说明：
+// - key 为 "处理器名/参数名" (--list 列出全部)，参数名唯一时可省略处理器名。
+// - 默认网格搜索 (每轴 steps 个点，缺省 5)；--random N 改为在各轴范围内随机采样 N 组。
+// - --refine R：在已评估的前 3 名附近再随机采样 R 轮，每轮范围减半 (粗到细的局部细化)。
+//   所有组合按实际生效的取值 (整型参数四舍五入) 去重，同一组合只评估一次。
+// - 未给出 --scene / --dvr 时使用全部合成预置场景 (各 480 帧)。
+// - --dvr 输入在扫描前逐个打开检查，任一无法读取即退出 (返回 2)；评估中失败的组合不参与排名与 CSV。
+// - 录制输入没有真值，只计入抖动与点数跳变；合成输入另计漏报 / 误报 / 定位误差 /
+//   误分裂 / 误合并。代价权重见 Engine::SweepWeights。
+
+#include "ParamSweep.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+
+// "key=min:max[:steps]"
+bool ParseAxis(const std::string& text, Engine::SweepAxis& axis) {
+    const size_t eq = text.rfind('=');
+    if (eq == std::string::npos || eq == 0) return false;
+    axis.key = text.substr(0, eq);
+    const std::string range = text.substr(eq + 1);
+    char* end = nullptr;
+    axis.min = std::strtod(range.c_str(), &end);
+    if (*end != ':') return false;
+    axis.max = std::strtod(end + 1, &end);
+    axis.steps = 5;
+    if (*end == ':') axis.steps = std::max(1, static_cast<int>(std::strtol(end + 1, &end, 10)));
+    return *end == '\0';
+}
+
+bool ParseScene(const std::string& text, Engine::SweepInput& input) {
+    const size_t colon = text.find(':');
+    const std::string name = text.substr(0, colon);
+    for (Engine::SceneConfig& preset : Engine::SceneGenerator::Presets()) {
+        if (preset.name != name) continue;
+        input.name = name;
+        input.scene = std::move(preset);
+        if (colon != std::string::npos) input.frames = std::max(1, std::atoi(text.c_str() + colon + 1));
+        return true;
+    }
+    return false;
+}
+
+// 失败的组合排在结果末尾，之前的都参与排名
+size_t CountRanked(const std::vector<Engine::SweepResult>& results) {
+    return static_cast<size_t>(std::count_if(results.begin(), results.end(),
+                                             [](const Engine::SweepResult& r) { return !r.failed; }));
+}
+
+// 按写入管线后实际生效的取值去重，已评估过的组合 (seen) 不再提交
+std::vector<Engine::SweepPoint> UniquePoints(const Engine::ParamSweep& sweep, std::span<const Engine::SweepPoint> candidates,
+                                             std::set<Engine::SweepPoint>& seen) {
+    std::vector<Engine::SweepPoint> unique;
+    for (Engine::SweepPoint& point : sweep.EffectivePoints(candidates)) {
+        if (seen.insert(point).second) unique.push_back(std::move(point));
+    }
+    return unique;
+}
+
+void PrintParams() {
+    Engine::FramePipeline pipeline;
+    Engine::AddDefaultProcessors(pipeline);
+    for (const auto& [key, param] : Engine::ListParams(pipeline)) {
+        std::printf("%-56s default=%-10g range=[%g, %g]%s\n", key.c_str(), param.Get(), param.min, param.max,
+                    param.type == Engine::ParamType::Float ? "" : " (int)");
+    }
+}
+
+void PrintResult(const char* label, const Engine::SweepResult& r, size_t axes) {
+    const Engine::SweepMetrics& m = r.metrics;
+    std::printf("%-8s %9.4f %8.3f %7d %7d %7llu %7llu %8.4f %8llu", label, r.cost, m.score.MeanError(),
+                m.score.missed, m.score.ghosts, static_cast<unsigned long long>(m.splits),
+                static_cast<unsigned long long>(m.merges), m.MeanJitter(),
+                static_cast<unsigned long long>(m.countChanges));
+    for (size_t a = 0; a < axes; ++a) std::printf(" %12g", r.point[a]);
+    std::printf("\n");
+}
+
+bool WriteCsv(const std::string& path, const std::vector<Engine::SweepAxis>& axes,
+              const std::vector<Engine::SweepResult>& results) {
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+    std::fprintf(f, "rank,cost,frames,truth,matched,missed,ghosts,mean_error,max_error,splits,merges,jitter,count_changes");
+    for (const Engine::SweepAxis& axis : axes) std::fprintf(f, ",\"%s\"", axis.key.c_str());
+    std::fprintf(f, "\n");
+    for (size_t i = 0; i < results.size() && !results[i].failed; ++i) {
+        const Engine::SweepMetrics& m = results[i].metrics;
+        std::fprintf(f, "%zu,%.6f,%llu,%d,%d,%d,%d,%.4f,%.4f,%llu,%llu,%.5f,%llu", i + 1, results[i].cost,
+                     static_cast<unsigned long long>(m.frames), m.score.truthCount, m.score.matched, m.score.missed,
+                     m.score.ghosts, m.score.MeanError(), m.score.maxError, static_cast<unsigned long long>(m.splits),
+                     static_cast<unsigned long long>(m.merges), m.MeanJitter(),
+                     static_cast<unsigned long long>(m.countChanges));
+        for (double value : results[i].point) std::fprintf(f, ",%g", value);
+        std::fprintf(f, "\n");
+    }
+    return std::fclose(f) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<Engine::SweepAxis> axes;
+    std::vector<Engine::SweepInput> inputs;
+    size_t randomCount = 0;
+    int refineRounds = 0;
+    size_t refineSamples = 16;
+    uint64_t seed = 1;
+    unsigned threads = 0;
+    size_t top = 10;
+    std::string csvPath;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        Engine::SweepAxis axis;
+        Engine::SweepInput input;
+        if (arg == "--list") {
+            PrintParams();
+            return 0;
+        } else if (arg == "--param" && i + 1 < argc && ParseAxis(argv[i + 1], axis)) {
+            axes.push_back(std::move(axis));
+            ++i;
+        } else if (arg == "--scene" && i + 1 < argc && ParseScene(argv[i + 1], input)) {
+            inputs.push_back(std::move(input));
+            ++i;
+        } else if (arg == "--dvr" && i + 1 < argc) {
+            input.name = argv[++i];
+            input.recording = input.name;
+            inputs.push_back(std::move(input));
+        } else if (arg == "--random" && i + 1 < argc) {
+            randomCount = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--refine" && i + 1 < argc) {
+            refineRounds = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--refine-samples" && i + 1 < argc) {
+            refineSamples = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<unsigned>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--top" && i + 1 < argc) {
+            top = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--csv" && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s --param key=min:max[:steps]... [--scene name[:frames]]... [--dvr path]...\n"
+                         "          [--random N] [--refine rounds] [--refine-samples N] [--seed S]\n"
+                         "          [--threads N] [--top K] [--csv out.csv]\n"
+                         "       %s --list\n",
+                         argv[0], argv[0]);
+            return 2;
+        }
+    }
+    if (axes.empty()) {
+        std::fprintf(stderr, "no --param given (see --list)\n");
+        return 2;
+    }
+    if (inputs.empty()) {
+        for (Engine::SceneConfig& preset : Engine::SceneGenerator::Presets()) {
+            Engine::SweepInput input;
+            input.name = preset.name;
+            input.scene = std::move(preset);
+            inputs.push_back(std::move(input));
+        }
+    }
+
+    Engine::ParamSweep sweep(axes, inputs);
+    std::string error;
+    if (!sweep.Validate(error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 2;
+    }
+
+    std::vector<Engine::SweepPoint> candidates = randomCount ? Engine::RandomPoints(axes, randomCount, seed)
+                                                             : Engine::GridPoints(axes);
+    const Engine::SweepPoint defaults = sweep.DefaultPoint();
+    candidates.insert(candidates.begin(), defaults);
+    std::set<Engine::SweepPoint> seen;
+    const std::vector<Engine::SweepPoint> points = UniquePoints(sweep, candidates, seen);
+
+    Engine::WorkStealingPool pool(threads);
+    std::printf("%zu configurations x %zu inputs on %u threads\n", points.size(), inputs.size(), pool.ThreadCount());
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<Engine::SweepResult> results = sweep.Evaluate(points, pool);
+
+    // 局部细化：在当前前 3 名附近采样，每轮范围减半；整型参数在小范围内多落到同一取值，去重后再提交
+    double radius = 0.25;
+    for (int round = 0; round < refineRounds; ++round, radius *= 0.5) {
+        std::vector<Engine::SweepPoint> local;
+        const size_t leaders = std::min<size_t>(3, CountRanked(results));
+        if (leaders == 0) break;
+        for (size_t k = 0; k < leaders; ++k) {
+            const size_t count = refineSamples / leaders + (k < refineSamples % leaders ? 1 : 0);
+            std::vector<Engine::SweepPoint> around =
+                Engine::LocalPoints(axes, results[k].point, radius, count, seed + 1000003ull * (round + 1) + k);
+            local.insert(local.end(), around.begin(), around.end());
+        }
+        const std::vector<Engine::SweepPoint> fresh = UniquePoints(sweep, local, seen);
+        if (fresh.empty()) continue;
+        std::vector<Engine::SweepResult> refined = sweep.Evaluate(fresh, pool);
+        results.insert(results.end(), refined.begin(), refined.end());
+        std::stable_sort(results.begin(), results.end(), [](const Engine::SweepResult& a, const Engine::SweepResult& b) {
+            return a.failed != b.failed ? b.failed : a.cost < b.cost;
+        });
+    }
+    const size_t ranked = CountRanked(results);
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%zu evaluations in %.2f s (%llu steals)\n\n", results.size() * inputs.size(), elapsed,
+                static_cast<unsigned long long>(pool.Steals()));
+
+    std::printf("%-8s %9s %8s %7s %7s %7s %7s %8s %8s", "rank", "cost", "err", "missed", "ghosts", "splits",
+                "merges", "jitter", "flicker");
+    for (size_t a = 0; a < axes.size(); ++a) std::printf(" %12s", ("p" + std::to_string(a)).c_str());
+    std::printf("\n");
+    for (size_t i = 0; i < std::min(top, ranked); ++i) {
+        PrintResult(std::to_string(i + 1).c_str(), results[i], axes.size());
+    }
+    for (size_t i = 0; i < ranked; ++i) {
+        if (results[i].point != defaults) continue;
+        PrintResult("default", results[i], axes.size());
+        std::printf("(default ranks %zu of %zu)\n", i + 1, ranked);
+        break;
+    }
+    std::printf("\n");
+    for (size_t a = 0; a < axes.size(); ++a) std::printf("p%zu = %s\n", a, axes[a].key.c_str());
+
+    if (!csvPath.empty() && !WriteCsv(csvPath, axes, results)) {
+        std::fprintf(stderr, "failed to write %s\n", csvPath.c_str());
+        return 1;
+    }
+    if (ranked < results.size()) {
+        std::fprintf(stderr, "%zu configurations failed to evaluate and were left out of the ranking\n",
+                     results.size() - ranked);
+        return 1;
+    }
+    return 0;
+}